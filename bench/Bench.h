@@ -0,0 +1,168 @@
+#ifndef VALUE_PTR__BENCH_H__
+#define VALUE_PTR__BENCH_H__
+
+
+#include <chrono>
+#include <cstddef>
+
+
+/**
+ * Static class encapsulating a minimal microbenchmark harness
+ *
+ * Every measurement repeatedly runs a batch of operations, the callable
+ * being handed a stopwatch so as to exclude its setup and teardown from the
+ * timing, and prints a single CSV record to standard output:
+ *
+ *   suite,subject,operation,param,batch,rounds,min_ns,median_ns
+ *
+ * where min_ns and median_ns are the per-operation times of the fastest and
+ * median rounds respectively.
+ *
+ */
+class bench {
+  public:
+    /**
+     * Run-wide options
+     *
+     */
+    struct settings {
+      /**
+       * Minimum total time to spend on each measurement, in milliseconds
+       *
+       */
+      double target_ms;
+
+      /**
+       * Largest array size to allocate, in bytes
+       *
+       */
+      std::size_t max_bytes;
+
+      /**
+       * Only suites whose name contains this string are run (nullptr for all)
+       *
+       */
+      char const *filter;
+    };
+
+    /**
+     * Stopwatch accumulating the time elapsed between start and stop calls
+     *
+     */
+    class stopwatch {
+      public:
+        /**
+         * Constructor
+         *
+         */
+        stopwatch() noexcept;
+
+        /**
+         * Start timing
+         *
+         */
+        void start() noexcept;
+
+        /**
+         * Stop timing, accumulating the time elapsed since the last start
+         *
+         */
+        void stop() noexcept;
+
+        /**
+         * Return the accumulated time
+         *
+         * @return the accumulated time, in nanoseconds
+         */
+        double elapsed() const noexcept __attribute__((pure));
+
+      protected:
+        /**
+         * Time of the last start
+         *
+         */
+        std::chrono::steady_clock::time_point begin;
+
+        /**
+         * Accumulated time, in nanoseconds
+         *
+         */
+        double total;
+    };
+
+    /**
+     * Return the run-wide options
+     *
+     * @return a reference to the run-wide options
+     */
+    static settings &options() noexcept __attribute__((const));
+
+    /**
+     * Parse the command line into the run-wide options
+     *
+     * Recognized arguments are "--quick", "--max-bytes N" and "--filter S".
+     *
+     * @param argc  Number of arguments
+     * @param argv  Arguments
+     * @return whether the command line could be parsed
+     */
+    static bool parse(int argc, char *argv[]) noexcept;
+
+    /**
+     * Print the CSV header
+     *
+     */
+    static void header();
+
+    /**
+     * Return whether the given suite is to be run
+     *
+     * @param suite  Name of the suite
+     * @return whether the suite passes the filter
+     */
+    static bool enabled(char const *suite) noexcept __attribute__((pure));
+
+    /**
+     * Measure a batch operation and print its CSV record
+     *
+     * The callable is invoked as f(stopwatch &, batch), and must time exactly
+     * batch operations.
+     *
+     * @param suite  Name of the suite
+     * @param subject  Name of the measured type
+     * @param operation  Name of the measured operation
+     * @param param  Free parameter of the measurement (eg. size in bytes, or number of threads)
+     * @param batch  Number of operations per round
+     * @param f  Callable performing a round
+     */
+    template <typename F>
+    static void measure(char const *suite, char const *subject, char const *operation, std::size_t param, std::size_t batch, F &&f);
+
+    /**
+     * Prevent the optimizer from discarding the given object
+     *
+     * @param value  Object to keep
+     */
+    template <typename T>
+    static void keep(T const &value) noexcept;
+
+  protected:
+    /**
+     * Print a CSV record
+     *
+     * @param suite  Name of the suite
+     * @param subject  Name of the measured type
+     * @param operation  Name of the measured operation
+     * @param param  Free parameter of the measurement
+     * @param batch  Number of operations per round
+     * @param rounds  Number of rounds measured
+     * @param min  Per-operation time of the fastest round, in nanoseconds
+     * @param median  Per-operation time of the median round, in nanoseconds
+     */
+    static void report(char const *suite, char const *subject, char const *operation, std::size_t param, std::size_t batch, std::size_t rounds, double min, double median);
+};
+
+
+#include "Bench.hpp"
+
+#endif /* VALUE_PTR__BENCH_H__ */
@@ -0,0 +1,155 @@
+#ifndef VALUE_PTR__BENCH_HPP__
+#define VALUE_PTR__BENCH_HPP__
+
+
+#include "Bench.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+
+/**
+ * Constructor
+ *
+ */
+inline bench::stopwatch::stopwatch() noexcept : begin(), total(0) {}
+
+/**
+ * Start timing
+ *
+ */
+inline void bench::stopwatch::start() noexcept {
+  begin = std::chrono::steady_clock::now();
+}
+
+/**
+ * Stop timing, accumulating the time elapsed since the last start
+ *
+ */
+inline void bench::stopwatch::stop() noexcept {
+  total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+}
+
+/**
+ * Return the accumulated time
+ *
+ * @return the accumulated time, in nanoseconds
+ */
+inline double bench::stopwatch::elapsed() const noexcept {
+  return total;
+}
+
+/**
+ * Return the run-wide options
+ *
+ * @return a reference to the run-wide options
+ */
+inline bench::settings &bench::options() noexcept {
+  static settings opts = { 200.0, std::size_t(64) << 20, nullptr };
+  return opts;
+}
+
+/**
+ * Parse the command line into the run-wide options
+ *
+ * Recognized arguments are "--quick", "--max-bytes N" and "--filter S".
+ *
+ * @param argc  Number of arguments
+ * @param argv  Arguments
+ * @return whether the command line could be parsed
+ */
+inline bool bench::parse(int argc, char *argv[]) noexcept {
+  for (int i = 1; i < argc; i++) {
+    if (0 == std::strcmp("--quick", argv[i])) {
+      options().target_ms = 10.0;
+    } else if (0 == std::strcmp("--max-bytes", argv[i]) && i + 1 < argc) {
+      options().max_bytes = std::strtoull(argv[++i], nullptr, 0);
+    } else if (0 == std::strcmp("--filter", argv[i]) && i + 1 < argc) {
+      options().filter = argv[++i];
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Print the CSV header
+ *
+ */
+inline void bench::header() {
+  std::cout << "suite,subject,operation,param,batch,rounds,min_ns,median_ns" << std::endl;
+}
+
+/**
+ * Return whether the given suite is to be run
+ *
+ * @param suite  Name of the suite
+ * @return whether the suite passes the filter
+ */
+inline bool bench::enabled(char const *suite) noexcept {
+  return nullptr == options().filter || nullptr != std::strstr(suite, options().filter);
+}
+
+/**
+ * Measure a batch operation and print its CSV record
+ *
+ * A first round is run as a warm-up, then rounds are run until the target
+ * time is spent (but at least 5 and at most 10000 of them).
+ *
+ * @param suite  Name of the suite
+ * @param subject  Name of the measured type
+ * @param operation  Name of the measured operation
+ * @param param  Free parameter of the measurement (eg. size in bytes, or number of threads)
+ * @param batch  Number of operations per round
+ * @param f  Callable performing a round
+ */
+template <typename F>
+void bench::measure(char const *suite, char const *subject, char const *operation, std::size_t param, std::size_t batch, F &&f) {
+  stopwatch warmup;
+  f(warmup, batch);
+
+  std::vector<double> rounds;
+  double spent = 0;
+  while (rounds.size() < 5 || (spent < options().target_ms * 1e6 && rounds.size() < 10000)) {
+    stopwatch watch;
+    f(watch, batch);
+    rounds.push_back(watch.elapsed() / static_cast<double>(batch));
+    spent += watch.elapsed();
+  }
+
+  std::sort(rounds.begin(), rounds.end());
+  report(suite, subject, operation, param, batch, rounds.size(), rounds.front(), rounds[rounds.size() / 2]);
+}
+
+/**
+ * Prevent the optimizer from discarding the given object
+ *
+ * @param value  Object to keep
+ */
+template <typename T>
+void bench::keep(T const &value) noexcept {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Print a CSV record
+ *
+ * @param suite  Name of the suite
+ * @param subject  Name of the measured type
+ * @param operation  Name of the measured operation
+ * @param param  Free parameter of the measurement
+ * @param batch  Number of operations per round
+ * @param rounds  Number of rounds measured
+ * @param min  Per-operation time of the fastest round, in nanoseconds
+ * @param median  Per-operation time of the median round, in nanoseconds
+ */
+inline void bench::report(char const *suite, char const *subject, char const *operation, std::size_t param, std::size_t batch, std::size_t rounds, double min, double median) {
+  std::cout << suite << ',' << subject << ',' << operation << ',' << param << ',' << batch << ',' << rounds << ',' << min << ',' << median << std::endl;
+}
+
+#endif /* VALUE_PTR__BENCH_HPP__ */
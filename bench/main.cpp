@@ -0,0 +1,879 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "value_ptr.h"
+#include "Parallel.h"
+#include "Counting.h"
+#include "Deferred.h"
+#include "Erased.h"
+#include "Collection.h"
+#include "Arena.h"
+#include "Compare.h"
+#include "Atomic.h"
+#include "Rcu.h"
+#include "Serialize.h"
+
+#include "Bench.h"
+
+// =========================================================================================================================================
+// =========================================================================================================================================
+
+class Shape {
+  public:
+    Shape() noexcept : area(1.0) {}
+    Shape(Shape const &) = default;
+    Shape &operator=(Shape const &) = default;
+    virtual ~Shape() noexcept {}
+
+    virtual Shape *clone(void *p = nullptr) const {
+      return nullptr == p ? new Shape(*this) : new(p) Shape(*this);
+    }
+
+    virtual double extent() const noexcept { return area; }
+
+    double area;
+};
+
+class Circle : public Shape {
+  public:
+    Circle() noexcept : Shape(), radius(1.0) {}
+    Circle(Circle const &) = default;
+    Circle &operator=(Circle const &) = default;
+    virtual ~Circle() noexcept {}
+
+    virtual Circle *clone(void *p = nullptr) const {
+      return nullptr == p ? new Circle(*this) : new(p) Circle(*this);
+    }
+
+    virtual double extent() const noexcept { return 2.0 * radius; }
+
+    double radius;
+};
+
+class Square : public Shape {
+  public:
+    Square() noexcept : Shape(), side(1.0) {}
+    Square(Square const &) = default;
+    Square &operator=(Square const &) = default;
+    virtual ~Square() noexcept {}
+
+    virtual Square *clone(void *p = nullptr) const {
+      return nullptr == p ? new Square(*this) : new(p) Square(*this);
+    }
+
+    virtual double extent() const noexcept { return side; }
+
+    double side;
+};
+
+struct Tagged {
+  Tagged() noexcept : tag(0) {}
+  Tagged(Tagged const &other) noexcept : tag(other.tag + 1) {}
+  Tagged &operator=(Tagged const &other) noexcept { tag = other.tag + 1; return *this; }
+  ~Tagged() noexcept {}
+
+  std::uint64_t tag;
+};
+
+struct Tree {
+  explicit Tree(std::size_t depth) : left(0 < depth ? new Tree(depth - 1) : nullptr), right(0 < depth ? new Tree(depth - 1) : nullptr) {}
+  Tree(Tree const &other) : left(nullptr != other.left ? new Tree(*other.left) : nullptr), right(nullptr != other.right ? new Tree(*other.right) : nullptr) {}
+  Tree &operator=(Tree const &) = delete;
+  ~Tree() noexcept { delete left; delete right; }
+
+  Tree *left;
+  Tree *right;
+};
+
+static constexpr std::size_t array_length = 16;
+
+// =========================================================================================================================================
+
+/**
+ * Raw-pointer operations on a pointee type, along with its by-value equivalent
+ *
+ */
+template <typename X> struct pointee;
+
+template <>
+struct pointee<int> {
+  using element = int;
+  using unique_type = std::unique_ptr<int>;
+  using value_type = int;
+
+  static int *make() { return new int(42); }
+  static int *copy(int const *p) { return new int(*p); }
+  static int *assign(int *p, int const *q) { *p = *q; return p; }
+  static void free(int const *p) noexcept { delete p; }
+  static value_type value() noexcept { return 42; }
+};
+
+template <>
+struct pointee<Shape> {
+  using element = Shape;
+  using unique_type = std::unique_ptr<Shape>;
+  using value_type = Circle;
+
+  static Circle *make() { return new Circle(); }
+  static Shape *copy(Shape const *p) { return p->clone(); }
+  static Shape *assign(Shape *p, Shape const *q) { Shape *ret = q->clone(); delete p; return ret; }
+  static void free(Shape const *p) noexcept { delete p; }
+  static value_type value() noexcept { return Circle(); }
+};
+
+template <>
+struct pointee<Shape[]> {
+  using element = Shape;
+  using unique_type = std::unique_ptr<Shape[]>;
+  using value_type = std::vector<Shape>;
+
+  static Shape *make() { return new Shape[array_length](); }
+  static Shape *copy(Shape const *p) { Shape *ret = new Shape[array_length]; std::copy_n(p, array_length, ret); return ret; }
+  static Shape *assign(Shape *p, Shape const *q) { std::copy_n(q, array_length, p); return p; }
+  static void free(Shape const *p) noexcept { delete[] p; }
+  static value_type value() { return value_type(array_length); }
+};
+
+template <>
+struct pointee<int[array_length]> {
+  using element = int;
+  using unique_type = std::unique_ptr<int[]>;
+  using value_type = std::array<int, array_length>;
+
+  static int *make() { return new int[array_length](); }
+  static int *copy(int const *p) { int *ret = new int[array_length]; std::memcpy(ret, p, sizeof(int[array_length])); return ret; }
+  static int *assign(int *p, int const *q) { std::memcpy(p, q, sizeof(int[array_length])); return p; }
+  static void free(int const *p) noexcept { delete[] p; }
+  static value_type value() noexcept { return value_type(); }
+};
+
+// =========================================================================================================================================
+
+/**
+ * Benchmarked operations on a value_ptr
+ *
+ */
+template <typename X, typename H = default_handler<X>>
+struct smart_subject {
+  using type = value_ptr<X, H>;
+
+  static type make() { return type(pointee<X>::make()); }
+  static type copy(type const &v) { return type(v); }
+  static type move(type &v) noexcept { return type(std::move(v)); }
+  static void assign(type &v, type const &w) { v = w; }
+  static void swap(type &v, type &w) noexcept { v.swap(w); }
+  static void reset(type &v) noexcept { v.reset(); }
+  static void destroy(type &v) noexcept { v.~type(); }
+};
+
+/**
+ * Benchmarked operations on a deep-copied std::unique_ptr
+ *
+ */
+template <typename X>
+struct unique_subject {
+  using type = typename pointee<X>::unique_type;
+
+  static type make() { return type(pointee<X>::make()); }
+  static type copy(type const &v) { return type(pointee<X>::copy(v.get())); }
+  static type move(type &v) noexcept { return type(std::move(v)); }
+  static void assign(type &v, type const &w) { typename pointee<X>::element *p = v.release(); v.reset(pointee<X>::assign(p, w.get())); }
+  static void swap(type &v, type &w) noexcept { v.swap(w); }
+  static void reset(type &v) noexcept { v.reset(); }
+  static void destroy(type &v) noexcept { v.~type(); }
+};
+
+/**
+ * Benchmarked operations on a deep-copied raw pointer
+ *
+ */
+template <typename X>
+struct raw_subject {
+  using type = typename pointee<X>::element *;
+
+  static type make() { return pointee<X>::make(); }
+  static type copy(type const &v) { return pointee<X>::copy(v); }
+  static type move(type &v) noexcept { type ret = v; v = nullptr; return ret; }
+  static void assign(type &v, type const &w) { v = pointee<X>::assign(v, w); }
+  static void swap(type &v, type &w) noexcept { std::swap(v, w); }
+  static void reset(type &v) noexcept { pointee<X>::free(v); v = nullptr; }
+  static void destroy(type &v) noexcept { pointee<X>::free(v); }
+};
+
+/**
+ * Benchmarked operations on by-value storage
+ *
+ */
+template <typename X>
+struct value_subject {
+  using type = typename pointee<X>::value_type;
+
+  static type make() { return pointee<X>::value(); }
+  static type copy(type const &v) { return type(v); }
+  static type move(type &v) noexcept { return type(std::move(v)); }
+  static void assign(type &v, type const &w) { v = w; }
+  static void swap(type &v, type &w) noexcept { std::swap(v, w); }
+  static void reset(type &v) { v = type(); }
+  static void destroy(type &v) noexcept { v.~type(); }
+};
+
+// =========================================================================================================================================
+
+/**
+ * Measure every basic operation of the given subject
+ *
+ * @param S  Subject class
+ * @param name  Name of the subject
+ * @param batch  Number of objects per round
+ */
+template <typename S>
+static void operations(char const *name, std::size_t batch) {
+  using V = typename S::type;
+
+  std::allocator<V> alloc;
+  V *slots = alloc.allocate(batch);
+  V *other = alloc.allocate(batch);
+  V *source = alloc.allocate(1);
+  new(source) V(S::make());
+
+  auto fill = [](V *where, std::size_t n) { for (std::size_t i = 0; i < n; i++) { new(where + i) V(S::make()); } };
+  auto clear = [](V *where, std::size_t n) { for (std::size_t i = 0; i < n; i++) { S::destroy(where[i]); } };
+
+  bench::measure("ops", name, "construct", 0, batch, [&](bench::stopwatch &w, std::size_t n) {
+    w.start(); for (std::size_t i = 0; i < n; i++) { new(slots + i) V(S::make()); } w.stop();
+    bench::keep(slots); clear(slots, n);
+  });
+  bench::measure("ops", name, "copy-construct", 0, batch, [&](bench::stopwatch &w, std::size_t n) {
+    w.start(); for (std::size_t i = 0; i < n; i++) { new(slots + i) V(S::copy(*source)); } w.stop();
+    bench::keep(slots); clear(slots, n);
+  });
+  bench::measure("ops", name, "copy-assign", 0, batch, [&](bench::stopwatch &w, std::size_t n) {
+    fill(slots, n);
+    w.start(); for (std::size_t i = 0; i < n; i++) { S::assign(slots[i], *source); } w.stop();
+    bench::keep(slots); clear(slots, n);
+  });
+  bench::measure("ops", name, "move", 0, batch, [&](bench::stopwatch &w, std::size_t n) {
+    fill(other, n);
+    w.start(); for (std::size_t i = 0; i < n; i++) { new(slots + i) V(S::move(other[i])); } w.stop();
+    bench::keep(slots); clear(other, n); clear(slots, n);
+  });
+  bench::measure("ops", name, "swap", 0, batch, [&](bench::stopwatch &w, std::size_t n) {
+    fill(slots, n);
+    w.start(); for (std::size_t i = 0; i < n; i++) { S::swap(slots[i], *source); } w.stop();
+    bench::keep(slots); clear(slots, n);
+  });
+  bench::measure("ops", name, "reset", 0, batch, [&](bench::stopwatch &w, std::size_t n) {
+    fill(slots, n);
+    w.start(); for (std::size_t i = 0; i < n; i++) { S::reset(slots[i]); } w.stop();
+    bench::keep(slots); clear(slots, n);
+  });
+  bench::measure("ops", name, "destroy", 0, batch, [&](bench::stopwatch &w, std::size_t n) {
+    fill(slots, n);
+    w.start(); for (std::size_t i = 0; i < n; i++) { S::destroy(slots[i]); } w.stop();
+    bench::keep(slots);
+  });
+
+  S::destroy(*source);
+  alloc.deallocate(source, 1);
+  alloc.deallocate(other, batch);
+  alloc.deallocate(slots, batch);
+}
+
+/**
+ * Compare value_ptr against std::unique_ptr, raw pointers, and by-value storage
+ *
+ */
+static void suite_ops() {
+  operations<smart_subject<int>>("value_ptr<int>", 1024);
+  operations<smart_subject<int, counting_handler<int>>>("value_ptr<int,counting>", 1024);
+  operations<unique_subject<int>>("unique_ptr<int>", 1024);
+  operations<raw_subject<int>>("int*", 1024);
+  operations<value_subject<int>>("int", 1024);
+
+  operations<smart_subject<Shape>>("value_ptr<Base>", 1024);
+  operations<smart_subject<Shape, erased_handler<Shape>>>("value_ptr<Base,erased>", 1024);
+  operations<unique_subject<Shape>>("unique_ptr<Base>", 1024);
+  operations<raw_subject<Shape>>("Base*", 1024);
+  operations<value_subject<Shape>>("Derived", 1024);
+
+  operations<smart_subject<Shape[]>>("value_ptr<Base[]>", 256);
+  operations<unique_subject<Shape[]>>("unique_ptr<Base[]>", 256);
+  operations<raw_subject<Shape[]>>("Base*[]", 256);
+  operations<value_subject<Shape[]>>("vector<Base>", 256);
+
+  operations<smart_subject<int[array_length]>>("value_ptr<int[16]>", 1024);
+  operations<unique_subject<int[array_length]>>("unique_ptr<int[]>", 1024);
+  operations<raw_subject<int[array_length]>>("int*[]", 1024);
+  operations<value_subject<int[array_length]>>("array<int,16>", 1024);
+}
+
+// =========================================================================================================================================
+
+/**
+ * Measure copying, and copying then writing, a value_ptr with the given handler
+ *
+ * @param H  Handler to use
+ * @param name  Name of the subject
+ */
+template <typename H>
+static void copies(char const *name) {
+  using payload = std::array<double, 512>;
+  using V = value_ptr<payload, H>;
+  constexpr std::size_t batch = 256;
+
+  std::allocator<V> alloc;
+  V *slots = alloc.allocate(batch);
+  V source = new payload();
+
+  bench::measure("cow", name, "copy-construct", sizeof(payload), batch, [&](bench::stopwatch &w, std::size_t n) {
+    w.start(); for (std::size_t i = 0; i < n; i++) { new(slots + i) V(source); } w.stop();
+    bench::keep(slots); for (std::size_t i = 0; i < n; i++) { slots[i].~V(); }
+  });
+  bench::measure("cow", name, "copy-write", sizeof(payload), batch, [&](bench::stopwatch &w, std::size_t n) {
+    w.start(); for (std::size_t i = 0; i < n; i++) { new(slots + i) V(source); (*slots[i].mutable_get())[0] = 1.0; } w.stop();
+    bench::keep(slots); for (std::size_t i = 0; i < n; i++) { slots[i].~V(); }
+  });
+
+  alloc.deallocate(slots, batch);
+}
+
+/**
+ * Compare deep copies against copy-on-write sharing
+ *
+ */
+static void suite_cow() {
+  copies<default_handler<std::array<double, 512>>>("value_ptr<4KiB>");
+  copies<cow_handler<std::array<double, 512>>>("value_ptr<4KiB,cow>");
+  copies<cow_handler<std::array<double, 512>, plain_refcount>>("value_ptr<4KiB,cow-plain>");
+}
+
+// =========================================================================================================================================
+
+/**
+ * Measure copy-constructing and copy-assigning arrays of the given size
+ *
+ * @param V  value_ptr type to copy
+ * @param name  Name of the subject
+ * @param source  Array to copy
+ * @param bytes  Size of the array, in bytes
+ */
+template <typename V>
+static void sweep(char const *name, V const &source, std::size_t bytes) {
+  std::size_t batch = std::max(std::size_t(1), std::min(std::size_t(1024), (std::size_t(1) << 22) / bytes));
+
+  std::allocator<V> alloc;
+  V *slots = alloc.allocate(batch);
+
+  bench::measure("bulk", name, "copy-construct", bytes, batch, [&](bench::stopwatch &w, std::size_t n) {
+    w.start(); for (std::size_t i = 0; i < n; i++) { new(slots + i) V(source); } w.stop();
+    bench::keep(slots); for (std::size_t i = 0; i < n; i++) { slots[i].~V(); }
+  });
+  bench::measure("bulk", name, "copy-assign", bytes, batch, [&](bench::stopwatch &w, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) { new(slots + i) V(source); }
+    w.start(); for (std::size_t i = 0; i < n; i++) { slots[i] = source; } w.stop();
+    bench::keep(slots); for (std::size_t i = 0; i < n; i++) { slots[i].~V(); }
+  });
+
+  alloc.deallocate(slots, batch);
+}
+
+/**
+ * Sweep array copies from 16 bytes up to the largest size allowed, trivially copyable (bulk) and not (element loop)
+ *
+ */
+static void suite_bulk() {
+  for (std::size_t bytes = 16; bytes <= bench::options().max_bytes; bytes *= 4) {
+    std::size_t n = bytes / sizeof(double);
+
+    double *d = Described<>::newArray<double>(n);
+    std::fill_n(d, n, 1.0);
+    value_ptr<double[], default_handler<double[], Described<>>> vd = d;
+    sweep("value_ptr<double[]>", vd, bytes);
+
+    value_ptr<Tagged[]> vt = new Tagged[bytes / sizeof(Tagged)]();
+    sweep("value_ptr<Tagged[]>", vt, bytes);
+  }
+}
+
+// =========================================================================================================================================
+
+/**
+ * Measure copy-constructing the given array with the given number of threads
+ *
+ * @param V  value_ptr type to copy, using a parallel_handler
+ * @param name  Name of the subject
+ * @param source  Array to copy
+ * @param threads  Number of threads
+ */
+template <typename V>
+static void scale(char const *name, V const &source, std::size_t threads) {
+  V v(source.get_handler().replicate(source.get()), typename V::handler_type(threads));
+
+  bench::measure("parallel", name, "copy-construct", threads, 1, [&v](bench::stopwatch &w, std::size_t) {
+    w.start(); V copy = v; w.stop();
+    bench::keep(copy);
+  });
+}
+
+/**
+ * Scale the replication of a large array across 1 to N threads
+ *
+ */
+static void suite_parallel() {
+  std::size_t bytes = std::min(bench::options().max_bytes, std::size_t(64) << 20);
+  std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+  using vd_type = value_ptr<double[], parallel_handler<double[], 1, Described<>>>;
+  using vt_type = value_ptr<Tagged[], parallel_handler<Tagged[], 1>>;
+
+  double *d = Described<>::newArray<double>(bytes / sizeof(double));
+  std::fill_n(d, bytes / sizeof(double), 1.0);
+  vd_type vd = d;
+  vt_type vt = new Tagged[bytes / sizeof(Tagged)]();
+
+  for (std::size_t threads = 1; threads <= cores; threads++) {
+    scale("value_ptr<double[]>", vd, threads);
+    scale("value_ptr<Tagged[]>", vt, threads);
+  }
+}
+
+// =========================================================================================================================================
+
+/**
+ * Measure resetting a copy of the given tree, pending deferred destructions being flushed between rounds
+ *
+ * @param V  value_ptr type to reset
+ * @param name  Name of the subject
+ * @param source  Tree to copy
+ * @param nodes  Number of nodes in the tree
+ */
+template <typename V>
+static void teardown(char const *name, V const &source, std::size_t nodes) {
+  bench::measure("teardown", name, "reset", nodes, 1, [&source](bench::stopwatch &w, std::size_t) {
+    V copy = source;
+    w.start(); copy.reset(); w.stop();
+    bench::keep(copy);
+    reclaimer::instance().flush();
+  });
+}
+
+/**
+ * Compare inline and deferred destruction latency of binary trees from 15 nodes up to the largest size allowed
+ *
+ */
+static void suite_teardown() {
+  for (std::size_t depth = 4; depth <= 20 && sizeof(Tree) << depth <= bench::options().max_bytes; depth += 4) {
+    std::size_t nodes = (std::size_t(1) << depth) - 1;
+
+    value_ptr<Tree> vt = new Tree(depth - 1);
+    teardown("value_ptr<Tree>", vt, nodes);
+
+    value_ptr<Tree, deferred_handler<Tree>> vd = new Tree(depth - 1);
+    teardown("value_ptr<Tree,deferred>", vd, nodes);
+  }
+}
+
+// =========================================================================================================================================
+
+/**
+ * Compare iterating and copying a shuffled mix of shapes held as value_ptrs in a std::vector versus in a value_collection
+ *
+ */
+static void suite_collection() {
+  constexpr std::size_t count = 4096;
+
+  std::vector<value_ptr<Shape>> vv;
+  value_collection<Shape> vc;
+  std::uint32_t seed = 1;
+  for (std::size_t i = 0; i < count; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    switch (seed >> 30) {
+      case 0:  vv.emplace_back(new Shape());  vc.emplace<Shape>();  break;
+      case 1:  vv.emplace_back(new Square()); vc.emplace<Square>(); break;
+      default: vv.emplace_back(new Circle()); vc.emplace<Circle>(); break;
+    }
+  }
+
+  bench::measure("collection", "vector<value_ptr<Base>>", "iterate", count, count, [&vv](bench::stopwatch &w, std::size_t) {
+    double sum = 0.0;
+    w.start(); for (value_ptr<Shape> const &v : vv) { sum += v->extent(); } w.stop();
+    bench::keep(sum);
+  });
+  bench::measure("collection", "value_collection<Base>", "iterate", count, count, [&vc](bench::stopwatch &w, std::size_t) {
+    double sum = 0.0;
+    w.start(); vc.for_each([&sum](Shape const &s) { sum += s.extent(); }); w.stop();
+    bench::keep(sum);
+  });
+  bench::measure("collection", "vector<value_ptr<Base>>", "copy", count, count, [&vv](bench::stopwatch &w, std::size_t) {
+    w.start(); std::vector<value_ptr<Shape>> copy = vv; w.stop();
+    bench::keep(copy);
+  });
+  bench::measure("collection", "value_collection<Base>", "copy", count, count, [&vc](bench::stopwatch &w, std::size_t) {
+    w.start(); value_collection<Shape> copy = vc; w.stop();
+    bench::keep(copy);
+  });
+}
+
+// =========================================================================================================================================
+
+/**
+ * Compare copying a vector of value_ptrs element by element against cloning it into a single arena, from 1k up to 100k elements
+ *
+ */
+static void suite_arena() {
+  for (std::size_t count = 1000; count <= 100000; count *= 10) {
+    std::vector<value_ptr<Tagged>> source;
+    source.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+      source.emplace_back(new Tagged());
+    }
+
+    bench::measure("arena", "vector<value_ptr<Tagged>>", "copy", count, count, [&source](bench::stopwatch &w, std::size_t) {
+      w.start(); std::vector<value_ptr<Tagged>> copy = source; w.stop();
+      bench::keep(copy);
+    });
+    bench::measure("arena", "vector<value_ptr<Tagged,arena>>", "clone_range", count, count, [&source](bench::stopwatch &w, std::size_t) {
+      std::vector<value_ptr<Tagged, arena_handler<Tagged>>> copy;
+      w.start(); copy.reserve(source.size()); clone_range(source.begin(), source.end(), std::back_inserter(copy)); w.stop();
+      bench::keep(copy);
+    });
+  }
+}
+
+// =========================================================================================================================================
+
+/**
+ * Compare ordering and hashing arrays element by element against value_compare
+ *
+ */
+static void suite_compare() {
+  using V = value_ptr<std::int32_t[], default_handler<std::int32_t[], Described<>>>;
+
+  for (std::size_t bytes = 64; bytes <= bench::options().max_bytes; bytes *= 16) {
+    std::size_t n = bytes / sizeof(std::int32_t);
+
+    V x = make_value<std::int32_t[], V::handler_type>(n);
+    for (std::size_t i = 0; i < n; i++) {
+      x[i] = static_cast<std::int32_t>(i);
+    }
+    V y = x;
+    y[n - 1] = -1;
+
+    bench::measure("compare", "value_ptr<int32_t[]>", "less (elementwise)", bytes, 1, [&x, &y, n](bench::stopwatch &w, std::size_t) {
+      w.start(); bool r = std::lexicographical_compare(x.get(), x.get() + n, y.get(), y.get() + n); w.stop();
+      bench::keep(r);
+    });
+    bench::measure("compare", "value_ptr<int32_t[]>", "less (value_compare)", bytes, 1, [&x, &y](bench::stopwatch &w, std::size_t) {
+      w.start(); bool r = value_compare::less(x, y); w.stop();
+      bench::keep(r);
+    });
+    bench::measure("compare", "value_ptr<int32_t[]>", "hash (elementwise)", bytes, 1, [&x, n](bench::stopwatch &w, std::size_t) {
+      w.start();
+      std::size_t h = n;
+      for (std::size_t i = 0; i < n; i++) {
+        h = value_kernels::combine(h, std::hash<std::int32_t>()(x[i]));
+      }
+      w.stop();
+      bench::keep(h);
+    });
+    bench::measure("compare", "value_ptr<int32_t[]>", "hash (value_compare)", bytes, 1, [&x](bench::stopwatch &w, std::size_t) {
+      w.start(); std::size_t h = value_compare::hash(x); w.stop();
+      bench::keep(h);
+    });
+  }
+}
+
+// =========================================================================================================================================
+
+/**
+ * Compare reading, copying and publishing an array behind a std::mutex against atomic_value_ptr
+ *
+ */
+static void suite_atomic() {
+  using V = value_ptr<std::int32_t[], default_handler<std::int32_t[], Described<>>>;
+
+  for (std::size_t bytes = 64; bytes <= bench::options().max_bytes; bytes *= 16) {
+    std::size_t n = bytes / sizeof(std::int32_t);
+
+    std::mutex lock;
+    V locked = make_value<std::int32_t[], V::handler_type>(n);
+    atomic_value_ptr<std::int32_t[], V::handler_type> published(make_value<std::int32_t[], V::handler_type>(n));
+
+    bench::measure("atomic", "value_ptr<int32_t[]>", "read (mutex)", bytes, 1, [&lock, &locked](bench::stopwatch &w, std::size_t) {
+      w.start();
+      std::int32_t r;
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        r = locked[0];
+      }
+      w.stop();
+      bench::keep(r);
+    });
+    bench::measure("atomic", "value_ptr<int32_t[]>", "read (borrow)", bytes, 1, [&published](bench::stopwatch &w, std::size_t) {
+      w.start();
+      std::int32_t r;
+      {
+        atomic_value_ptr<std::int32_t[], V::handler_type>::guard g = published.borrow();
+        r = g.get()[0];
+      }
+      w.stop();
+      bench::keep(r);
+    });
+    bench::measure("atomic", "value_ptr<int32_t[]>", "copy (mutex)", bytes, 1, [&lock, &locked](bench::stopwatch &w, std::size_t) {
+      w.start();
+      V r;
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        r = locked;
+      }
+      w.stop();
+      bench::keep(r.get());
+    });
+    bench::measure("atomic", "value_ptr<int32_t[]>", "copy (load)", bytes, 1, [&published](bench::stopwatch &w, std::size_t) {
+      w.start(); V r = published.load(); w.stop();
+      bench::keep(r.get());
+    });
+    bench::measure("atomic", "value_ptr<int32_t[]>", "publish (mutex)", bytes, 1, [&lock, &locked, n](bench::stopwatch &w, std::size_t) {
+      V next = make_value<std::int32_t[], V::handler_type>(n);
+      w.start();
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        swap(locked, next);
+      }
+      next.reset();
+      w.stop();
+    });
+    bench::measure("atomic", "value_ptr<int32_t[]>", "publish (store)", bytes, 1, [&published, n](bench::stopwatch &w, std::size_t) {
+      V next = make_value<std::int32_t[], V::handler_type>(n);
+      w.start(); published.store(std::move(next)); w.stop();
+    });
+  }
+}
+
+// =========================================================================================================================================
+
+/**
+ * Background readers, running a read repeatedly until destroyed
+ *
+ */
+class contention {
+  public:
+    /**
+     * Start the given number of background threads running the given read
+     *
+     * @param F  Callable type, taking an iteration index
+     * @param threads  Number of background threads
+     * @param f  Read to run repeatedly
+     */
+    template <typename F>
+    contention(std::size_t threads, F const &f) : workers(), done(false), padding() {
+      for (std::size_t i = 0; i < threads; i++) {
+        workers.emplace_back([this, f]() {
+          for (std::size_t j = 0; !done.load(std::memory_order_relaxed); j++) {
+            bench::keep(f(j));
+          }
+        });
+      }
+    }
+
+    /**
+     * Stop and join the background threads
+     *
+     */
+    ~contention() {
+      done.store(true);
+      for (std::thread &t : workers) {
+        t.join();
+      }
+    }
+
+  protected:
+    /**
+     * Background threads
+     *
+     */
+    std::vector<std::thread> workers;
+
+    /**
+     * Whether the background threads are to stop
+     *
+     */
+    std::atomic<bool> done;
+
+    /**
+     * Padding up to the alignment of workers
+     *
+     */
+    [[no_unique_address]] explicit_padding<padding_to<sizeof(std::vector<std::thread>) + sizeof(std::atomic<bool>), alignof(std::vector<std::thread>)>::value> padding;
+};
+
+/**
+ * Compare reading and updating a table behind a std::shared_mutex versus an rcu_value_ptr, with up to one reader per core
+ *
+ */
+static void suite_rcu() {
+  using V = value_ptr<std::int32_t[], default_handler<std::int32_t[], Described<>>>;
+
+  std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t n = 4096;
+
+  std::shared_mutex lock;
+  V locked = make_value<std::int32_t[], V::handler_type>(n);
+  rcu_value_ptr<std::int32_t[], V::handler_type> published(make_value<std::int32_t[], V::handler_type>(n));
+
+  auto readLocked = [&lock, &locked, n](std::size_t i) {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return locked[i % n];
+  };
+  auto readPublished = [&published, n](std::size_t i) {
+    rcu_value_ptr<std::int32_t[], V::handler_type>::snapshot s = published.read();
+    return s.get()[i % n];
+  };
+
+  for (std::size_t threads = 1; threads <= cores; threads *= 2) {
+    {
+      contention background(threads - 1, readLocked);
+      bench::measure("rcu", "value_ptr<int32_t[4096]>", "read (shared_mutex)", threads, 1024, [&readLocked](bench::stopwatch &w, std::size_t batch) {
+        std::int32_t r = 0;
+        w.start();
+        for (std::size_t i = 0; i < batch; i++) {
+          r += readLocked(i);
+        }
+        w.stop();
+        bench::keep(r);
+      });
+      bench::measure("rcu", "value_ptr<int32_t[4096]>", "update (shared_mutex)", threads, 1, [&lock, &locked](bench::stopwatch &w, std::size_t) {
+        w.start();
+        {
+          std::unique_lock<std::shared_mutex> guard(lock);
+          locked[0]++;
+        }
+        w.stop();
+      });
+    }
+    {
+      contention background(threads - 1, readPublished);
+      bench::measure("rcu", "value_ptr<int32_t[4096]>", "read (rcu_value_ptr)", threads, 1024, [&readPublished](bench::stopwatch &w, std::size_t batch) {
+        std::int32_t r = 0;
+        w.start();
+        for (std::size_t i = 0; i < batch; i++) {
+          r += readPublished(i);
+        }
+        w.stop();
+        bench::keep(r);
+      });
+      bench::measure("rcu", "value_ptr<int32_t[4096]>", "update (rcu_value_ptr)", threads, 1, [&published](bench::stopwatch &w, std::size_t) {
+        w.start(); published.update([](V &v) { v[0]++; }); w.stop();
+      });
+    }
+    published.synchronize();
+  }
+}
+
+// =========================================================================================================================================
+
+/**
+ * Compare saving and loading an array element by element against value_writer / value_reader
+ *
+ */
+static void suite_serialize() {
+  using V = value_ptr<double[], default_handler<double[], Described<>>>;
+
+  for (std::size_t bytes = 64; bytes <= bench::options().max_bytes; bytes *= 16) {
+    std::size_t n = bytes / sizeof(double);
+
+    V source = make_value<double[], V::handler_type>(n);
+    std::vector<char> image;
+    {
+      value_writer out(image);
+      out.write(source);
+    }
+
+    bench::measure("serialize", "value_ptr<double[]>", "save (per element)", bytes, 1, [&source, n](bench::stopwatch &w, std::size_t) {
+      std::vector<char> r;
+      w.start();
+      std::uint64_t count = n;
+      r.push_back(1);
+      r.insert(r.end(), reinterpret_cast<char const *>(&count), reinterpret_cast<char const *>(&count + 1));
+      for (std::size_t i = 0; i < n; i++) {
+        r.insert(r.end(), reinterpret_cast<char const *>(&source[i]), reinterpret_cast<char const *>(&source[i] + 1));
+      }
+      w.stop();
+      bench::keep(r.data());
+    });
+    bench::measure("serialize", "value_ptr<double[]>", "save (value_writer)", bytes, 1, [&source](bench::stopwatch &w, std::size_t) {
+      std::vector<char> r;
+      w.start();
+      {
+        value_writer out(r);
+        out.write(source);
+      }
+      w.stop();
+      bench::keep(r.data());
+    });
+    bench::measure("serialize", "value_ptr<double[]>", "load (per element)", bytes, 1, [&image](bench::stopwatch &w, std::size_t) {
+      w.start();
+      char const *cursor = image.data() + 1;
+      std::uint64_t count;
+      std::memcpy(&count, cursor, sizeof(count));
+      cursor += sizeof(count);
+      V r = make_value<double[], V::handler_type>(count);
+      for (std::size_t i = 0; i < count; i++, cursor += sizeof(double)) {
+        std::memcpy(&r[i], cursor, sizeof(double));
+      }
+      w.stop();
+      bench::keep(r.get());
+    });
+    bench::measure("serialize", "value_ptr<double[]>", "load (value_reader)", bytes, 1, [&image](bench::stopwatch &w, std::size_t) {
+      w.start();
+      value_reader in(image);
+      V r = in.read<V>();
+      w.stop();
+      bench::keep(r.get());
+    });
+  }
+}
+
+// =========================================================================================================================================
+// =========================================================================================================================================
+
+
+using namespace std;
+
+
+int main(int argc, char *argv[]) {
+  if (!bench::parse(argc, argv)) {
+    cerr << "Usage: " << argv[0] << " [--quick] [--max-bytes N] [--filter SUITE]" << endl;
+    return 1;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  bench::header();
+
+  if (bench::enabled("ops"))        { suite_ops();        }
+  if (bench::enabled("cow"))        { suite_cow();        }
+  if (bench::enabled("bulk"))       { suite_bulk();       }
+  if (bench::enabled("parallel"))   { suite_parallel();   }
+  if (bench::enabled("teardown"))   { suite_teardown();   }
+  if (bench::enabled("collection")) { suite_collection(); }
+  if (bench::enabled("arena"))      { suite_arena();      }
+  if (bench::enabled("compare"))    { suite_compare();    }
+  if (bench::enabled("atomic"))     { suite_atomic();     }
+  if (bench::enabled("rcu"))        { suite_rcu();        }
+  if (bench::enabled("serialize"))  { suite_serialize();  }
+
+  // ---------------------------------------------------------------------------
+
+  return 0;
+}
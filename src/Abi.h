@@ -3,6 +3,7 @@
 
 
 #include <cstdint>
+#include <cstddef>
 
 
 /**
@@ -37,6 +38,49 @@ class Abi {
      * @param p  Pointer to the array proper
      */
     template <typename T> static void delArray(T const *p) noexcept;
+
+    /**
+     * Return a new array allocated from the given resource, including cookie if needed, but do NOT call constructors
+     *
+     * The resource must provide allocate(bytes, alignment) and
+     * deallocate(pointer, bytes, alignment) methods.
+     *
+     * @param T  Underlying type of the array
+     * @param Resource  Type of the memory resource to allocate from
+     * @param n  Number of elements in the allocated array
+     * @param resource  Memory resource to allocate from
+     * @return a pointer to the allocated array
+     * @throws std::bad_alloc  In case the underlying operation throws
+     */
+    template <typename T, typename Resource> static T *newArray(std::size_t n, Resource &resource);
+
+    /**
+     * Return an array created by newArray<T, Resource> to the given resource, including cookie if needed, but do NOT call destructors
+     *
+     * @param T  Underlying type of the array
+     * @param Resource  Type of the memory resource the array was allocated from
+     * @param p  Pointer to the array proper
+     * @param n  Number of elements in the array
+     * @param resource  Memory resource the array was allocated from
+     */
+    template <typename T, typename Resource> static void delArray(T const *p, std::size_t n, Resource &resource) noexcept;
+
+    /**
+     * Return the number of bytes newArray<T, Resource> requests from a resource
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the array
+     * @return the number of bytes requested for an array of n elements
+     */
+    template <typename T> static constexpr std::size_t arrayBytes(std::size_t n) noexcept;
+
+    /**
+     * Return the alignment newArray<T, Resource> requests from a resource
+     *
+     * @param T  Underlying type of the array
+     * @return the alignment requested for arrays of the given type
+     */
+    template <typename T> static constexpr std::size_t arrayAlign() noexcept;
 };
 
 /**
@@ -65,7 +109,7 @@ class Itanium : public Abi {
      * @throws abi_error  In case the size cannot be determined
      */
     template <typename T>
-    static std::size_t arraySize(T const *p) noexcept override __attribute__((pure));
+    static std::size_t arraySize(T const *p) noexcept __attribute__((pure));
 
     /**
      * Return a new array, including cookie if needed, but do NOT call constructors
@@ -76,7 +120,7 @@ class Itanium : public Abi {
      * @throws std::bad_alloc  In case the underlying operation throws
      */
     template <typename T>
-    static T *newArray(std::size_t n) override;
+    static T *newArray(std::size_t n);
 
     /**
      * Delete an array created by newArray<T>, including cookie if needed, but do NOT call destructors
@@ -85,7 +129,380 @@ class Itanium : public Abi {
      * @param p  Pointer to the array proper
      */
     template <typename T>
-    static void delArray(T const *p) noexcept override;
+    static void delArray(T const *p) noexcept;
+
+    /**
+     * Return a new array allocated from the given resource, including cookie if needed, but do NOT call constructors
+     *
+     * The resource must provide allocate(bytes, alignment) and
+     * deallocate(pointer, bytes, alignment) methods.
+     *
+     * @param T  Underlying type of the array
+     * @param Resource  Type of the memory resource to allocate from
+     * @param n  Number of elements in the allocated array
+     * @param resource  Memory resource to allocate from
+     * @return a pointer to the allocated array
+     * @throws std::bad_alloc  In case the underlying operation throws
+     */
+    template <typename T, typename Resource>
+    static T *newArray(std::size_t n, Resource &resource);
+
+    /**
+     * Return an array created by newArray<T, Resource> to the given resource, including cookie if needed, but do NOT call destructors
+     *
+     * @param T  Underlying type of the array
+     * @param Resource  Type of the memory resource the array was allocated from
+     * @param p  Pointer to the array proper
+     * @param n  Number of elements in the array
+     * @param resource  Memory resource the array was allocated from
+     */
+    template <typename T, typename Resource>
+    static void delArray(T const *p, std::size_t n, Resource &resource) noexcept;
+
+    /**
+     * Return the number of bytes newArray<T, Resource> requests from a resource
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the array
+     * @return the size of the array plus its cookie, if needed
+     */
+    template <typename T>
+    static constexpr std::size_t arrayBytes(std::size_t n) noexcept __attribute__((const));
+
+    /**
+     * Return the alignment to request from a memory resource for an array
+     *
+     * @param T  Underlying type of the array
+     * @return the alignment needed for both the cookie and the elements
+     */
+    template <typename T>
+    static constexpr std::size_t arrayAlign() noexcept  __attribute__((pure));
+};
+
+
+/**
+ * Static class to encapsulate over-aligned array operations
+ *
+ * Arrays are laid out after a header holding the offset to the start of the
+ * underlying allocation and the element count (always stored, so that the
+ * array size is available for every underlying type), and are aligned to the
+ * largest of the given alignment and that of their underlying type. Each
+ * allocation is followed by (zeroed) tail padding so that vectorized kernels
+ * may safely read past the last element, and can optionally be padded to
+ * whole cache lines so that no other object shares the array's cache lines.
+ *
+ * Note that arrays must have been created by this class' newArray methods:
+ * arrays obtained from new[] are NOT compatible with it.
+ *
+ * @param Alignment  Minimum alignment of the array proper (a power of two)
+ * @param TailPadding  Number of bytes following the last element that may be read
+ * @param CacheLinePadding  Whether to align and pad the array to whole cache lines
+ */
+template <std::size_t Alignment = 64, std::size_t TailPadding = 64, bool CacheLinePadding = false>
+class Aligned : public Abi {
+  static_assert(0 != Alignment && 0 == (Alignment & (Alignment - 1)), "alignment must be a power of two");
+
+  public:
+    /**
+     * Assumed size of a cache line
+     *
+     */
+    static constexpr std::size_t cache_line = 64;
+
+    /**
+     * Return the size of the pointed-to array
+     *
+     * @param T  Underlying type of the array
+     * @param p  Pointer to the array proper
+     * @return the size of the pointed-to array
+     */
+    template <typename T>
+    static std::size_t arraySize(T const *p) noexcept __attribute__((pure));
+
+    /**
+     * Return a new array, including header and padding, but do NOT call constructors
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the allocated array
+     * @return a pointer to the allocated array
+     * @throws std::bad_alloc  In case the underlying operation throws
+     */
+    template <typename T>
+    static T *newArray(std::size_t n);
+
+    /**
+     * Delete an array created by newArray<T>, including header and padding, but do NOT call destructors
+     *
+     * @param T  Underlying type of the array
+     * @param p  Pointer to the array proper
+     */
+    template <typename T>
+    static void delArray(T const *p) noexcept;
+
+    /**
+     * Return a new array allocated from the given resource, including header and padding, but do NOT call constructors
+     *
+     * The resource must provide allocate(bytes, alignment) and
+     * deallocate(pointer, bytes, alignment) methods, and honour the requested
+     * alignment.
+     *
+     * @param T  Underlying type of the array
+     * @param Resource  Type of the memory resource to allocate from
+     * @param n  Number of elements in the allocated array
+     * @param resource  Memory resource to allocate from
+     * @return a pointer to the allocated array
+     * @throws std::bad_alloc  In case the underlying operation throws
+     */
+    template <typename T, typename Resource>
+    static T *newArray(std::size_t n, Resource &resource);
+
+    /**
+     * Return an array created by newArray<T, Resource> to the given resource, including header and padding, but do NOT call destructors
+     *
+     * @param T  Underlying type of the array
+     * @param Resource  Type of the memory resource the array was allocated from
+     * @param p  Pointer to the array proper
+     * @param n  Number of elements in the array
+     * @param resource  Memory resource the array was allocated from
+     */
+    template <typename T, typename Resource>
+    static void delArray(T const *p, std::size_t n, Resource &resource) noexcept;
+
+    /**
+     * Return the number of bytes newArray<T, Resource> requests from a resource
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the array
+     * @return the size of the header, the array and its padding
+     */
+    template <typename T>
+    static constexpr std::size_t arrayBytes(std::size_t n) noexcept __attribute__((const));
+
+    /**
+     * Return the alignment of arrays of the given type
+     *
+     * @param T  Underlying type of the array
+     * @return the alignment of arrays of the given type
+     */
+    template <typename T>
+    static constexpr std::size_t arrayAlign() noexcept __attribute__((const));
+
+  protected:
+    /**
+     * Round the given size up to a multiple of the given power of two
+     *
+     * @param n  Size to round up
+     * @param m  Power of two to round up to
+     * @return n rounded up to a multiple of m
+     */
+    static constexpr std::size_t roundUp(std::size_t n, std::size_t m) noexcept __attribute__((const));
+
+    /**
+     * Return the size of the header preceding arrays of the given type
+     *
+     * @param T  Underlying type of the array
+     * @return the size of the header
+     */
+    template <typename T>
+    static constexpr std::size_t headerLen() noexcept __attribute__((const));
+
+    /**
+     * Return the size of the array proper plus its padding
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the array
+     * @return the size of the array plus its padding
+     */
+    template <typename T>
+    static constexpr std::size_t payloadLen(std::size_t n) noexcept __attribute__((const));
+
+    /**
+     * Lay out the header and zero the tail padding of an array
+     *
+     * @param T  Underlying type of the array
+     * @param raw  Pointer to the underlying allocation
+     * @param ret  Pointer to the array proper
+     * @param n  Number of elements in the array
+     * @return ret
+     */
+    template <typename T>
+    static T *layOut(void *raw, char *ret, std::size_t n) noexcept;
+};
+
+
+/**
+ * Static class to encapsulate self-describing array operations
+ *
+ * Arrays are laid out after a header always holding the element count
+ * (and, optionally, the capacity the array was allocated with), so that the
+ * array size is available for every underlying type, including trivially
+ * destructible ones. Arrays are aligned as the global allocation function
+ * does, use the Aligned ABI for over-aligned types.
+ *
+ * Note that arrays must have been created by this class' newArray or
+ * reserveArray methods: arrays obtained from new[] are NOT compatible with
+ * it.
+ *
+ * @param StoreCapacity  Whether to store the capacity in the header as well
+ */
+template <bool StoreCapacity = false>
+class Described : public Abi {
+  public:
+    /**
+     * Return the size of the pointed-to array
+     *
+     * @param T  Underlying type of the array
+     * @param p  Pointer to the array proper
+     * @return the size of the pointed-to array
+     */
+    template <typename T>
+    static std::size_t arraySize(T const *p) noexcept __attribute__((pure));
+
+    /**
+     * Return the number of elements the pointed-to array has room for
+     *
+     * @param T  Underlying type of the array
+     * @param p  Pointer to the array proper
+     * @return the capacity of the pointed-to array
+     */
+    template <typename T>
+    static std::size_t arrayCapacity(T const *p) noexcept __attribute__((pure));
+
+    /**
+     * Return a new array, including header, but do NOT call constructors
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the allocated array
+     * @return a pointer to the allocated array
+     * @throws std::bad_alloc  In case the underlying operation throws
+     */
+    template <typename T>
+    static T *newArray(std::size_t n);
+
+    /**
+     * Return a new array with room for the given number of elements, including header, but do NOT call constructors
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the allocated array
+     * @param capacity  Number of elements to allocate room for (at least n)
+     * @return a pointer to the allocated array
+     * @throws std::bad_alloc  In case the underlying operation throws
+     */
+    template <typename T>
+    static T *reserveArray(std::size_t n, std::size_t capacity);
+
+    /**
+     * Delete an array created by newArray<T> or reserveArray<T>, including header, but do NOT call destructors
+     *
+     * @param T  Underlying type of the array
+     * @param p  Pointer to the array proper
+     */
+    template <typename T>
+    static void delArray(T const *p) noexcept;
+
+    /**
+     * Return a new array allocated from the given resource, including header, but do NOT call constructors
+     *
+     * The resource must provide allocate(bytes, alignment) and
+     * deallocate(pointer, bytes, alignment) methods.
+     *
+     * @param T  Underlying type of the array
+     * @param Resource  Type of the memory resource to allocate from
+     * @param n  Number of elements in the allocated array
+     * @param resource  Memory resource to allocate from
+     * @return a pointer to the allocated array
+     * @throws std::bad_alloc  In case the underlying operation throws
+     */
+    template <typename T, typename Resource>
+    static T *newArray(std::size_t n, Resource &resource);
+
+    /**
+     * Return an array created by newArray<T, Resource> to the given resource, including header, but do NOT call destructors
+     *
+     * @param T  Underlying type of the array
+     * @param Resource  Type of the memory resource the array was allocated from
+     * @param p  Pointer to the array proper
+     * @param n  Number of elements in the array
+     * @param resource  Memory resource the array was allocated from
+     */
+    template <typename T, typename Resource>
+    static void delArray(T const *p, std::size_t n, Resource &resource) noexcept;
+
+    /**
+     * Return the number of bytes newArray<T, Resource> requests from a resource
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the array
+     * @return the size of the header and the array
+     */
+    template <typename T>
+    static constexpr std::size_t arrayBytes(std::size_t n) noexcept __attribute__((const));
+
+    /**
+     * Return the alignment of arrays of the given type
+     *
+     * @param T  Underlying type of the array
+     * @return the alignment needed for both the header and the elements
+     */
+    template <typename T>
+    static constexpr std::size_t arrayAlign() noexcept __attribute__((const));
+
+  protected:
+    /**
+     * Return the size of the header preceding arrays of the given type
+     *
+     * @param T  Underlying type of the array
+     * @return the size of the header
+     */
+    template <typename T>
+    static constexpr std::size_t headerLen() noexcept __attribute__((const));
+
+    /**
+     * Lay out the header of an array
+     *
+     * @param T  Underlying type of the array
+     * @param raw  Pointer to the underlying allocation
+     * @param n  Number of elements in the array
+     * @param capacity  Number of elements the array has room for
+     * @return a pointer to the array proper
+     */
+    template <typename T>
+    static T *layOut(void *raw, std::size_t n, std::size_t capacity) noexcept;
+};
+
+
+
+/**
+ * Static class to allocate arrays of known bound during constant evaluation
+ *
+ * Constant evaluation forbids reinterpreting storage, so that no ABI can
+ * lay out its cookie or header then: arrays of known bound are instead
+ * allocated by std::allocator (their length being known again when they are
+ * deleted), while arrays of unknown bound, whose length is read back from
+ * the ABI, cannot be used in constant expressions.
+ *
+ */
+class constant_array {
+  public:
+    /**
+     * Return a new array, but do NOT call constructors
+     *
+     * @param T  Underlying type of the array
+     * @param n  Number of elements in the allocated array
+     * @return a pointer to the allocated array
+     */
+    template <typename T>
+    static constexpr T *newArray(std::size_t n);
+
+    /**
+     * Delete an array created by newArray<T>, but do NOT call destructors
+     *
+     * @param T  Underlying type of the array
+     * @param p  Pointer to the array
+     * @param n  Number of elements in the array
+     */
+    template <typename T>
+    static constexpr void delArray(T const *p, std::size_t n) noexcept;
 };
 
 
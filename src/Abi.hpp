@@ -5,6 +5,9 @@
 #include "Abi.h"
 
 #include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
 
 
 /**
@@ -18,6 +21,17 @@ constexpr std::size_t Itanium::arrayCookieLen() noexcept {
   return __has_trivial_destructor(T) ? 0 : std::max(sizeof(std::size_t), alignof(T));
 }
 
+/**
+ * Return the alignment to request from a memory resource for an array
+ *
+ * @param T  Underlying type of the array
+ * @return the alignment needed for both the cookie and the elements
+ */
+template <typename T>
+constexpr std::size_t Itanium::arrayAlign() noexcept {
+  return alignof(T) < alignof(std::size_t) ? alignof(std::size_t) : alignof(T);
+}
+
 /**
  * Return the size of the pointed-to array
  *
@@ -64,5 +78,420 @@ void Itanium::delArray(T const *p) noexcept {
   delete[] (reinterpret_cast<char const *>(p) - arrayCookieLen<T>());
 }
 
+/**
+ * Return a new array allocated from the given resource, including cookie if needed, but do NOT call constructors
+ *
+ * The resource must provide allocate(bytes, alignment) and
+ * deallocate(pointer, bytes, alignment) methods.
+ *
+ * @param T  Underlying type of the array
+ * @param Resource  Type of the memory resource to allocate from
+ * @param n  Number of elements in the allocated array
+ * @param resource  Memory resource to allocate from
+ * @return a pointer to the allocated array
+ * @throws std::bad_alloc  In case the underlying operation throws
+ */
+template <typename T, typename Resource>
+T *Itanium::newArray(std::size_t n, Resource &resource) {
+  std::size_t padding = arrayCookieLen<T>();
+  T *ret = reinterpret_cast<T *>(static_cast<char *>(resource.allocate(arrayBytes<T>(n), arrayAlign<T>())) + padding);
+
+  if (padding) {
+    reinterpret_cast<std::size_t *>(ret)[-1] = n;
+  }
+
+  return ret;
+}
+
+/**
+ * Return an array created by newArray<T, Resource> to the given resource, including cookie if needed, but do NOT call destructors
+ *
+ * @param T  Underlying type of the array
+ * @param Resource  Type of the memory resource the array was allocated from
+ * @param p  Pointer to the array proper
+ * @param n  Number of elements in the array
+ * @param resource  Memory resource the array was allocated from
+ */
+template <typename T, typename Resource>
+void Itanium::delArray(T const *p, std::size_t n, Resource &resource) noexcept {
+  resource.deallocate(const_cast<char *>(reinterpret_cast<char const *>(p) - arrayCookieLen<T>()), arrayBytes<T>(n), arrayAlign<T>());
+}
+
+/**
+ * Return the number of bytes newArray<T, Resource> requests from a resource
+ *
+ * @param T  Underlying type of the array
+ * @param n  Number of elements in the array
+ * @return the size of the array plus its cookie, if needed
+ */
+template <typename T>
+constexpr std::size_t Itanium::arrayBytes(std::size_t n) noexcept {
+  return n * sizeof(T) + arrayCookieLen<T>();
+}
+
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+constexpr std::size_t Aligned<Alignment, TailPadding, CacheLinePadding>::cache_line;
+
+/**
+ * Return the size of the pointed-to array
+ *
+ * @param T  Underlying type of the array
+ * @param p  Pointer to the array proper
+ * @return the size of the pointed-to array
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T>
+std::size_t Aligned<Alignment, TailPadding, CacheLinePadding>::arraySize(T const *p) noexcept {
+  return reinterpret_cast<std::size_t const *>(p)[-1];
+}
+
+/**
+ * Return a new array, including header and padding, but do NOT call constructors
+ *
+ * The global allocation function only guarantees fundamental alignment, the
+ * allocation is thus oversized by the array's alignment and the array placed
+ * at the first suitable address.
+ *
+ * @param T  Underlying type of the array
+ * @param n  Number of elements in the allocated array
+ * @return a pointer to the allocated array
+ * @throws std::bad_alloc  In case the underlying operation throws
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T>
+T *Aligned<Alignment, TailPadding, CacheLinePadding>::newArray(std::size_t n) {
+  char *raw = static_cast<char *>(::operator new(headerLen<T>() + payloadLen<T>(n) + arrayAlign<T>() - 1));
+  std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw + headerLen<T>());
+
+  return layOut<T>(raw, raw + (roundUp(start, arrayAlign<T>()) - reinterpret_cast<std::uintptr_t>(raw)), n);
+}
+
+/**
+ * Delete an array created by newArray<T>, including header and padding, but do NOT call destructors
+ *
+ * @param T  Underlying type of the array
+ * @param p  Pointer to the array proper
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T>
+void Aligned<Alignment, TailPadding, CacheLinePadding>::delArray(T const *p) noexcept {
+  char const *ret = reinterpret_cast<char const *>(p);
+  ::operator delete(const_cast<char *>(ret - reinterpret_cast<std::size_t const *>(p)[-2]));
+}
+
+/**
+ * Return a new array allocated from the given resource, including header and padding, but do NOT call constructors
+ *
+ * The resource must provide allocate(bytes, alignment) and
+ * deallocate(pointer, bytes, alignment) methods, and honour the requested
+ * alignment.
+ *
+ * @param T  Underlying type of the array
+ * @param Resource  Type of the memory resource to allocate from
+ * @param n  Number of elements in the allocated array
+ * @param resource  Memory resource to allocate from
+ * @return a pointer to the allocated array
+ * @throws std::bad_alloc  In case the underlying operation throws
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T, typename Resource>
+T *Aligned<Alignment, TailPadding, CacheLinePadding>::newArray(std::size_t n, Resource &resource) {
+  char *raw = static_cast<char *>(resource.allocate(arrayBytes<T>(n), arrayAlign<T>()));
+
+  return layOut<T>(raw, raw + headerLen<T>(), n);
+}
+
+/**
+ * Return an array created by newArray<T, Resource> to the given resource, including header and padding, but do NOT call destructors
+ *
+ * @param T  Underlying type of the array
+ * @param Resource  Type of the memory resource the array was allocated from
+ * @param p  Pointer to the array proper
+ * @param n  Number of elements in the array
+ * @param resource  Memory resource the array was allocated from
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T, typename Resource>
+void Aligned<Alignment, TailPadding, CacheLinePadding>::delArray(T const *p, std::size_t n, Resource &resource) noexcept {
+  resource.deallocate(const_cast<char *>(reinterpret_cast<char const *>(p) - headerLen<T>()), arrayBytes<T>(n), arrayAlign<T>());
+}
+
+/**
+ * Return the number of bytes newArray<T, Resource> requests from a resource
+ *
+ * @param T  Underlying type of the array
+ * @param n  Number of elements in the array
+ * @return the size of the header, the array and its padding
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T>
+constexpr std::size_t Aligned<Alignment, TailPadding, CacheLinePadding>::arrayBytes(std::size_t n) noexcept {
+  return headerLen<T>() + payloadLen<T>(n);
+}
+
+/**
+ * Return the alignment of arrays of the given type
+ *
+ * @param T  Underlying type of the array
+ * @return the alignment of arrays of the given type
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T>
+constexpr std::size_t Aligned<Alignment, TailPadding, CacheLinePadding>::arrayAlign() noexcept {
+  return std::max(std::max(Alignment, alignof(T)), std::max(alignof(std::size_t), CacheLinePadding ? cache_line : std::size_t(1)));
+}
+
+/**
+ * Round the given size up to a multiple of the given power of two
+ *
+ * @param n  Size to round up
+ * @param m  Power of two to round up to
+ * @return n rounded up to a multiple of m
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+constexpr std::size_t Aligned<Alignment, TailPadding, CacheLinePadding>::roundUp(std::size_t n, std::size_t m) noexcept {
+  return (n + m - 1) & ~(m - 1);
+}
+
+/**
+ * Return the size of the header preceding arrays of the given type
+ *
+ * The header holds the offset to the start of the allocation and the
+ * element count, and is rounded up so as to keep the array aligned.
+ *
+ * @param T  Underlying type of the array
+ * @return the size of the header
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T>
+constexpr std::size_t Aligned<Alignment, TailPadding, CacheLinePadding>::headerLen() noexcept {
+  return roundUp(2 * sizeof(std::size_t), arrayAlign<T>());
+}
+
+/**
+ * Return the size of the array proper plus its padding
+ *
+ * @param T  Underlying type of the array
+ * @param n  Number of elements in the array
+ * @return the size of the array plus its padding
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T>
+constexpr std::size_t Aligned<Alignment, TailPadding, CacheLinePadding>::payloadLen(std::size_t n) noexcept {
+  return CacheLinePadding ? roundUp(n * sizeof(T) + TailPadding, cache_line) : n * sizeof(T) + TailPadding;
+}
+
+/**
+ * Lay out the header and zero the tail padding of an array
+ *
+ * @param T  Underlying type of the array
+ * @param raw  Pointer to the underlying allocation
+ * @param ret  Pointer to the array proper
+ * @param n  Number of elements in the array
+ * @return ret
+ */
+template <std::size_t Alignment, std::size_t TailPadding, bool CacheLinePadding>
+template <typename T>
+T *Aligned<Alignment, TailPadding, CacheLinePadding>::layOut(void *raw, char *ret, std::size_t n) noexcept {
+  reinterpret_cast<std::size_t *>(ret)[-2] = static_cast<std::size_t>(ret - static_cast<char *>(raw));
+  reinterpret_cast<std::size_t *>(ret)[-1] = n;
+  std::memset(ret + n * sizeof(T), 0, payloadLen<T>(n) - n * sizeof(T));
+
+  return reinterpret_cast<T *>(ret);
+}
+
+
+/**
+ * Return the size of the pointed-to array
+ *
+ * @param T  Underlying type of the array
+ * @param p  Pointer to the array proper
+ * @return the size of the pointed-to array
+ */
+template <bool StoreCapacity>
+template <typename T>
+std::size_t Described<StoreCapacity>::arraySize(T const *p) noexcept {
+  return reinterpret_cast<std::size_t const *>(p)[-1];
+}
+
+/**
+ * Return the number of elements the pointed-to array has room for
+ *
+ * Without a stored capacity, this is the array size itself.
+ *
+ * @param T  Underlying type of the array
+ * @param p  Pointer to the array proper
+ * @return the capacity of the pointed-to array
+ */
+template <bool StoreCapacity>
+template <typename T>
+std::size_t Described<StoreCapacity>::arrayCapacity(T const *p) noexcept {
+  return reinterpret_cast<std::size_t const *>(p)[StoreCapacity ? -2 : -1];
+}
+
+/**
+ * Return a new array, including header, but do NOT call constructors
+ *
+ * @param T  Underlying type of the array
+ * @param n  Number of elements in the allocated array
+ * @return a pointer to the allocated array
+ * @throws std::bad_alloc  In case the underlying operation throws
+ */
+template <bool StoreCapacity>
+template <typename T>
+T *Described<StoreCapacity>::newArray(std::size_t n) {
+  return reserveArray<T>(n, n);
+}
+
+/**
+ * Return a new array with room for the given number of elements, including header, but do NOT call constructors
+ *
+ * Without a stored capacity, the extra room is allocated but not recorded.
+ *
+ * @param T  Underlying type of the array
+ * @param n  Number of elements in the allocated array
+ * @param capacity  Number of elements to allocate room for (at least n)
+ * @return a pointer to the allocated array
+ * @throws std::bad_alloc  In case the underlying operation throws
+ */
+template <bool StoreCapacity>
+template <typename T>
+T *Described<StoreCapacity>::reserveArray(std::size_t n, std::size_t capacity) {
+  capacity = std::max(n, capacity);
+  return layOut<T>(::operator new(headerLen<T>() + capacity * sizeof(T)), n, capacity);
+}
+
+/**
+ * Delete an array created by newArray<T> or reserveArray<T>, including header, but do NOT call destructors
+ *
+ * @param T  Underlying type of the array
+ * @param p  Pointer to the array proper
+ */
+template <bool StoreCapacity>
+template <typename T>
+void Described<StoreCapacity>::delArray(T const *p) noexcept {
+  ::operator delete(const_cast<char *>(reinterpret_cast<char const *>(p) - headerLen<T>()));
+}
+
+/**
+ * Return a new array allocated from the given resource, including header, but do NOT call constructors
+ *
+ * The resource must provide allocate(bytes, alignment) and
+ * deallocate(pointer, bytes, alignment) methods.
+ *
+ * @param T  Underlying type of the array
+ * @param Resource  Type of the memory resource to allocate from
+ * @param n  Number of elements in the allocated array
+ * @param resource  Memory resource to allocate from
+ * @return a pointer to the allocated array
+ * @throws std::bad_alloc  In case the underlying operation throws
+ */
+template <bool StoreCapacity>
+template <typename T, typename Resource>
+T *Described<StoreCapacity>::newArray(std::size_t n, Resource &resource) {
+  return layOut<T>(resource.allocate(arrayBytes<T>(n), arrayAlign<T>()), n, n);
+}
+
+/**
+ * Return an array created by newArray<T, Resource> to the given resource, including header, but do NOT call destructors
+ *
+ * @param T  Underlying type of the array
+ * @param Resource  Type of the memory resource the array was allocated from
+ * @param p  Pointer to the array proper
+ * @param n  Number of elements in the array
+ * @param resource  Memory resource the array was allocated from
+ */
+template <bool StoreCapacity>
+template <typename T, typename Resource>
+void Described<StoreCapacity>::delArray(T const *p, std::size_t n, Resource &resource) noexcept {
+  resource.deallocate(const_cast<char *>(reinterpret_cast<char const *>(p) - headerLen<T>()), arrayBytes<T>(n), arrayAlign<T>());
+}
+
+/**
+ * Return the number of bytes newArray<T, Resource> requests from a resource
+ *
+ * @param T  Underlying type of the array
+ * @param n  Number of elements in the array
+ * @return the size of the header and the array
+ */
+template <bool StoreCapacity>
+template <typename T>
+constexpr std::size_t Described<StoreCapacity>::arrayBytes(std::size_t n) noexcept {
+  return headerLen<T>() + n * sizeof(T);
+}
+
+/**
+ * Return the alignment of arrays of the given type
+ *
+ * @param T  Underlying type of the array
+ * @return the alignment needed for both the header and the elements
+ */
+template <bool StoreCapacity>
+template <typename T>
+constexpr std::size_t Described<StoreCapacity>::arrayAlign() noexcept {
+  static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types need the Aligned ABI");
+  return std::max(alignof(T), alignof(std::size_t));
+}
+
+/**
+ * Return the size of the header preceding arrays of the given type
+ *
+ * The header holds the element count (preceded by the capacity, if stored),
+ * and is rounded up so as to keep the array aligned.
+ *
+ * @param T  Underlying type of the array
+ * @return the size of the header
+ */
+template <bool StoreCapacity>
+template <typename T>
+constexpr std::size_t Described<StoreCapacity>::headerLen() noexcept {
+  return ((StoreCapacity ? 2 : 1) * sizeof(std::size_t) + arrayAlign<T>() - 1) / arrayAlign<T>() * arrayAlign<T>();
+}
+
+/**
+ * Lay out the header of an array
+ *
+ * @param T  Underlying type of the array
+ * @param raw  Pointer to the underlying allocation
+ * @param n  Number of elements in the array
+ * @param capacity  Number of elements the array has room for
+ * @return a pointer to the array proper
+ */
+template <bool StoreCapacity>
+template <typename T>
+T *Described<StoreCapacity>::layOut(void *raw, std::size_t n, std::size_t capacity) noexcept {
+  std::size_t *ret = reinterpret_cast<std::size_t *>(static_cast<char *>(raw) + headerLen<T>());
+  if (StoreCapacity) {
+    ret[-2] = capacity;
+  }
+  ret[-1] = n;
+
+  return reinterpret_cast<T *>(ret);
+}
+
+/**
+ * Return a new array, but do NOT call constructors
+ *
+ * @param T  Underlying type of the array
+ * @param n  Number of elements in the allocated array
+ * @return a pointer to the allocated array
+ */
+template <typename T>
+constexpr T *constant_array::newArray(std::size_t n) {
+  return std::allocator<T>().allocate(n);
+}
+
+/**
+ * Delete an array created by newArray<T>, but do NOT call destructors
+ *
+ * @param T  Underlying type of the array
+ * @param p  Pointer to the array
+ * @param n  Number of elements in the array
+ */
+template <typename T>
+constexpr void constant_array::delArray(T const *p, std::size_t n) noexcept {
+  std::allocator<T>().deallocate(const_cast<T *>(p), n);
+}
+
 #endif /* VALUE_PTR__ABI_HPP__ */
 
@@ -0,0 +1,481 @@
+#ifndef VALUE_PTR__ARENA_H__
+#define VALUE_PTR__ARENA_H__
+
+
+#include <type_traits>
+#include <cstddef>
+#include <atomic>
+
+#include "value_ptr.h"
+#include "ResourceHandler.h"
+
+
+/**
+ * Reference-counted bump allocator over a single block, holding the copies made by clone_range
+ *
+ * The block is allocated along with the arena itself, and is sized up
+ * front; allocations are never returned individually, the whole block being
+ * released along with the last reference to the arena (each object placed
+ * in it holding one, and its creator another). Allocation is not thread
+ * safe, but references may be dropped from any thread.
+ *
+ */
+class clone_arena {
+  public:
+    /**
+     * Number of sources clone_range prefetches ahead of the one being copied
+     *
+     */
+    static constexpr std::size_t prefetch_distance = 8;
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    clone_arena(clone_arena const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    clone_arena &operator=(clone_arena const &) = delete;
+
+    /**
+     * Create an arena of the given capacity, holding a single reference for the caller
+     *
+     * @param bytes  Number of bytes the arena is to hold
+     * @return the new arena
+     * @throws std::bad_alloc  In case the block cannot be allocated
+     */
+    static clone_arena *create(std::size_t bytes);
+
+    /**
+     * Return the number of bytes an allocation takes up in an arena, padding included
+     *
+     * @param bytes  Number of bytes to allocate
+     * @param alignment  Alignment of the allocation
+     * @return the number of bytes the allocation takes up, at most
+     */
+    static constexpr std::size_t footprint(std::size_t bytes, std::size_t alignment) noexcept __attribute__((const));
+
+    /**
+     * Allocate storage from the block
+     *
+     * @param bytes  Number of bytes to allocate
+     * @param alignment  Alignment of the allocation (a power of two)
+     * @return a pointer to the allocated storage
+     * @throws std::bad_alloc  In case the block is exhausted
+     */
+    void *allocate(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * Return storage to the block (a no-op, the block being released as a whole)
+     *
+     * @param <unnamed>  Pointer to the storage
+     * @param <unnamed>  Number of bytes allocated
+     * @param <unnamed>  Alignment of the allocation
+     */
+    void deallocate(void *, std::size_t, std::size_t) noexcept;
+
+    /**
+     * Add a reference to the arena
+     *
+     */
+    void retain() noexcept;
+
+    /**
+     * Drop a reference to the arena, releasing it if it was the last one
+     *
+     */
+    void release() noexcept;
+
+    /**
+     * Return the number of bytes the block holds
+     *
+     * @return the capacity of the block
+     */
+    std::size_t capacity() const noexcept __attribute__((pure));
+
+    /**
+     * Return the number of bytes allocated from the block so far, padding included
+     *
+     * @return the number of bytes used
+     */
+    std::size_t used() const noexcept __attribute__((pure));
+
+  protected:
+    /**
+     * Constructor
+     *
+     * @param bytes  Number of bytes the block following the arena holds
+     */
+    explicit clone_arena(std::size_t bytes) noexcept;
+
+    /**
+     * Destructor
+     *
+     */
+    ~clone_arena() noexcept = default;
+
+    /**
+     * Round the given size up to a multiple of the given power of two
+     *
+     * @param n  Size to round up
+     * @param m  Power of two to round up to
+     * @return n rounded up to a multiple of m
+     */
+    static constexpr std::size_t roundUp(std::size_t n, std::size_t m) noexcept __attribute__((const));
+
+    /**
+     * Return the offset of the block from the start of the arena
+     *
+     * @return the offset of the block
+     */
+    static constexpr std::size_t headerLen() noexcept __attribute__((const));
+
+    /**
+     * Return the start of the block
+     *
+     * @return a pointer to the start of the block
+     */
+    unsigned char *data() noexcept __attribute__((const));
+
+    /**
+     * Number of references held
+     *
+     */
+    std::atomic<std::size_t> refs;
+
+    /**
+     * Number of bytes the block holds
+     *
+     */
+    std::size_t size;
+
+    /**
+     * Offset of the next allocation within the block
+     *
+     */
+    std::size_t next;
+};
+
+
+/**
+ * Handler for value_ptrs whose pointee may live in a clone_arena
+ *
+ * Pointees placed in an arena by clone_range are destroyed in place, each
+ * dropping its reference to the arena (the last one releasing the block);
+ * replicas and adopted pointers live on the heap and are handled by
+ * default_handler. Copies of the handler do not share the arena, since they
+ * are meant for replicas.
+ *
+ * @param T  Underlying type this class handles
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ */
+template <typename T, typename ABI = Itanium>
+struct arena_handler : public default_handler<T, ABI> {
+  using default_handler<T, ABI>::slice_safe;
+
+  /**
+   * Pointee type, the element type for arrays
+   *
+   */
+  using element_type = typename std::remove_extent<T>::type;
+
+  /**
+   * Whether objects of the underlying type can be copied into an arena at all
+   *
+   * Cloneable types (and arrays thereof) must be placement cloneable for
+   * this to be the case, other types copy constructible.
+   *
+   */
+  static constexpr bool placeable = 0 == std::rank<T>::value ? (is_cloneable<T>::value ? is_placement_cloneable<T>::value : std::is_copy_constructible<T>::value) : resource_array<element_type, clone_arena, ABI>::placeable;
+
+  /**
+   * Default constructor
+   *
+   */
+  arena_handler() noexcept;
+
+  /**
+   * Constructor for pointees placed in the given arena
+   *
+   * The handler takes over a reference to the arena, to be dropped upon the
+   * pointee's destruction.
+   *
+   * @param arena  Arena holding the pointee
+   */
+  explicit arena_handler(clone_arena *arena) noexcept;
+
+  /**
+   * Copy constructor
+   *
+   * Does not share the given handler's arena.
+   *
+   * @param <unnamed>  Handler to copy
+   */
+  arena_handler(arena_handler const &) noexcept;
+
+  /**
+   * Move constructor
+   *
+   * Takes over the given handler's reference to its arena.
+   *
+   * @param other  Handler to move
+   */
+  arena_handler(arena_handler &&other) noexcept;
+
+  /**
+   * Copy-assignment operator
+   *
+   * Handlers carry no state but for the arena holding their own pointee,
+   * which is kept.
+   *
+   * @param <unnamed>  Handler to copy-assign
+   * @return the assigned handler
+   */
+  arena_handler &operator=(arena_handler const &) noexcept;
+
+  /**
+   * Move-assignment operator
+   *
+   * Takes over the given handler's reference to its arena, this handler must
+   * not hold one.
+   *
+   * @param other  Handler to move-assign
+   * @return the assigned handler
+   */
+  arena_handler &operator=(arena_handler &&other) noexcept;
+
+  /**
+   * Destroyer implementation
+   *
+   * This method destroys a pointee placed in an arena in place and drops
+   * its reference to the arena, and delegates to default_handler otherwise.
+   *
+   * @param p  Pointer to the object to destroy
+   */
+  void destroy(element_type const *p);
+
+  /**
+   * In-place assignment implementation
+   *
+   * Pointees placed in an arena are never assigned in place.
+   *
+   * @param p  Pointer to the object to assign to
+   * @param q  Pointer to the object to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(element_type *p, element_type const *q);
+
+  /**
+   * Release implementation
+   *
+   * This method replicates a pointee placed in an arena onto the heap (and
+   * destroys the original), pointers to heap objects are simply handed back.
+   *
+   * @param p  Pointer to the object to release
+   * @return a pointer the caller may take ownership of
+   */
+  element_type *release(element_type *p);
+
+  /**
+   * Return the arena holding the pointee, if any
+   *
+   * @return the arena holding the pointee, or nullptr if it lives on the heap
+   */
+  clone_arena *arena() const noexcept __attribute__((pure));
+
+  /**
+   * Return the number of bytes a copy of the given object takes up in an arena
+   *
+   * @param p  Pointer to the object to copy
+   * @return the number of bytes a copy takes up, or 0 if it cannot be placed in an arena
+   */
+  static std::size_t footprint(element_type const *p) noexcept;
+
+  /**
+   * Copy the given object into the given arena
+   *
+   * The object's footprint must not be 0, the copy holds no reference to
+   * the arena.
+   *
+   * @param p  Pointer to the object to copy
+   * @param arena  Arena to copy into
+   * @return a pointer to the copy
+   */
+  static element_type *place(element_type const *p, clone_arena &arena);
+
+  protected:
+    /**
+     * Return the number of bytes a copy of the given object takes up in an arena
+     *
+     * The object can only be placed if its dynamic type is known, ie. if it
+     * coincides with T.
+     *
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating whether T is an array type
+     * @return the number of bytes a copy takes up, or 0 if it cannot be placed in an arena
+     */
+    static std::size_t measure(element_type const *p, std::false_type) noexcept;
+
+    /**
+     * Return the number of bytes a copy of the given array takes up in an arena
+     *
+     * @param p  Pointer to the array to copy
+     * @param <unnamed>  Tag indicating whether T is an array type
+     * @return the number of bytes a copy takes up
+     */
+    static std::size_t measure(element_type const *p, std::true_type) noexcept;
+
+    /**
+     * Copy the given object into the given arena, T being placeable
+     *
+     * @param p  Pointer to the object to copy
+     * @param arena  Arena to copy into
+     * @param <unnamed>  Tag indicating placeability
+     * @return a pointer to the copy
+     */
+    static element_type *placeIf(element_type const *p, clone_arena &arena, std::true_type);
+
+    /**
+     * Refuse to copy the given object into the given arena, T not being placeable
+     *
+     * @param <unnamed>  Pointer to the object to copy
+     * @param <unnamed>  Arena to copy into
+     * @param <unnamed>  Tag indicating placeability
+     * @return nullptr, always
+     */
+    static constexpr element_type *placeIf(element_type const *, clone_arena &, std::false_type) noexcept __attribute__((const));
+
+    /**
+     * Copy the given object into the given arena
+     *
+     * @param p  Pointer to the object to copy
+     * @param arena  Arena to copy into
+     * @param <unnamed>  Tag indicating whether T is an array type
+     * @return a pointer to the copy
+     */
+    static element_type *placeAs(element_type const *p, clone_arena &arena, std::false_type);
+
+    /**
+     * Copy the given array into the given arena
+     *
+     * @param p  Pointer to the array to copy
+     * @param arena  Arena to copy into
+     * @param <unnamed>  Tag indicating whether T is an array type
+     * @return a pointer to the copy
+     */
+    static element_type *placeAs(element_type const *p, clone_arena &arena, std::true_type);
+
+    /**
+     * Copy the given object into the given storage using its copy constructor
+     *
+     * @param raw  Storage to copy into
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     * @return a pointer to the copy
+     */
+    static element_type *copyInto(void *raw, element_type const *p, std::false_type);
+
+    /**
+     * Copy the given object into the given storage using its placement clone method
+     *
+     * @param raw  Storage to copy into
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     * @return a pointer to the copy
+     */
+    static element_type *copyInto(void *raw, element_type const *p, std::true_type);
+
+    /**
+     * Destroy the given object in place
+     *
+     * @param p  Pointer to the object to destroy
+     * @param arena  Arena holding the object
+     * @param <unnamed>  Tag indicating whether T is an array type
+     */
+    static void destroyIn(element_type const *p, clone_arena &arena, std::false_type);
+
+    /**
+     * Destroy the given array in place
+     *
+     * @param p  Pointer to the array to destroy
+     * @param arena  Arena holding the array
+     * @param <unnamed>  Tag indicating whether T is an array type
+     */
+    static void destroyIn(element_type const *p, clone_arena &arena, std::true_type);
+
+    /**
+     * Return the number of elements in the given array of unknown bound
+     *
+     * @param p  Pointer to the array
+     * @param <unnamed>  Tag indicating whether T is an array of unknown bound
+     * @return the number of elements in the array
+     */
+    static std::size_t length(element_type const *p, std::true_type) noexcept __attribute__((pure));
+
+    /**
+     * Return the number of elements in the given array of known bound
+     *
+     * @param <unnamed>  Pointer to the array
+     * @param <unnamed>  Tag indicating whether T is an array of unknown bound
+     * @return the number of elements in the array
+     */
+    static constexpr std::size_t length(element_type const *, std::false_type) noexcept __attribute__((const));
+
+    /**
+     * Arena holding the pointee, nullptr if it lives on the heap
+     *
+     */
+    clone_arena *a;
+};
+
+
+/**
+ * Metaprogramming class extracting the underlying type of a value_ptr
+ *
+ * @param V  value_ptr type
+ */
+template <typename V>
+struct value_ptr_underlying;
+
+/**
+ * Specialization of value_ptr_underlying for value_ptrs
+ *
+ * @param T  Underlying type of the value_ptr
+ * @param H  Handler type of the value_ptr
+ */
+template <typename T, typename H>
+struct value_ptr_underlying<value_ptr<T, H>> {
+  using type = T;
+};
+
+
+/**
+ * Deep-copy a range of value_ptrs into a single arena block
+ *
+ * Every pointee whose size can be told (ie. whose dynamic type is known, and
+ * array lengths, through the ABI) is sized up front, a single arena holding
+ * them all is allocated, and each is copied into it, upcoming sources being
+ * prefetched; copies are handed out as value_ptrs using an arena_handler,
+ * and the arena is released along with the last of them. Pointees whose
+ * size cannot be told are replicated onto the heap by default_handler.
+ *
+ * Should a copy throw, the copies already handed out are left in place,
+ * and the exception is rethrown.
+ *
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ * @param It  Forward iterator over value_ptrs
+ * @param Out  Output iterator accepting value_ptr<T, arena_handler<T, ABI>>
+ * @param first  Start of the range to copy
+ * @param last  End of the range to copy
+ * @param out  Iterator to write the copies to
+ * @return the output iterator past the last copy written
+ */
+template <typename ABI = Itanium, typename It, typename Out> Out clone_range(It first, It last, Out out);
+
+
+#include "Arena.hpp"
+
+#endif /* VALUE_PTR__ARENA_H__ */
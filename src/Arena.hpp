@@ -0,0 +1,530 @@
+#ifndef VALUE_PTR__ARENA_HPP__
+#define VALUE_PTR__ARENA_HPP__
+
+
+#include "Arena.h"
+
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <typeinfo>
+#include <utility>
+
+
+/**
+ * Create an arena of the given capacity, holding a single reference for the caller
+ *
+ * @param bytes  Number of bytes the arena is to hold
+ * @return the new arena
+ * @throws std::bad_alloc  In case the block cannot be allocated
+ */
+inline clone_arena *clone_arena::create(std::size_t bytes) {
+  if (bytes > static_cast<std::size_t>(-1) - headerLen()) {
+    throw std::bad_array_new_length();
+  }
+  return new(::operator new(headerLen() + bytes)) clone_arena(bytes);
+}
+
+/**
+ * Return the number of bytes an allocation takes up in an arena, padding included
+ *
+ * Allocations start at multiples of alignof(std::max_align_t) from the
+ * start of the block, so that more strictly aligned ones may need padding.
+ *
+ * @param bytes  Number of bytes to allocate
+ * @param alignment  Alignment of the allocation
+ * @return the number of bytes the allocation takes up, at most
+ */
+inline constexpr std::size_t clone_arena::footprint(std::size_t bytes, std::size_t alignment) noexcept {
+  return roundUp(bytes, alignof(std::max_align_t)) + (alignment > alignof(std::max_align_t) ? alignment - alignof(std::max_align_t) : 0);
+}
+
+/**
+ * Allocate storage from the block
+ *
+ * @param bytes  Number of bytes to allocate
+ * @param alignment  Alignment of the allocation (a power of two)
+ * @return a pointer to the allocated storage
+ * @throws std::bad_alloc  In case the block is exhausted
+ */
+inline void *clone_arena::allocate(std::size_t bytes, std::size_t alignment) {
+  std::uintptr_t base = reinterpret_cast<std::uintptr_t>(data());
+  std::size_t at = roundUp(base + next, alignment) - base;
+  if (at > size || bytes > size - at) {
+    throw std::bad_alloc();
+  }
+  next = roundUp(at + bytes, alignof(std::max_align_t));
+
+  return data() + at;
+}
+
+/**
+ * Return storage to the block (a no-op, the block being released as a whole)
+ *
+ * @param <unnamed>  Pointer to the storage
+ * @param <unnamed>  Number of bytes allocated
+ * @param <unnamed>  Alignment of the allocation
+ */
+inline void clone_arena::deallocate(void *, std::size_t, std::size_t) noexcept {}
+
+/**
+ * Add a reference to the arena
+ *
+ */
+inline void clone_arena::retain() noexcept {
+  refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Drop a reference to the arena, releasing it if it was the last one
+ *
+ */
+inline void clone_arena::release() noexcept {
+  if (1 == refs.fetch_sub(1, std::memory_order_acq_rel)) {
+    this->~clone_arena();
+    ::operator delete(static_cast<void *>(this));
+  }
+}
+
+/**
+ * Return the number of bytes the block holds
+ *
+ * @return the capacity of the block
+ */
+inline std::size_t clone_arena::capacity() const noexcept {
+  return size;
+}
+
+/**
+ * Return the number of bytes allocated from the block so far, padding included
+ *
+ * @return the number of bytes used
+ */
+inline std::size_t clone_arena::used() const noexcept {
+  return next;
+}
+
+/**
+ * Constructor
+ *
+ * @param bytes  Number of bytes the block following the arena holds
+ */
+inline clone_arena::clone_arena(std::size_t bytes) noexcept : refs(1), size(bytes), next(0) {}
+
+/**
+ * Round the given size up to a multiple of the given power of two
+ *
+ * @param n  Size to round up
+ * @param m  Power of two to round up to
+ * @return n rounded up to a multiple of m
+ */
+inline constexpr std::size_t clone_arena::roundUp(std::size_t n, std::size_t m) noexcept {
+  return (n + m - 1) & ~(m - 1);
+}
+
+/**
+ * Return the offset of the block from the start of the arena
+ *
+ * @return the offset of the block
+ */
+inline constexpr std::size_t clone_arena::headerLen() noexcept {
+  return roundUp(sizeof(clone_arena), alignof(std::max_align_t));
+}
+
+/**
+ * Return the start of the block
+ *
+ * @return a pointer to the start of the block
+ */
+inline unsigned char *clone_arena::data() noexcept {
+  return reinterpret_cast<unsigned char *>(this) + headerLen();
+}
+
+
+/**
+ * Default constructor
+ *
+ */
+template <typename T, typename ABI>
+arena_handler<T, ABI>::arena_handler() noexcept : default_handler<T, ABI>(), a(nullptr) {}
+
+/**
+ * Constructor for pointees placed in the given arena
+ *
+ * The handler takes over a reference to the arena, to be dropped upon the
+ * pointee's destruction.
+ *
+ * @param arena  Arena holding the pointee
+ */
+template <typename T, typename ABI>
+arena_handler<T, ABI>::arena_handler(clone_arena *arena) noexcept : default_handler<T, ABI>(), a(arena) {}
+
+/**
+ * Copy constructor
+ *
+ * Does not share the given handler's arena.
+ *
+ * @param <unnamed>  Handler to copy
+ */
+template <typename T, typename ABI>
+arena_handler<T, ABI>::arena_handler(arena_handler<T, ABI> const &) noexcept : default_handler<T, ABI>(), a(nullptr) {}
+
+/**
+ * Move constructor
+ *
+ * Takes over the given handler's reference to its arena.
+ *
+ * @param other  Handler to move
+ */
+template <typename T, typename ABI>
+arena_handler<T, ABI>::arena_handler(arena_handler<T, ABI> &&other) noexcept : default_handler<T, ABI>(), a(other.a) { other.a = nullptr; }
+
+/**
+ * Copy-assignment operator
+ *
+ * Handlers carry no state but for the arena holding their own pointee,
+ * which is kept.
+ *
+ * @param <unnamed>  Handler to copy-assign
+ * @return the assigned handler
+ */
+template <typename T, typename ABI>
+arena_handler<T, ABI> &arena_handler<T, ABI>::operator=(arena_handler<T, ABI> const &) noexcept {
+  return *this;
+}
+
+/**
+ * Move-assignment operator
+ *
+ * Takes over the given handler's reference to its arena, this handler must
+ * not hold one.
+ *
+ * @param other  Handler to move-assign
+ * @return the assigned handler
+ */
+template <typename T, typename ABI>
+arena_handler<T, ABI> &arena_handler<T, ABI>::operator=(arena_handler<T, ABI> &&other) noexcept {
+  if (this != &other) {
+    a = other.a;
+    other.a = nullptr;
+  }
+  return *this;
+}
+
+/**
+ * Destroyer implementation
+ *
+ * This method destroys a pointee placed in an arena in place and drops
+ * its reference to the arena (even if its destructor throws), and delegates
+ * to default_handler otherwise.
+ *
+ * @param p  Pointer to the object to destroy
+ */
+template <typename T, typename ABI>
+void arena_handler<T, ABI>::destroy(typename arena_handler<T, ABI>::element_type const *p) {
+  if (nullptr == p || nullptr == a) {
+    default_handler<T, ABI>::destroy(p);
+    return;
+  }
+
+  clone_arena *arena = a;
+  a = nullptr;
+  try {
+    destroyIn(p, *arena, typename condition<0 != std::rank<T>::value>::type());
+  } catch (...) {
+    arena->release();
+    throw;
+  }
+  arena->release();
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * Pointees placed in an arena are never assigned in place.
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename ABI>
+bool arena_handler<T, ABI>::assign(typename arena_handler<T, ABI>::element_type *p, typename arena_handler<T, ABI>::element_type const *q) {
+  return nullptr == a && default_handler<T, ABI>::assign(p, q);
+}
+
+/**
+ * Release implementation
+ *
+ * This method replicates a pointee placed in an arena onto the heap (and
+ * destroys the original), pointers to heap objects are simply handed back.
+ *
+ * @param p  Pointer to the object to release
+ * @return a pointer the caller may take ownership of
+ */
+template <typename T, typename ABI>
+typename arena_handler<T, ABI>::element_type *arena_handler<T, ABI>::release(typename arena_handler<T, ABI>::element_type *p) {
+  if (nullptr == p || nullptr == a) {
+    return p;
+  }
+
+  element_type *ret = default_handler<T, ABI>::replicate(p);
+  destroy(p);
+
+  return ret;
+}
+
+/**
+ * Return the arena holding the pointee, if any
+ *
+ * @return the arena holding the pointee, or nullptr if it lives on the heap
+ */
+template <typename T, typename ABI>
+clone_arena *arena_handler<T, ABI>::arena() const noexcept {
+  return a;
+}
+
+/**
+ * Return the number of bytes a copy of the given object takes up in an arena
+ *
+ * @param p  Pointer to the object to copy
+ * @return the number of bytes a copy takes up, or 0 if it cannot be placed in an arena
+ */
+template <typename T, typename ABI>
+std::size_t arena_handler<T, ABI>::footprint(typename arena_handler<T, ABI>::element_type const *p) noexcept {
+  return placeable && nullptr != p ? measure(p, typename condition<0 != std::rank<T>::value>::type()) : 0;
+}
+
+/**
+ * Copy the given object into the given arena
+ *
+ * The object's footprint must not be 0, the copy holds no reference to
+ * the arena.
+ *
+ * @param p  Pointer to the object to copy
+ * @param arena  Arena to copy into
+ * @return a pointer to the copy
+ */
+template <typename T, typename ABI>
+typename arena_handler<T, ABI>::element_type *arena_handler<T, ABI>::place(typename arena_handler<T, ABI>::element_type const *p, clone_arena &arena) {
+  return placeIf(p, arena, typename condition<placeable>::type());
+}
+
+/**
+ * Return the number of bytes a copy of the given object takes up in an arena
+ *
+ * The object can only be placed if its dynamic type is known, ie. if it
+ * coincides with T.
+ *
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating whether T is an array type
+ * @return the number of bytes a copy takes up, or 0 if it cannot be placed in an arena
+ */
+template <typename T, typename ABI>
+std::size_t arena_handler<T, ABI>::measure(typename arena_handler<T, ABI>::element_type const *p, std::false_type) noexcept {
+  return typeid(*p) == typeid(T) ? clone_arena::footprint(sizeof(T), alignof(T)) : 0;
+}
+
+/**
+ * Return the number of bytes a copy of the given array takes up in an arena
+ *
+ * @param p  Pointer to the array to copy
+ * @param <unnamed>  Tag indicating whether T is an array type
+ * @return the number of bytes a copy takes up
+ */
+template <typename T, typename ABI>
+std::size_t arena_handler<T, ABI>::measure(typename arena_handler<T, ABI>::element_type const *p, std::true_type) noexcept {
+  return clone_arena::footprint(ABI::template arrayBytes<element_type>(length(p, typename condition<0 == std::extent<T>::value>::type())), ABI::template arrayAlign<element_type>());
+}
+
+/**
+ * Copy the given object into the given arena, T being placeable
+ *
+ * @param p  Pointer to the object to copy
+ * @param arena  Arena to copy into
+ * @param <unnamed>  Tag indicating placeability
+ * @return a pointer to the copy
+ */
+template <typename T, typename ABI>
+typename arena_handler<T, ABI>::element_type *arena_handler<T, ABI>::placeIf(typename arena_handler<T, ABI>::element_type const *p, clone_arena &arena, std::true_type) {
+  return placeAs(p, arena, typename condition<0 != std::rank<T>::value>::type());
+}
+
+/**
+ * Refuse to copy the given object into the given arena, T not being placeable
+ *
+ * @param <unnamed>  Pointer to the object to copy
+ * @param <unnamed>  Arena to copy into
+ * @param <unnamed>  Tag indicating placeability
+ * @return nullptr, always
+ */
+template <typename T, typename ABI>
+constexpr typename arena_handler<T, ABI>::element_type *arena_handler<T, ABI>::placeIf(typename arena_handler<T, ABI>::element_type const *, clone_arena &, std::false_type) noexcept {
+  return nullptr;
+}
+
+/**
+ * Copy the given object into the given arena
+ *
+ * @param p  Pointer to the object to copy
+ * @param arena  Arena to copy into
+ * @param <unnamed>  Tag indicating whether T is an array type
+ * @return a pointer to the copy
+ */
+template <typename T, typename ABI>
+typename arena_handler<T, ABI>::element_type *arena_handler<T, ABI>::placeAs(typename arena_handler<T, ABI>::element_type const *p, clone_arena &arena, std::false_type) {
+  return copyInto(arena.allocate(sizeof(T), alignof(T)), p, typename condition<is_cloneable<T>::value>::type());
+}
+
+/**
+ * Copy the given array into the given arena
+ *
+ * @param p  Pointer to the array to copy
+ * @param arena  Arena to copy into
+ * @param <unnamed>  Tag indicating whether T is an array type
+ * @return a pointer to the copy
+ */
+template <typename T, typename ABI>
+typename arena_handler<T, ABI>::element_type *arena_handler<T, ABI>::placeAs(typename arena_handler<T, ABI>::element_type const *p, clone_arena &arena, std::true_type) {
+  return resource_array<element_type, clone_arena, ABI>::replicate(p, length(p, typename condition<0 == std::extent<T>::value>::type()), arena);
+}
+
+/**
+ * Copy the given object into the given storage using its copy constructor
+ *
+ * @param raw  Storage to copy into
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ * @return a pointer to the copy
+ */
+template <typename T, typename ABI>
+typename arena_handler<T, ABI>::element_type *arena_handler<T, ABI>::copyInto(void *raw, typename arena_handler<T, ABI>::element_type const *p, std::false_type) {
+  return new(raw) T(*p);
+}
+
+/**
+ * Copy the given object into the given storage using its placement clone method
+ *
+ * @param raw  Storage to copy into
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ * @return a pointer to the copy
+ */
+template <typename T, typename ABI>
+typename arena_handler<T, ABI>::element_type *arena_handler<T, ABI>::copyInto(void *raw, typename arena_handler<T, ABI>::element_type const *p, std::true_type) {
+  return p->clone(raw);
+}
+
+/**
+ * Destroy the given object in place
+ *
+ * @param p  Pointer to the object to destroy
+ * @param <unnamed>  Arena holding the object
+ * @param <unnamed>  Tag indicating whether T is an array type
+ */
+template <typename T, typename ABI>
+void arena_handler<T, ABI>::destroyIn(typename arena_handler<T, ABI>::element_type const *p, clone_arena &, std::false_type) {
+  p->~T();
+}
+
+/**
+ * Destroy the given array in place
+ *
+ * @param p  Pointer to the array to destroy
+ * @param arena  Arena holding the array
+ * @param <unnamed>  Tag indicating whether T is an array type
+ */
+template <typename T, typename ABI>
+void arena_handler<T, ABI>::destroyIn(typename arena_handler<T, ABI>::element_type const *p, clone_arena &arena, std::true_type) {
+  resource_array<element_type, clone_arena, ABI>::destroy(p, length(p, typename condition<0 == std::extent<T>::value>::type()), arena);
+}
+
+/**
+ * Return the number of elements in the given array of unknown bound
+ *
+ * @param p  Pointer to the array
+ * @param <unnamed>  Tag indicating whether T is an array of unknown bound
+ * @return the number of elements in the array
+ */
+template <typename T, typename ABI>
+std::size_t arena_handler<T, ABI>::length(typename arena_handler<T, ABI>::element_type const *p, std::true_type) noexcept {
+  return ABI::template arraySize<element_type>(p);
+}
+
+/**
+ * Return the number of elements in the given array of known bound
+ *
+ * @param <unnamed>  Pointer to the array
+ * @param <unnamed>  Tag indicating whether T is an array of unknown bound
+ * @return the number of elements in the array
+ */
+template <typename T, typename ABI>
+constexpr std::size_t arena_handler<T, ABI>::length(typename arena_handler<T, ABI>::element_type const *, std::false_type) noexcept {
+  return std::extent<T>::value;
+}
+
+
+/**
+ * Deep-copy a range of value_ptrs into a single arena block
+ *
+ * Every pointee whose size can be told (ie. whose dynamic type is known, and
+ * array lengths, through the ABI) is sized up front, a single arena holding
+ * them all is allocated, and each is copied into it, upcoming sources being
+ * prefetched; copies are handed out as value_ptrs using an arena_handler,
+ * and the arena is released along with the last of them. Pointees whose
+ * size cannot be told are replicated onto the heap by default_handler.
+ *
+ * Should a copy throw, the copies already handed out are left in place,
+ * and the exception is rethrown.
+ *
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ * @param It  Forward iterator over value_ptrs
+ * @param Out  Output iterator accepting value_ptr<T, arena_handler<T, ABI>>
+ * @param first  Start of the range to copy
+ * @param last  End of the range to copy
+ * @param out  Iterator to write the copies to
+ * @return the output iterator past the last copy written
+ */
+template <typename ABI, typename It, typename Out>
+Out clone_range(It first, It last, Out out) {
+  using T = typename value_ptr_underlying<typename std::iterator_traits<It>::value_type>::type;
+  using H = arena_handler<T, ABI>;
+  using V = value_ptr<T, H>;
+
+  std::size_t bytes = 0;
+  for (It it = first; it != last; ++it) {
+    bytes += H::footprint(it->get());
+  }
+
+  clone_arena *arena = clone_arena::create(bytes);
+  try {
+    It ahead = first;
+    for (std::size_t i = 0; i < clone_arena::prefetch_distance && ahead != last; i++) {
+      ++ahead;
+    }
+
+    for (; first != last; ++first) {
+      if (ahead != last) {
+        __builtin_prefetch(ahead->get());
+        ++ahead;
+      }
+
+      typename V::const_pointer_type p = first->get();
+      if (0 != H::footprint(p)) {
+        typename V::pointer_type copy = H::place(p, *arena);
+        arena->retain();
+        *out = V(copy, H(arena));
+      } else {
+        *out = V(default_handler<T, ABI>().replicate(p), H());
+      }
+      ++out;
+    }
+  } catch (...) {
+    arena->release();
+    throw;
+  }
+  arena->release();
+
+  return out;
+}
+
+#endif /* VALUE_PTR__ARENA_HPP__ */
@@ -0,0 +1,330 @@
+#ifndef VALUE_PTR__ATOMIC_H__
+#define VALUE_PTR__ATOMIC_H__
+
+
+#include <type_traits>
+#include <cstddef>
+#include <atomic>
+
+#include "value_ptr.h"
+
+
+/**
+ * Atomically published value_ptr, read through deep copies or borrowed pointers
+ *
+ * Ownership of a pointee is moved in and out atomically (by store,
+ * exchange, and compare_exchange), so that readers never take a lock:
+ * they either load a deep copy of the current pointee, or borrow it for as
+ * long as they hold a guard. Borrowing is protected by hazard pointers: a
+ * guard announces the pointee it borrows in a hazard record of its own
+ * (records are reused, and only ever allocated when every existing one is
+ * in use), and a replaced pointee is only destroyed once no record
+ * announces it any longer.
+ *
+ * Pointees replaced by store and compare_exchange are retired onto a
+ * lock-free list, scanned (and those no longer borrowed destroyed) upon
+ * every replacement and upon reclaim(); exchange, which hands the old
+ * pointee over to the caller, instead waits until it is no longer
+ * borrowed. Since retired pointees are destroyed by a default-constructed
+ * handler, the handler must be stateless.
+ *
+ * The atomic_value_ptr itself must outlive every guard borrowing from it.
+ *
+ * @param T  Underlying type to wrap
+ * @param H  Handler type to use (default_handler<T> by default)
+ */
+template <typename T, typename H = default_handler<T>>
+class atomic_value_ptr {
+  protected:
+    /**
+     * Hazard record, announcing the pointee borrowed by a guard
+     *
+     */
+    struct hazard;
+
+  public:
+    /**
+     * Refuse to work on stateful handlers
+     *
+     */
+    static_assert(std::is_empty<H>::value, "atomic_value_ptr requires a stateless handler");
+
+    using value_type         = value_ptr<T, H>;
+    using handler_type       = H;
+    using pointer_type       = typename value_type::pointer_type;
+    using const_pointer_type = typename value_type::const_pointer_type;
+
+    /**
+     * Pointee borrowed from an atomic_value_ptr
+     *
+     * The pointee is guaranteed not to be destroyed for as long as the
+     * guard lives; it is only ever given const access to.
+     *
+     */
+    class guard {
+      public:
+        /**
+         * Borrow the current pointee of the given atomic_value_ptr
+         *
+         * @param source  atomic_value_ptr to borrow from
+         * @throws std::bad_alloc  In case a new hazard record cannot be allocated
+         */
+        explicit guard(atomic_value_ptr const &source);
+
+        /**
+         * Deleted copy constructor
+         *
+         */
+        guard(guard const &) = delete;
+
+        /**
+         * Deleted copy-assignment operator
+         *
+         */
+        guard &operator=(guard const &) = delete;
+
+        /**
+         * Destructor, ending the borrow
+         *
+         */
+        ~guard() noexcept;
+
+        /**
+         * Return the borrowed pointer
+         *
+         * @return the borrowed pointer
+         */
+        const_pointer_type get() const noexcept __attribute__((always_inline, pure));
+
+        /**
+         * Return the borrowed pointer
+         *
+         * @return the borrowed pointer
+         */
+        const_pointer_type operator->() const noexcept __attribute__((always_inline, pure));
+
+        /**
+         * Return the borrowed pointee
+         *
+         * @return the borrowed pointee
+         */
+        typename value_type::const_reference_type operator*() const noexcept __attribute__((always_inline, pure));
+
+        /**
+         * Return whether a non-null pointee is borrowed
+         *
+         * @return whether a non-null pointee is borrowed
+         */
+        explicit operator bool() const noexcept __attribute__((always_inline, pure));
+
+      protected:
+        /**
+         * Hazard record announcing the borrowed pointee
+         *
+         */
+        hazard *record;
+
+        /**
+         * Borrowed pointer
+         *
+         */
+        pointer_type p;
+    };
+
+    /**
+     * Default constructor
+     *
+     */
+    atomic_value_ptr() noexcept;
+
+    /**
+     * Constructor, taking over the given value_ptr's pointee
+     *
+     * @param v  value_ptr to take the pointee from, left null
+     */
+    explicit atomic_value_ptr(value_type &&v) noexcept;
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    atomic_value_ptr(atomic_value_ptr const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    atomic_value_ptr &operator=(atomic_value_ptr const &) = delete;
+
+    /**
+     * Destructor
+     *
+     * Destroys the current pointee, every retired one, and the hazard
+     * records; no guard may be left.
+     *
+     */
+    ~atomic_value_ptr() noexcept;
+
+    /**
+     * Return a deep copy of the current pointee
+     *
+     * @return a value_ptr holding a copy of the current pointee, or nullptr
+     */
+    value_type load() const;
+
+    /**
+     * Borrow the current pointee
+     *
+     * @return a guard borrowing the current pointee
+     */
+    guard borrow() const;
+
+    /**
+     * Replace the current pointee with the given value_ptr's, retiring the former
+     *
+     * @param v  value_ptr to take the new pointee from, left null
+     */
+    void store(value_type &&v) noexcept;
+
+    /**
+     * Replace the current pointee with the given value_ptr's, and hand the former over
+     *
+     * Waits until the former pointee is no longer borrowed.
+     *
+     * @param v  value_ptr to take the new pointee from, left null
+     * @return a value_ptr holding the former pointee
+     */
+    value_type exchange(value_type &&v) noexcept;
+
+    /**
+     * Replace the current pointee with the given value_ptr's should it be the one a guard borrows, retiring the former
+     *
+     * The expected pointee is only accepted through a live guard: being
+     * borrowed, it cannot be destroyed and its address reused in the
+     * meantime, which would have the comparison succeed against an unrelated
+     * pointee (the ABA problem).
+     *
+     * @param expected  Guard borrowing the pointee expected to be current
+     * @param v  value_ptr to take the new pointee from, left null on success only
+     * @return whether the expected pointee was current and got replaced
+     */
+    bool compare_exchange(guard const &expected, value_type &v) noexcept;
+
+    /**
+     * Destroy every retired pointee no longer borrowed
+     *
+     * @return the number of retired pointees still borrowed
+     */
+    std::size_t reclaim() noexcept;
+
+    /**
+     * Return the number of retired pointees not yet destroyed
+     *
+     * @return the number of retired pointees not yet destroyed
+     */
+    std::size_t retired() const noexcept __attribute__((pure));
+
+  protected:
+    /**
+     * Hazard record, announcing the pointee borrowed by a guard
+     *
+     */
+    struct hazard {
+      std::atomic<void const *> p{nullptr};
+      hazard *next = nullptr;
+      std::atomic<bool> active{true};
+      [[no_unique_address]] explicit_padding<padding_to<sizeof(std::atomic<bool>), alignof(hazard *)>::value> padding{};
+    };
+
+    /**
+     * Retired pointee, awaiting destruction
+     *
+     */
+    struct retiree {
+      pointer_type p;
+      retiree *next;
+    };
+
+    /**
+     * Obtain an inactive hazard record, allocating a new one if every record is in use
+     *
+     * @return an active hazard record
+     * @throws std::bad_alloc  In case a new record cannot be allocated
+     */
+    hazard *acquire() const;
+
+    /**
+     * Announce the current pointer in the given hazard record, until it is stable
+     *
+     * The pointer is re-read after being announced: should it have changed in
+     * the meantime, it may have been retired (and scanned for) before the
+     * announcement became visible, and the new one is announced instead.
+     *
+     * @param record  Hazard record to announce the pointer in
+     * @return the announced pointer
+     */
+    pointer_type protect(hazard *record) const noexcept;
+
+    /**
+     * Return whether any hazard record announces the given pointer
+     *
+     * @param p  Pointer to look for
+     * @return whether p is announced
+     */
+    bool borrowed(void const *p) const noexcept;
+
+    /**
+     * Push retired pointees onto the retired list
+     *
+     * @param first  First retired pointee in the chain to push
+     * @param last  Last retired pointee in the chain to push
+     * @param n  Number of retired pointees in the chain
+     */
+    void pushRetired(retiree *first, retiree *last, std::size_t n) noexcept;
+
+    /**
+     * Retire the given pointee, destroying it later on
+     *
+     * Should no retired entry be allocatable, waits until the pointee is
+     * no longer borrowed and destroys it at once.
+     *
+     * @param p  Pointee to retire
+     */
+    void retire(pointer_type p) noexcept;
+
+    /**
+     * Wait until the given pointer is no longer borrowed
+     *
+     * @param p  Pointer to wait for
+     */
+    void quiesce(void const *p) const noexcept;
+
+    /**
+     * Current pointer
+     *
+     */
+    std::atomic<pointer_type> current;
+
+    /**
+     * Hazard records, never removed until destruction
+     *
+     */
+    mutable std::atomic<hazard *> hazards;
+
+    /**
+     * Retired pointees
+     *
+     */
+    std::atomic<retiree *> retirees;
+
+    /**
+     * Number of retired pointees
+     *
+     */
+    std::atomic<std::size_t> pending;
+};
+
+
+#include "Atomic.hpp"
+
+#endif /* VALUE_PTR__ATOMIC_H__ */
@@ -0,0 +1,326 @@
+#ifndef VALUE_PTR__ATOMIC_HPP__
+#define VALUE_PTR__ATOMIC_HPP__
+
+
+#include "Atomic.h"
+
+#include <new>
+#include <thread>
+
+
+/**
+ * Borrow the current pointee of the given atomic_value_ptr
+ *
+ * @param source  atomic_value_ptr to borrow from
+ * @throws std::bad_alloc  In case a new hazard record cannot be allocated
+ */
+template <typename T, typename H>
+atomic_value_ptr<T, H>::guard::guard(atomic_value_ptr<T, H> const &source) : record(source.acquire()), p(source.protect(record)) {}
+
+/**
+ * Destructor, ending the borrow
+ *
+ */
+template <typename T, typename H>
+atomic_value_ptr<T, H>::guard::~guard() noexcept {
+  record->p.store(nullptr, std::memory_order_release);
+  record->active.store(false, std::memory_order_release);
+}
+
+/**
+ * Return the borrowed pointer
+ *
+ * @return the borrowed pointer
+ */
+template <typename T, typename H>
+inline typename atomic_value_ptr<T, H>::const_pointer_type atomic_value_ptr<T, H>::guard::get() const noexcept { return p; }
+
+/**
+ * Return the borrowed pointer
+ *
+ * @return the borrowed pointer
+ */
+template <typename T, typename H>
+inline typename atomic_value_ptr<T, H>::const_pointer_type atomic_value_ptr<T, H>::guard::operator->() const noexcept { return p; }
+
+/**
+ * Return the borrowed pointee
+ *
+ * @return the borrowed pointee
+ */
+template <typename T, typename H>
+inline typename atomic_value_ptr<T, H>::value_type::const_reference_type atomic_value_ptr<T, H>::guard::operator*() const noexcept { return *p; }
+
+/**
+ * Return whether a non-null pointee is borrowed
+ *
+ * @return whether a non-null pointee is borrowed
+ */
+template <typename T, typename H>
+inline atomic_value_ptr<T, H>::guard::operator bool() const noexcept { return nullptr != p; }
+
+
+/**
+ * Default constructor
+ *
+ */
+template <typename T, typename H>
+atomic_value_ptr<T, H>::atomic_value_ptr() noexcept : current(nullptr), hazards(nullptr), retirees(nullptr), pending(0) {}
+
+/**
+ * Constructor, taking over the given value_ptr's pointee
+ *
+ * @param v  value_ptr to take the pointee from, left null
+ */
+template <typename T, typename H>
+atomic_value_ptr<T, H>::atomic_value_ptr(typename atomic_value_ptr<T, H>::value_type &&v) noexcept : current(v.release()), hazards(nullptr), retirees(nullptr), pending(0) {}
+
+/**
+ * Destructor
+ *
+ * Destroys the current pointee, every retired one, and the hazard
+ * records; no guard may be left.
+ *
+ */
+template <typename T, typename H>
+atomic_value_ptr<T, H>::~atomic_value_ptr() noexcept {
+  pointer_type p = current.load(std::memory_order_acquire);
+  if (nullptr != p) {
+    handler_type().destroy(p);
+  }
+  for (retiree *r = retirees.load(std::memory_order_acquire), *next; nullptr != r; r = next) {
+    next = r->next;
+    handler_type().destroy(r->p);
+    delete r;
+  }
+  for (hazard *h = hazards.load(std::memory_order_acquire), *next; nullptr != h; h = next) {
+    next = h->next;
+    delete h;
+  }
+}
+
+/**
+ * Return a deep copy of the current pointee
+ *
+ * @return a value_ptr holding a copy of the current pointee, or nullptr
+ */
+template <typename T, typename H>
+typename atomic_value_ptr<T, H>::value_type atomic_value_ptr<T, H>::load() const {
+  guard g(*this);
+  return g ? value_type(handler_type().replicate(g.get())) : value_type();
+}
+
+/**
+ * Borrow the current pointee
+ *
+ * @return a guard borrowing the current pointee
+ */
+template <typename T, typename H>
+typename atomic_value_ptr<T, H>::guard atomic_value_ptr<T, H>::borrow() const {
+  return guard(*this);
+}
+
+/**
+ * Replace the current pointee with the given value_ptr's, retiring the former
+ *
+ * @param v  value_ptr to take the new pointee from, left null
+ */
+template <typename T, typename H>
+void atomic_value_ptr<T, H>::store(typename atomic_value_ptr<T, H>::value_type &&v) noexcept {
+  pointer_type old = current.exchange(v.release(), std::memory_order_seq_cst);
+  if (nullptr != old) {
+    retire(old);
+  }
+}
+
+/**
+ * Replace the current pointee with the given value_ptr's, and hand the former over
+ *
+ * Waits until the former pointee is no longer borrowed.
+ *
+ * @param v  value_ptr to take the new pointee from, left null
+ * @return a value_ptr holding the former pointee
+ */
+template <typename T, typename H>
+typename atomic_value_ptr<T, H>::value_type atomic_value_ptr<T, H>::exchange(typename atomic_value_ptr<T, H>::value_type &&v) noexcept {
+  pointer_type old = current.exchange(v.release(), std::memory_order_seq_cst);
+  if (nullptr == old) {
+    return value_type();
+  }
+  quiesce(old);
+  return value_type(old);
+}
+
+/**
+ * Replace the current pointee with the given value_ptr's should it be the one a guard borrows, retiring the former
+ *
+ * The expected pointee is only accepted through a live guard: being
+ * borrowed, it cannot be destroyed and its address reused in the
+ * meantime, which would have the comparison succeed against an unrelated
+ * pointee (the ABA problem).
+ *
+ * @param expected  Guard borrowing the pointee expected to be current
+ * @param v  value_ptr to take the new pointee from, left null on success only
+ * @return whether the expected pointee was current and got replaced
+ */
+template <typename T, typename H>
+bool atomic_value_ptr<T, H>::compare_exchange(typename atomic_value_ptr<T, H>::guard const &expected, typename atomic_value_ptr<T, H>::value_type &v) noexcept {
+  pointer_type old = const_cast<pointer_type>(expected.get());
+  if (!current.compare_exchange_strong(old, v.get(), std::memory_order_seq_cst)) {
+    return false;
+  }
+  v.release();
+  if (nullptr != old) {
+    retire(old);
+  }
+  return true;
+}
+
+/**
+ * Destroy every retired pointee no longer borrowed
+ *
+ * @return the number of retired pointees still borrowed
+ */
+template <typename T, typename H>
+std::size_t atomic_value_ptr<T, H>::reclaim() noexcept {
+  retiree *first = nullptr, *last = nullptr;
+  std::size_t kept = 0;
+  for (retiree *r = retirees.exchange(nullptr, std::memory_order_acquire), *next; nullptr != r; r = next) {
+    next = r->next;
+    if (borrowed(r->p)) {
+      r->next = first;
+      first = r;
+      if (nullptr == last) {
+        last = r;
+      }
+      kept++;
+    } else {
+      pending.fetch_sub(1, std::memory_order_relaxed);
+      handler_type().destroy(r->p);
+      delete r;
+    }
+  }
+  if (nullptr != first) {
+    pending.fetch_sub(kept, std::memory_order_relaxed);
+    pushRetired(first, last, kept);
+  }
+  return kept;
+}
+
+/**
+ * Return the number of retired pointees not yet destroyed
+ *
+ * @return the number of retired pointees not yet destroyed
+ */
+template <typename T, typename H>
+std::size_t atomic_value_ptr<T, H>::retired() const noexcept {
+  return pending.load(std::memory_order_relaxed);
+}
+
+/**
+ * Obtain an inactive hazard record, allocating a new one if every record is in use
+ *
+ * @return an active hazard record
+ * @throws std::bad_alloc  In case a new record cannot be allocated
+ */
+template <typename T, typename H>
+typename atomic_value_ptr<T, H>::hazard *atomic_value_ptr<T, H>::acquire() const {
+  for (hazard *h = hazards.load(std::memory_order_acquire); nullptr != h; h = h->next) {
+    bool idle = false;
+    if (!h->active.load(std::memory_order_relaxed) && h->active.compare_exchange_strong(idle, true, std::memory_order_acquire)) {
+      return h;
+    }
+  }
+
+  hazard *h = new hazard();
+  h->next = hazards.load(std::memory_order_relaxed);
+  while (!hazards.compare_exchange_weak(h->next, h, std::memory_order_release, std::memory_order_relaxed)) {}
+  return h;
+}
+
+/**
+ * Announce the current pointer in the given hazard record, until it is stable
+ *
+ * The pointer is re-read after being announced: should it have changed in
+ * the meantime, it may have been retired (and scanned for) before the
+ * announcement became visible, and the new one is announced instead.
+ *
+ * @param record  Hazard record to announce the pointer in
+ * @return the announced pointer
+ */
+template <typename T, typename H>
+typename atomic_value_ptr<T, H>::pointer_type atomic_value_ptr<T, H>::protect(typename atomic_value_ptr<T, H>::hazard *record) const noexcept {
+  pointer_type p = current.load(std::memory_order_acquire);
+  for (;;) {
+    record->p.store(p, std::memory_order_seq_cst);
+    pointer_type q = current.load(std::memory_order_seq_cst);
+    if (q == p) {
+      return p;
+    }
+    p = q;
+  }
+}
+
+/**
+ * Return whether any hazard record announces the given pointer
+ *
+ * @param p  Pointer to look for
+ * @return whether p is announced
+ */
+template <typename T, typename H>
+bool atomic_value_ptr<T, H>::borrowed(void const *p) const noexcept {
+  for (hazard *h = hazards.load(std::memory_order_acquire); nullptr != h; h = h->next) {
+    if (p == h->p.load(std::memory_order_seq_cst)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Push retired pointees onto the retired list
+ *
+ * @param first  First retired pointee in the chain to push
+ * @param last  Last retired pointee in the chain to push
+ * @param n  Number of retired pointees in the chain
+ */
+template <typename T, typename H>
+void atomic_value_ptr<T, H>::pushRetired(typename atomic_value_ptr<T, H>::retiree *first, typename atomic_value_ptr<T, H>::retiree *last, std::size_t n) noexcept {
+  pending.fetch_add(n, std::memory_order_relaxed);
+  last->next = retirees.load(std::memory_order_relaxed);
+  while (!retirees.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+/**
+ * Retire the given pointee, destroying it later on
+ *
+ * Should no retired entry be allocatable, waits until the pointee is
+ * no longer borrowed and destroys it at once.
+ *
+ * @param p  Pointee to retire
+ */
+template <typename T, typename H>
+void atomic_value_ptr<T, H>::retire(typename atomic_value_ptr<T, H>::pointer_type p) noexcept {
+  try {
+    retiree *r = new retiree{p, nullptr};
+    pushRetired(r, r, 1);
+  } catch (std::bad_alloc const &) {
+    quiesce(p);
+    handler_type().destroy(p);
+  }
+  reclaim();
+}
+
+/**
+ * Wait until the given pointer is no longer borrowed
+ *
+ * @param p  Pointer to wait for
+ */
+template <typename T, typename H>
+void atomic_value_ptr<T, H>::quiesce(void const *p) const noexcept {
+  while (borrowed(p)) {
+    std::this_thread::yield();
+  }
+}
+
+#endif /* VALUE_PTR__ATOMIC_HPP__ */
@@ -40,30 +40,10 @@ struct is_placement_cloneable {
     template <typename>
     static constexpr auto test(...) -> std::false_type;
 
-    /**
-     * Test for the existence of the "clone" method
-     *
-     * This metamethod will only be defined when decltype(&S::clone) succeeds,
-     * which will only happen when S has a method named "clone" itself.
-     *
-     * It will also try to resolve "decltype(test(&S::clone, nullptr))", since
-     * this appears to be its return type; this in turn triggers the signature
-     * recognition metamethod below.
-     *
-     * Note that this method will have the same return type as the metamethod
-     * below, if substitution succeeds, or the same as the one above, if
-     * substitution fails.
-     *
-     * @param S  Base class under which to look for a "clone" method
-     */
-    template <typename S>
-    static constexpr auto test(decltype(&S::clone))
-      -> decltype(test(&S::clone, nullptr));
-
     /**
      * Test for the correct signature for "clone"
      *
-     * This metamethod will check that the "clone" method identified above has
+     * This metamethod will check that the "clone" method identified below has
      * the required signature. Note the R parameter: this is added in order to
      * allow for covariant return types in the resolved method (this is later
      * checked for in the metamethod's return type, along with a check for size
@@ -84,6 +64,27 @@ struct is_placement_cloneable {
         std::is_same<R *, decltype(std::declval<S>().clone(nullptr))>::value
       >::type;
 
+    /**
+     * Test for the existence of the "clone" method
+     *
+     * This metamethod will only be defined when decltype(&S::clone) succeeds,
+     * which will only happen when S has a method named "clone" itself.
+     *
+     * It will also try to resolve "decltype(test(&S::clone, nullptr))", since
+     * this appears to be its return type; this in turn triggers the signature
+     * recognition metamethod above (which must therefore be declared first,
+     * lest it not be found when resolving this very return type).
+     *
+     * Note that this method will have the same return type as the signature
+     * recognition metamethod, if substitution succeeds, or the same as the
+     * default case, if substitution fails.
+     *
+     * @param S  Base class under which to look for a "clone" method
+     */
+    template <typename S>
+    static constexpr auto test(decltype(&S::clone))
+      -> decltype(test(&S::clone, nullptr));
+
   public:
     /**
      * A class will be placement cloneable if it is a polymorphic one and it
@@ -143,30 +144,10 @@ struct is_cloneable {
     template <typename>
     static constexpr auto test(...) -> std::false_type;
 
-    /**
-     * Test for the existence of the "clone" method
-     *
-     * This metamethod will only be defined when decltype(&S::clone) succeeds,
-     * which will only happen when S has a method named "clone" itself.
-     *
-     * It will also try to resolve "decltype(test(&S::clone, nullptr))", since
-     * this appears to be its return type; this in turn triggers the signature
-     * recognition metamethod below.
-     *
-     * Note that this method will have the same return type as the metamethod
-     * below, if substitution succeeds, or the same as the one above, if
-     * substitution fails.
-     *
-     * @param S  Base class under which to look for a "clone" method
-     */
-    template <typename S>
-    static constexpr auto test(decltype(&S::clone))
-      -> decltype(test(&S::clone, nullptr));
-
     /**
      * Test for the correct signature for "clone"
      *
-     * This metamethod will check that the "clone" method identified above has
+     * This metamethod will check that the "clone" method identified below has
      * the required signature. Note the R parameter: this is added in order to
      * allow for covariant return types in the resolved method (this is later
      * checked for in the metamethod's return type, along with a check for size
@@ -187,6 +168,27 @@ struct is_cloneable {
         std::is_same<R *, decltype(std::declval<S>().clone())>::value
       >::type;
 
+    /**
+     * Test for the existence of the "clone" method
+     *
+     * This metamethod will only be defined when decltype(&S::clone) succeeds,
+     * which will only happen when S has a method named "clone" itself.
+     *
+     * It will also try to resolve "decltype(test(&S::clone, nullptr))", since
+     * this appears to be its return type; this in turn triggers the signature
+     * recognition metamethod above (which must therefore be declared first,
+     * lest it not be found when resolving this very return type).
+     *
+     * Note that this method will have the same return type as the signature
+     * recognition metamethod, if substitution succeeds, or the same as the
+     * default case, if substitution fails.
+     *
+     * @param S  Base class under which to look for a "clone" method
+     */
+    template <typename S>
+    static constexpr auto test(decltype(&S::clone))
+      -> decltype(test(&S::clone, nullptr));
+
   public:
     /**
      * A class will be cloneable if it is a polymorphic one and it contains a
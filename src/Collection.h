@@ -0,0 +1,400 @@
+#ifndef VALUE_PTR__COLLECTION_H__
+#define VALUE_PTR__COLLECTION_H__
+
+
+#include <type_traits>
+#include <cstddef>
+#include <vector>
+
+#include "Cloneable.h"
+
+
+/**
+ * Container of polymorphic objects with value semantics, segregated by dynamic type
+ *
+ * Elements are stored by value in contiguous per-type blocks (one for each
+ * dynamic type inserted), rather than each on its own heap allocation as in
+ * a std::vector of value_ptr: iterating the collection thus walks a handful
+ * of dense arrays, and virtual calls made on the elements of a block all
+ * resolve to the same targets.
+ *
+ * Copying the collection deep-copies every block, calling each element's
+ * copy constructor directly (or its "placement clone" method, should it not
+ * be copy constructible); moving it transfers the blocks. Elements are not
+ * kept in insertion order, and inserting into a block may relocate its
+ * elements, invalidating references to them.
+ *
+ * @param T  Common base type of the elements, of which they must be non-virtual subobjects
+ */
+template <typename T>
+class value_collection {
+  public:
+    /**
+     * Refuse to accept array types
+     *
+     */
+    static_assert(0 == std::rank<T>::value, "value_collection cannot work on array types");
+
+    /**
+     * Common base type of the elements
+     *
+     */
+    using value_type = T;
+
+    /**
+     * Type used for sizes
+     *
+     */
+    using size_type = std::size_t;
+
+    /**
+     * Default constructor
+     *
+     */
+    value_collection() noexcept;
+
+    /**
+     * Copy constructor
+     *
+     * Deep-copies every block, each into storage just large enough.
+     *
+     * @param other  Collection to copy
+     */
+    value_collection(value_collection const &other);
+
+    /**
+     * Move constructor
+     *
+     * @param other  Collection to take the blocks from, left empty
+     */
+    value_collection(value_collection &&other) noexcept;
+
+    /**
+     * Copy-assignment operator
+     *
+     * Provides the strong exception guarantee.
+     *
+     * @param other  Collection to copy
+     * @return a reference to this collection
+     */
+    value_collection &operator=(value_collection const &other);
+
+    /**
+     * Move-assignment operator
+     *
+     * @param other  Collection to take the blocks from, left empty
+     * @return a reference to this collection
+     */
+    value_collection &operator=(value_collection &&other) noexcept;
+
+    /**
+     * Destructor
+     *
+     */
+    ~value_collection() noexcept;
+
+    /**
+     * Construct a new element of type D in its block
+     *
+     * The arguments may refer to elements of this collection.
+     *
+     * @param D  Type of the element to construct
+     * @param args  Arguments to construct the element from
+     * @return a reference to the new element
+     */
+    template <typename D, typename... Args> D &emplace(Args&&... args);
+
+    /**
+     * Copy or move an object into its block
+     *
+     * @param x  Object to insert, whose dynamic type must be its static one
+     * @return a reference to the new element
+     * @throws std::bad_typeid  In case the object's dynamic type differs from its static one
+     */
+    template <typename X> typename std::decay<X>::type &insert(X &&x);
+
+    /**
+     * Reserve room for the given number of elements of type D
+     *
+     * @param D  Type of the elements
+     * @param n  Number of elements the block of D is to hold without relocating
+     */
+    template <typename D> void reserve(std::size_t n);
+
+    /**
+     * Remove every element, releasing every block
+     *
+     */
+    void clear() noexcept;
+
+    /**
+     * Return the number of elements
+     *
+     * @return the number of elements
+     */
+    std::size_t size() const noexcept __attribute__((pure));
+
+    /**
+     * Return whether the collection holds no elements
+     *
+     * @return whether the collection holds no elements
+     */
+    bool empty() const noexcept __attribute__((pure));
+
+    /**
+     * Return the number of elements of type D
+     *
+     * @param D  Type of the elements
+     * @return the number of elements of type D
+     */
+    template <typename D> std::size_t count() const noexcept __attribute__((pure));
+
+    /**
+     * Return the number of distinct dynamic types held, ie. of non-empty blocks
+     *
+     * @return the number of distinct dynamic types held
+     */
+    std::size_t type_count() const noexcept __attribute__((pure));
+
+    /**
+     * Call the given function on every element, block by block
+     *
+     * @param f  Function to call with a reference to each element, as a T
+     */
+    template <typename F> void for_each(F &&f);
+
+    /**
+     * Call the given function on every element, block by block (const overload)
+     *
+     * @param f  Function to call with a const reference to each element, as a T
+     */
+    template <typename F> void for_each(F &&f) const;
+
+    /**
+     * Call the given function on every element of type D
+     *
+     * Since the elements' type is statically known, virtual calls made on
+     * them can be devirtualized.
+     *
+     * @param D  Type of the elements
+     * @param f  Function to call with a reference to each element, as a D
+     */
+    template <typename D, typename F> void for_each_of(F &&f);
+
+    /**
+     * Call the given function on every element of type D (const overload)
+     *
+     * @param D  Type of the elements
+     * @param f  Function to call with a const reference to each element, as a D
+     */
+    template <typename D, typename F> void for_each_of(F &&f) const;
+
+    /**
+     * Swap the contents with another collection
+     *
+     * @param other  Collection to swap contents with
+     */
+    void swap(value_collection &other) noexcept;
+
+  protected:
+    /**
+     * Per-type function table
+     *
+     */
+    struct table {
+      std::size_t size;
+      std::size_t align;
+      void (*copy)(void *, void const *, std::size_t);
+      void (*relocate)(void *, void *, std::size_t);
+      void (*destroy)(void *, std::size_t) noexcept;
+      T *(*upcast)(void *) noexcept;
+    };
+
+    /**
+     * Contiguous storage for elements of a single dynamic type
+     *
+     */
+    struct block {
+      table const *type;
+      unsigned char *data;
+      std::size_t count;
+      std::size_t capacity;
+    };
+
+    /**
+     * Check whether D can be held (ie. T is D or one of its non-virtual bases)
+     *
+     * @param D  Type to check
+     * @return std::true_type
+     */
+    template <typename D> static constexpr auto holdable(int) noexcept -> decltype(static_cast<D *>(std::declval<T *>()), typename condition<std::is_convertible<D *, T *>::value>::type());
+
+    /**
+     * Refuse to hold D, since T is a virtual base of D or unrelated to it
+     *
+     * @param D  Type to check
+     * @return std::false_type
+     */
+    template <typename D> static constexpr std::false_type holdable(long) noexcept;
+
+    /**
+     * Return the function table for elements of the given type
+     *
+     * @param D  Type of the elements
+     * @return the function table for D
+     */
+    template <typename D> static table const *capture() noexcept __attribute__((const));
+
+    /**
+     * Return the block holding elements of the given type, if any
+     *
+     * @param D  Type of the elements
+     * @return the block holding elements of type D, or nullptr if none
+     */
+    template <typename D> block *find() noexcept __attribute__((pure));
+
+    /**
+     * Return the block holding elements of the given type, if any (const overload)
+     *
+     * @param D  Type of the elements
+     * @return the block holding elements of type D, or nullptr if none
+     */
+    template <typename D> block const *find() const noexcept __attribute__((pure));
+
+    /**
+     * Return the block holding elements of the given type, creating an empty one if needed
+     *
+     * @param D  Type of the elements
+     * @return the block holding elements of type D
+     */
+    template <typename D> block &obtain();
+
+    /**
+     * Allocate storage for the given number of elements of the given type
+     *
+     * @param type  Function table of the elements' type
+     * @param n  Number of elements
+     * @return the allocated storage
+     */
+    static unsigned char *allocate(table const *type, std::size_t n);
+
+    /**
+     * Release storage for elements of the given type
+     *
+     * @param type  Function table of the elements' type
+     * @param data  Storage to release
+     */
+    static void deallocate(table const *type, unsigned char *data) noexcept;
+
+    /**
+     * Copy-construct the given number of elements of type D into raw storage
+     *
+     * Should a copy throw, the elements already copied are destroyed before
+     * rethrowing.
+     *
+     * @param D  Type of the elements
+     * @param dst  Storage to copy into
+     * @param src  Elements to copy
+     * @param n  Number of elements
+     */
+    template <typename D> static void copyAs(void *dst, void const *src, std::size_t n);
+
+    /**
+     * Copy-construct one element of type D into raw storage using its copy constructor
+     *
+     * @param D  Type of the element
+     * @param dst  Storage to copy into
+     * @param src  Element to copy
+     * @param <unnamed>  Tag indicating copy constructibility
+     */
+    template <typename D> static void copyOne(D *dst, D const *src, std::true_type);
+
+    /**
+     * Copy-construct one element of type D into raw storage using its "placement clone" method
+     *
+     * @param D  Type of the element
+     * @param dst  Storage to copy into
+     * @param src  Element to copy
+     * @param <unnamed>  Tag indicating copy constructibility
+     */
+    template <typename D> static void copyOne(D *dst, D const *src, std::false_type);
+
+    /**
+     * Move the given number of elements of type D into raw storage, destroying the originals
+     *
+     * The elements are moved if that cannot throw, and copied otherwise (in
+     * which case, should a copy throw, the originals are left untouched).
+     *
+     * @param D  Type of the elements
+     * @param dst  Storage to move into
+     * @param src  Elements to move
+     * @param n  Number of elements
+     */
+    template <typename D> static void relocateAs(void *dst, void *src, std::size_t n);
+
+    /**
+     * Move the given number of elements of type D into raw storage using their move constructor
+     *
+     * @param D  Type of the elements
+     * @param dst  Storage to move into
+     * @param src  Elements to move
+     * @param n  Number of elements
+     * @param <unnamed>  Tag indicating nothrow move constructibility
+     */
+    template <typename D> static void relocateEach(D *dst, D *src, std::size_t n, std::true_type) noexcept;
+
+    /**
+     * Copy the given number of elements of type D into raw storage
+     *
+     * @param D  Type of the elements
+     * @param dst  Storage to copy into
+     * @param src  Elements to copy
+     * @param n  Number of elements
+     * @param <unnamed>  Tag indicating nothrow move constructibility
+     */
+    template <typename D> static void relocateEach(D *dst, D *src, std::size_t n, std::false_type);
+
+    /**
+     * Destroy the given number of elements of type D, in reverse order
+     *
+     * @param D  Type of the elements
+     * @param p  Elements to destroy
+     * @param n  Number of elements
+     */
+    template <typename D> static void destroyAs(void *p, std::size_t n) noexcept;
+
+    /**
+     * Convert a pointer to an element of type D into a pointer to T
+     *
+     * @param D  Type of the element
+     * @param p  Pointer to the element
+     * @return the converted pointer
+     */
+    template <typename D> static T *upcastAs(void *p) noexcept __attribute__((const));
+
+    /**
+     * Per-type blocks, in order of first insertion
+     *
+     */
+    std::vector<block> blocks;
+
+    /**
+     * Total number of elements
+     *
+     */
+    std::size_t total;
+};
+
+
+/**
+ * Swap the contents of two collections
+ *
+ * @param x  First collection to swap
+ * @param y  Second collection to swap
+ */
+template <typename T> void swap(value_collection<T> &x, value_collection<T> &y) noexcept;
+
+
+#include "Collection.hpp"
+
+#endif /* VALUE_PTR__COLLECTION_H__ */
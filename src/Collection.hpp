@@ -0,0 +1,589 @@
+#ifndef VALUE_PTR__COLLECTION_HPP__
+#define VALUE_PTR__COLLECTION_HPP__
+
+
+#include "Collection.h"
+
+#include <new>
+#include <typeinfo>
+#include <utility>
+
+
+/**
+ * Default constructor
+ *
+ */
+template <typename T>
+value_collection<T>::value_collection() noexcept : blocks(), total(0) {}
+
+/**
+ * Copy constructor
+ *
+ * Deep-copies every block, each into storage just large enough; should a
+ * copy throw, the blocks already copied are released by the destructor
+ * (this constructor delegating to the default one).
+ *
+ * @param other  Collection to copy
+ */
+template <typename T>
+value_collection<T>::value_collection(value_collection<T> const &other) : value_collection<T>() {
+  blocks.reserve(other.blocks.size());
+  for (block const &b : other.blocks) {
+    if (0 < b.count) {
+      unsigned char *data = allocate(b.type, b.count);
+      try {
+        b.type->copy(data, b.data, b.count);
+      } catch (...) {
+        deallocate(b.type, data);
+        throw;
+      }
+      blocks.push_back(block{b.type, data, b.count, b.count});
+      total += b.count;
+    }
+  }
+}
+
+/**
+ * Move constructor
+ *
+ * @param other  Collection to take the blocks from, left empty
+ */
+template <typename T>
+value_collection<T>::value_collection(value_collection<T> &&other) noexcept : blocks(std::move(other.blocks)), total(other.total) {
+  other.blocks.clear();
+  other.total = 0;
+}
+
+/**
+ * Copy-assignment operator
+ *
+ * Provides the strong exception guarantee.
+ *
+ * @param other  Collection to copy
+ * @return a reference to this collection
+ */
+template <typename T>
+value_collection<T> &value_collection<T>::operator=(value_collection<T> const &other) {
+  value_collection<T>(other).swap(*this);
+  return *this;
+}
+
+/**
+ * Move-assignment operator
+ *
+ * @param other  Collection to take the blocks from, left empty
+ * @return a reference to this collection
+ */
+template <typename T>
+value_collection<T> &value_collection<T>::operator=(value_collection<T> &&other) noexcept {
+  value_collection<T>(std::move(other)).swap(*this);
+  return *this;
+}
+
+/**
+ * Destructor
+ *
+ */
+template <typename T>
+value_collection<T>::~value_collection() noexcept {
+  clear();
+}
+
+/**
+ * Construct a new element of type D in its block
+ *
+ * Should the block be full, the new element is constructed into the new
+ * storage before the existing ones are relocated, so that the arguments may
+ * refer to elements of this collection.
+ *
+ * @param D  Type of the element to construct
+ * @param args  Arguments to construct the element from
+ * @return a reference to the new element
+ */
+template <typename T>
+template <typename D, typename... Args>
+D &value_collection<T>::emplace(Args&&... args) {
+  block &b = obtain<D>();
+
+  if (b.count < b.capacity) {
+    D *ret = ::new(static_cast<void *>(b.data + b.count * sizeof(D))) D(std::forward<Args>(args)...);
+    b.count++;
+    total++;
+    return *ret;
+  }
+
+  std::size_t capacity = 0 == b.capacity ? 4 : 2 * b.capacity;
+  unsigned char *data = allocate(b.type, capacity);
+  D *ret = nullptr;
+  try {
+    ret = ::new(static_cast<void *>(data + b.count * sizeof(D))) D(std::forward<Args>(args)...);
+    relocateAs<D>(data, b.data, b.count);
+  } catch (...) {
+    if (nullptr != ret) {
+      ret->~D();
+    }
+    deallocate(b.type, data);
+    throw;
+  }
+  deallocate(b.type, b.data);
+  b.data = data;
+  b.capacity = capacity;
+  b.count++;
+  total++;
+
+  return *ret;
+}
+
+/**
+ * Copy or move an object into its block
+ *
+ * Inserting an object through a reference to one of its bases would slice
+ * it, and is thus refused.
+ *
+ * @param x  Object to insert, whose dynamic type must be its static one
+ * @return a reference to the new element
+ * @throws std::bad_typeid  In case the object's dynamic type differs from its static one
+ */
+template <typename T>
+template <typename X>
+typename std::decay<X>::type &value_collection<T>::insert(X &&x) {
+  using D = typename std::decay<X>::type;
+
+  if (typeid(x) != typeid(D)) {
+    throw std::bad_typeid();
+  }
+
+  return emplace<D>(std::forward<X>(x));
+}
+
+/**
+ * Reserve room for the given number of elements of type D
+ *
+ * @param D  Type of the elements
+ * @param n  Number of elements the block of D is to hold without relocating
+ */
+template <typename T>
+template <typename D>
+void value_collection<T>::reserve(std::size_t n) {
+  block &b = obtain<D>();
+
+  if (n <= b.capacity) {
+    return;
+  }
+
+  unsigned char *data = allocate(b.type, n);
+  try {
+    relocateAs<D>(data, b.data, b.count);
+  } catch (...) {
+    deallocate(b.type, data);
+    throw;
+  }
+  deallocate(b.type, b.data);
+  b.data = data;
+  b.capacity = n;
+}
+
+/**
+ * Remove every element, releasing every block
+ *
+ */
+template <typename T>
+void value_collection<T>::clear() noexcept {
+  for (block &b : blocks) {
+    b.type->destroy(b.data, b.count);
+    deallocate(b.type, b.data);
+  }
+  blocks.clear();
+  total = 0;
+}
+
+/**
+ * Return the number of elements
+ *
+ * @return the number of elements
+ */
+template <typename T>
+std::size_t value_collection<T>::size() const noexcept {
+  return total;
+}
+
+/**
+ * Return whether the collection holds no elements
+ *
+ * @return whether the collection holds no elements
+ */
+template <typename T>
+bool value_collection<T>::empty() const noexcept {
+  return 0 == total;
+}
+
+/**
+ * Return the number of elements of type D
+ *
+ * @param D  Type of the elements
+ * @return the number of elements of type D
+ */
+template <typename T>
+template <typename D>
+std::size_t value_collection<T>::count() const noexcept {
+  block const *b = find<D>();
+  return nullptr != b ? b->count : 0;
+}
+
+/**
+ * Return the number of distinct dynamic types held, ie. of non-empty blocks
+ *
+ * @return the number of distinct dynamic types held
+ */
+template <typename T>
+std::size_t value_collection<T>::type_count() const noexcept {
+  std::size_t ret = 0;
+  for (block const &b : blocks) {
+    if (0 < b.count) {
+      ret++;
+    }
+  }
+  return ret;
+}
+
+/**
+ * Call the given function on every element, block by block
+ *
+ * Elements being non-virtual subobjects, the offset of T within them is the
+ * same throughout a block, and is only computed once per block.
+ *
+ * @param f  Function to call with a reference to each element, as a T
+ */
+template <typename T>
+template <typename F>
+void value_collection<T>::for_each(F &&f) {
+  for (block &b : blocks) {
+    if (0 < b.count) {
+      std::size_t stride = b.type->size;
+      unsigned char *p = b.data;
+      std::ptrdiff_t offset = reinterpret_cast<unsigned char *>(b.type->upcast(p)) - p;
+      for (unsigned char *end = p + b.count * stride; p != end; p += stride) {
+        f(*reinterpret_cast<T *>(p + offset));
+      }
+    }
+  }
+}
+
+/**
+ * Call the given function on every element, block by block (const overload)
+ *
+ * Elements being non-virtual subobjects, the offset of T within them is the
+ * same throughout a block, and is only computed once per block.
+ *
+ * @param f  Function to call with a const reference to each element, as a T
+ */
+template <typename T>
+template <typename F>
+void value_collection<T>::for_each(F &&f) const {
+  for (block const &b : blocks) {
+    if (0 < b.count) {
+      std::size_t stride = b.type->size;
+      unsigned char const *p = b.data;
+      std::ptrdiff_t offset = reinterpret_cast<unsigned char const *>(b.type->upcast(b.data)) - p;
+      for (unsigned char const *end = p + b.count * stride; p != end; p += stride) {
+        f(*reinterpret_cast<T const *>(p + offset));
+      }
+    }
+  }
+}
+
+/**
+ * Call the given function on every element of type D
+ *
+ * Since the elements' type is statically known, virtual calls made on
+ * them can be devirtualized.
+ *
+ * @param D  Type of the elements
+ * @param f  Function to call with a reference to each element, as a D
+ */
+template <typename T>
+template <typename D, typename F>
+void value_collection<T>::for_each_of(F &&f) {
+  block *b = find<D>();
+  if (nullptr != b) {
+    D *p = reinterpret_cast<D *>(b->data);
+    for (std::size_t i = 0; i < b->count; i++) {
+      f(p[i]);
+    }
+  }
+}
+
+/**
+ * Call the given function on every element of type D (const overload)
+ *
+ * @param D  Type of the elements
+ * @param f  Function to call with a const reference to each element, as a D
+ */
+template <typename T>
+template <typename D, typename F>
+void value_collection<T>::for_each_of(F &&f) const {
+  block const *b = find<D>();
+  if (nullptr != b) {
+    D const *p = reinterpret_cast<D const *>(b->data);
+    for (std::size_t i = 0; i < b->count; i++) {
+      f(p[i]);
+    }
+  }
+}
+
+/**
+ * Swap the contents with another collection
+ *
+ * @param other  Collection to swap contents with
+ */
+template <typename T>
+void value_collection<T>::swap(value_collection<T> &other) noexcept {
+  blocks.swap(other.blocks);
+  std::swap(total, other.total);
+}
+
+/**
+ * Return the function table for elements of the given type
+ *
+ * @param D  Type of the elements
+ * @return the function table for D
+ */
+template <typename T>
+template <typename D>
+typename value_collection<T>::table const *value_collection<T>::capture() noexcept {
+  static_assert(decltype(holdable<D>(0))::value, "value_collection elements must have T as a non-virtual base");
+  static_assert(std::is_copy_constructible<D>::value || is_placement_cloneable<D>::value, "value_collection elements must be copy constructible or placement cloneable");
+
+  static constexpr table entries = { sizeof(D), alignof(D), &copyAs<D>, &relocateAs<D>, &destroyAs<D>, &upcastAs<D> };
+  return &entries;
+}
+
+/**
+ * Return the block holding elements of the given type, if any
+ *
+ * @param D  Type of the elements
+ * @return the block holding elements of type D, or nullptr if none
+ */
+template <typename T>
+template <typename D>
+typename value_collection<T>::block *value_collection<T>::find() noexcept {
+  table const *type = capture<D>();
+  for (block &b : blocks) {
+    if (type == b.type) {
+      return &b;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Return the block holding elements of the given type, if any (const overload)
+ *
+ * @param D  Type of the elements
+ * @return the block holding elements of type D, or nullptr if none
+ */
+template <typename T>
+template <typename D>
+typename value_collection<T>::block const *value_collection<T>::find() const noexcept {
+  table const *type = capture<D>();
+  for (block const &b : blocks) {
+    if (type == b.type) {
+      return &b;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Return the block holding elements of the given type, creating an empty one if needed
+ *
+ * @param D  Type of the elements
+ * @return the block holding elements of type D
+ */
+template <typename T>
+template <typename D>
+typename value_collection<T>::block &value_collection<T>::obtain() {
+  block *ret = find<D>();
+  if (nullptr != ret) {
+    return *ret;
+  }
+
+  blocks.push_back(block{capture<D>(), nullptr, 0, 0});
+  return blocks.back();
+}
+
+/**
+ * Allocate storage for the given number of elements of the given type
+ *
+ * @param type  Function table of the elements' type
+ * @param n  Number of elements
+ * @return the allocated storage
+ * @throws std::bad_array_new_length  In case the storage size overflows
+ */
+template <typename T>
+unsigned char *value_collection<T>::allocate(typename value_collection<T>::table const *type, std::size_t n) {
+  if (n > static_cast<std::size_t>(-1) / type->size) {
+    throw std::bad_array_new_length();
+  }
+  return static_cast<unsigned char *>(::operator new(n * type->size, std::align_val_t(type->align)));
+}
+
+/**
+ * Release storage for elements of the given type
+ *
+ * @param type  Function table of the elements' type
+ * @param data  Storage to release
+ */
+template <typename T>
+void value_collection<T>::deallocate(typename value_collection<T>::table const *type, unsigned char *data) noexcept {
+  ::operator delete(data, std::align_val_t(type->align));
+}
+
+/**
+ * Copy-construct the given number of elements of type D into raw storage
+ *
+ * Should a copy throw, the elements already copied are destroyed before
+ * rethrowing.
+ *
+ * @param D  Type of the elements
+ * @param dst  Storage to copy into
+ * @param src  Elements to copy
+ * @param n  Number of elements
+ */
+template <typename T>
+template <typename D>
+void value_collection<T>::copyAs(void *dst, void const *src, std::size_t n) {
+  D *to = static_cast<D *>(dst);
+  D const *from = static_cast<D const *>(src);
+  std::size_t i = 0;
+  try {
+    for (; i < n; i++) {
+      copyOne<D>(to + i, from + i, typename condition<std::is_copy_constructible<D>::value>::type());
+    }
+  } catch (...) {
+    destroyAs<D>(to, i);
+    throw;
+  }
+}
+
+/**
+ * Copy-construct one element of type D into raw storage using its copy constructor
+ *
+ * @param D  Type of the element
+ * @param dst  Storage to copy into
+ * @param src  Element to copy
+ * @param <unnamed>  Tag indicating copy constructibility
+ */
+template <typename T>
+template <typename D>
+void value_collection<T>::copyOne(D *dst, D const *src, std::true_type) {
+  ::new(static_cast<void *>(dst)) D(*src);
+}
+
+/**
+ * Copy-construct one element of type D into raw storage using its "placement clone" method
+ *
+ * @param D  Type of the element
+ * @param dst  Storage to copy into
+ * @param src  Element to copy
+ * @param <unnamed>  Tag indicating copy constructibility
+ */
+template <typename T>
+template <typename D>
+void value_collection<T>::copyOne(D *dst, D const *src, std::false_type) {
+  src->clone(static_cast<void *>(dst));
+}
+
+/**
+ * Move the given number of elements of type D into raw storage, destroying the originals
+ *
+ * The elements are moved if that cannot throw, and copied otherwise (in
+ * which case, should a copy throw, the originals are left untouched).
+ *
+ * @param D  Type of the elements
+ * @param dst  Storage to move into
+ * @param src  Elements to move
+ * @param n  Number of elements
+ */
+template <typename T>
+template <typename D>
+void value_collection<T>::relocateAs(void *dst, void *src, std::size_t n) {
+  relocateEach<D>(static_cast<D *>(dst), static_cast<D *>(src), n, typename condition<std::is_nothrow_move_constructible<D>::value>::type());
+}
+
+/**
+ * Move the given number of elements of type D into raw storage using their move constructor
+ *
+ * @param D  Type of the elements
+ * @param dst  Storage to move into
+ * @param src  Elements to move
+ * @param n  Number of elements
+ * @param <unnamed>  Tag indicating nothrow move constructibility
+ */
+template <typename T>
+template <typename D>
+void value_collection<T>::relocateEach(D *dst, D *src, std::size_t n, std::true_type) noexcept {
+  for (std::size_t i = 0; i < n; i++) {
+    ::new(static_cast<void *>(dst + i)) D(std::move(src[i]));
+  }
+  destroyAs<D>(src, n);
+}
+
+/**
+ * Copy the given number of elements of type D into raw storage
+ *
+ * @param D  Type of the elements
+ * @param dst  Storage to copy into
+ * @param src  Elements to copy
+ * @param n  Number of elements
+ * @param <unnamed>  Tag indicating nothrow move constructibility
+ */
+template <typename T>
+template <typename D>
+void value_collection<T>::relocateEach(D *dst, D *src, std::size_t n, std::false_type) {
+  copyAs<D>(dst, src, n);
+  destroyAs<D>(src, n);
+}
+
+/**
+ * Destroy the given number of elements of type D, in reverse order
+ *
+ * @param D  Type of the elements
+ * @param p  Elements to destroy
+ * @param n  Number of elements
+ */
+template <typename T>
+template <typename D>
+void value_collection<T>::destroyAs(void *p, std::size_t n) noexcept {
+  D *q = static_cast<D *>(p);
+  while (0 < n) {
+    q[--n].~D();
+  }
+}
+
+/**
+ * Convert a pointer to an element of type D into a pointer to T
+ *
+ * @param D  Type of the element
+ * @param p  Pointer to the element
+ * @return the converted pointer
+ */
+template <typename T>
+template <typename D>
+T *value_collection<T>::upcastAs(void *p) noexcept {
+  return static_cast<T *>(static_cast<D *>(p));
+}
+
+
+/**
+ * Swap the contents of two collections
+ *
+ * @param x  First collection to swap
+ * @param y  Second collection to swap
+ */
+template <typename T>
+void swap(value_collection<T> &x, value_collection<T> &y) noexcept {
+  x.swap(y);
+}
+
+#endif /* VALUE_PTR__COLLECTION_HPP__ */
@@ -0,0 +1,436 @@
+#ifndef VALUE_PTR__COMPARE_H__
+#define VALUE_PTR__COMPARE_H__
+
+
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "value_ptr.h"
+
+
+/**
+ * Metaprogramming class to tell the ABI adapter class a handler uses
+ *
+ * The ABI is deduced from the (single) default_destroy base of the handler,
+ * Itanium being assumed for handlers lacking one.
+ *
+ * @param H  Handler type to inspect
+ */
+template <typename H>
+struct handler_abi {
+  /**
+   * Deduce the ABI from a default_destroy base
+   *
+   * @param U  Underlying type of the base
+   * @param A  ABI adapter class of the base
+   * @param <unnamed>  Pointer to the base
+   * @return an A
+   */
+  template <typename U, typename A> static A probe(default_destroy<U, A> const *) noexcept;
+
+  /**
+   * Fallback for handlers lacking a (single) default_destroy base
+   *
+   * @param <unnamed>  Pointer to the handler
+   * @return an Itanium
+   */
+  static Itanium probe(...) noexcept;
+
+  using type = decltype(probe(static_cast<H const *>(nullptr)));
+};
+
+
+/**
+ * Static class providing the byte-level kernels of value_compare
+ *
+ * The kernels work on whole runs of bytes: comparisons defer to memcmp
+ * (vectorized by the C library) in large chunks, and hashing mixes four
+ * independent 64-bit lanes per 32 bytes read, so that the compiler may
+ * vectorize (or at least pipeline) them. Hashes depend on the platform's
+ * endianness, and are thus not meant to be persisted.
+ *
+ */
+class value_kernels {
+  public:
+    /**
+     * Number of bytes mismatch compares at once before looking for the first difference
+     *
+     */
+    static constexpr std::size_t chunk = 256;
+
+    /**
+     * Return whether two runs of bytes are equal
+     *
+     * @param p  First run of bytes
+     * @param q  Second run of bytes
+     * @param n  Number of bytes in either run
+     * @return whether both runs are equal
+     */
+    static bool equal(void const *p, void const *q, std::size_t n) noexcept __attribute__((pure));
+
+    /**
+     * Return the offset of the first byte differing between two runs of bytes
+     *
+     * @param p  First run of bytes
+     * @param q  Second run of bytes
+     * @param n  Number of bytes in either run
+     * @return the offset of the first differing byte, or n if both runs are equal
+     */
+    static std::size_t mismatch(void const *p, void const *q, std::size_t n) noexcept __attribute__((pure));
+
+    /**
+     * Hash a run of bytes
+     *
+     * @param p  Run of bytes to hash
+     * @param n  Number of bytes in the run
+     * @param seed  Seed to start from
+     * @return the hash of the run
+     */
+    static std::size_t hash(void const *p, std::size_t n, std::uint64_t seed = 0) noexcept __attribute__((pure));
+
+    /**
+     * Combine a hash with that of a further element
+     *
+     * @param h  Hash so far
+     * @param v  Hash of the further element
+     * @return the combined hash
+     */
+    static constexpr std::size_t combine(std::size_t h, std::size_t v) noexcept __attribute__((const));
+
+  protected:
+    /**
+     * Hashing multipliers
+     *
+     */
+    static constexpr std::uint64_t prime1 = 0x9e3779b185ebca87ull;
+    static constexpr std::uint64_t prime2 = 0xc2b2ae3d27d4eb4full;
+    static constexpr std::uint64_t prime3 = 0x165667b19e3779f9ull;
+    static constexpr std::uint64_t prime4 = 0x85ebca77c2b2ae63ull;
+    static constexpr std::uint64_t prime5 = 0x27d4eb2f165667c5ull;
+
+    /**
+     * Rotate a 64-bit word left
+     *
+     * @param x  Word to rotate
+     * @param r  Number of bits to rotate by
+     * @return the rotated word
+     */
+    static constexpr std::uint64_t rotl(std::uint64_t x, unsigned r) noexcept __attribute__((always_inline, const));
+
+    /**
+     * Load an unaligned 64-bit word
+     *
+     * @param p  Address to load from
+     * @return the loaded word
+     */
+    static std::uint64_t load64(unsigned char const *p) noexcept __attribute__((always_inline, pure));
+
+    /**
+     * Load an unaligned 32-bit word
+     *
+     * @param p  Address to load from
+     * @return the loaded word
+     */
+    static std::uint32_t load32(unsigned char const *p) noexcept __attribute__((always_inline, pure));
+
+    /**
+     * Mix a 64-bit word into a lane
+     *
+     * @param lane  Lane to mix into
+     * @param w  Word to mix in
+     * @return the updated lane
+     */
+    static constexpr std::uint64_t round(std::uint64_t lane, std::uint64_t w) noexcept __attribute__((always_inline, const));
+
+    /**
+     * Spread the entropy of a hash over all its bits
+     *
+     * @param h  Hash to finalize
+     * @return the finalized hash
+     */
+    static constexpr std::uint64_t avalanche(std::uint64_t h) noexcept __attribute__((const));
+};
+
+
+/**
+ * Static class providing deep (ie. pointee-wise) comparison and hashing of value_ptrs
+ *
+ * value_ptr's own comparison operators compare addresses, as for any other
+ * smart pointer; the functions here compare the pointees instead, so that
+ * value_ptrs may serve as keys by value (see value_equal, value_less and
+ * value_hash). Pointer identity (including both being null) short-circuits
+ * to equality, and a null value_ptr orders before any other.
+ *
+ * Scalar pointees are compared by their own operator== and operator<, and
+ * hashed by std::hash. Arrays (their lengths taken from the extent, or from
+ * the handler's ABI for arrays of unknown bound) are compared
+ * lexicographically; arrays of trivially comparable elements (ie. having
+ * unique object representations, which excludes floating point types) are
+ * compared and hashed as raw bytes by value_kernels.
+ *
+ */
+class value_compare {
+  public:
+    /**
+     * Return whether the pointees of two value_ptrs are equal
+     *
+     * @param x  First value_ptr to compare
+     * @param y  Second value_ptr to compare
+     * @return whether both are null, or their pointees are equal
+     */
+    template <typename T1, typename H1, typename T2, typename H2> static bool equal(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
+
+    /**
+     * Return whether the pointee of a value_ptr is less than that of another
+     *
+     * @param x  First value_ptr to compare
+     * @param y  Second value_ptr to compare
+     * @return whether x is null and y is not, or both are non-null and x's pointee is less than y's
+     */
+    template <typename T1, typename H1, typename T2, typename H2> static bool less(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
+
+    /**
+     * Hash the pointee of a value_ptr
+     *
+     * Value_ptrs whose pointees compare equal hash equal, whatever their
+     * handlers (and array bounds).
+     *
+     * @param x  Value_ptr to hash
+     * @return the hash of the pointee, or 0 if null
+     */
+    template <typename T, typename H> static std::size_t hash(value_ptr<T, H> const &x);
+
+  protected:
+    /**
+     * Metaprogramming class to tell whether arrays of E1 and E2 may be compared as raw bytes
+     *
+     * @param E1  Element type of the first array
+     * @param E2  Element type of the second array
+     */
+    template <typename E1, typename E2> using bitwise = condition<std::is_same<typename std::remove_cv<E1>::type, typename std::remove_cv<E2>::type>::value && std::has_unique_object_representations<typename std::remove_cv<E1>::type>::value>;
+
+    /**
+     * Return the number of elements in the pointee of a value_ptr to an array of unknown bound
+     *
+     * @param x  Value_ptr to an array
+     * @param <unnamed>  Tag indicating whether T is an array of unknown bound
+     * @return the number of elements in the array
+     */
+    template <typename T, typename H> static std::size_t length(value_ptr<T, H> const &x, std::true_type) noexcept __attribute__((pure));
+
+    /**
+     * Return the number of elements in the pointee of a value_ptr to an array of known bound
+     *
+     * @param <unnamed>  Value_ptr to an array
+     * @param <unnamed>  Tag indicating whether T is an array of unknown bound
+     * @return the number of elements in the array
+     */
+    template <typename T, typename H> static constexpr std::size_t length(value_ptr<T, H> const &, std::false_type) noexcept __attribute__((const));
+
+    /**
+     * Return the number of elements in the pointee of a value_ptr to an array
+     *
+     * @param x  Value_ptr to an array
+     * @return the number of elements in the array
+     */
+    template <typename T, typename H> static std::size_t length(value_ptr<T, H> const &x) noexcept __attribute__((pure));
+
+    /**
+     * Return whether the (non-null) pointees of two value_ptrs to scalars are equal
+     *
+     * @param x  First value_ptr to compare
+     * @param y  Second value_ptr to compare
+     * @param <unnamed>  Tag indicating whether the pointees are arrays
+     * @return whether both pointees are equal
+     */
+    template <typename T1, typename H1, typename T2, typename H2> static bool equalAs(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y, std::false_type);
+
+    /**
+     * Return whether the (non-null) pointees of two value_ptrs to arrays are equal
+     *
+     * @param x  First value_ptr to compare
+     * @param y  Second value_ptr to compare
+     * @param <unnamed>  Tag indicating whether the pointees are arrays
+     * @return whether both arrays have the same length and equal elements
+     */
+    template <typename T1, typename H1, typename T2, typename H2> static bool equalAs(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y, std::true_type);
+
+    /**
+     * Return whether two arrays of the same length have equal elements, comparing them one by one
+     *
+     * @param p  First array to compare
+     * @param q  Second array to compare
+     * @param n  Number of elements in either array
+     * @param <unnamed>  Tag indicating whether the arrays may be compared as raw bytes
+     * @return whether all elements are equal
+     */
+    template <typename E1, typename E2> static bool equalEach(E1 const *p, E2 const *q, std::size_t n, std::false_type);
+
+    /**
+     * Return whether two arrays of the same length have equal elements, comparing them as raw bytes
+     *
+     * @param p  First array to compare
+     * @param q  Second array to compare
+     * @param n  Number of elements in either array
+     * @param <unnamed>  Tag indicating whether the arrays may be compared as raw bytes
+     * @return whether all elements are equal
+     */
+    template <typename E1, typename E2> static bool equalEach(E1 const *p, E2 const *q, std::size_t n, std::true_type) noexcept;
+
+    /**
+     * Return whether the (non-null) pointee of a value_ptr to a scalar is less than that of another
+     *
+     * @param x  First value_ptr to compare
+     * @param y  Second value_ptr to compare
+     * @param <unnamed>  Tag indicating whether the pointees are arrays
+     * @return whether x's pointee is less than y's
+     */
+    template <typename T1, typename H1, typename T2, typename H2> static bool lessAs(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y, std::false_type);
+
+    /**
+     * Return whether the (non-null) pointee of a value_ptr to an array lexicographically precedes that of another
+     *
+     * @param x  First value_ptr to compare
+     * @param y  Second value_ptr to compare
+     * @param <unnamed>  Tag indicating whether the pointees are arrays
+     * @return whether x's array lexicographically precedes y's
+     */
+    template <typename T1, typename H1, typename T2, typename H2> static bool lessAs(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y, std::true_type);
+
+    /**
+     * Return whether an array lexicographically precedes another, comparing elements one by one
+     *
+     * @param p  First array to compare
+     * @param m  Number of elements in the first array
+     * @param q  Second array to compare
+     * @param n  Number of elements in the second array
+     * @param <unnamed>  Tag indicating whether the arrays may be compared as raw bytes
+     * @return whether the first array lexicographically precedes the second
+     */
+    template <typename E1, typename E2> static bool lessEach(E1 const *p, std::size_t m, E2 const *q, std::size_t n, std::false_type);
+
+    /**
+     * Return whether an array lexicographically precedes another, locating the first difference as raw bytes
+     *
+     * Only the first differing elements are then compared proper.
+     *
+     * @param p  First array to compare
+     * @param m  Number of elements in the first array
+     * @param q  Second array to compare
+     * @param n  Number of elements in the second array
+     * @param <unnamed>  Tag indicating whether the arrays may be compared as raw bytes
+     * @return whether the first array lexicographically precedes the second
+     */
+    template <typename E1, typename E2> static bool lessEach(E1 const *p, std::size_t m, E2 const *q, std::size_t n, std::true_type);
+
+    /**
+     * Hash the (non-null) pointee of a value_ptr to a scalar
+     *
+     * @param x  Value_ptr to hash
+     * @param <unnamed>  Tag indicating whether the pointee is an array
+     * @return the hash of the pointee
+     */
+    template <typename T, typename H> static std::size_t hashAs(value_ptr<T, H> const &x, std::false_type);
+
+    /**
+     * Hash the (non-null) pointee of a value_ptr to an array
+     *
+     * @param x  Value_ptr to hash
+     * @param <unnamed>  Tag indicating whether the pointee is an array
+     * @return the hash of the array
+     */
+    template <typename T, typename H> static std::size_t hashAs(value_ptr<T, H> const &x, std::true_type);
+
+    /**
+     * Hash an array, element by element
+     *
+     * @param p  Array to hash
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating whether the array may be hashed as raw bytes
+     * @return the hash of the array
+     */
+    template <typename E> static std::size_t hashEach(E const *p, std::size_t n, std::false_type);
+
+    /**
+     * Hash an array as raw bytes
+     *
+     * @param p  Array to hash
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating whether the array may be hashed as raw bytes
+     * @return the hash of the array
+     */
+    template <typename E> static std::size_t hashEach(E const *p, std::size_t n, std::true_type) noexcept;
+};
+
+
+/**
+ * Function object comparing value_ptrs for equality by pointee (see value_compare::equal)
+ *
+ */
+struct value_equal {
+  using is_transparent = void;
+
+  /**
+   * Return whether the pointees of two value_ptrs are equal
+   *
+   * @param x  First value_ptr to compare
+   * @param y  Second value_ptr to compare
+   * @return whether both are null, or their pointees are equal
+   */
+  template <typename T1, typename H1, typename T2, typename H2> bool operator()(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) const;
+};
+
+/**
+ * Function object ordering value_ptrs by pointee (see value_compare::less)
+ *
+ */
+struct value_less {
+  using is_transparent = void;
+
+  /**
+   * Return whether the pointee of a value_ptr is less than that of another
+   *
+   * @param x  First value_ptr to compare
+   * @param y  Second value_ptr to compare
+   * @return whether x orders before y
+   */
+  template <typename T1, typename H1, typename T2, typename H2> bool operator()(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) const;
+};
+
+/**
+ * Function object hashing value_ptrs by pointee (see value_compare::hash)
+ *
+ */
+struct value_hash {
+  using is_transparent = void;
+
+  /**
+   * Hash the pointee of a value_ptr
+   *
+   * @param x  Value_ptr to hash
+   * @return the hash of the pointee, or 0 if null
+   */
+  template <typename T, typename H> std::size_t operator()(value_ptr<T, H> const &x) const;
+};
+
+
+namespace std {
+  /**
+   * Hash specialization for value_ptrs, hashing by pointee
+   *
+   * Note that value_ptr's operator== compares addresses: use value_equal as
+   * the equality predicate for unordered containers to look keys up by value.
+   *
+   * @param T  Underlying type of the value_ptr
+   * @param H  Handler type of the value_ptr
+   */
+  template <typename T, typename H>
+  struct hash<value_ptr<T, H>> : value_hash {};
+}
+
+
+#include "Compare.hpp"
+
+#endif /* VALUE_PTR__COMPARE_H__ */
@@ -0,0 +1,476 @@
+#ifndef VALUE_PTR__COMPARE_HPP__
+#define VALUE_PTR__COMPARE_HPP__
+
+
+#include "Compare.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+/**
+ * Return whether two runs of bytes are equal
+ *
+ * @param p  First run of bytes
+ * @param q  Second run of bytes
+ * @param n  Number of bytes in either run
+ * @return whether both runs are equal
+ */
+inline bool value_kernels::equal(void const *p, void const *q, std::size_t n) noexcept {
+  return 0 == n || 0 == std::memcmp(p, q, n);
+}
+
+/**
+ * Return the offset of the first byte differing between two runs of bytes
+ *
+ * Whole chunks are compared by memcmp until one differs, which is then
+ * scanned word by word, and finally byte by byte.
+ *
+ * @param p  First run of bytes
+ * @param q  Second run of bytes
+ * @param n  Number of bytes in either run
+ * @return the offset of the first differing byte, or n if both runs are equal
+ */
+inline std::size_t value_kernels::mismatch(void const *p, void const *q, std::size_t n) noexcept {
+  unsigned char const *a = static_cast<unsigned char const *>(p);
+  unsigned char const *b = static_cast<unsigned char const *>(q);
+
+  std::size_t i = 0;
+  while (i + chunk <= n && 0 == std::memcmp(a + i, b + i, chunk)) {
+    i += chunk;
+  }
+  while (i + sizeof(std::uint64_t) <= n && load64(a + i) == load64(b + i)) {
+    i += sizeof(std::uint64_t);
+  }
+  while (i < n && a[i] == b[i]) {
+    i++;
+  }
+
+  return i;
+}
+
+/**
+ * Hash a run of bytes
+ *
+ * Runs of at least 32 bytes are mixed into four independent lanes, 8 bytes
+ * each at a time, which are then merged; the remaining bytes are mixed in
+ * sequentially.
+ *
+ * @param p  Run of bytes to hash
+ * @param n  Number of bytes in the run
+ * @param seed  Seed to start from
+ * @return the hash of the run
+ */
+inline std::size_t value_kernels::hash(void const *p, std::size_t n, std::uint64_t seed) noexcept {
+  unsigned char const *b = static_cast<unsigned char const *>(p);
+  unsigned char const *end = b + n;
+  std::uint64_t h;
+
+  if (n >= 4 * sizeof(std::uint64_t)) {
+    std::uint64_t lanes[4] = { seed + prime1 + prime2, seed + prime2, seed, seed - prime1 };
+    for (; b + 4 * sizeof(std::uint64_t) <= end; b += 4 * sizeof(std::uint64_t)) {
+      for (std::size_t k = 0; k < 4; k++) {
+        lanes[k] = round(lanes[k], load64(b + k * sizeof(std::uint64_t)));
+      }
+    }
+
+    h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+    for (std::size_t k = 0; k < 4; k++) {
+      h = (h ^ round(0, lanes[k])) * prime1 + prime4;
+    }
+  } else {
+    h = seed + prime5;
+  }
+  h += n;
+
+  for (; b + sizeof(std::uint64_t) <= end; b += sizeof(std::uint64_t)) {
+    h = rotl(h ^ round(0, load64(b)), 27) * prime1 + prime4;
+  }
+  if (b + sizeof(std::uint32_t) <= end) {
+    h = rotl(h ^ (load32(b) * prime1), 23) * prime2 + prime3;
+    b += sizeof(std::uint32_t);
+  }
+  for (; b < end; b++) {
+    h = rotl(h ^ (*b * prime5), 11) * prime1;
+  }
+
+  return avalanche(h);
+}
+
+/**
+ * Combine a hash with that of a further element
+ *
+ * @param h  Hash so far
+ * @param v  Hash of the further element
+ * @return the combined hash
+ */
+inline constexpr std::size_t value_kernels::combine(std::size_t h, std::size_t v) noexcept {
+  return h ^ (v + static_cast<std::size_t>(prime1) + (h << 6) + (h >> 2));
+}
+
+/**
+ * Rotate a 64-bit word left
+ *
+ * @param x  Word to rotate
+ * @param r  Number of bits to rotate by
+ * @return the rotated word
+ */
+inline constexpr std::uint64_t value_kernels::rotl(std::uint64_t x, unsigned r) noexcept {
+  return (x << r) | (x >> (64 - r));
+}
+
+/**
+ * Load an unaligned 64-bit word
+ *
+ * @param p  Address to load from
+ * @return the loaded word
+ */
+inline std::uint64_t value_kernels::load64(unsigned char const *p) noexcept {
+  std::uint64_t w;
+  std::memcpy(&w, p, sizeof(w));
+  return w;
+}
+
+/**
+ * Load an unaligned 32-bit word
+ *
+ * @param p  Address to load from
+ * @return the loaded word
+ */
+inline std::uint32_t value_kernels::load32(unsigned char const *p) noexcept {
+  std::uint32_t w;
+  std::memcpy(&w, p, sizeof(w));
+  return w;
+}
+
+/**
+ * Mix a 64-bit word into a lane
+ *
+ * @param lane  Lane to mix into
+ * @param w  Word to mix in
+ * @return the updated lane
+ */
+inline constexpr std::uint64_t value_kernels::round(std::uint64_t lane, std::uint64_t w) noexcept {
+  return rotl(lane + w * prime2, 31) * prime1;
+}
+
+/**
+ * Spread the entropy of a hash over all its bits
+ *
+ * @param h  Hash to finalize
+ * @return the finalized hash
+ */
+inline constexpr std::uint64_t value_kernels::avalanche(std::uint64_t h) noexcept {
+  h = (h ^ (h >> 33)) * prime2;
+  h = (h ^ (h >> 29)) * prime3;
+  return h ^ (h >> 32);
+}
+
+
+/**
+ * Return whether the pointees of two value_ptrs are equal
+ *
+ * @param x  First value_ptr to compare
+ * @param y  Second value_ptr to compare
+ * @return whether both are null, or their pointees are equal
+ */
+template <typename T1, typename H1, typename T2, typename H2>
+bool value_compare::equal(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) {
+  static_assert((0 == std::rank<T1>::value) == (0 == std::rank<T2>::value), "cannot compare scalars to arrays");
+
+  if (static_cast<void const *>(x.get()) == static_cast<void const *>(y.get())) {
+    return true;
+  }
+  if (nullptr == x.get() || nullptr == y.get()) {
+    return false;
+  }
+  return equalAs(x, y, typename condition<0 != std::rank<T1>::value>::type());
+}
+
+/**
+ * Return whether the pointee of a value_ptr is less than that of another
+ *
+ * @param x  First value_ptr to compare
+ * @param y  Second value_ptr to compare
+ * @return whether x is null and y is not, or both are non-null and x's pointee is less than y's
+ */
+template <typename T1, typename H1, typename T2, typename H2>
+bool value_compare::less(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) {
+  static_assert((0 == std::rank<T1>::value) == (0 == std::rank<T2>::value), "cannot compare scalars to arrays");
+
+  if (static_cast<void const *>(x.get()) == static_cast<void const *>(y.get()) || nullptr == y.get()) {
+    return false;
+  }
+  if (nullptr == x.get()) {
+    return true;
+  }
+  return lessAs(x, y, typename condition<0 != std::rank<T1>::value>::type());
+}
+
+/**
+ * Hash the pointee of a value_ptr
+ *
+ * Value_ptrs whose pointees compare equal hash equal, whatever their
+ * handlers (and array bounds).
+ *
+ * @param x  Value_ptr to hash
+ * @return the hash of the pointee, or 0 if null
+ */
+template <typename T, typename H>
+std::size_t value_compare::hash(value_ptr<T, H> const &x) {
+  if (nullptr == x.get()) {
+    return 0;
+  }
+  return hashAs(x, typename condition<0 != std::rank<T>::value>::type());
+}
+
+/**
+ * Return the number of elements in the pointee of a value_ptr to an array of unknown bound
+ *
+ * @param x  Value_ptr to an array
+ * @param <unnamed>  Tag indicating whether T is an array of unknown bound
+ * @return the number of elements in the array
+ */
+template <typename T, typename H>
+std::size_t value_compare::length(value_ptr<T, H> const &x, std::true_type) noexcept {
+  return handler_abi<H>::type::template arraySize<typename std::remove_extent<T>::type>(x.get());
+}
+
+/**
+ * Return the number of elements in the pointee of a value_ptr to an array of known bound
+ *
+ * @param <unnamed>  Value_ptr to an array
+ * @param <unnamed>  Tag indicating whether T is an array of unknown bound
+ * @return the number of elements in the array
+ */
+template <typename T, typename H>
+constexpr std::size_t value_compare::length(value_ptr<T, H> const &, std::false_type) noexcept {
+  return std::extent<T>::value;
+}
+
+/**
+ * Return the number of elements in the pointee of a value_ptr to an array
+ *
+ * @param x  Value_ptr to an array
+ * @return the number of elements in the array
+ */
+template <typename T, typename H>
+std::size_t value_compare::length(value_ptr<T, H> const &x) noexcept {
+  return length(x, typename condition<0 == std::extent<T>::value>::type());
+}
+
+/**
+ * Return whether the (non-null) pointees of two value_ptrs to scalars are equal
+ *
+ * @param x  First value_ptr to compare
+ * @param y  Second value_ptr to compare
+ * @param <unnamed>  Tag indicating whether the pointees are arrays
+ * @return whether both pointees are equal
+ */
+template <typename T1, typename H1, typename T2, typename H2>
+bool value_compare::equalAs(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y, std::false_type) {
+  return *x == *y;
+}
+
+/**
+ * Return whether the (non-null) pointees of two value_ptrs to arrays are equal
+ *
+ * @param x  First value_ptr to compare
+ * @param y  Second value_ptr to compare
+ * @param <unnamed>  Tag indicating whether the pointees are arrays
+ * @return whether both arrays have the same length and equal elements
+ */
+template <typename T1, typename H1, typename T2, typename H2>
+bool value_compare::equalAs(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y, std::true_type) {
+  using E1 = typename std::remove_extent<T1>::type;
+  using E2 = typename std::remove_extent<T2>::type;
+
+  std::size_t n = length(x);
+  return n == length(y) && equalEach(x.get(), y.get(), n, typename bitwise<E1, E2>::type());
+}
+
+/**
+ * Return whether two arrays of the same length have equal elements, comparing them one by one
+ *
+ * @param p  First array to compare
+ * @param q  Second array to compare
+ * @param n  Number of elements in either array
+ * @param <unnamed>  Tag indicating whether the arrays may be compared as raw bytes
+ * @return whether all elements are equal
+ */
+template <typename E1, typename E2>
+bool value_compare::equalEach(E1 const *p, E2 const *q, std::size_t n, std::false_type) {
+  return std::equal(p, p + n, q);
+}
+
+/**
+ * Return whether two arrays of the same length have equal elements, comparing them as raw bytes
+ *
+ * @param p  First array to compare
+ * @param q  Second array to compare
+ * @param n  Number of elements in either array
+ * @param <unnamed>  Tag indicating whether the arrays may be compared as raw bytes
+ * @return whether all elements are equal
+ */
+template <typename E1, typename E2>
+bool value_compare::equalEach(E1 const *p, E2 const *q, std::size_t n, std::true_type) noexcept {
+  return value_kernels::equal(p, q, n * sizeof(E1));
+}
+
+/**
+ * Return whether the (non-null) pointee of a value_ptr to a scalar is less than that of another
+ *
+ * @param x  First value_ptr to compare
+ * @param y  Second value_ptr to compare
+ * @param <unnamed>  Tag indicating whether the pointees are arrays
+ * @return whether x's pointee is less than y's
+ */
+template <typename T1, typename H1, typename T2, typename H2>
+bool value_compare::lessAs(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y, std::false_type) {
+  return *x < *y;
+}
+
+/**
+ * Return whether the (non-null) pointee of a value_ptr to an array lexicographically precedes that of another
+ *
+ * @param x  First value_ptr to compare
+ * @param y  Second value_ptr to compare
+ * @param <unnamed>  Tag indicating whether the pointees are arrays
+ * @return whether x's array lexicographically precedes y's
+ */
+template <typename T1, typename H1, typename T2, typename H2>
+bool value_compare::lessAs(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y, std::true_type) {
+  using E1 = typename std::remove_extent<T1>::type;
+  using E2 = typename std::remove_extent<T2>::type;
+
+  return lessEach(x.get(), length(x), y.get(), length(y), typename bitwise<E1, E2>::type());
+}
+
+/**
+ * Return whether an array lexicographically precedes another, comparing elements one by one
+ *
+ * @param p  First array to compare
+ * @param m  Number of elements in the first array
+ * @param q  Second array to compare
+ * @param n  Number of elements in the second array
+ * @param <unnamed>  Tag indicating whether the arrays may be compared as raw bytes
+ * @return whether the first array lexicographically precedes the second
+ */
+template <typename E1, typename E2>
+bool value_compare::lessEach(E1 const *p, std::size_t m, E2 const *q, std::size_t n, std::false_type) {
+  return std::lexicographical_compare(p, p + m, q, q + n);
+}
+
+/**
+ * Return whether an array lexicographically precedes another, locating the first difference as raw bytes
+ *
+ * Only the first differing elements are then compared proper.
+ *
+ * @param p  First array to compare
+ * @param m  Number of elements in the first array
+ * @param q  Second array to compare
+ * @param n  Number of elements in the second array
+ * @param <unnamed>  Tag indicating whether the arrays may be compared as raw bytes
+ * @return whether the first array lexicographically precedes the second
+ */
+template <typename E1, typename E2>
+bool value_compare::lessEach(E1 const *p, std::size_t m, E2 const *q, std::size_t n, std::true_type) {
+  std::size_t common = std::min(m, n);
+  std::size_t i = value_kernels::mismatch(p, q, common * sizeof(E1)) / sizeof(E1);
+
+  return i < common ? p[i] < q[i] : m < n;
+}
+
+/**
+ * Hash the (non-null) pointee of a value_ptr to a scalar
+ *
+ * @param x  Value_ptr to hash
+ * @param <unnamed>  Tag indicating whether the pointee is an array
+ * @return the hash of the pointee
+ */
+template <typename T, typename H>
+std::size_t value_compare::hashAs(value_ptr<T, H> const &x, std::false_type) {
+  return std::hash<typename std::remove_cv<T>::type>()(*x);
+}
+
+/**
+ * Hash the (non-null) pointee of a value_ptr to an array
+ *
+ * @param x  Value_ptr to hash
+ * @param <unnamed>  Tag indicating whether the pointee is an array
+ * @return the hash of the array
+ */
+template <typename T, typename H>
+std::size_t value_compare::hashAs(value_ptr<T, H> const &x, std::true_type) {
+  using E = typename std::remove_extent<T>::type;
+
+  return hashEach(x.get(), length(x), typename bitwise<E, E>::type());
+}
+
+/**
+ * Hash an array, element by element
+ *
+ * @param p  Array to hash
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating whether the array may be hashed as raw bytes
+ * @return the hash of the array
+ */
+template <typename E>
+std::size_t value_compare::hashEach(E const *p, std::size_t n, std::false_type) {
+  std::size_t h = n;
+  for (std::size_t i = 0; i < n; i++) {
+    h = value_kernels::combine(h, std::hash<typename std::remove_cv<E>::type>()(p[i]));
+  }
+  return h;
+}
+
+/**
+ * Hash an array as raw bytes
+ *
+ * @param p  Array to hash
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating whether the array may be hashed as raw bytes
+ * @return the hash of the array
+ */
+template <typename E>
+std::size_t value_compare::hashEach(E const *p, std::size_t n, std::true_type) noexcept {
+  return value_kernels::hash(p, n * sizeof(E));
+}
+
+
+/**
+ * Return whether the pointees of two value_ptrs are equal
+ *
+ * @param x  First value_ptr to compare
+ * @param y  Second value_ptr to compare
+ * @return whether both are null, or their pointees are equal
+ */
+template <typename T1, typename H1, typename T2, typename H2>
+bool value_equal::operator()(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) const {
+  return value_compare::equal(x, y);
+}
+
+/**
+ * Return whether the pointee of a value_ptr is less than that of another
+ *
+ * @param x  First value_ptr to compare
+ * @param y  Second value_ptr to compare
+ * @return whether x orders before y
+ */
+template <typename T1, typename H1, typename T2, typename H2>
+bool value_less::operator()(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) const {
+  return value_compare::less(x, y);
+}
+
+/**
+ * Hash the pointee of a value_ptr
+ *
+ * @param x  Value_ptr to hash
+ * @return the hash of the pointee, or 0 if null
+ */
+template <typename T, typename H>
+std::size_t value_hash::operator()(value_ptr<T, H> const &x) const {
+  return value_compare::hash(x);
+}
+
+#endif /* VALUE_PTR__COMPARE_HPP__ */
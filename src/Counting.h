@@ -0,0 +1,440 @@
+#ifndef VALUE_PTR__COUNTING_H__
+#define VALUE_PTR__COUNTING_H__
+
+
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "Handler.h"
+
+
+/**
+ * Process-wide registry of per-type handler statistics
+ *
+ * Every counted type owns an entry, and every thread counting that type
+ * owns one of the entry's shards: shards are only ever written by their
+ * owning thread (with plain relaxed loads and stores, no read-modify-write
+ * operations), and only read by snapshots, so that counting costs next to
+ * nothing. Shards of exited threads are kept (and reused by later threads),
+ * so that no counts are ever lost.
+ *
+ * Live bytes are exact in snapshots, but their peak is tracked on the entry,
+ * shards publishing their net change once it exceeds slack bytes, and is
+ * thus accurate to within slack bytes per counting thread.
+ *
+ */
+class counting_registry {
+  public:
+    /**
+     * Net change in live bytes a shard accumulates before publishing it
+     *
+     */
+    static constexpr std::int64_t slack = 64 * 1024;
+
+    /**
+     * Statistics for a single type, as summed across shards
+     *
+     * Objects enter the handler's care by being replicated or adopted, and
+     * leave it by being destroyed or released; byte counts are those of the
+     * static type (times the number of elements, for arrays).
+     *
+     */
+    struct snapshot {
+      std::string type;
+      std::uint64_t replicas;
+      std::uint64_t adoptions;
+      std::uint64_t destructions;
+      std::uint64_t releases;
+      std::uint64_t bytes_allocated;
+      std::int64_t live_objects;
+      std::int64_t live_bytes;
+      std::int64_t peak_live_bytes;
+    };
+
+    /**
+     * Per-thread counters for a single type
+     *
+     */
+    struct shard {
+      std::atomic<std::uint64_t> replicas;
+      std::atomic<std::uint64_t> adoptions;
+      std::atomic<std::uint64_t> destructions;
+      std::atomic<std::uint64_t> releases;
+      std::atomic<std::uint64_t> bytes_allocated;
+      std::atomic<std::uint64_t> bytes_adopted;
+      std::atomic<std::uint64_t> bytes_dropped;
+      std::atomic<std::int64_t> pending;
+      shard *next;
+      std::atomic<bool> busy;
+      [[no_unique_address]] explicit_padding<padding_to<sizeof(std::atomic<bool>), alignof(shard *)>::value> padding;
+    };
+
+    /**
+     * Per-type shard list and published live bytes
+     *
+     */
+    struct entry {
+      char const *name;
+      std::atomic<std::int64_t> published;
+      std::atomic<std::int64_t> peak;
+      shard *shards;
+      entry *next;
+    };
+
+    /**
+     * Thread-local holder of a thread's shard for a single type
+     *
+     * Publishes the shard's pending change and hands it back for reuse upon
+     * thread exit.
+     *
+     */
+    struct holder {
+      entry *owner;
+      shard *mine;
+      ~holder() noexcept;
+    };
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    counting_registry(counting_registry const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    counting_registry &operator=(counting_registry const &) = delete;
+
+    /**
+     * Return the process-wide registry
+     *
+     * The registry is never destroyed, so that objects outliving static
+     * destruction may still be counted.
+     *
+     * @return the process-wide registry
+     */
+    static counting_registry &instance();
+
+    /**
+     * Return the entry for the type with the given (mangled) name, creating it if needed
+     *
+     * @param name  Mangled type name, as given by std::type_info::name()
+     * @return the type's entry
+     */
+    entry &enroll(char const *name);
+
+    /**
+     * Return an idle shard of the given entry, creating one if needed
+     *
+     * @param e  Entry to get a shard of
+     * @return an idle shard, now busy
+     */
+    shard &acquire(entry &e);
+
+    /**
+     * Return statistics for the given entry
+     *
+     * @param e  Entry to report
+     * @return the entry's statistics
+     */
+    snapshot report(entry const &e) const;
+
+    /**
+     * Return statistics for every counted type
+     *
+     * @return every type's statistics, in enrollment order
+     */
+    std::vector<snapshot> report() const;
+
+    /**
+     * Print statistics for every counted type as CSV
+     *
+     * @param out  Stream to print to
+     */
+    void dump(std::ostream &out) const;
+
+    /**
+     * Account for a replica of the given size
+     *
+     * @param s  Calling thread's shard
+     * @param e  Shard's entry
+     * @param bytes  Size of the replica
+     */
+    static void replicated(shard &s, entry &e, std::size_t bytes) noexcept;
+
+    /**
+     * Account for an adopted pointee of the given size
+     *
+     * @param s  Calling thread's shard
+     * @param e  Shard's entry
+     * @param bytes  Size of the pointee
+     */
+    static void adopted(shard &s, entry &e, std::size_t bytes) noexcept;
+
+    /**
+     * Account for a destroyed pointee of the given size
+     *
+     * @param s  Calling thread's shard
+     * @param e  Shard's entry
+     * @param bytes  Size of the pointee
+     */
+    static void destroyed(shard &s, entry &e, std::size_t bytes) noexcept;
+
+    /**
+     * Account for a released pointee of the given size
+     *
+     * @param s  Calling thread's shard
+     * @param e  Shard's entry
+     * @param bytes  Size of the pointee
+     */
+    static void released(shard &s, entry &e, std::size_t bytes) noexcept;
+
+  protected:
+    /**
+     * Constructor
+     *
+     */
+    counting_registry() noexcept;
+
+    /**
+     * Destructor
+     *
+     */
+    ~counting_registry() noexcept = default;
+
+    /**
+     * Increment a shard counter (owning thread only)
+     *
+     * @param counter  Counter to increment
+     * @param delta  Amount to increment by
+     */
+    static void bump(std::atomic<std::uint64_t> &counter, std::uint64_t delta) noexcept;
+
+    /**
+     * Add to a shard's pending change, publishing it once it exceeds the slack
+     *
+     * @param s  Calling thread's shard
+     * @param e  Shard's entry
+     * @param delta  Change in live bytes
+     */
+    static void account(shard &s, entry &e, std::int64_t delta) noexcept;
+
+    /**
+     * Publish a shard's pending change to its entry, updating the peak
+     *
+     * @param s  Calling thread's shard
+     * @param e  Shard's entry
+     */
+    static void publish(shard &s, entry &e) noexcept;
+
+    /**
+     * Return the demangled form of the given type name
+     *
+     * @param name  Mangled type name
+     * @return the demangled name (or the mangled one, should demangling fail)
+     */
+    static std::string demangle(char const *name);
+
+    /**
+     * Guard for the entry and shard lists
+     *
+     */
+    mutable std::mutex lock;
+
+    /**
+     * Entry list, most recently enrolled first
+     *
+     */
+    entry *entries;
+};
+
+
+/**
+ * Metaprogramming class counting the replications and destructions performed by another handler
+ *
+ * This handler behaves as the given one, forwarding every call to it, but
+ * records per-type call counts, bytes allocated, live objects and peak live
+ * bytes in the counting_registry. Objects obtained otherwise (eg. by the
+ * given handler's in-place assignment or detachment) are not counted.
+ *
+ * @param T  Underlying type this class handles
+ * @param H  Handler to forward to (default_handler<T, ABI> by default)
+ * @param ABI  ABI adapter class to use to determine array sizes (Itanium by default)
+ */
+template <typename T, typename H = default_handler<T>, typename ABI = Itanium>
+struct counting_handler : public H {
+  using H::H;
+
+  /**
+   * Pointee type, the element type for arrays
+   *
+   */
+  using element_type = typename std::remove_extent<T>::type;
+
+  /**
+   * Adoption implementation
+   *
+   * Counts the adopted pointee and forwards to the given handler's "adopt"
+   * method, if any.
+   *
+   * @param T2  Static type of the adopted pointee
+   * @param p  Pointer to the adopted pointee
+   */
+  template <typename T2>
+  void adopt(T2 const *p);
+
+  /**
+   * Construction implementation
+   *
+   * Forwards to the given handler's "construct" method, if any (and
+   * otherwise constructs the pointee through default_construct and lets the
+   * given handler adopt it), counting the new pointee as adopted.
+   *
+   * @param T2  Type of the pointee to construct
+   * @param args  Arguments to construct the pointee from
+   * @return a new pointee constructed from args
+   */
+  template <typename T2, typename... Args>
+  typename std::remove_extent<T2>::type *construct(Args&&... args);
+
+  /**
+   * Replication implementation
+   *
+   * @param p  Pointer to the object to replicate
+   * @return either nullptr if nullptr is given, or a replica of p
+   */
+  element_type *replicate(element_type const *p);
+
+  /**
+   * Destruction implementation
+   *
+   * @param p  Pointer to the object to destroy
+   */
+  void destroy(element_type const *p);
+
+  /**
+   * Release implementation
+   *
+   * Counts the released pointee and forwards to the given handler's
+   * "release" method, if any.
+   *
+   * @param p  Pointer to the object to release
+   * @return a pointer no longer bound to the handler
+   */
+  element_type *release(element_type *p);
+
+  /**
+   * Return the statistics for the underlying type
+   *
+   * @return the statistics for the underlying type
+   */
+  static counting_registry::snapshot statistics();
+
+  protected:
+    /**
+     * Return the underlying type's registry entry
+     *
+     * @return the underlying type's registry entry
+     */
+    static counting_registry::entry &entry();
+
+    /**
+     * Return the calling thread's shard for the underlying type
+     *
+     * @return the calling thread's shard
+     */
+    static counting_registry::shard &shard();
+
+    /**
+     * Return the size of an object or fixed array
+     *
+     * @param <unnamed>  Pointer to the object
+     * @param <unnamed>  Tag indicating a statically known size
+     * @return the size of the object
+     */
+    static constexpr std::size_t bytes(element_type const *, std::true_type) noexcept __attribute__((const));
+
+    /**
+     * Return the size of an array
+     *
+     * @param p  Pointer to the array
+     * @param <unnamed>  Tag indicating a statically known size
+     * @return the size of the array
+     */
+    static std::size_t bytes(element_type const *p, std::false_type) noexcept __attribute__((pure));
+
+    /**
+     * Forward to the given handler's "adopt" method
+     *
+     * This overload is only viable if the handler does provide an "adopt"
+     * method.
+     *
+     * @param h  Handler to forward to
+     * @param p  Pointer to the adopted pointee
+     */
+    template <typename H2, typename T2> static auto forwardAdopt(H2 &h, T2 const *p, int) -> decltype(h.adopt(p));
+
+    /**
+     * Fallback for handlers lacking an "adopt" method
+     *
+     */
+    template <typename H2, typename T2> static constexpr void forwardAdopt(H2 &, T2 const *, long) noexcept;
+
+    /**
+     * Forward to the given handler's "construct" method
+     *
+     * This overload is only viable if the handler does provide a "construct"
+     * method.
+     *
+     * @param h  Handler to forward to
+     * @param args  Arguments to construct the pointee from
+     * @return a new pointee constructed from args
+     */
+    template <typename T2, typename H2, typename... Args> static auto forwardConstruct(H2 &h, int, Args&&... args) -> decltype(h.template construct<T2>(std::forward<Args>(args)...));
+
+    /**
+     * Fallback for handlers lacking a "construct" method
+     *
+     * Constructs the pointee through default_construct and lets the given
+     * handler adopt it, deleting it should that throw.
+     *
+     * @param h  Handler to forward to
+     * @param args  Arguments to construct the pointee from
+     * @return a new pointee constructed from args
+     */
+    template <typename T2, typename H2, typename... Args> static typename std::remove_extent<T2>::type *forwardConstruct(H2 &h, long, Args&&... args);
+
+    /**
+     * Forward to the given handler's "release" method
+     *
+     * This overload is only viable if the handler does provide a "release"
+     * method.
+     *
+     * @param h  Handler to forward to
+     * @param p  Pointer to the released pointee
+     * @return a pointer no longer bound to the handler
+     */
+    template <typename H2> static auto forwardRelease(H2 &h, element_type *p, int) -> decltype(h.release(p));
+
+    /**
+     * Fallback for handlers lacking a "release" method
+     *
+     * @param <unnamed>  Handler
+     * @param p  Pointer to the released pointee
+     * @return p
+     */
+    template <typename H2> static constexpr element_type *forwardRelease(H2 &, element_type *p, long) noexcept __attribute__((const));
+};
+
+
+#include "Counting.hpp"
+
+#endif /* VALUE_PTR__COUNTING_H__ */
@@ -0,0 +1,500 @@
+#ifndef VALUE_PTR__COUNTING_HPP__
+#define VALUE_PTR__COUNTING_HPP__
+
+
+#include "Counting.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <typeinfo>
+#include <cxxabi.h>
+
+
+/**
+ * Destructor
+ *
+ * Publishes the shard's pending change and hands it back for reuse.
+ *
+ */
+inline counting_registry::holder::~holder() noexcept {
+  if (nullptr != mine) {
+    publish(*mine, *owner);
+    mine->busy.store(false, std::memory_order_release);
+    mine = nullptr;
+  }
+}
+
+/**
+ * Return the process-wide registry
+ *
+ * The registry is never destroyed, so that objects outliving static
+ * destruction may still be counted.
+ *
+ * @return the process-wide registry
+ */
+inline counting_registry &counting_registry::instance() {
+  static counting_registry *registry = new counting_registry();
+  return *registry;
+}
+
+/**
+ * Return the entry for the type with the given (mangled) name, creating it if needed
+ *
+ * @param name  Mangled type name, as given by std::type_info::name()
+ * @return the type's entry
+ */
+inline counting_registry::entry &counting_registry::enroll(char const *name) {
+  std::lock_guard<std::mutex> guard(lock);
+
+  for (entry *e = entries; nullptr != e; e = e->next) {
+    if (0 == std::strcmp(name, e->name)) {
+      return *e;
+    }
+  }
+
+  entries = new entry{name, {0}, {0}, nullptr, entries};
+  return *entries;
+}
+
+/**
+ * Return an idle shard of the given entry, creating one if needed
+ *
+ * @param e  Entry to get a shard of
+ * @return an idle shard, now busy
+ */
+inline counting_registry::shard &counting_registry::acquire(counting_registry::entry &e) {
+  std::lock_guard<std::mutex> guard(lock);
+
+  for (shard *s = e.shards; nullptr != s; s = s->next) {
+    bool idle = false;
+    if (s->busy.compare_exchange_strong(idle, true, std::memory_order_acquire)) {
+      return *s;
+    }
+  }
+
+  e.shards = new shard{{0}, {0}, {0}, {0}, {0}, {0}, {0}, {0}, e.shards, {true}, {}};
+  return *e.shards;
+}
+
+/**
+ * Return statistics for the given entry
+ *
+ * @param e  Entry to report
+ * @return the entry's statistics
+ */
+inline counting_registry::snapshot counting_registry::report(counting_registry::entry const &e) const {
+  snapshot ret = {demangle(e.name), 0, 0, 0, 0, 0, 0, 0, 0};
+  std::uint64_t in = 0, out = 0;
+
+  std::lock_guard<std::mutex> guard(lock);
+  for (shard const *s = e.shards; nullptr != s; s = s->next) {
+    ret.replicas        += s->replicas.load(std::memory_order_relaxed);
+    ret.adoptions       += s->adoptions.load(std::memory_order_relaxed);
+    ret.destructions    += s->destructions.load(std::memory_order_relaxed);
+    ret.releases        += s->releases.load(std::memory_order_relaxed);
+    ret.bytes_allocated += s->bytes_allocated.load(std::memory_order_relaxed);
+    in                  += s->bytes_allocated.load(std::memory_order_relaxed) + s->bytes_adopted.load(std::memory_order_relaxed);
+    out                 += s->bytes_dropped.load(std::memory_order_relaxed);
+  }
+
+  ret.live_objects = static_cast<std::int64_t>(ret.replicas + ret.adoptions - ret.destructions - ret.releases);
+  ret.live_bytes = static_cast<std::int64_t>(in - out);
+  ret.peak_live_bytes = std::max(e.peak.load(std::memory_order_relaxed), ret.live_bytes);
+
+  return ret;
+}
+
+/**
+ * Return statistics for every counted type
+ *
+ * @return every type's statistics, in enrollment order
+ */
+inline std::vector<counting_registry::snapshot> counting_registry::report() const {
+  std::vector<entry const *> all;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    for (entry const *e = entries; nullptr != e; e = e->next) {
+      all.push_back(e);
+    }
+  }
+
+  std::vector<snapshot> ret;
+  for (auto e = all.rbegin(); e != all.rend(); ++e) {
+    ret.push_back(report(**e));
+  }
+
+  return ret;
+}
+
+/**
+ * Print statistics for every counted type as CSV
+ *
+ * @param out  Stream to print to
+ */
+inline void counting_registry::dump(std::ostream &out) const {
+  out << "type,replicas,adoptions,destructions,releases,bytes_allocated,live_objects,live_bytes,peak_live_bytes" << '\n';
+  for (snapshot const &s : report()) {
+    out << '"' << s.type << '"' << ',' << s.replicas << ',' << s.adoptions << ',' << s.destructions << ',' << s.releases << ',' << s.bytes_allocated << ',' << s.live_objects << ',' << s.live_bytes << ',' << s.peak_live_bytes << '\n';
+  }
+  out.flush();
+}
+
+/**
+ * Account for a replica of the given size
+ *
+ * @param s  Calling thread's shard
+ * @param e  Shard's entry
+ * @param bytes  Size of the replica
+ */
+inline void counting_registry::replicated(counting_registry::shard &s, counting_registry::entry &e, std::size_t bytes) noexcept {
+  bump(s.replicas, 1);
+  bump(s.bytes_allocated, bytes);
+  account(s, e, static_cast<std::int64_t>(bytes));
+}
+
+/**
+ * Account for an adopted pointee of the given size
+ *
+ * @param s  Calling thread's shard
+ * @param e  Shard's entry
+ * @param bytes  Size of the pointee
+ */
+inline void counting_registry::adopted(counting_registry::shard &s, counting_registry::entry &e, std::size_t bytes) noexcept {
+  bump(s.adoptions, 1);
+  bump(s.bytes_adopted, bytes);
+  account(s, e, static_cast<std::int64_t>(bytes));
+}
+
+/**
+ * Account for a destroyed pointee of the given size
+ *
+ * @param s  Calling thread's shard
+ * @param e  Shard's entry
+ * @param bytes  Size of the pointee
+ */
+inline void counting_registry::destroyed(counting_registry::shard &s, counting_registry::entry &e, std::size_t bytes) noexcept {
+  bump(s.destructions, 1);
+  bump(s.bytes_dropped, bytes);
+  account(s, e, -static_cast<std::int64_t>(bytes));
+}
+
+/**
+ * Account for a released pointee of the given size
+ *
+ * @param s  Calling thread's shard
+ * @param e  Shard's entry
+ * @param bytes  Size of the pointee
+ */
+inline void counting_registry::released(counting_registry::shard &s, counting_registry::entry &e, std::size_t bytes) noexcept {
+  bump(s.releases, 1);
+  bump(s.bytes_dropped, bytes);
+  account(s, e, -static_cast<std::int64_t>(bytes));
+}
+
+/**
+ * Constructor
+ *
+ */
+inline counting_registry::counting_registry() noexcept : lock(), entries(nullptr) {}
+
+/**
+ * Increment a shard counter (owning thread only)
+ *
+ * @param counter  Counter to increment
+ * @param delta  Amount to increment by
+ */
+inline void counting_registry::bump(std::atomic<std::uint64_t> &counter, std::uint64_t delta) noexcept {
+  counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+/**
+ * Add to a shard's pending change, publishing it once it exceeds the slack
+ *
+ * @param s  Calling thread's shard
+ * @param e  Shard's entry
+ * @param delta  Change in live bytes
+ */
+inline void counting_registry::account(counting_registry::shard &s, counting_registry::entry &e, std::int64_t delta) noexcept {
+  std::int64_t pending = s.pending.load(std::memory_order_relaxed) + delta;
+  s.pending.store(pending, std::memory_order_relaxed);
+  if (pending > slack || pending < -slack) {
+    publish(s, e);
+  }
+}
+
+/**
+ * Publish a shard's pending change to its entry, updating the peak
+ *
+ * @param s  Calling thread's shard
+ * @param e  Shard's entry
+ */
+inline void counting_registry::publish(counting_registry::shard &s, counting_registry::entry &e) noexcept {
+  std::int64_t delta = s.pending.load(std::memory_order_relaxed);
+  s.pending.store(0, std::memory_order_relaxed);
+
+  std::int64_t now = e.published.fetch_add(delta, std::memory_order_relaxed) + delta;
+  std::int64_t peak = e.peak.load(std::memory_order_relaxed);
+  while (now > peak && !e.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+/**
+ * Return the demangled form of the given type name
+ *
+ * @param name  Mangled type name
+ * @return the demangled name (or the mangled one, should demangling fail)
+ */
+inline std::string counting_registry::demangle(char const *name) {
+  int status = 0;
+  char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  std::string ret = 0 == status && nullptr != demangled ? demangled : name;
+  std::free(demangled);
+
+  return ret;
+}
+
+
+
+/**
+ * Adoption implementation
+ *
+ * Counts the adopted pointee and forwards to the given handler's "adopt"
+ * method, if any.
+ *
+ * @param T2  Static type of the adopted pointee
+ * @param p  Pointer to the adopted pointee
+ */
+template <typename T, typename H, typename ABI>
+template <typename T2>
+void counting_handler<T, H, ABI>::adopt(T2 const *p) {
+  forwardAdopt(static_cast<H &>(*this), p, 0);
+  counting_registry::adopted(shard(), entry(), bytes(p, typename condition<0 == std::rank<T>::value || 0 != std::extent<T>::value>::type()));
+}
+
+/**
+ * Construction implementation
+ *
+ * Forwards to the given handler's "construct" method, if any (and
+ * otherwise constructs the pointee through default_construct and lets the
+ * given handler adopt it), counting the new pointee as adopted.
+ *
+ * @param T2  Type of the pointee to construct
+ * @param args  Arguments to construct the pointee from
+ * @return a new pointee constructed from args
+ */
+template <typename T, typename H, typename ABI>
+template <typename T2, typename... Args>
+typename std::remove_extent<T2>::type *counting_handler<T, H, ABI>::construct(Args&&... args) {
+  typename std::remove_extent<T2>::type *ret = forwardConstruct<T2>(static_cast<H &>(*this), 0, std::forward<Args>(args)...);
+  counting_registry::adopted(shard(), entry(), bytes(ret, typename condition<0 == std::rank<T>::value || 0 != std::extent<T>::value>::type()));
+
+  return ret;
+}
+
+/**
+ * Replication implementation
+ *
+ * @param p  Pointer to the object to replicate
+ * @return either nullptr if nullptr is given, or a replica of p
+ */
+template <typename T, typename H, typename ABI>
+typename counting_handler<T, H, ABI>::element_type *counting_handler<T, H, ABI>::replicate(typename counting_handler<T, H, ABI>::element_type const *p) {
+  element_type *ret = H::replicate(p);
+  if (nullptr != ret) {
+    counting_registry::replicated(shard(), entry(), bytes(ret, typename condition<0 == std::rank<T>::value || 0 != std::extent<T>::value>::type()));
+  }
+
+  return ret;
+}
+
+/**
+ * Destruction implementation
+ *
+ * @param p  Pointer to the object to destroy
+ */
+template <typename T, typename H, typename ABI>
+void counting_handler<T, H, ABI>::destroy(typename counting_handler<T, H, ABI>::element_type const *p) {
+  if (nullptr != p) {
+    counting_registry::destroyed(shard(), entry(), bytes(p, typename condition<0 == std::rank<T>::value || 0 != std::extent<T>::value>::type()));
+  }
+  H::destroy(p);
+}
+
+/**
+ * Release implementation
+ *
+ * Counts the released pointee and forwards to the given handler's
+ * "release" method, if any.
+ *
+ * @param p  Pointer to the object to release
+ * @return a pointer no longer bound to the handler
+ */
+template <typename T, typename H, typename ABI>
+typename counting_handler<T, H, ABI>::element_type *counting_handler<T, H, ABI>::release(typename counting_handler<T, H, ABI>::element_type *p) {
+  if (nullptr != p) {
+    counting_registry::released(shard(), entry(), bytes(p, typename condition<0 == std::rank<T>::value || 0 != std::extent<T>::value>::type()));
+  }
+
+  return forwardRelease(static_cast<H &>(*this), p, 0);
+}
+
+/**
+ * Return the statistics for the underlying type
+ *
+ * @return the statistics for the underlying type
+ */
+template <typename T, typename H, typename ABI>
+counting_registry::snapshot counting_handler<T, H, ABI>::statistics() {
+  return counting_registry::instance().report(entry());
+}
+
+/**
+ * Return the underlying type's registry entry
+ *
+ * @return the underlying type's registry entry
+ */
+template <typename T, typename H, typename ABI>
+counting_registry::entry &counting_handler<T, H, ABI>::entry() {
+  static counting_registry::entry &e = counting_registry::instance().enroll(typeid(T).name());
+  return e;
+}
+
+/**
+ * Return the calling thread's shard for the underlying type
+ *
+ * The shard is cached in a trivially destructible thread-local pointer, so
+ * that the common path needs no thread-local initialization guard; the
+ * holder handing it back upon thread exit is only touched on first use.
+ *
+ * @return the calling thread's shard
+ */
+template <typename T, typename H, typename ABI>
+counting_registry::shard &counting_handler<T, H, ABI>::shard() {
+  static thread_local counting_registry::shard *mine = nullptr;
+  if (__builtin_expect(nullptr == mine, 0)) {
+    static thread_local counting_registry::holder h = { nullptr, nullptr };
+    h.owner = &entry();
+    h.mine = mine = &counting_registry::instance().acquire(*h.owner);
+  }
+
+  return *mine;
+}
+
+/**
+ * Return the size of an object or fixed array
+ *
+ * @param <unnamed>  Pointer to the object
+ * @param <unnamed>  Tag indicating a statically known size
+ * @return the size of the object
+ */
+template <typename T, typename H, typename ABI>
+constexpr std::size_t counting_handler<T, H, ABI>::bytes(typename counting_handler<T, H, ABI>::element_type const *, std::true_type) noexcept {
+  return sizeof(T);
+}
+
+/**
+ * Return the size of an array
+ *
+ * @param p  Pointer to the array
+ * @param <unnamed>  Tag indicating a statically known size
+ * @return the size of the array
+ */
+template <typename T, typename H, typename ABI>
+std::size_t counting_handler<T, H, ABI>::bytes(typename counting_handler<T, H, ABI>::element_type const *p, std::false_type) noexcept {
+  return ABI::template arraySize<element_type>(p) * sizeof(element_type);
+}
+
+/**
+ * Forward to the given handler's "adopt" method
+ *
+ * This overload is only viable if the handler does provide an "adopt"
+ * method.
+ *
+ * @param h  Handler to forward to
+ * @param p  Pointer to the adopted pointee
+ */
+template <typename T, typename H, typename ABI>
+template <typename H2, typename T2>
+auto counting_handler<T, H, ABI>::forwardAdopt(H2 &h, T2 const *p, int) -> decltype(h.adopt(p)) {
+  return h.adopt(p);
+}
+
+/**
+ * Fallback for handlers lacking an "adopt" method
+ *
+ */
+template <typename T, typename H, typename ABI>
+template <typename H2, typename T2>
+constexpr void counting_handler<T, H, ABI>::forwardAdopt(H2 &, T2 const *, long) noexcept {}
+
+/**
+ * Forward to the given handler's "construct" method
+ *
+ * This overload is only viable if the handler does provide a "construct"
+ * method.
+ *
+ * @param h  Handler to forward to
+ * @param args  Arguments to construct the pointee from
+ * @return a new pointee constructed from args
+ */
+template <typename T, typename H, typename ABI>
+template <typename T2, typename H2, typename... Args>
+auto counting_handler<T, H, ABI>::forwardConstruct(H2 &h, int, Args&&... args) -> decltype(h.template construct<T2>(std::forward<Args>(args)...)) {
+  return h.template construct<T2>(std::forward<Args>(args)...);
+}
+
+/**
+ * Fallback for handlers lacking a "construct" method
+ *
+ * Constructs the pointee through default_construct and lets the given
+ * handler adopt it, deleting it should that throw.
+ *
+ * @param h  Handler to forward to
+ * @param args  Arguments to construct the pointee from
+ * @return a new pointee constructed from args
+ */
+template <typename T, typename H, typename ABI>
+template <typename T2, typename H2, typename... Args>
+typename std::remove_extent<T2>::type *counting_handler<T, H, ABI>::forwardConstruct(H2 &h, long, Args&&... args) {
+  typename std::remove_extent<T2>::type *ret = default_construct<T, ABI>().template construct<T2>(std::forward<Args>(args)...);
+
+  try {
+    forwardAdopt(h, ret, 0);
+  } catch (...) {
+    default_destroy<T, ABI>().destroy(ret);
+    throw;
+  }
+
+  return ret;
+}
+
+/**
+ * Forward to the given handler's "release" method
+ *
+ * This overload is only viable if the handler does provide a "release"
+ * method.
+ *
+ * @param h  Handler to forward to
+ * @param p  Pointer to the released pointee
+ * @return a pointer no longer bound to the handler
+ */
+template <typename T, typename H, typename ABI>
+template <typename H2>
+auto counting_handler<T, H, ABI>::forwardRelease(H2 &h, typename counting_handler<T, H, ABI>::element_type *p, int) -> decltype(h.release(p)) {
+  return h.release(p);
+}
+
+/**
+ * Fallback for handlers lacking a "release" method
+ *
+ * @param <unnamed>  Handler
+ * @param p  Pointer to the released pointee
+ * @return p
+ */
+template <typename T, typename H, typename ABI>
+template <typename H2>
+constexpr typename counting_handler<T, H, ABI>::element_type *counting_handler<T, H, ABI>::forwardRelease(H2 &, typename counting_handler<T, H, ABI>::element_type *p, long) noexcept {
+  return p;
+}
+
+#endif /* VALUE_PTR__COUNTING_HPP__ */
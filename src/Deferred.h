@@ -0,0 +1,319 @@
+#ifndef VALUE_PTR__DEFERRED_H__
+#define VALUE_PTR__DEFERRED_H__
+
+
+#include <type_traits>
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "Handler.h"
+
+
+/**
+ * Process-wide background reclaimer running deferred destructions
+ *
+ * Destructions are pushed onto a bounded lock-free queue, and run in order
+ * by a background thread started upon the first push. Should the queue be
+ * full, the push fails and the caller is expected to destroy the object
+ * itself: producers thus pay for teardown themselves once the reclaimer
+ * falls behind, instead of queueing unboundedly.
+ *
+ * The reclaimer is never destroyed, and is stopped upon program exit (after
+ * running every pending destruction), destructions being run inline by
+ * their callers from then on; should the background thread fail to start,
+ * every destruction is likewise run inline.
+ *
+ */
+class reclaimer {
+  public:
+    /**
+     * Number of destructions the queue can hold (a power of 2)
+     *
+     */
+    static constexpr std::size_t capacity = 4096;
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    reclaimer(reclaimer const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    reclaimer &operator=(reclaimer const &) = delete;
+
+    /**
+     * Return the process-wide reclaimer
+     *
+     * @return the process-wide reclaimer
+     */
+    static reclaimer &instance();
+
+    /**
+     * Queue a destruction
+     *
+     * May be called from any thread.
+     *
+     * @param run  Function destroying its argument, must not throw
+     * @param p  Pointer to the object to destroy
+     * @return whether the destruction was queued (if not, the caller is to destroy the object)
+     */
+    bool defer(void (*run)(void const *), void const *p) noexcept;
+
+    /**
+     * Wait until every destruction queued before the call has been run
+     *
+     * Must not be called from within a deferred destruction.
+     *
+     */
+    void flush() noexcept;
+
+    /**
+     * Return the number of queued destructions not yet run
+     *
+     * @return the number of queued destructions not yet run
+     */
+    std::size_t pending() const noexcept __attribute__((pure));
+
+    /**
+     * Return the number of destructions refused because the queue was full
+     *
+     * @return the number of refused destructions
+     */
+    std::size_t overflows() const noexcept __attribute__((pure));
+
+  protected:
+    /**
+     * Reclaimer states
+     *
+     */
+    enum : int { idle, running, stopped };
+
+    /**
+     * Background thread sleep depths
+     *
+     * A dozing thread wakes up on its own after doze(), and is only woken
+     * up earlier by producers should the queue fill up past a quarter of
+     * its capacity; a thread that dozed off without anything left to do
+     * falls asleep, and is woken up by the next producer.
+     *
+     */
+    enum : int { awake, dozing, asleep };
+
+    /**
+     * Return the time a dozing background thread waits for work
+     *
+     * @return the time a dozing background thread waits for work
+     */
+    static constexpr std::chrono::milliseconds doze() noexcept __attribute__((const));
+
+    /**
+     * Queued destruction
+     *
+     */
+    struct task {
+      void (*run)(void const *);
+      void const *p;
+    };
+
+    /**
+     * Queue cell, its sequence number telling whether it is free or full for a given position
+     *
+     */
+    struct cell {
+      std::atomic<std::size_t> sequence{0};
+      task job{nullptr, nullptr};
+    };
+
+    /**
+     * Constructor
+     *
+     */
+    reclaimer() noexcept;
+
+    /**
+     * Destructor
+     *
+     */
+    ~reclaimer() noexcept = default;
+
+    /**
+     * Create the process-wide reclaimer, arranging for it to be stopped upon exit
+     *
+     * @return the process-wide reclaimer
+     */
+    static reclaimer *create();
+
+    /**
+     * Stop the process-wide reclaimer (registered with std::atexit)
+     *
+     */
+    static void shutdown() noexcept;
+
+    /**
+     * Start the background thread, if not yet started
+     *
+     * @return whether the background thread is running
+     */
+    bool start() noexcept;
+
+    /**
+     * Stop the background thread and run every pending destruction on the calling thread
+     *
+     */
+    void stop() noexcept;
+
+    /**
+     * Background thread body
+     *
+     */
+    void work() noexcept;
+
+    /**
+     * Run queued destructions until the queue is empty (consumer only)
+     *
+     * @return whether any destruction was run
+     */
+    bool drain() noexcept;
+
+    /**
+     * Return whether the next destruction to run has been queued (consumer only)
+     *
+     * @return whether the queue holds a destruction ready to run
+     */
+    bool ready() const noexcept;
+
+    /**
+     * Wake the background thread up
+     *
+     */
+    void wake() noexcept;
+
+    /**
+     * Next position to be claimed by producers
+     *
+     */
+    std::atomic<std::size_t> tail;
+
+    /**
+     * Number of refused destructions
+     *
+     */
+    std::atomic<std::size_t> spilled;
+
+    /**
+     * Queue cells
+     *
+     */
+    cell cells[capacity];
+
+    /**
+     * Next position to be run, ie. the number of destructions run so far
+     *
+     */
+    std::atomic<std::size_t> head;
+
+    /**
+     * Current state
+     *
+     */
+    std::atomic<int> state;
+
+    /**
+     * How deeply the background thread is (about to start) waiting for work
+     *
+     */
+    std::atomic<int> sleeping;
+
+    /**
+     * Number of threads waiting in flush
+     *
+     */
+    std::atomic<std::size_t> flushing;
+
+    /**
+     * Guard for state changes and condition variables
+     *
+     */
+    std::mutex lock;
+
+    /**
+     * Condition the background thread waits on for work
+     *
+     */
+    std::condition_variable wakeup;
+
+    /**
+     * Condition flushing threads wait on for progress
+     *
+     */
+    std::condition_variable drained;
+
+    /**
+     * Background thread
+     *
+     */
+    std::thread worker;
+};
+
+
+/**
+ * Metaprogramming class deferring the destructions performed by another handler to the background reclaimer
+ *
+ * This handler behaves as the given one, except that destroying a pointee
+ * merely queues it, so that (eg. deep trees or large arrays) teardown costs
+ * are moved off the calling thread; should the reclaimer's queue be full,
+ * the pointee is destroyed inline. Pointees are thus destroyed on another
+ * thread, at an unspecified later time: their destructors must not depend
+ * on the destroying thread's state.
+ *
+ * Since queued destructions are run by a default-constructed handler, the
+ * given handler must be stateless.
+ *
+ * @param T  Underlying type this class handles
+ * @param H  Handler to forward to (default_handler<T, Itanium> by default)
+ */
+template <typename T, typename H = default_handler<T>>
+struct deferred_handler : public H {
+  static_assert(std::is_empty<H>::value && std::is_default_constructible<H>::value, "deferred_handler requires a stateless handler");
+
+  using H::H;
+
+  /**
+   * Pointee type, the element type for arrays
+   *
+   */
+  using element_type = typename std::remove_extent<T>::type;
+
+  /**
+   * Destruction implementation
+   *
+   * @param p  Pointer to the object to destroy
+   */
+  void destroy(element_type const *p);
+
+  /**
+   * Wait until every destruction queued before the call has been run
+   *
+   */
+  static void flush() noexcept;
+
+  protected:
+    /**
+     * Destroy a queued pointee
+     *
+     * @param p  Pointer to the object to destroy
+     */
+    static void reclaim(void const *p) noexcept;
+};
+
+
+#include "Deferred.hpp"
+
+#endif /* VALUE_PTR__DEFERRED_H__ */
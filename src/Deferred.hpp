@@ -0,0 +1,300 @@
+#ifndef VALUE_PTR__DEFERRED_HPP__
+#define VALUE_PTR__DEFERRED_HPP__
+
+
+#include "Deferred.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+
+/**
+ * Return the process-wide reclaimer
+ *
+ * @return the process-wide reclaimer
+ */
+inline reclaimer &reclaimer::instance() {
+  static reclaimer *r = create();
+  return *r;
+}
+
+/**
+ * Queue a destruction
+ *
+ * May be called from any thread.
+ *
+ * @param run  Function destroying its argument, must not throw
+ * @param p  Pointer to the object to destroy
+ * @return whether the destruction was queued (if not, the caller is to destroy the object)
+ */
+inline bool reclaimer::defer(void (*run)(void const *), void const *p) noexcept {
+  if (running != state.load(std::memory_order_acquire) && !start()) {
+    return false;
+  }
+
+  std::size_t pos = tail.load(std::memory_order_relaxed);
+  cell *c;
+  for (;;) {
+    c = &cells[pos & (capacity - 1)];
+    std::intptr_t diff = static_cast<std::intptr_t>(c->sequence.load(std::memory_order_acquire) - pos);
+    if (0 == diff) {
+      if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      spilled.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = tail.load(std::memory_order_relaxed);
+    }
+  }
+
+  c->job = task{run, p};
+  c->sequence.store(pos + 1, std::memory_order_release);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int depth = sleeping.load(std::memory_order_relaxed);
+  if (asleep == depth || (dozing == depth && pos - head.load(std::memory_order_relaxed) >= capacity / 4)) {
+    wake();
+  }
+
+  return true;
+}
+
+/**
+ * Wait until every destruction queued before the call has been run
+ *
+ * Must not be called from within a deferred destruction.
+ *
+ */
+inline void reclaimer::flush() noexcept {
+  if (running != state.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  std::size_t target = tail.load(std::memory_order_seq_cst);
+  flushing.fetch_add(1, std::memory_order_seq_cst);
+  wake();
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    drained.wait(guard, [this, target]() { return target <= head.load(std::memory_order_seq_cst) || stopped == state.load(std::memory_order_relaxed); });
+  }
+  flushing.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/**
+ * Return the number of queued destructions not yet run
+ *
+ * @return the number of queued destructions not yet run
+ */
+inline std::size_t reclaimer::pending() const noexcept {
+  std::size_t done = head.load(std::memory_order_relaxed);
+  std::size_t claimed = tail.load(std::memory_order_relaxed);
+  return claimed > done ? claimed - done : 0;
+}
+
+/**
+ * Return the number of destructions refused because the queue was full
+ *
+ * @return the number of refused destructions
+ */
+inline std::size_t reclaimer::overflows() const noexcept {
+  return spilled.load(std::memory_order_relaxed);
+}
+
+/**
+ * Constructor
+ *
+ */
+inline reclaimer::reclaimer() noexcept : tail(0), spilled(0), cells(), head(0), state(idle), sleeping(awake), flushing(0), lock(), wakeup(), drained(), worker() {
+  for (std::size_t i = 0; i < capacity; i++) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * Return the time a dozing background thread waits for work
+ *
+ * @return the time a dozing background thread waits for work
+ */
+inline constexpr std::chrono::milliseconds reclaimer::doze() noexcept {
+  return std::chrono::milliseconds(1);
+}
+
+/**
+ * Create the process-wide reclaimer, arranging for it to be stopped upon exit
+ *
+ * Objects destroyed during static destruction after the reclaimer has been
+ * stopped are destroyed inline, the reclaimer itself never being deleted.
+ *
+ * @return the process-wide reclaimer
+ */
+inline reclaimer *reclaimer::create() {
+  reclaimer *ret = new reclaimer();
+  std::atexit(&reclaimer::shutdown);
+  return ret;
+}
+
+/**
+ * Stop the process-wide reclaimer (registered with std::atexit)
+ *
+ */
+inline void reclaimer::shutdown() noexcept {
+  instance().stop();
+}
+
+/**
+ * Start the background thread, if not yet started
+ *
+ * Should the thread fail to start, the reclaimer is stopped for good.
+ *
+ * @return whether the background thread is running
+ */
+inline bool reclaimer::start() noexcept {
+  std::lock_guard<std::mutex> guard(lock);
+
+  if (idle == state.load(std::memory_order_relaxed)) {
+    try {
+      worker = std::thread(&reclaimer::work, this);
+      state.store(running, std::memory_order_release);
+    } catch (...) {
+      state.store(stopped, std::memory_order_release);
+    }
+  }
+
+  return running == state.load(std::memory_order_relaxed);
+}
+
+/**
+ * Stop the background thread and run every pending destruction on the calling thread
+ *
+ */
+inline void reclaimer::stop() noexcept {
+  bool join;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    join = running == state.load(std::memory_order_relaxed);
+    state.store(stopped, std::memory_order_release);
+    wakeup.notify_one();
+    drained.notify_all();
+  }
+
+  if (join) {
+    worker.join();
+    drain();
+  }
+}
+
+/**
+ * Background thread body
+ *
+ * Runs queued destructions, and waits whenever the queue is empty: dozing
+ * if it just ran some (so that producers under steady load need not wake
+ * it up), and sleeping otherwise.
+ *
+ */
+inline void reclaimer::work() noexcept {
+  for (;;) {
+    int depth = drain() ? dozing : asleep;
+
+    std::unique_lock<std::mutex> guard(lock);
+    if (stopped == state.load(std::memory_order_relaxed)) {
+      return;
+    }
+    sleeping.store(depth, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ready()) {
+      if (dozing == depth) {
+        wakeup.wait_for(guard, doze());
+      } else {
+        wakeup.wait(guard);
+      }
+    }
+    sleeping.store(awake, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * Run queued destructions until the queue is empty (consumer only)
+ *
+ * Cells are handed back to producers before their destruction is run, so
+ * that a long destruction does not hold up the queue.
+ *
+ * @return whether any destruction was run
+ */
+inline bool reclaimer::drain() noexcept {
+  std::size_t start = head.load(std::memory_order_relaxed);
+  std::size_t pos = start;
+  while (ready()) {
+    cell &c = cells[pos & (capacity - 1)];
+    task job = c.job;
+    c.sequence.store(pos + capacity, std::memory_order_release);
+
+    job.run(job.p);
+
+    head.store(++pos, std::memory_order_seq_cst);
+    if (0 != flushing.load(std::memory_order_seq_cst)) {
+      std::lock_guard<std::mutex> guard(lock);
+      drained.notify_all();
+    }
+  }
+
+  return pos != start;
+}
+
+/**
+ * Return whether the next destruction to run has been queued (consumer only)
+ *
+ * @return whether the queue holds a destruction ready to run
+ */
+inline bool reclaimer::ready() const noexcept {
+  std::size_t pos = head.load(std::memory_order_relaxed);
+  return pos + 1 == cells[pos & (capacity - 1)].sequence.load(std::memory_order_acquire);
+}
+
+/**
+ * Wake the background thread up
+ *
+ */
+inline void reclaimer::wake() noexcept {
+  std::lock_guard<std::mutex> guard(lock);
+  wakeup.notify_one();
+}
+
+
+/**
+ * Destruction implementation
+ *
+ * Queues the pointee for destruction by the background reclaimer, or
+ * destroys it inline should the reclaimer's queue be full.
+ *
+ * @param p  Pointer to the object to destroy
+ */
+template <typename T, typename H>
+void deferred_handler<T, H>::destroy(typename deferred_handler<T, H>::element_type const *p) {
+  if (nullptr == p || !reclaimer::instance().defer(&reclaim, p)) {
+    H::destroy(p);
+  }
+}
+
+/**
+ * Wait until every destruction queued before the call has been run
+ *
+ */
+template <typename T, typename H>
+void deferred_handler<T, H>::flush() noexcept {
+  reclaimer::instance().flush();
+}
+
+/**
+ * Destroy a queued pointee
+ *
+ * @param p  Pointer to the object to destroy
+ */
+template <typename T, typename H>
+void deferred_handler<T, H>::reclaim(void const *p) noexcept {
+  H h;
+  h.destroy(static_cast<element_type const *>(p));
+}
+
+#endif /* VALUE_PTR__DEFERRED_HPP__ */
@@ -0,0 +1,259 @@
+#ifndef VALUE_PTR__ERASED_H__
+#define VALUE_PTR__ERASED_H__
+
+
+#include <type_traits>
+
+#include "Handler.h"
+
+
+/**
+ * Handler capturing the adopted pointee's copy constructor and destructor
+ *
+ * Upon adoption (ie. upon construction of a value_ptr from a pointer to
+ * T2), this handler records a static per-type table of functions copying
+ * and deleting T2 objects directly, carried along by copies of the handler:
+ * copies thus call T2's copy constructor without going through a virtual
+ * "clone" method, and polymorphic hierarchies lacking one become usable
+ * without slicing.
+ *
+ * Should the dynamic type of the adopted pointee differ from T2 (eg. a
+ * pointer to a base class was adopted, or a pointer was given to "reset"),
+ * it is unknown: replicas are then obtained through "clone" methods if T
+ * provides them, and replication throws std::bad_typeid otherwise.
+ *
+ * @param T  Underlying type this class handles
+ */
+template <typename T>
+struct erased_handler {
+  /**
+   * Refuse to accept array types
+   *
+   * Array elements all share the array's static type, there is nothing to
+   * capture.
+   *
+   */
+  static_assert(0 == std::rank<T>::value, "erased_handler cannot work on array types");
+
+  /**
+   * Whether the replication method is safe from slicing
+   *
+   */
+  static constexpr bool slice_safe = true;
+
+  /**
+   * Per-type function table
+   *
+   */
+  struct table {
+    T *(*replicate)(T const *);
+    bool (*assign)(T *, T const *);
+    void (*destroy)(T const *);
+  };
+
+  /**
+   * Default constructor
+   *
+   * The dynamic type is assumed to be the static one for non-polymorphic
+   * (or final) copy constructible types, and unknown otherwise.
+   *
+   */
+  erased_handler() noexcept;
+
+  /**
+   * Adoption implementation
+   *
+   * This method records T2's function table if the dynamic type of the given
+   * object coincides with T2 (and T2 is copy constructible), and the unknown
+   * type's table otherwise.
+   *
+   * @param T2  Static type of the adopted object
+   * @param p  Pointer to the adopted object
+   */
+  template <typename T2> void adopt(T2 const *p) noexcept;
+
+  /**
+   * Replication implementation
+   *
+   * @param p  Pointer to the object to copy
+   * @return either nullptr if nullptr is given, or a new object copied from p
+   * @throws std::bad_typeid  In case the dynamic type is unknown and T is not cloneable
+   */
+  T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * This method copy-assigns the object pointed to by q into the one pointed
+   * to by p, provided both share the captured dynamic type (which can only
+   * be told for polymorphic or final types) and it is nothrow
+   * copy-assignable; otherwise, the caller replicates and swaps instead.
+   *
+   * @param p  Pointer to the object to assign to
+   * @param q  Pointer to the object to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q) const;
+
+  /**
+   * Destroyer implementation
+   *
+   * @param p  Pointer to the object to delete
+   */
+  void destroy(T const *p) const;
+
+  protected:
+    /**
+     * Return the function table for objects of the given (copy constructible) type
+     *
+     * @param T2  Dynamic type of the objects
+     * @param <unnamed>  Tag indicating copy constructibility
+     * @return the function table for T2
+     */
+    template <typename T2> static table const *capture(std::true_type) noexcept __attribute__((const));
+
+    /**
+     * Return the function table for unknown types, T2 not being copy constructible
+     *
+     * @param T2  Dynamic type of the objects
+     * @param <unnamed>  Tag indicating copy constructibility
+     * @return the function table for unknown types
+     */
+    template <typename T2> static table const *capture(std::false_type) noexcept __attribute__((const));
+
+    /**
+     * Return the function table for unknown types
+     *
+     * @return the function table for unknown types
+     */
+    static table const *unknown() noexcept __attribute__((const));
+
+    /**
+     * Copy an object of dynamic type T2
+     *
+     * @param T2  Dynamic type of the object
+     * @param p  Pointer to the object to copy
+     * @return a new object copied from p
+     */
+    template <typename T2> static T *replicateAs(T const *p);
+
+    /**
+     * Copy-assign an object of dynamic type T2, if the other one shares it
+     *
+     * @param T2  Dynamic type of the object to assign to
+     * @param p  Pointer to the object to assign to
+     * @param q  Pointer to the object to assign from
+     * @return whether the assignment could be performed in place
+     */
+    template <typename T2> static bool assignAs(T *p, T const *q);
+
+    /**
+     * Copy-assign an object of nothrow copy-assignable dynamic type T2
+     *
+     * @param T2  Dynamic type of both objects
+     * @param p  Pointer to the object to assign to
+     * @param q  Pointer to the object to assign from
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     * @return true, always
+     */
+    template <typename T2> static bool assignInPlace(T *p, T const *q, std::true_type) noexcept;
+
+    /**
+     * Refuse to copy-assign an object of potentially throwing or non copy-assignable dynamic type T2
+     *
+     * Such objects are replicated and swapped in instead, so that a throwing
+     * copy leaves the object pointed to by p untouched.
+     *
+     * @param T2  Dynamic type of both objects
+     * @param <unnamed>  Pointer to the object to assign to
+     * @param <unnamed>  Pointer to the object to assign from
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     * @return false, always
+     */
+    template <typename T2> static constexpr bool assignInPlace(T *, T const *, std::false_type) noexcept __attribute__((const));
+
+    /**
+     * Delete an object of dynamic type T2
+     *
+     * @param T2  Dynamic type of the object
+     * @param p  Pointer to the object to delete
+     */
+    template <typename T2> static void destroyAs(T const *p);
+
+    /**
+     * Copy an object of unknown dynamic type
+     *
+     * @param p  Pointer to the object to copy
+     * @return a new object copied from p
+     * @throws std::bad_typeid  In case T is not cloneable
+     */
+    static T *replicateUnknown(T const *p);
+
+    /**
+     * Refuse to copy-assign an object of unknown dynamic type
+     *
+     * @param <unnamed>  Pointer to the object to assign to
+     * @param <unnamed>  Pointer to the object to assign from
+     * @return false, always
+     */
+    static constexpr bool assignUnknown(T *, T const *) noexcept __attribute__((const));
+
+    /**
+     * Delete an object of unknown dynamic type
+     *
+     * @param p  Pointer to the object to delete
+     */
+    static void destroyUnknown(T const *p);
+
+    /**
+     * Copy an object of unknown dynamic type using its "clone" method
+     *
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     * @return a new object copied from p
+     */
+    static T *replicateUnknown(T const *p, std::true_type);
+
+    /**
+     * Refuse to copy an object of unknown dynamic type
+     *
+     * @param <unnamed>  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     * @return never
+     * @throws std::bad_typeid  Always
+     */
+    [[noreturn]] static T *replicateUnknown(T const *, std::false_type);
+
+    /**
+     * Convert a pointer to T into a pointer to its dynamic type T2 by a static cast
+     *
+     * This overload is only viable if T is a non-virtual base of T2.
+     *
+     * @param T2  Dynamic type of the object
+     * @param p  Pointer to convert
+     * @param <unnamed>  int parameter to use for overload prioritization
+     * @return the converted pointer
+     */
+    template <typename T2> static constexpr auto concrete(T const *p, int) noexcept -> decltype(static_cast<T2 const *>(p)) __attribute__((const));
+
+    /**
+     * Convert a pointer to T into a pointer to its dynamic type T2 through the most derived object
+     *
+     * @param T2  Dynamic type of the object
+     * @param p  Pointer to convert
+     * @param <unnamed>  long parameter to use for overload prioritization
+     * @return the converted pointer
+     */
+    template <typename T2> static T2 const *concrete(T const *p, long) noexcept __attribute__((pure));
+
+    /**
+     * Function table of the pointee's dynamic type
+     *
+     */
+    table const *vtable;
+};
+
+
+#include "Erased.hpp"
+
+#endif /* VALUE_PTR__ERASED_H__ */
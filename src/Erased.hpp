@@ -0,0 +1,278 @@
+#ifndef VALUE_PTR__ERASED_HPP__
+#define VALUE_PTR__ERASED_HPP__
+
+
+#include "Erased.h"
+
+#include <typeinfo>
+
+
+/**
+ * Default constructor
+ *
+ * The dynamic type is assumed to be the static one for non-polymorphic
+ * (or final) copy constructible types, and unknown otherwise.
+ *
+ */
+template <typename T>
+erased_handler<T>::erased_handler() noexcept : vtable(!std::is_polymorphic<T>::value || std::is_final<T>::value ? capture<T>(typename condition<std::is_copy_constructible<T>::value>::type()) : unknown()) {}
+
+/**
+ * Adoption implementation
+ *
+ * This method records T2's function table if the dynamic type of the given
+ * object coincides with T2 (and T2 is copy constructible), and the unknown
+ * type's table otherwise.
+ *
+ * @param T2  Static type of the adopted object
+ * @param p  Pointer to the adopted object
+ */
+template <typename T>
+template <typename T2>
+void erased_handler<T>::adopt(T2 const *p) noexcept {
+  vtable = typeid(*p) == typeid(T2) ? capture<T2>(typename condition<std::is_copy_constructible<T2>::value>::type()) : unknown();
+}
+
+/**
+ * Replication implementation
+ *
+ * @param p  Pointer to the object to copy
+ * @return either nullptr if nullptr is given, or a new object copied from p
+ * @throws std::bad_typeid  In case the dynamic type is unknown and T is not cloneable
+ */
+template <typename T>
+T *erased_handler<T>::replicate(T const *p) const {
+  return nullptr != p ? vtable->replicate(p) : nullptr;
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * This method copy-assigns the object pointed to by q into the one pointed
+ * to by p, provided both share the captured dynamic type (which can only
+ * be told for polymorphic or final types) and it is nothrow
+ * copy-assignable; otherwise, the caller replicates and swaps instead.
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T>
+bool erased_handler<T>::assign(T *p, T const *q) const {
+  return vtable->assign(p, q);
+}
+
+/**
+ * Destroyer implementation
+ *
+ * @param p  Pointer to the object to delete
+ */
+template <typename T>
+void erased_handler<T>::destroy(T const *p) const {
+  if (nullptr != p) {
+    vtable->destroy(p);
+  }
+}
+
+/**
+ * Return the function table for objects of the given (copy constructible) type
+ *
+ * @param T2  Dynamic type of the objects
+ * @param <unnamed>  Tag indicating copy constructibility
+ * @return the function table for T2
+ */
+template <typename T>
+template <typename T2>
+typename erased_handler<T>::table const *erased_handler<T>::capture(std::true_type) noexcept {
+  static constexpr table entries = { &replicateAs<T2>, &assignAs<T2>, &destroyAs<T2> };
+  return &entries;
+}
+
+/**
+ * Return the function table for unknown types, T2 not being copy constructible
+ *
+ * @param T2  Dynamic type of the objects
+ * @param <unnamed>  Tag indicating copy constructibility
+ * @return the function table for unknown types
+ */
+template <typename T>
+template <typename T2>
+typename erased_handler<T>::table const *erased_handler<T>::capture(std::false_type) noexcept {
+  return unknown();
+}
+
+/**
+ * Return the function table for unknown types
+ *
+ * @return the function table for unknown types
+ */
+template <typename T>
+typename erased_handler<T>::table const *erased_handler<T>::unknown() noexcept {
+  static constexpr table entries = { &replicateUnknown, &assignUnknown, &destroyUnknown };
+  return &entries;
+}
+
+/**
+ * Copy an object of dynamic type T2
+ *
+ * @param T2  Dynamic type of the object
+ * @param p  Pointer to the object to copy
+ * @return a new object copied from p
+ */
+template <typename T>
+template <typename T2>
+T *erased_handler<T>::replicateAs(T const *p) {
+  return new T2(*concrete<T2>(p, 0));
+}
+
+/**
+ * Copy-assign an object of dynamic type T2, if the other one shares it
+ *
+ * @param T2  Dynamic type of the object to assign to
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T>
+template <typename T2>
+bool erased_handler<T>::assignAs(T *p, T const *q) {
+  return (std::is_polymorphic<T>::value || std::is_final<T>::value) && std::is_nothrow_copy_assignable<T2>::value && typeid(*q) == typeid(T2) && assignInPlace<T2>(p, q, typename condition<std::is_nothrow_copy_assignable<T2>::value>::type());
+}
+
+/**
+ * Copy-assign an object of nothrow copy-assignable dynamic type T2
+ *
+ * @param T2  Dynamic type of both objects
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ * @return true, always
+ */
+template <typename T>
+template <typename T2>
+bool erased_handler<T>::assignInPlace(T *p, T const *q, std::true_type) noexcept {
+  *const_cast<T2 *>(concrete<T2>(p, 0)) = *concrete<T2>(q, 0);
+
+  return true;
+}
+
+/**
+ * Refuse to copy-assign an object of potentially throwing or non copy-assignable dynamic type T2
+ *
+ * Such objects are replicated and swapped in instead, so that a throwing
+ * copy leaves the object pointed to by p untouched.
+ *
+ * @param T2  Dynamic type of both objects
+ * @param <unnamed>  Pointer to the object to assign to
+ * @param <unnamed>  Pointer to the object to assign from
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ * @return false, always
+ */
+template <typename T>
+template <typename T2>
+constexpr bool erased_handler<T>::assignInPlace(T *, T const *, std::false_type) noexcept {
+  return false;
+}
+
+/**
+ * Delete an object of dynamic type T2
+ *
+ * @param T2  Dynamic type of the object
+ * @param p  Pointer to the object to delete
+ */
+template <typename T>
+template <typename T2>
+void erased_handler<T>::destroyAs(T const *p) {
+  delete concrete<T2>(p, 0);
+}
+
+/**
+ * Copy an object of unknown dynamic type
+ *
+ * @param p  Pointer to the object to copy
+ * @return a new object copied from p
+ * @throws std::bad_typeid  In case T is not cloneable
+ */
+template <typename T>
+T *erased_handler<T>::replicateUnknown(T const *p) {
+  return replicateUnknown(p, typename condition<is_cloneable<T>::value>::type());
+}
+
+/**
+ * Refuse to copy-assign an object of unknown dynamic type
+ *
+ * @param <unnamed>  Pointer to the object to assign to
+ * @param <unnamed>  Pointer to the object to assign from
+ * @return false, always
+ */
+template <typename T>
+constexpr bool erased_handler<T>::assignUnknown(T *, T const *) noexcept {
+  return false;
+}
+
+/**
+ * Delete an object of unknown dynamic type
+ *
+ * @param p  Pointer to the object to delete
+ */
+template <typename T>
+void erased_handler<T>::destroyUnknown(T const *p) {
+  delete p;
+}
+
+/**
+ * Copy an object of unknown dynamic type using its "clone" method
+ *
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ * @return a new object copied from p
+ */
+template <typename T>
+T *erased_handler<T>::replicateUnknown(T const *p, std::true_type) {
+  return p->clone();
+}
+
+/**
+ * Refuse to copy an object of unknown dynamic type
+ *
+ * @param <unnamed>  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ * @return never
+ * @throws std::bad_typeid  Always
+ */
+template <typename T>
+T *erased_handler<T>::replicateUnknown(T const *, std::false_type) {
+  throw std::bad_typeid();
+}
+
+/**
+ * Convert a pointer to T into a pointer to its dynamic type T2 by a static cast
+ *
+ * This overload is only viable if T is a non-virtual base of T2.
+ *
+ * @param T2  Dynamic type of the object
+ * @param p  Pointer to convert
+ * @param <unnamed>  int parameter to use for overload prioritization
+ * @return the converted pointer
+ */
+template <typename T>
+template <typename T2>
+constexpr auto erased_handler<T>::concrete(T const *p, int) noexcept -> decltype(static_cast<T2 const *>(p)) {
+  return static_cast<T2 const *>(p);
+}
+
+/**
+ * Convert a pointer to T into a pointer to its dynamic type T2 through the most derived object
+ *
+ * @param T2  Dynamic type of the object
+ * @param p  Pointer to convert
+ * @param <unnamed>  long parameter to use for overload prioritization
+ * @return the converted pointer
+ */
+template <typename T>
+template <typename T2>
+T2 const *erased_handler<T>::concrete(T const *p, long) noexcept {
+  return static_cast<T2 const *>(dynamic_cast<void const *>(p));
+}
+
+#endif /* VALUE_PTR__ERASED_HPP__ */
@@ -3,11 +3,78 @@
 
 
 #include <type_traits>
+#include <cstddef>
+#include <atomic>
 
 #include "Abi.h"
 #include "Cloneable.h"
 
 
+/**
+ * Static class encapsulating bulk destruction of arrays
+ *
+ * Trivially destructible types are merely deallocated, nothrow destructible
+ * ones are destroyed by a plain loop, and only the remaining ones pay for the
+ * exception cleanup scaffolding.
+ *
+ * @param T  Underlying type of the array
+ * @param ABI  ABI adapter class to use
+ */
+template <typename T, typename ABI>
+struct array_destroy {
+  /**
+   * Destroy each object in the given array and then delete the substrate array
+   *
+   * Should any destructor throw, the remaining objects are still destroyed
+   * and the array deleted before rethrowing.
+   *
+   * During constant evaluation, the array is deleted through constant_array.
+   *
+   * @param p  Pointer to the array to delete
+   * @param n  Number of elements in the array
+   */
+  static constexpr void destroy(T const *p, std::size_t n);
+
+  protected:
+    /**
+     * Delete an array of trivially destructible objects
+     *
+     * @param p  Pointer to the array to delete
+     * @param <unnamed>  Number of elements in the array
+     * @param <unnamed>  Tag indicating trivial destructibility
+     */
+    static void destroy(T const *p, std::size_t, std::true_type) noexcept;
+
+    /**
+     * Destroy and delete an array of non trivially destructible objects
+     *
+     * @param p  Pointer to the array to delete
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating trivial destructibility
+     */
+    static void destroy(T const *p, std::size_t n, std::false_type);
+
+    /**
+     * Destroy and delete an array of nothrow destructible objects
+     *
+     * @param p  Pointer to the array to delete
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating nothrow destructibility
+     */
+    static void destroyEach(T const *p, std::size_t n, std::true_type) noexcept;
+
+    /**
+     * Destroy and delete an array of potentially throwing destructible objects
+     *
+     * @param p  Pointer to the array to delete
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating nothrow destructibility
+     */
+    static void destroyEach(T const *p, std::size_t n, std::false_type);
+};
+
+
+
 /**
  * Metaprogramming class to automatically select the destruction method to use
  *
@@ -23,7 +90,7 @@ struct default_destroy {
    *
    * @param p  Pointer to the object to delete
    */
-  void destroy(T const *p) const;
+  constexpr void destroy(T const *p) const;
 };
 
 /**
@@ -36,11 +103,29 @@ struct default_destroy<T[], ABI> {
    * Destroyer implementation
    *
    * This method calls each object's destructor and then deletes the substrate
-   * array.
+   * array (the array size is not even looked up for trivially destructible
+   * types).
    *
    * @param p  Pointer to the array to delete
    */
   void destroy(T const *p) const;
+
+  protected:
+    /**
+     * Destroyer implementation for trivially destructible types
+     *
+     * @param p  Pointer to the array to delete
+     * @param <unnamed>  Tag indicating trivial destructibility
+     */
+    static void destroyArray(T const *p, std::true_type) noexcept;
+
+    /**
+     * Destroyer implementation for non trivially destructible types
+     *
+     * @param p  Pointer to the array to delete
+     * @param <unnamed>  Tag indicating trivial destructibility
+     */
+    static void destroyArray(T const *p, std::false_type);
 };
 
 /**
@@ -57,7 +142,183 @@ struct default_destroy<T[N], ABI> {
    *
    * @param p  Pointer to the array to delete
    */
-  void destroy(T const *p) const;
+  constexpr void destroy(T const *p) const;
+};
+
+
+
+/**
+ * Static class encapsulating bulk copies of arrays
+ *
+ * Trivially copyable types are copied with a single memcpy, nothrow
+ * copyable ones with a plain loop, and only the remaining ones pay for the
+ * exception cleanup scaffolding.
+ *
+ * @param T  Underlying type of the array
+ * @param ABI  ABI adapter class to use
+ */
+template <typename T, typename ABI>
+struct array_copy {
+  /**
+   * Return a new array copied from the given one
+   *
+   * Should any copy constructor throw, the already constructed objects are
+   * destroyed and the array deleted before rethrowing.
+   *
+   * During constant evaluation, the array is allocated through
+   * constant_array and copied element by element.
+   *
+   * @param p  Pointer to the array to copy
+   * @param n  Number of elements in the array
+   * @return a new array copied from p
+   */
+  static constexpr T *replicate(T const *p, std::size_t n);
+
+  /**
+   * Copy-assign each object in the given array into the corresponding one in the other
+   *
+   * Should any assignment throw, the array pointed to by p is destroyed
+   * before rethrowing.
+   *
+   * During constant evaluation, elements are assigned one by one.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @param n  Number of elements in both arrays
+   */
+  static constexpr void assign(T *p, T const *q, std::size_t n);
+
+  protected:
+    /**
+     * Construct copies of trivially copyable objects
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param p  Pointer to the array to copy
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void construct(T *ret, T const *p, std::size_t n, std::true_type) noexcept;
+
+    /**
+     * Construct copies of non trivially copyable objects
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param p  Pointer to the array to copy
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void construct(T *ret, T const *p, std::size_t n, std::false_type);
+
+    /**
+     * Construct copies of nothrow copy constructible objects
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param p  Pointer to the array to copy
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating nothrow copy constructibility
+     */
+    static void constructEach(T *ret, T const *p, std::size_t n, std::true_type) noexcept;
+
+    /**
+     * Construct copies of potentially throwing copy constructible objects
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param p  Pointer to the array to copy
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating nothrow copy constructibility
+     */
+    static void constructEach(T *ret, T const *p, std::size_t n, std::false_type);
+
+    /**
+     * Copy-assign trivially copyable objects
+     *
+     * @param p  Pointer to the array to assign to
+     * @param q  Pointer to the array to assign from
+     * @param n  Number of elements in both arrays
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void assign(T *p, T const *q, std::size_t n, std::true_type) noexcept;
+
+    /**
+     * Copy-assign non trivially copyable objects
+     *
+     * @param p  Pointer to the array to assign to
+     * @param q  Pointer to the array to assign from
+     * @param n  Number of elements in both arrays
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void assign(T *p, T const *q, std::size_t n, std::false_type);
+
+    /**
+     * Copy-assign nothrow copy-assignable objects
+     *
+     * @param p  Pointer to the array to assign to
+     * @param q  Pointer to the array to assign from
+     * @param n  Number of elements in both arrays
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     */
+    static void assignEach(T *p, T const *q, std::size_t n, std::true_type) noexcept;
+
+    /**
+     * Copy-assign potentially throwing copy-assignable objects
+     *
+     * @param p  Pointer to the array to assign to
+     * @param q  Pointer to the array to assign from
+     * @param n  Number of elements in both arrays
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     */
+    static void assignEach(T *p, T const *q, std::size_t n, std::false_type);
+};
+
+
+/**
+ * Static class encapsulating construction of value-initialized arrays
+ *
+ * Elements may instead be constructed from lvalue arguments shared by all
+ * of them, in order (eg. a value_reader each element loads itself from).
+ * Nothrow constructible types are constructed with a plain loop, and only
+ * the remaining ones pay for the exception cleanup scaffolding.
+ *
+ * @param T  Underlying type of the array
+ * @param ABI  ABI adapter class to use
+ */
+template <typename T, typename ABI>
+struct array_construct {
+  /**
+   * Return a new array of objects value-initialized, or constructed from the given arguments
+   *
+   * Should any constructor throw, the already constructed objects are
+   * destroyed and the array deleted before rethrowing.
+   *
+   * During constant evaluation, the array is allocated through
+   * constant_array.
+   *
+   * @param n  Number of elements in the array
+   * @param args  Arguments to construct every element from, in order
+   * @return a new array of n objects
+   */
+  template <typename... Args> static constexpr T *construct(std::size_t n, Args &... args);
+
+  protected:
+    /**
+     * Construct nothrow constructible objects
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating nothrow constructibility
+     * @param args  Arguments to construct every element from, in order
+     */
+    template <typename... Args> static void constructEach(T *ret, std::size_t n, std::true_type, Args &... args) noexcept;
+
+    /**
+     * Construct potentially throwing constructible objects
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating nothrow constructibility
+     * @param args  Arguments to construct every element from, in order
+     */
+    template <typename... Args> static void constructEach(T *ret, std::size_t n, std::false_type, Args &... args);
 };
 
 
@@ -89,7 +350,42 @@ struct default_copy {
    * @param p  Pointer to the object to copy
    * @return either nullptr if nullptr is given, or a new object copied from p
    */
-  T *replicate(T const *p) const;
+  constexpr T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * This method copy-assigns the object pointed to by q into the one pointed
+   * to by p, provided the underlying class is nothrow copy-assignable; other
+   * classes are replicated and swapped in instead, so that a throwing copy
+   * leaves the object pointed to by p untouched.
+   *
+   * @param p  Pointer to the object to assign to
+   * @param q  Pointer to the object to assign from
+   * @return whether the assignment could be performed in place
+   */
+  constexpr bool assign(T *p, T const *q) const;
+
+  protected:
+    /**
+     * In-place assignment implementation for nothrow copy-assignable types
+     *
+     * @param p  Pointer to the object to assign to
+     * @param q  Pointer to the object to assign from
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     * @return true, always
+     */
+    static constexpr bool assignInPlace(T *p, T const *q, std::true_type) noexcept;
+
+    /**
+     * In-place assignment implementation for potentially throwing or non copy-assignable types
+     *
+     * @param <unnamed>  Pointer to the object to assign to
+     * @param <unnamed>  Pointer to the object to assign from
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     * @return false, always
+     */
+    static constexpr bool assignInPlace(T *, T const *, std::false_type) noexcept __attribute__((const));
 };
 
 /**
@@ -112,12 +408,51 @@ struct default_copy<T[], ABI> {
    *
    * This method returns a new array of objects of the underlying class by
    * performing a placement new using its copy constructor on each given
-   * object, it returns nullptr if a nullptr is given.
+   * object (or a single bulk copy for trivially copyable types), it returns
+   * nullptr if a nullptr is given.
    *
    * @param p  Pointer to the array to copy
    * @return either nullptr if nullptr is given, or a new array copied from p
    */
   T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * This method copy-assigns each object in the array pointed to by q into
+   * the corresponding one in the array pointed to by p, provided both arrays
+   * have the same length and the underlying class is nothrow
+   * copy-assignable; other classes are replicated and swapped in instead, so
+   * that a throwing copy leaves the array pointed to by p untouched.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q) const;
+
+  protected:
+    /**
+     * In-place assignment implementation for nothrow copy-assignable types
+     *
+     * @param p  Pointer to the array to assign to
+     * @param q  Pointer to the array to assign from
+     * @param n  Number of elements in both arrays
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     * @return true, always
+     */
+    static bool assignInPlace(T *p, T const *q, std::size_t n, std::true_type);
+
+    /**
+     * In-place assignment implementation for potentially throwing or non copy-assignable types
+     *
+     * @param <unnamed>  Pointer to the array to assign to
+     * @param <unnamed>  Pointer to the array to assign from
+     * @param <unnamed>  Number of elements in both arrays
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     * @return false, always
+     */
+    static constexpr bool assignInPlace(T *, T const *, std::size_t, std::false_type) noexcept __attribute__((const));
 };
 
 /**
@@ -140,12 +475,51 @@ struct default_copy<T[N], ABI> {
    *
    * This method returns a new array of objects of the underlying class by
    * performing a placement new using its copy constructor on each given
-   * object, it returns nullptr if a nullptr is given.
+   * object (or a single bulk copy for trivially copyable types), it returns
+   * nullptr if a nullptr is given.
    *
    * @param p  Pointer to the array to copy
    * @return either nullptr if nullptr is given, or a new array copied from p
    */
-  T *replicate(T const *p) const;
+  constexpr T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * This method copy-assigns each object in the array pointed to by q into
+   * the corresponding one in the array pointed to by p, provided both arrays
+   * have the same length and the underlying class is nothrow
+   * copy-assignable; other classes are replicated and swapped in instead, so
+   * that a throwing copy leaves the array pointed to by p untouched.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @return whether the assignment could be performed in place
+   */
+  constexpr bool assign(T *p, T const *q) const;
+
+  protected:
+    /**
+     * In-place assignment implementation for nothrow copy-assignable types
+     *
+     * @param p  Pointer to the array to assign to
+     * @param q  Pointer to the array to assign from
+     * @param n  Number of elements in both arrays
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     * @return true, always
+     */
+    static constexpr bool assignInPlace(T *p, T const *q, std::size_t n, std::true_type);
+
+    /**
+     * In-place assignment implementation for potentially throwing or non copy-assignable types
+     *
+     * @param <unnamed>  Pointer to the array to assign to
+     * @param <unnamed>  Pointer to the array to assign from
+     * @param <unnamed>  Number of elements in both arrays
+     * @param <unnamed>  Tag indicating nothrow copy-assignability
+     * @return false, always
+     */
+    static constexpr bool assignInPlace(T *, T const *, std::size_t, std::false_type) noexcept __attribute__((const));
 };
 
 
@@ -177,7 +551,61 @@ struct default_clone {
    * @param p  Pointer to the object to copy
    * @return either nullptr if nullptr is given, or a new object cloned from p
    */
-  T *replicate(T const *p) const;
+  constexpr T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * If both objects share the same dynamic type and the underlying class is
+   * placement cloneable, this method destroys the object pointed to by p and
+   * placement clones the one pointed to by q into its storage; should the
+   * placement clone throw, the storage is returned to the deallocation
+   * function a delete expression would use (T's own, if it declares or
+   * inherits one, the global one otherwise) before rethrowing.
+   *
+   * @param p  Pointer to the object to assign to
+   * @param q  Pointer to the object to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q) const;
+
+  protected:
+    /**
+     * Return storage to T's class-specific deallocation function
+     *
+     * @param raw  Pointer to the storage to deallocate
+     * @param <unnamed>  int parameter to use for overload prioritization
+     */
+    template <typename T2 = T>
+    static auto deallocate(void *raw, int) noexcept -> decltype(T2::operator delete(raw), void());
+
+    /**
+     * Return storage to the global deallocation function
+     *
+     * @param raw  Pointer to the storage to deallocate
+     * @param <unnamed>  long parameter to use for overload prioritization
+     */
+    static void deallocate(void *raw, long) noexcept;
+
+    /**
+     * In-place assignment implementation for placement cloneable types
+     *
+     * @param p  Pointer to the object to assign to
+     * @param q  Pointer to the object to assign from
+     * @param <unnamed>  Tag indicating placement cloneability
+     * @return whether the assignment could be performed in place
+     */
+    static bool assignInPlace(T *p, T const *q, std::true_type);
+
+    /**
+     * In-place assignment implementation for non placement cloneable types
+     *
+     * @param <unnamed>  Pointer to the object to assign to
+     * @param <unnamed>  Pointer to the object to assign from
+     * @param <unnamed>  Tag indicating placement cloneability
+     * @return false, always
+     */
+    static constexpr bool assignInPlace(T *, T const *, std::false_type) noexcept __attribute__((const));
 };
 
 /**
@@ -206,6 +634,32 @@ struct default_clone<T[], ABI> {
    * @return either nullptr if nullptr is given, or a new array cloned from p
    */
   T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * Provided both arrays have the same length, this method destroys each
+   * object in the array pointed to by p and placement clones the
+   * corresponding one in the array pointed to by q into its storage; should
+   * any placement clone throw, the array pointed to by p is destroyed before
+   * rethrowing.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q) const;
+
+  protected:
+    /**
+     * In-place assignment implementation
+     *
+     * @param p  Pointer to the array to assign to
+     * @param q  Pointer to the array to assign from
+     * @param n  Number of elements in both arrays
+     * @return true, always
+     */
+    static bool assignInPlace(T *p, T const *q, std::size_t n);
 };
 
 /**
@@ -234,6 +688,32 @@ struct default_clone<T[N], ABI> {
    * @return either nullptr if nullptr is given, or a new array cloned from p
    */
   T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * Provided both arrays have the same length, this method destroys each
+   * object in the array pointed to by p and placement clones the
+   * corresponding one in the array pointed to by q into its storage; should
+   * any placement clone throw, the array pointed to by p is destroyed before
+   * rethrowing.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q) const;
+
+  protected:
+    /**
+     * In-place assignment implementation
+     *
+     * @param p  Pointer to the array to assign to
+     * @param q  Pointer to the array to assign from
+     * @param n  Number of elements in both arrays
+     * @return true, always
+     */
+    static bool assignInPlace(T *p, T const *q, std::size_t n);
 };
 
 
@@ -254,6 +734,7 @@ template <typename T, typename ABI, bool use_clone = is_cloneable<T>::value> str
 template <typename T, typename ABI>
 struct default_replicate<T, ABI, true> : public default_clone<T, ABI> {
   using default_clone<T, ABI>::replicate;
+  using default_clone<T, ABI>::assign;
 
   /**
    * Whether the replication method uses "clone" methods
@@ -269,6 +750,7 @@ struct default_replicate<T, ABI, true> : public default_clone<T, ABI> {
 template <typename T, typename ABI>
 struct default_replicate<T, ABI, false> : public default_copy<T, ABI> {
   using default_copy<T, ABI>::replicate;
+  using default_copy<T, ABI>::assign;
 
   /**
    * Whether the replication method uses "clone" methods
@@ -280,17 +762,584 @@ struct default_replicate<T, ABI, false> : public default_copy<T, ABI> {
 
 
 /**
- * Metaprogramming class encapsulating replication and destruction
+ * Metaprogramming class to provide a default constructor of new pointees
+ *
+ * @param T  Class to provide a constructor for
+ * @param ABI  ABI adapter class to use
+ */
+template <typename T, typename ABI>
+struct default_construct {
+  /**
+   * Construction implementation
+   *
+   * This method returns a new object of class T2 (T or a class derived
+   * from it) constructed from the given arguments.
+   *
+   * @param T2  Class of the object to construct
+   * @param args  Arguments to forward to T2's constructor
+   * @return a new object constructed from args
+   */
+  template <typename T2, typename... Args> constexpr T2 *construct(Args&&... args) const;
+};
+
+/**
+ * Specialization of default_construct for array types
+ *
+ */
+template <typename T, typename ABI>
+struct default_construct<T[], ABI> {
+  /**
+   * Construction implementation
+   *
+   * This method returns a new array of objects of the underlying class,
+   * value-initialized or constructed from the given (lvalue) arguments in
+   * order, allocated through the ABI adapter.
+   *
+   * @param T2  Array type to construct (T[])
+   * @param n  Number of elements in the array
+   * @param args  Arguments to construct every element from
+   * @return a new array of n objects
+   */
+  template <typename T2, typename... Args> T *construct(std::size_t n, Args &... args) const;
+};
+
+/**
+ * Specialization of default_construct for fixed array types
+ *
+ */
+template <typename T, typename ABI, std::size_t N>
+struct default_construct<T[N], ABI> {
+  /**
+   * Construction implementation
+   *
+   * This method returns a new array of N objects of the underlying class,
+   * value-initialized or constructed from the given (lvalue) arguments in
+   * order, allocated through the ABI adapter.
+   *
+   * @param T2  Array type to construct (T[N])
+   * @param args  Arguments to construct every element from
+   * @return a new array of N objects
+   */
+  template <typename T2, typename... Args> constexpr T *construct(Args &... args) const;
+};
+
+
+
+/**
+ * Metaprogramming class encapsulating construction, replication and destruction
  *
  * @param T  Underlying type this class handles
  * @param ABI  ABI adapter class to use (Itanium by default)
  * @param use_clone  Whether the replication should use cloning or copying
  */
 template <typename T, typename ABI = Itanium>
-struct default_handler : public default_destroy<T, ABI>, public default_replicate<T, ABI> {
+struct default_handler : public default_destroy<T, ABI>, public default_replicate<T, ABI>, public default_construct<T, ABI> {
   using default_destroy<T, ABI>::destroy;
   using default_replicate<T, ABI>::replicate;
+  using default_replicate<T, ABI>::assign;
   using default_replicate<T, ABI>::slice_safe;
+  using default_construct<T, ABI>::construct;
+};
+
+
+
+/**
+ * Explicit padding of N bytes
+ *
+ * Meant to be declared [[no_unique_address]] at the end of a member list,
+ * so that padding up to the alignment is spelled out rather than left
+ * implicit; the specialization for 0 bytes takes up no room at all.
+ *
+ * @param N  Number of padding bytes
+ */
+template <std::size_t N>
+struct explicit_padding {
+  char bytes[N];
+};
+
+/**
+ * Specialization of explicit_padding for no padding at all
+ *
+ */
+template <>
+struct explicit_padding<0> {};
+
+/**
+ * Number of padding bytes needed after the given number of bytes to reach the given alignment
+ *
+ * @param Used  Number of bytes taken up so far
+ * @param Align  Alignment to reach
+ * @var std::size_t value  Number of padding bytes needed
+ */
+template <std::size_t Used, std::size_t Align>
+struct padding_to {
+  static constexpr std::size_t value = (Align - Used % Align) % Align;
+};
+
+
+/**
+ * Metaprogramming class encapsulating replication and destruction into an inline buffer
+ *
+ * This handler behaves as a default_handler, except that replicas of the
+ * underlying type are constructed in its inline buffer (by copy
+ * construction or placement clone, as appropriate) instead of on the heap,
+ * provided the type fits in (and is suitably aligned for) the buffer.
+ *
+ * Since moving or swapping value_ptrs whose pointees are held inline
+ * relocates them, and value_ptr's moves and swaps are noexcept, only types
+ * whose relocation cannot throw are ever held inline (as std::function
+ * does): the type must be nothrow move constructible and non-polymorphic,
+ * and adopted pointers or constructed objects of any other (eg. derived)
+ * type are kept on the heap. Releasing an inline pointee moves it onto the
+ * heap first, so that value_ptr::release may throw std::bad_alloc.
+ *
+ * @param T  Underlying type this class handles
+ * @param Capacity  Size in bytes of the inline buffer
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ */
+template <typename T, std::size_t Capacity = 48, typename ABI = Itanium>
+struct inline_handler : public default_handler<T, ABI> {
+  /**
+   * Refuse to accept array types
+   *
+   * Arrays need an ABI dependent cookie and their sizes are not bounded,
+   * inline storage makes little sense for them.
+   *
+   */
+  static_assert(0 == std::rank<T>::value, "inline_handler cannot work on array types");
+
+  using default_handler<T, ABI>::slice_safe;
+
+  /**
+   * Whether objects of the underlying type can be held inline at all
+   *
+   * The type must fit in the buffer and be relocatable without throwing
+   * (ie. be nothrow move constructible and non-polymorphic); cloneable
+   * types must also be placement cloneable.
+   *
+   */
+  static constexpr bool placeable = (!is_cloneable<T>::value || is_placement_cloneable<T>::value) && std::is_nothrow_move_constructible<T>::value && !std::is_polymorphic<T>::value && sizeof(T) <= Capacity && alignof(T) <= alignof(std::max_align_t);
+
+  /**
+   * Default constructor
+   *
+   * Initializes an empty buffer, the pointee is assumed to be of the
+   * underlying type.
+   *
+   */
+  inline_handler() noexcept;
+
+  /**
+   * Copy constructor
+   *
+   * Initializes an empty buffer, copying only the knowledge of the pointee's
+   * dynamic type.
+   *
+   * @param other  Handler to copy
+   */
+  inline_handler(inline_handler const &other) noexcept;
+
+  /**
+   * Copy-assignment operator
+   *
+   * Leaves the buffer untouched, copying only the knowledge of the pointee's
+   * dynamic type.
+   *
+   * @param other  Handler to copy-assign
+   * @return the assigned handler
+   */
+  inline_handler &operator=(inline_handler const &other) noexcept;
+
+  /**
+   * Adoption implementation
+   *
+   * This method records whether the adopted object is of the underlying
+   * type, and may thus be replicated into the inline buffer.
+   *
+   * @param T2  Static type of the adopted object
+   * @param <unnamed>  Pointer to the adopted object
+   */
+  template <typename T2> void adopt(T2 const *) noexcept;
+
+  /**
+   * Construction implementation
+   *
+   * This method constructs the new object in the inline buffer if it is
+   * free and T2 is the (placeable) underlying type, and delegates to
+   * default_handler (adopting the new object) otherwise.
+   *
+   * @param T2  Class of the object to construct
+   * @param args  Arguments to forward to T2's constructor
+   * @return a new object constructed from args
+   */
+  template <typename T2, typename... Args> T2 *construct(Args&&... args);
+
+  /**
+   * Destroyer implementation
+   *
+   * This method destroys in place an object held in the inline buffer, and
+   * delegates to default_handler otherwise.
+   *
+   * @param p  Pointer to the object to delete
+   */
+  void destroy(T const *p);
+
+  /**
+   * Replication implementation
+   *
+   * This method constructs the replica in the inline buffer if it is free
+   * and the object is of the (placeable) underlying type, and delegates to
+   * default_handler otherwise.
+   *
+   * @param p  Pointer to the object to copy
+   * @return either nullptr if nullptr is given, or a new object copied from p
+   */
+  T *replicate(T const *p);
+
+  /**
+   * In-place assignment implementation
+   *
+   * For objects held in the inline buffer, this method destroys the object
+   * and copies the other one into its place (provided both dynamic types
+   * coincide); should the copy throw, the buffer is left empty. For other
+   * objects, it delegates to default_handler.
+   *
+   * @param p  Pointer to the object to assign to
+   * @param q  Pointer to the object to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q);
+
+  /**
+   * Relocation implementation
+   *
+   * This method moves an object held in the given handler's inline buffer
+   * into this one's (which value_ptr always empties beforehand), pointers to
+   * heap objects are simply taken over.
+   *
+   * @param from  Handler currently owning the object
+   * @param p  Pointer to the object to take over
+   * @return the pointer to use from now on
+   */
+  T *relocate(inline_handler &from, T *p) noexcept;
+
+  /**
+   * Release implementation
+   *
+   * This method moves an object held in the inline buffer onto the heap (and
+   * destroys the inline one), pointers to heap objects are simply handed
+   * back.
+   *
+   * @param p  Pointer to the object to release
+   * @return a pointer the caller may take ownership of
+   * @throws std::bad_alloc  In case the heap object cannot be allocated
+   */
+  T *release(T *p);
+
+  protected:
+    /**
+     * Determine whether the given pointer is the one held in the inline buffer
+     *
+     * Inline objects are always of the underlying type, hence placed at the
+     * very start of the buffer.
+     *
+     * @param p  Pointer to check
+     * @return true if p points to the inline buffer
+     */
+    bool holds(T const *p) const noexcept __attribute__((pure));
+
+    /**
+     * Copy the given object into the inline buffer using its copy constructor
+     *
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     * @return a pointer to the new inline object
+     */
+    T *place(T const *p, std::false_type);
+
+    /**
+     * Copy the given object into the inline buffer using its placement clone method
+     *
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     * @return a pointer to the new inline object
+     */
+    T *place(T const *p, std::true_type);
+
+    /**
+     * Move the given object into the inline buffer using its move constructor
+     *
+     * @param p  Pointer to the object to move
+     * @return a pointer to the new inline object
+     */
+    T *placeMoved(T *p) noexcept;
+
+    /**
+     * Inline buffer
+     *
+     */
+    typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type buffer;
+
+    /**
+     * Size of the underlying type if placeable and the pointee is known to be of it, 0 otherwise
+     *
+     */
+    std::size_t size;
+
+    /**
+     * Whether the inline buffer currently holds an object
+     *
+     */
+    bool engaged;
+
+    /**
+     * Padding up to the buffer's alignment
+     *
+     */
+    [[no_unique_address]] explicit_padding<padding_to<sizeof(std::size_t) + sizeof(bool), alignof(std::max_align_t)>::value> padding;
+};
+
+
+
+/**
+ * Reference counting policy using atomic operations
+ *
+ * Suitable for sharing pointees across threads.
+ *
+ */
+struct atomic_refcount {
+  /**
+   * Type of the counter proper
+   *
+   */
+  using count_type = std::atomic<std::size_t>;
+
+  /**
+   * Increment the given counter
+   *
+   * @param c  Counter to increment
+   */
+  static void increment(count_type &c) noexcept;
+
+  /**
+   * Decrement the given counter
+   *
+   * @param c  Counter to decrement
+   * @return the counter's new value
+   */
+  static std::size_t decrement(count_type &c) noexcept;
+
+  /**
+   * Read the given counter
+   *
+   * @param c  Counter to read
+   * @return the counter's current value
+   */
+  static std::size_t load(count_type const &c) noexcept;
+};
+
+/**
+ * Reference counting policy using plain operations
+ *
+ * Only suitable for pointees that are never shared across threads, but
+ * cheaper than atomic_refcount.
+ *
+ */
+struct plain_refcount {
+  /**
+   * Type of the counter proper
+   *
+   */
+  using count_type = std::size_t;
+
+  /**
+   * Increment the given counter
+   *
+   * @param c  Counter to increment
+   */
+  static void increment(count_type &c) noexcept;
+
+  /**
+   * Decrement the given counter
+   *
+   * @param c  Counter to decrement
+   * @return the counter's new value
+   */
+  static std::size_t decrement(count_type &c) noexcept;
+
+  /**
+   * Read the given counter
+   *
+   * @param c  Counter to read
+   * @return the counter's current value
+   */
+  static std::size_t load(count_type const &c) noexcept __attribute__((pure));
+};
+
+
+
+/**
+ * Metaprogramming class encapsulating copy-on-write replication and destruction
+ *
+ * Replicating through this handler merely shares the pointee, bumping a
+ * reference count allocated upon adoption; value_ptr::mutable_get()
+ * detaches it (ie. performs a real replication using default_handler) only
+ * when it is actually shared, and destruction only takes place once the
+ * last owner lets go. Since value_ptr's other accessors never detach, every
+ * write must go through mutable_get().
+ *
+ * Note that this handler's state is tied to the pointee it owns: handlers
+ * should not be reassigned by hand (eg. via get_handler()) while owning.
+ *
+ * @param T  Underlying type this class handles
+ * @param Policy  Reference counting policy (atomic_refcount by default)
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ */
+template <typename T, typename Policy = atomic_refcount, typename ABI = Itanium>
+struct cow_handler : public default_handler<T, ABI> {
+  using default_handler<T, ABI>::slice_safe;
+
+  /**
+   * Type of the reference counter
+   *
+   */
+  using count_type = typename Policy::count_type;
+
+  /**
+   * Default constructor
+   *
+   * Initializes a handler owning nothing.
+   *
+   */
+  cow_handler() noexcept;
+
+  /**
+   * Copy constructor
+   *
+   * Initializes a handler referring to the same reference counter as the
+   * given one; sharing only actually takes place upon replication.
+   *
+   * @param other  Handler to copy
+   */
+  cow_handler(cow_handler const &other) noexcept;
+
+  /**
+   * Move constructor
+   *
+   * Takes over the given handler's reference counter.
+   *
+   * @param other  Handler to move
+   */
+  cow_handler(cow_handler &&other) noexcept;
+
+  /**
+   * Copy-assignment operator
+   *
+   * Refers to the same reference counter as the given handler.
+   *
+   * @param other  Handler to copy-assign
+   * @return the assigned handler
+   */
+  cow_handler &operator=(cow_handler const &other) noexcept;
+
+  /**
+   * Move-assignment operator
+   *
+   * Takes over the given handler's reference counter.
+   *
+   * @param other  Handler to move-assign
+   * @return the assigned handler
+   */
+  cow_handler &operator=(cow_handler &&other) noexcept;
+
+  /**
+   * Adoption implementation
+   *
+   * This method allocates a fresh reference counter for the adopted object;
+   * since adoption cannot fail, should that allocation throw the object is
+   * merely left unshared (copies then replicate it for real).
+   *
+   * @param T2  Static type of the adopted object
+   * @param <unnamed>  Pointer to the adopted object
+   */
+  template <typename T2> void adopt(T2 const *) noexcept;
+
+  /**
+   * Construction implementation
+   *
+   * This method delegates to default_handler, and then allocates a fresh
+   * reference counter for the new object (deleting it should that throw).
+   *
+   * @param T2  Class of the object to construct
+   * @param args  Arguments to forward to T2's constructor
+   * @return a new object constructed from args
+   */
+  template <typename T2, typename... Args> T2 *construct(Args&&... args);
+
+  /**
+   * Destroyer implementation
+   *
+   * This method drops a reference to the given object, destroying it (and
+   * its reference counter) if it was the last one.
+   *
+   * @param p  Pointer to the object to delete
+   */
+  void destroy(T const *p);
+
+  /**
+   * Replication implementation
+   *
+   * This method shares the given object if this handler refers to its
+   * reference counter (ie. it was copied from its owner's), and performs a
+   * real replication otherwise.
+   *
+   * @param p  Pointer to the object to copy
+   * @return either nullptr if nullptr is given, or a (possibly shared) copy of p
+   */
+  T *replicate(T const *p);
+
+  /**
+   * In-place assignment implementation
+   *
+   * Assignment never writes into a (possibly shared) object, this method
+   * only succeeds if both pointers refer to the very same object already,
+   * and sharing takes place otherwise.
+   *
+   * @param p  Pointer to the object to assign to
+   * @param q  Pointer to the object to assign from
+   * @return whether both pointers refer to the same object
+   */
+  static constexpr bool assign(T *p, T const *q) noexcept __attribute__((const));
+
+  /**
+   * Detachment implementation
+   *
+   * This method performs a real replication of the given object if it is
+   * shared, dropping the reference to the shared one.
+   *
+   * @param p  Pointer to the (possibly shared) object
+   * @return a pointer to an unshared object
+   */
+  T *detach(T *p);
+
+  /**
+   * Release implementation
+   *
+   * This method detaches the given object and drops its reference counter.
+   * Releasing a shared pointee thus replicates it, which may throw (leaving
+   * the pointee shared).
+   *
+   * @param p  Pointer to the object to release
+   * @return a pointer the caller may take ownership of
+   */
+  T *release(T *p);
+
+  protected:
+    /**
+     * Reference counter of the owned object, nullptr if none
+     *
+     */
+    count_type *count;
 };
 
 
@@ -4,11 +4,105 @@
 
 #include "Handler.h"
 
+#include <functional>
 #include <exception>
+#include <typeinfo>
+#include <utility>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <new>
 
 
+/**
+ * Destroy each object in the given array and then delete the substrate array
+ *
+ * Should any destructor throw, the remaining objects are still destroyed
+ * and the array deleted before rethrowing.
+ *
+ * During constant evaluation, the array is deleted through constant_array.
+ *
+ * @param p  Pointer to the array to delete
+ * @param n  Number of elements in the array
+ */
+template <typename T, typename ABI>
+constexpr void array_destroy<T, ABI>::destroy(T const *p, std::size_t n) {
+  if (std::is_constant_evaluated()) {
+    for (std::size_t i = n; i--; ) {
+      (p + i)->~T();
+    }
+    constant_array::delArray<T>(p, n);
+    return;
+  }
+
+  destroy(p, n, typename condition<std::is_trivially_destructible<T>::value>::type());
+}
+
+/**
+ * Delete an array of trivially destructible objects
+ *
+ * @param p  Pointer to the array to delete
+ * @param <unnamed>  Number of elements in the array
+ * @param <unnamed>  Tag indicating trivial destructibility
+ */
+template <typename T, typename ABI>
+void array_destroy<T, ABI>::destroy(T const *p, std::size_t, std::true_type) noexcept {
+  ABI::template delArray<T>(p);
+}
+
+/**
+ * Destroy and delete an array of non trivially destructible objects
+ *
+ * @param p  Pointer to the array to delete
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating trivial destructibility
+ */
+template <typename T, typename ABI>
+void array_destroy<T, ABI>::destroy(T const *p, std::size_t n, std::false_type) {
+  destroyEach(p, n, typename condition<std::is_nothrow_destructible<T>::value>::type());
+}
+
+/**
+ * Destroy and delete an array of nothrow destructible objects
+ *
+ * @param p  Pointer to the array to delete
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating nothrow destructibility
+ */
+template <typename T, typename ABI>
+void array_destroy<T, ABI>::destroyEach(T const *p, std::size_t n, std::true_type) noexcept {
+  while (n--) {
+    (p + n)->~T();
+  }
+  ABI::template delArray<T>(p);
+}
+
+/**
+ * Destroy and delete an array of potentially throwing destructible objects
+ *
+ * Should any destructor throw, the remaining objects are still destroyed
+ * and the array deleted before rethrowing.
+ *
+ * @param p  Pointer to the array to delete
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating nothrow destructibility
+ */
+template <typename T, typename ABI>
+void array_destroy<T, ABI>::destroyEach(T const *p, std::size_t n, std::false_type) {
+  try {
+    while (n--) {
+      (p + n)->~T();
+    }
+    ABI::template delArray<T>(p);
+  } catch (...) {
+    while (n--) {
+      try { (p + n)->~T(); } catch (...) { std::terminate(); }
+    }
+    ABI::template delArray<T>(p);
+    throw;
+  }
+}
+
 /**
  * Destroyer implementation
  *
@@ -17,7 +111,7 @@
  * @param p  Pointer to the object to delete
  */
 template <typename T, typename ABI>
-void default_destroy<T, ABI>::destroy(T const *p) const {
+constexpr void default_destroy<T, ABI>::destroy(T const *p) const {
   static_assert(sizeof(T) > 0, "default_destroy cannot work on incomplete types");
 
   delete p;
@@ -27,7 +121,8 @@ void default_destroy<T, ABI>::destroy(T const *p) const {
  * Destroyer implementation
  *
  * This method calls each object's destructor and then deletes the substrate
- * array.
+ * array (the array size is not even looked up for trivially destructible
+ * types).
  *
  * @param p  Pointer to the array to delete
  */
@@ -39,20 +134,29 @@ void default_destroy<T[], ABI>::destroy(T const *p) const {
     return;
   }
 
-  std::size_t n = ABI::template arraySize<T>(p), i = n;
+  destroyArray(p, typename condition<std::is_trivially_destructible<T>::value>::type());
+}
 
-  try {
-    while (i--) {
-      (p + i)->~T();
-    }
-    ABI::template delArray<T>(p);
-  } catch (...) {
-    while (i--) {
-      try { (p + i)->~T(); } catch (...) { std::terminate(); }
-    }
-    ABI::template delArray<T>(p);
-    throw;
-  }
+/**
+ * Destroyer implementation for trivially destructible types
+ *
+ * @param p  Pointer to the array to delete
+ * @param <unnamed>  Tag indicating trivial destructibility
+ */
+template <typename T, typename ABI>
+void default_destroy<T[], ABI>::destroyArray(T const *p, std::true_type) noexcept {
+  ABI::template delArray<T>(p);
+}
+
+/**
+ * Destroyer implementation for non trivially destructible types
+ *
+ * @param p  Pointer to the array to delete
+ * @param <unnamed>  Tag indicating trivial destructibility
+ */
+template <typename T, typename ABI>
+void default_destroy<T[], ABI>::destroyArray(T const *p, std::false_type) {
+  array_destroy<T, ABI>::destroy(p, ABI::template arraySize<T>(p));
 }
 
 /**
@@ -64,62 +168,124 @@ void default_destroy<T[], ABI>::destroy(T const *p) const {
  * @param p  Pointer to the array to delete
  */
 template <typename T, typename ABI, std::size_t N>
-void default_destroy<T[N], ABI>::destroy(T const *p) const {
+constexpr void default_destroy<T[N], ABI>::destroy(T const *p) const {
   static_assert(sizeof(T) > 0, "default_destroy cannot work on incomplete types");
 
   if (nullptr == p) {
     return;
   }
 
-  std::size_t i = N;
+  array_destroy<T, ABI>::destroy(p, N);
+}
 
-  try {
-    while (i--) {
-      (p + i)->~T();
-    }
-    ABI::template delArray<T>(p);
-  } catch (...) {
-    while (i--) {
-      try { (p + i)->~T(); } catch (...) { std::terminate(); }
+/**
+ * Return a new array copied from the given one
+ *
+ * Should any copy constructor throw, the already constructed objects are
+ * destroyed and the array deleted before rethrowing.
+ *
+ * During constant evaluation, the array is allocated through
+ * constant_array and copied element by element.
+ *
+ * @param p  Pointer to the array to copy
+ * @param n  Number of elements in the array
+ * @return a new array copied from p
+ */
+template <typename T, typename ABI>
+constexpr T *array_copy<T, ABI>::replicate(T const *p, std::size_t n) {
+  if (std::is_constant_evaluated()) {
+    T *ret = constant_array::newArray<T>(n);
+    for (std::size_t i = 0; i < n; i++) {
+      std::construct_at(ret + i, p[i]);
     }
-    ABI::template delArray<T>(p);
-    throw;
+    return ret;
   }
+
+  T *ret = ABI::template newArray<T>(n);
+  construct(ret, p, n, typename condition<std::is_trivially_copyable<T>::value>::type());
+
+  return ret;
 }
 
 /**
- * Replication implementation
+ * Copy-assign each object in the given array into the corresponding one in the other
  *
- * This method returns a new object of the underlying class by calling its
- * copy constructor on the given object, it returns nullptr if a nullptr is
- * given.
+ * Should any assignment throw, the array pointed to by p is destroyed
+ * before rethrowing.
  *
- * @param p  Pointer to the object to copy
- * @return either nullptr if nullptr is given, or a new object copied from p
+ * During constant evaluation, elements are assigned one by one.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
  */
 template <typename T, typename ABI>
-T *default_copy<T, ABI>::replicate(T const *p) const {
-  return nullptr != p ? new T{*p} : nullptr;
+constexpr void array_copy<T, ABI>::assign(T *p, T const *q, std::size_t n) {
+  if (std::is_constant_evaluated()) {
+    for (std::size_t i = 0; i < n; i++) {
+      p[i] = q[i];
+    }
+    return;
+  }
+
+  assign(p, q, n, typename condition<std::is_trivially_copyable<T>::value>::type());
 }
 
 /**
- * Replication implementation
+ * Construct copies of trivially copyable objects
  *
- * This method returns a new array of objects of the underlying class by
- * performing a placement new using its copy constructor on each given
- * object, it returns nullptr if a nullptr is given.
+ * @param ret  Pointer to the uninitialized array
+ * @param p  Pointer to the array to copy
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T, typename ABI>
+void array_copy<T, ABI>::construct(T *ret, T const *p, std::size_t n, std::true_type) noexcept {
+  std::memcpy(static_cast<void *>(ret), static_cast<void const *>(p), n * sizeof(T));
+}
+
+/**
+ * Construct copies of non trivially copyable objects
  *
+ * @param ret  Pointer to the uninitialized array
  * @param p  Pointer to the array to copy
- * @return either nullptr if nullptr is given, or a new array copied from p
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating trivial copyability
  */
 template <typename T, typename ABI>
-T *default_copy<T[], ABI>::replicate(T const *p) const {
-  if (nullptr == p) {
-    return nullptr;
+void array_copy<T, ABI>::construct(T *ret, T const *p, std::size_t n, std::false_type) {
+  constructEach(ret, p, n, typename condition<std::is_nothrow_copy_constructible<T>::value>::type());
+}
+
+/**
+ * Construct copies of nothrow copy constructible objects
+ *
+ * @param ret  Pointer to the uninitialized array
+ * @param p  Pointer to the array to copy
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating nothrow copy constructibility
+ */
+template <typename T, typename ABI>
+void array_copy<T, ABI>::constructEach(T *ret, T const *p, std::size_t n, std::true_type) noexcept {
+  for (std::size_t i = 0; i < n; i++) {
+    new(ret + i) T{p[i]};
   }
+}
 
-  std::size_t i, n = ABI::template arraySize<T>(p);
-  T *ret = ABI::template newArray<T>(n);
+/**
+ * Construct copies of potentially throwing copy constructible objects
+ *
+ * Should any copy constructor throw, the already constructed objects are
+ * destroyed and the array deleted before rethrowing.
+ *
+ * @param ret  Pointer to the uninitialized array
+ * @param p  Pointer to the array to copy
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating nothrow copy constructibility
+ */
+template <typename T, typename ABI>
+void array_copy<T, ABI>::constructEach(T *ret, T const *p, std::size_t n, std::false_type) {
+  std::size_t i;
 
   try {
     for (i = 0; i < n; i++) {
@@ -132,81 +298,142 @@ T *default_copy<T[], ABI>::replicate(T const *p) const {
     ABI::template delArray<T>(ret);
     throw;
   }
+}
 
-  return ret;
+/**
+ * Copy-assign trivially copyable objects
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T, typename ABI>
+void array_copy<T, ABI>::assign(T *p, T const *q, std::size_t n, std::true_type) noexcept {
+  if (p != q) {
+    std::memcpy(static_cast<void *>(p), static_cast<void const *>(q), n * sizeof(T));
+  }
 }
 
 /**
- * Replication implementation
+ * Copy-assign non trivially copyable objects
  *
- * This method returns a new array of objects of the underlying class by
- * performing a placement new using its copy constructor on each given
- * object, it returns nullptr if a nullptr is given.
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T, typename ABI>
+void array_copy<T, ABI>::assign(T *p, T const *q, std::size_t n, std::false_type) {
+  assignEach(p, q, n, typename condition<std::is_nothrow_copy_assignable<T>::value>::type());
+}
+
+/**
+ * Copy-assign nothrow copy-assignable objects
  *
- * @param p  Pointer to the array to copy
- * @return either nullptr if nullptr is given, or a new array copied from p
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
  */
-template <typename T, typename ABI, std::size_t N>
-T *default_copy<T[N], ABI>::replicate(T const *p) const {
-  if (nullptr == p) {
-    return nullptr;
+template <typename T, typename ABI>
+void array_copy<T, ABI>::assignEach(T *p, T const *q, std::size_t n, std::true_type) noexcept {
+  for (std::size_t i = 0; i < n; i++) {
+    p[i] = q[i];
   }
+}
 
-  std::size_t i;
-  T *ret = ABI::template newArray<T>(N);
-
+/**
+ * Copy-assign potentially throwing copy-assignable objects
+ *
+ * Should any assignment throw, the array pointed to by p is destroyed
+ * before rethrowing.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ */
+template <typename T, typename ABI>
+void array_copy<T, ABI>::assignEach(T *p, T const *q, std::size_t n, std::false_type) {
   try {
-    for (i = 0; i < N; i++) {
-      new(ret + i) T{p[i]};
+    for (std::size_t i = 0; i < n; i++) {
+      p[i] = q[i];
     }
   } catch (...) {
-    while (i--) {
-      try { (ret + i)->~T(); } catch (...) { std::terminate(); }
+    while (n--) {
+      try { (p + n)->~T(); } catch (...) { std::terminate(); }
     }
-    ABI::template delArray<T>(ret);
+    ABI::template delArray<T>(p);
     throw;
   }
-
-  return ret;
 }
 
 /**
- * Replication implementation
+ * Return a new array of objects value-initialized, or constructed from the given arguments
  *
- * This method returns a new object of the underlying class by calling its
- * "clone" method on the given object, it returns nullptr if a nullptr is
- * given.
+ * Should any constructor throw, the already constructed objects are
+ * destroyed and the array deleted before rethrowing.
  *
- * @param p  Pointer to the object to copy
- * @return either nullptr if nullptr is given, or a new object cloned from p
+ * During constant evaluation, the array is allocated through
+ * constant_array.
+ *
+ * @param n  Number of elements in the array
+ * @param args  Arguments to construct every element from, in order
+ * @return a new array of n objects
  */
 template <typename T, typename ABI>
-T *default_clone<T, ABI>::replicate(T const *p) const {
-  return nullptr != p ? p->clone() : nullptr;
+template <typename... Args>
+constexpr T *array_construct<T, ABI>::construct(std::size_t n, Args &... args) {
+  if (std::is_constant_evaluated()) {
+    T *ret = constant_array::newArray<T>(n);
+    for (std::size_t i = 0; i < n; i++) {
+      std::construct_at(ret + i, args...);
+    }
+    return ret;
+  }
+
+  T *ret = ABI::template newArray<T>(n);
+  constructEach(ret, n, typename condition<std::is_nothrow_constructible<T, Args &...>::value>::type(), args...);
+
+  return ret;
 }
 
 /**
- * Replication implementation
- *
- * This method returns a new array of objects of the underlying class by
- * performing a placement clone on each given object, it returns nullptr if
- * a nullptr is given.
+ * Construct nothrow constructible objects
  *
- * @param p  Pointer to the array to copy
- * @return either nullptr if nullptr is given, or a new array cloned from p
+ * @param ret  Pointer to the uninitialized array
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating nothrow constructibility
+ * @param args  Arguments to construct every element from, in order
  */
 template <typename T, typename ABI>
-T *default_clone<T[], ABI>::replicate(T const *p) const {
-  if (nullptr == p) {
-    return nullptr;
+template <typename... Args>
+void array_construct<T, ABI>::constructEach(T *ret, std::size_t n, std::true_type, Args &... args) noexcept {
+  for (std::size_t i = 0; i < n; i++) {
+    new(ret + i) T(args...);
   }
+}
 
-  std::size_t i, n = ABI::template arraySize<T>(p);
-  T *ret = ABI::template newArray<T>(n);
+/**
+ * Construct potentially throwing constructible objects
+ *
+ * Should any constructor throw, the already constructed objects are
+ * destroyed and the array deleted before rethrowing.
+ *
+ * @param ret  Pointer to the uninitialized array
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating nothrow constructibility
+ * @param args  Arguments to construct every element from, in order
+ */
+template <typename T, typename ABI>
+template <typename... Args>
+void array_construct<T, ABI>::constructEach(T *ret, std::size_t n, std::false_type, Args &... args) {
+  std::size_t i;
 
   try {
     for (i = 0; i < n; i++) {
-      (p + i)->clone(ret + i);
+      new(ret + i) T(args...);
     }
   } catch (...) {
     while (i--) {
@@ -215,22 +442,408 @@ T *default_clone<T[], ABI>::replicate(T const *p) const {
     ABI::template delArray<T>(ret);
     throw;
   }
+}
 
-  return ret;
+
+/**
+ * Replication implementation
+ *
+ * This method returns a new object of the underlying class by calling its
+ * copy constructor on the given object, it returns nullptr if a nullptr is
+ * given.
+ *
+ * @param p  Pointer to the object to copy
+ * @return either nullptr if nullptr is given, or a new object copied from p
+ */
+template <typename T, typename ABI>
+constexpr T *default_copy<T, ABI>::replicate(T const *p) const {
+  return nullptr != p ? new T{*p} : nullptr;
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * This method copy-assigns the object pointed to by q into the one pointed
+ * to by p, provided the underlying class is nothrow copy-assignable; other
+ * classes are replicated and swapped in instead, so that a throwing copy
+ * leaves the object pointed to by p untouched.
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename ABI>
+constexpr bool default_copy<T, ABI>::assign(T *p, T const *q) const {
+  return assignInPlace(p, q, typename condition<std::is_nothrow_copy_assignable<T>::value>::type());
+}
+
+/**
+ * In-place assignment implementation for nothrow copy-assignable types
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ * @return true, always
+ */
+template <typename T, typename ABI>
+constexpr bool default_copy<T, ABI>::assignInPlace(T *p, T const *q, std::true_type) noexcept {
+  *p = *q;
+
+  return true;
+}
+
+/**
+ * In-place assignment implementation for potentially throwing or non copy-assignable types
+ *
+ * @param <unnamed>  Pointer to the object to assign to
+ * @param <unnamed>  Pointer to the object to assign from
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ * @return false, always
+ */
+template <typename T, typename ABI>
+constexpr bool default_copy<T, ABI>::assignInPlace(T *, T const *, std::false_type) noexcept {
+  return false;
 }
 
 /**
  * Replication implementation
  *
  * This method returns a new array of objects of the underlying class by
- * performing a placement clone on each given object, it returns nullptr if
- * a nullptr is given.
+ * performing a placement new using its copy constructor on each given
+ * object (or a single bulk copy for trivially copyable types), it returns
+ * nullptr if a nullptr is given.
  *
  * @param p  Pointer to the array to copy
- * @return either nullptr if nullptr is given, or a new array cloned from p
+ * @return either nullptr if nullptr is given, or a new array copied from p
  */
-template <typename T, typename ABI, std::size_t N>
-T *default_clone<T[N], ABI>::replicate(T const *p) const {
+template <typename T, typename ABI>
+T *default_copy<T[], ABI>::replicate(T const *p) const {
+  if (nullptr == p) {
+    return nullptr;
+  }
+
+  return array_copy<T, ABI>::replicate(p, ABI::template arraySize<T>(p));
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * This method copy-assigns each object in the array pointed to by q into
+ * the corresponding one in the array pointed to by p, provided both arrays
+ * have the same length and the underlying class is nothrow
+ * copy-assignable; other classes are replicated and swapped in instead, so
+ * that a throwing copy leaves the array pointed to by p untouched.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename ABI>
+bool default_copy<T[], ABI>::assign(T *p, T const *q) const {
+  std::size_t n = ABI::template arraySize<T>(p);
+  if (n != ABI::template arraySize<T>(q)) {
+    return false;
+  }
+
+  return assignInPlace(p, q, n, typename condition<std::is_nothrow_copy_assignable<T>::value>::type());
+}
+
+/**
+ * In-place assignment implementation for nothrow copy-assignable types
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ * @return true, always
+ */
+template <typename T, typename ABI>
+bool default_copy<T[], ABI>::assignInPlace(T *p, T const *q, std::size_t n, std::true_type) {
+  array_copy<T, ABI>::assign(p, q, n);
+
+  return true;
+}
+
+/**
+ * In-place assignment implementation for potentially throwing or non copy-assignable types
+ *
+ * @param <unnamed>  Pointer to the array to assign to
+ * @param <unnamed>  Pointer to the array to assign from
+ * @param <unnamed>  Number of elements in both arrays
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ * @return false, always
+ */
+template <typename T, typename ABI>
+constexpr bool default_copy<T[], ABI>::assignInPlace(T *, T const *, std::size_t, std::false_type) noexcept {
+  return false;
+}
+
+/**
+ * Replication implementation
+ *
+ * This method returns a new array of objects of the underlying class by
+ * performing a placement new using its copy constructor on each given
+ * object (or a single bulk copy for trivially copyable types), it returns
+ * nullptr if a nullptr is given.
+ *
+ * @param p  Pointer to the array to copy
+ * @return either nullptr if nullptr is given, or a new array copied from p
+ */
+template <typename T, typename ABI, std::size_t N>
+constexpr T *default_copy<T[N], ABI>::replicate(T const *p) const {
+  if (nullptr == p) {
+    return nullptr;
+  }
+
+  return array_copy<T, ABI>::replicate(p, N);
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * This method copy-assigns each object in the array pointed to by q into
+ * the corresponding one in the array pointed to by p, provided both arrays
+ * have the same length and the underlying class is nothrow
+ * copy-assignable; other classes are replicated and swapped in instead, so
+ * that a throwing copy leaves the array pointed to by p untouched.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename ABI, std::size_t N>
+constexpr bool default_copy<T[N], ABI>::assign(T *p, T const *q) const {
+  return assignInPlace(p, q, N, typename condition<std::is_nothrow_copy_assignable<T>::value>::type());
+}
+
+/**
+ * In-place assignment implementation for nothrow copy-assignable types
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ * @return true, always
+ */
+template <typename T, typename ABI, std::size_t N>
+constexpr bool default_copy<T[N], ABI>::assignInPlace(T *p, T const *q, std::size_t n, std::true_type) {
+  array_copy<T, ABI>::assign(p, q, n);
+
+  return true;
+}
+
+/**
+ * In-place assignment implementation for potentially throwing or non copy-assignable types
+ *
+ * @param <unnamed>  Pointer to the array to assign to
+ * @param <unnamed>  Pointer to the array to assign from
+ * @param <unnamed>  Number of elements in both arrays
+ * @param <unnamed>  Tag indicating nothrow copy-assignability
+ * @return false, always
+ */
+template <typename T, typename ABI, std::size_t N>
+constexpr bool default_copy<T[N], ABI>::assignInPlace(T *, T const *, std::size_t, std::false_type) noexcept {
+  return false;
+}
+
+/**
+ * Replication implementation
+ *
+ * This method returns a new object of the underlying class by calling its
+ * "clone" method on the given object, it returns nullptr if a nullptr is
+ * given.
+ *
+ * @param p  Pointer to the object to copy
+ * @return either nullptr if nullptr is given, or a new object cloned from p
+ */
+template <typename T, typename ABI>
+constexpr T *default_clone<T, ABI>::replicate(T const *p) const {
+  return nullptr != p ? p->clone() : nullptr;
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * If both objects share the same dynamic type and the underlying class is
+ * placement cloneable, this method destroys the object pointed to by p and
+ * placement clones the one pointed to by q into its storage; should the
+ * placement clone throw, the storage is returned to the deallocation
+ * function a delete expression would use (T's own, if it declares or
+ * inherits one, the global one otherwise) before rethrowing.
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename ABI>
+bool default_clone<T, ABI>::assign(T *p, T const *q) const {
+  return assignInPlace(p, q, typename condition<is_placement_cloneable<T>::value>::type());
+}
+
+/**
+ * In-place assignment implementation for placement cloneable types
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @param <unnamed>  Tag indicating placement cloneability
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename ABI>
+bool default_clone<T, ABI>::assignInPlace(T *p, T const *q, std::true_type) {
+  if (typeid(*p) != typeid(*q)) {
+    return false;
+  }
+
+  void *raw = dynamic_cast<void *>(p);
+
+  p->~T();
+  try {
+    q->clone(raw);
+  } catch (...) {
+    deallocate(raw, 0);
+    throw;
+  }
+
+  return true;
+}
+
+/**
+ * Return storage to T's class-specific deallocation function
+ *
+ * @param raw  Pointer to the storage to deallocate
+ * @param <unnamed>  int parameter to use for overload prioritization
+ */
+template <typename T, typename ABI>
+template <typename T2>
+auto default_clone<T, ABI>::deallocate(void *raw, int) noexcept -> decltype(T2::operator delete(raw), void()) {
+  T2::operator delete(raw);
+}
+
+/**
+ * Return storage to the global deallocation function
+ *
+ * @param raw  Pointer to the storage to deallocate
+ * @param <unnamed>  long parameter to use for overload prioritization
+ */
+template <typename T, typename ABI>
+void default_clone<T, ABI>::deallocate(void *raw, long) noexcept {
+  ::operator delete(raw);
+}
+
+/**
+ * In-place assignment implementation for non placement cloneable types
+ *
+ * @param <unnamed>  Pointer to the object to assign to
+ * @param <unnamed>  Pointer to the object to assign from
+ * @param <unnamed>  Tag indicating placement cloneability
+ * @return false, always
+ */
+template <typename T, typename ABI>
+constexpr bool default_clone<T, ABI>::assignInPlace(T *, T const *, std::false_type) noexcept {
+  return false;
+}
+
+/**
+ * Replication implementation
+ *
+ * This method returns a new array of objects of the underlying class by
+ * performing a placement clone on each given object, it returns nullptr if
+ * a nullptr is given.
+ *
+ * @param p  Pointer to the array to copy
+ * @return either nullptr if nullptr is given, or a new array cloned from p
+ */
+template <typename T, typename ABI>
+T *default_clone<T[], ABI>::replicate(T const *p) const {
+  if (nullptr == p) {
+    return nullptr;
+  }
+
+  std::size_t i, n = ABI::template arraySize<T>(p);
+  T *ret = ABI::template newArray<T>(n);
+
+  try {
+    for (i = 0; i < n; i++) {
+      (p + i)->clone(ret + i);
+    }
+  } catch (...) {
+    while (i--) {
+      try { (ret + i)->~T(); } catch (...) { std::terminate(); }
+    }
+    ABI::template delArray<T>(ret);
+    throw;
+  }
+
+  return ret;
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * Provided both arrays have the same length, this method destroys each
+ * object in the array pointed to by p and placement clones the
+ * corresponding one in the array pointed to by q into its storage; should
+ * any placement clone throw, the array pointed to by p is destroyed before
+ * rethrowing.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename ABI>
+bool default_clone<T[], ABI>::assign(T *p, T const *q) const {
+  std::size_t n = ABI::template arraySize<T>(p);
+  if (n != ABI::template arraySize<T>(q)) {
+    return false;
+  }
+
+  return assignInPlace(p, q, n);
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
+ * @return true, always
+ */
+template <typename T, typename ABI>
+bool default_clone<T[], ABI>::assignInPlace(T *p, T const *q, std::size_t n) {
+  std::size_t i;
+
+  try {
+    for (i = 0; i < n; i++) {
+      (p + i)->~T();
+      (q + i)->clone(p + i);
+    }
+  } catch (...) {
+    std::size_t j = n;
+    while (--j > i) {
+      try { (p + j)->~T(); } catch (...) { std::terminate(); }
+    }
+    while (i--) {
+      try { (p + i)->~T(); } catch (...) { std::terminate(); }
+    }
+    ABI::template delArray<T>(p);
+    throw;
+  }
+
+  return true;
+}
+
+/**
+ * Replication implementation
+ *
+ * This method returns a new array of objects of the underlying class by
+ * performing a placement clone on each given object, it returns nullptr if
+ * a nullptr is given.
+ *
+ * @param p  Pointer to the array to copy
+ * @return either nullptr if nullptr is given, or a new array cloned from p
+ */
+template <typename T, typename ABI, std::size_t N>
+T *default_clone<T[N], ABI>::replicate(T const *p) const {
   if (nullptr == p) {
     return nullptr;
   }
@@ -253,6 +866,644 @@ T *default_clone<T[N], ABI>::replicate(T const *p) const {
   return ret;
 }
 
+/**
+ * In-place assignment implementation
+ *
+ * Provided both arrays have the same length, this method destroys each
+ * object in the array pointed to by p and placement clones the
+ * corresponding one in the array pointed to by q into its storage; should
+ * any placement clone throw, the array pointed to by p is destroyed before
+ * rethrowing.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename ABI, std::size_t N>
+bool default_clone<T[N], ABI>::assign(T *p, T const *q) const {
+  return assignInPlace(p, q, N);
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @param n  Number of elements in both arrays
+ * @return true, always
+ */
+template <typename T, typename ABI, std::size_t N>
+bool default_clone<T[N], ABI>::assignInPlace(T *p, T const *q, std::size_t n) {
+  std::size_t i;
+
+  try {
+    for (i = 0; i < n; i++) {
+      (p + i)->~T();
+      (q + i)->clone(p + i);
+    }
+  } catch (...) {
+    std::size_t j = n;
+    while (--j > i) {
+      try { (p + j)->~T(); } catch (...) { std::terminate(); }
+    }
+    while (i--) {
+      try { (p + i)->~T(); } catch (...) { std::terminate(); }
+    }
+    ABI::template delArray<T>(p);
+    throw;
+  }
+
+  return true;
+}
+
+
+/**
+ * Construction implementation
+ *
+ * This method returns a new object of class T2 (T or a class derived
+ * from it) constructed from the given arguments.
+ *
+ * @param T2  Class of the object to construct
+ * @param args  Arguments to forward to T2's constructor
+ * @return a new object constructed from args
+ */
+template <typename T, typename ABI>
+template <typename T2, typename... Args>
+constexpr T2 *default_construct<T, ABI>::construct(Args&&... args) const {
+  return new T2(std::forward<Args>(args)...);
+}
+
+/**
+ * Construction implementation
+ *
+ * This method returns a new array of objects of the underlying class,
+ * value-initialized or constructed from the given (lvalue) arguments in
+ * order, allocated through the ABI adapter.
+ *
+ * @param T2  Array type to construct (T[])
+ * @param n  Number of elements in the array
+ * @param args  Arguments to construct every element from
+ * @return a new array of n objects
+ */
+template <typename T, typename ABI>
+template <typename T2, typename... Args>
+T *default_construct<T[], ABI>::construct(std::size_t n, Args &... args) const {
+  static_assert(std::is_same<T2, T[]>::value, "arrays can only be constructed as such");
+
+  return array_construct<T, ABI>::construct(n, args...);
+}
+
+/**
+ * Construction implementation
+ *
+ * This method returns a new array of N objects of the underlying class,
+ * value-initialized or constructed from the given (lvalue) arguments in
+ * order, allocated through the ABI adapter.
+ *
+ * @param T2  Array type to construct (T[N])
+ * @param args  Arguments to construct every element from
+ * @return a new array of N objects
+ */
+template <typename T, typename ABI, std::size_t N>
+template <typename T2, typename... Args>
+constexpr T *default_construct<T[N], ABI>::construct(Args &... args) const {
+  static_assert(std::is_same<T2, T[N]>::value, "arrays can only be constructed as such");
+
+  return array_construct<T, ABI>::construct(N, args...);
+}
+
+
+/**
+ * Default constructor
+ *
+ * Initializes an empty buffer, the pointee is assumed to be of the
+ * underlying type.
+ *
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+inline_handler<T, Capacity, ABI>::inline_handler() noexcept : default_handler<T, ABI>(), buffer(), size(placeable ? sizeof(T) : 0), engaged(false), padding() {}
+
+/**
+ * Copy constructor
+ *
+ * Initializes an empty buffer, copying only the knowledge of the pointee's
+ * dynamic type.
+ *
+ * @param other  Handler to copy
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+inline_handler<T, Capacity, ABI>::inline_handler(inline_handler<T, Capacity, ABI> const &other) noexcept : default_handler<T, ABI>(other), buffer(), size(other.size), engaged(false), padding() {}
+
+/**
+ * Copy-assignment operator
+ *
+ * Leaves the buffer untouched, copying only the knowledge of the pointee's
+ * dynamic type.
+ *
+ * @param other  Handler to copy-assign
+ * @return the assigned handler
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+inline_handler<T, Capacity, ABI> &inline_handler<T, Capacity, ABI>::operator=(inline_handler<T, Capacity, ABI> const &other) noexcept {
+  size = other.size;
+  return *this;
+}
+
+/**
+ * Adoption implementation
+ *
+ * This method records whether the adopted object is of the underlying
+ * type, and may thus be replicated into the inline buffer.
+ *
+ * @param T2  Static type of the adopted object
+ * @param <unnamed>  Pointer to the adopted object
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+template <typename T2>
+void inline_handler<T, Capacity, ABI>::adopt(T2 const *) noexcept {
+  size = placeable && std::is_same<T2, T>::value ? sizeof(T) : 0;
+}
+
+/**
+ * Construction implementation
+ *
+ * This method constructs the new object in the inline buffer if it is
+ * free and T2 is the (placeable) underlying type, and delegates to
+ * default_handler (adopting the new object) otherwise.
+ *
+ * @param T2  Class of the object to construct
+ * @param args  Arguments to forward to T2's constructor
+ * @return a new object constructed from args
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+template <typename T2, typename... Args>
+T2 *inline_handler<T, Capacity, ABI>::construct(Args&&... args) {
+  if (!placeable || engaged || !std::is_same<T2, T>::value) {
+    T2 *ret = default_handler<T, ABI>::template construct<T2>(std::forward<Args>(args)...);
+    adopt(ret);
+    return ret;
+  }
+
+  T2 *ret = new(&buffer) T2(std::forward<Args>(args)...);
+  size = sizeof(T);
+  engaged = true;
+  return ret;
+}
+
+/**
+ * Destroyer implementation
+ *
+ * This method destroys in place an object held in the inline buffer, and
+ * delegates to default_handler otherwise.
+ *
+ * @param p  Pointer to the object to delete
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+void inline_handler<T, Capacity, ABI>::destroy(T const *p) {
+  if (holds(p)) {
+    engaged = false;
+    p->~T();
+  } else {
+    default_handler<T, ABI>::destroy(p);
+  }
+}
+
+/**
+ * Replication implementation
+ *
+ * This method constructs the replica in the inline buffer if it is free
+ * and the object is of the (placeable) underlying type, and delegates to
+ * default_handler otherwise.
+ *
+ * @param p  Pointer to the object to copy
+ * @return either nullptr if nullptr is given, or a new object copied from p
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+T *inline_handler<T, Capacity, ABI>::replicate(T const *p) {
+  if (nullptr == p || engaged || 0 == size) {
+    return default_handler<T, ABI>::replicate(p);
+  }
+
+  T *ret = place(p, typename condition<is_cloneable<T>::value>::type());
+  engaged = true;
+  return ret;
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * For objects held in the inline buffer, this method destroys the object
+ * and copies the other one into its place (provided both dynamic types
+ * coincide); should the copy throw, the buffer is left empty. For other
+ * objects, it delegates to default_handler.
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+bool inline_handler<T, Capacity, ABI>::assign(T *p, T const *q) {
+  if (!holds(p)) {
+    return default_handler<T, ABI>::assign(p, q);
+  }
+
+  if (typeid(*p) != typeid(*q)) {
+    return false;
+  }
+
+  engaged = false;
+  p->~T();
+  place(q, typename condition<is_cloneable<T>::value>::type());
+  engaged = true;
+
+  return true;
+}
+
+/**
+ * Relocation implementation
+ *
+ * This method moves an object held in the given handler's inline buffer
+ * into this one's (which value_ptr always empties beforehand), pointers to
+ * heap objects are simply taken over.
+ *
+ * @param from  Handler currently owning the object
+ * @param p  Pointer to the object to take over
+ * @return the pointer to use from now on
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+T *inline_handler<T, Capacity, ABI>::relocate(inline_handler<T, Capacity, ABI> &from, T *p) noexcept {
+  if (!from.holds(p)) {
+    return p;
+  }
+
+  T *ret = placeMoved(p);
+  engaged = true;
+  from.engaged = false;
+  p->~T();
+
+  return ret;
+}
+
+/**
+ * Release implementation
+ *
+ * This method moves an object held in the inline buffer onto the heap (and
+ * destroys the inline one), pointers to heap objects are simply handed
+ * back.
+ *
+ * @param p  Pointer to the object to release
+ * @return a pointer the caller may take ownership of
+ * @throws std::bad_alloc  In case the heap object cannot be allocated
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+T *inline_handler<T, Capacity, ABI>::release(T *p) {
+  if (!holds(p)) {
+    return p;
+  }
+
+  T *ret = new T(std::move(*p));
+  destroy(p);
+
+  return ret;
+}
+
+/**
+ * Determine whether the given pointer is the one held in the inline buffer
+ *
+ * Inline objects are always of the underlying type, hence placed at the
+ * very start of the buffer.
+ *
+ * @param p  Pointer to check
+ * @return true if p points to the inline buffer
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+bool inline_handler<T, Capacity, ABI>::holds(T const *p) const noexcept {
+  return static_cast<void const *>(p) == static_cast<void const *>(&buffer);
+}
+
+/**
+ * Copy the given object into the inline buffer using its copy constructor
+ *
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ * @return a pointer to the new inline object
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+T *inline_handler<T, Capacity, ABI>::place(T const *p, std::false_type) {
+  return new(&buffer) T{*p};
+}
+
+/**
+ * Copy the given object into the inline buffer using its placement clone method
+ *
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ * @return a pointer to the new inline object
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+T *inline_handler<T, Capacity, ABI>::place(T const *p, std::true_type) {
+  return p->clone(&buffer);
+}
+
+/**
+ * Move the given object into the inline buffer using its move constructor
+ *
+ * @param p  Pointer to the object to move
+ * @return a pointer to the new inline object
+ */
+template <typename T, std::size_t Capacity, typename ABI>
+T *inline_handler<T, Capacity, ABI>::placeMoved(T *p) noexcept {
+  return new(&buffer) T(std::move(*p));
+}
+
+
+/**
+ * Increment the given counter
+ *
+ * @param c  Counter to increment
+ */
+inline void atomic_refcount::increment(atomic_refcount::count_type &c) noexcept {
+  c.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Decrement the given counter
+ *
+ * @param c  Counter to decrement
+ * @return the counter's new value
+ */
+inline std::size_t atomic_refcount::decrement(atomic_refcount::count_type &c) noexcept {
+  return c.fetch_sub(1, std::memory_order_acq_rel) - 1;
+}
+
+/**
+ * Read the given counter
+ *
+ * @param c  Counter to read
+ * @return the counter's current value
+ */
+inline std::size_t atomic_refcount::load(atomic_refcount::count_type const &c) noexcept {
+  return c.load(std::memory_order_acquire);
+}
+
+/**
+ * Increment the given counter
+ *
+ * @param c  Counter to increment
+ */
+inline void plain_refcount::increment(plain_refcount::count_type &c) noexcept {
+  ++c;
+}
+
+/**
+ * Decrement the given counter
+ *
+ * @param c  Counter to decrement
+ * @return the counter's new value
+ */
+inline std::size_t plain_refcount::decrement(plain_refcount::count_type &c) noexcept {
+  return --c;
+}
+
+/**
+ * Read the given counter
+ *
+ * @param c  Counter to read
+ * @return the counter's current value
+ */
+inline std::size_t plain_refcount::load(plain_refcount::count_type const &c) noexcept {
+  return c;
+}
+
+/**
+ * Default constructor
+ *
+ * Initializes a handler owning nothing.
+ *
+ */
+template <typename T, typename Policy, typename ABI>
+cow_handler<T, Policy, ABI>::cow_handler() noexcept : default_handler<T, ABI>(), count(nullptr) {}
+
+/**
+ * Copy constructor
+ *
+ * Initializes a handler referring to the same reference counter as the
+ * given one; sharing only actually takes place upon replication.
+ *
+ * @param other  Handler to copy
+ */
+template <typename T, typename Policy, typename ABI>
+cow_handler<T, Policy, ABI>::cow_handler(cow_handler<T, Policy, ABI> const &other) noexcept : default_handler<T, ABI>(other), count(other.count) {}
+
+/**
+ * Move constructor
+ *
+ * Takes over the given handler's reference counter.
+ *
+ * @param other  Handler to move
+ */
+template <typename T, typename Policy, typename ABI>
+cow_handler<T, Policy, ABI>::cow_handler(cow_handler<T, Policy, ABI> &&other) noexcept : default_handler<T, ABI>(other), count(other.count) { other.count = nullptr; }
+
+/**
+ * Copy-assignment operator
+ *
+ * Refers to the same reference counter as the given handler.
+ *
+ * @param other  Handler to copy-assign
+ * @return the assigned handler
+ */
+template <typename T, typename Policy, typename ABI>
+cow_handler<T, Policy, ABI> &cow_handler<T, Policy, ABI>::operator=(cow_handler<T, Policy, ABI> const &other) noexcept {
+  count = other.count;
+  return *this;
+}
+
+/**
+ * Move-assignment operator
+ *
+ * Takes over the given handler's reference counter.
+ *
+ * @param other  Handler to move-assign
+ * @return the assigned handler
+ */
+template <typename T, typename Policy, typename ABI>
+cow_handler<T, Policy, ABI> &cow_handler<T, Policy, ABI>::operator=(cow_handler<T, Policy, ABI> &&other) noexcept {
+  if (this != &other) {
+    count = other.count;
+    other.count = nullptr;
+  }
+  return *this;
+}
+
+/**
+ * Adoption implementation
+ *
+ * This method allocates a fresh reference counter for the adopted object;
+ * since adoption cannot fail, should that allocation throw the object is
+ * merely left unshared (copies then replicate it for real).
+ *
+ * @param T2  Static type of the adopted object
+ * @param <unnamed>  Pointer to the adopted object
+ */
+template <typename T, typename Policy, typename ABI>
+template <typename T2>
+void cow_handler<T, Policy, ABI>::adopt(T2 const *) noexcept {
+  try {
+    count = new count_type(1);
+  } catch (std::bad_alloc const &) {
+    count = nullptr;
+  }
+}
+
+/**
+ * Construction implementation
+ *
+ * This method delegates to default_handler, and then allocates a fresh
+ * reference counter for the new object (deleting it should that throw).
+ *
+ * @param T2  Class of the object to construct
+ * @param args  Arguments to forward to T2's constructor
+ * @return a new object constructed from args
+ */
+template <typename T, typename Policy, typename ABI>
+template <typename T2, typename... Args>
+T2 *cow_handler<T, Policy, ABI>::construct(Args&&... args) {
+  T2 *ret = default_handler<T, ABI>::template construct<T2>(std::forward<Args>(args)...);
+
+  try {
+    count = new count_type(1);
+  } catch (...) {
+    default_handler<T, ABI>::destroy(ret);
+    throw;
+  }
+
+  return ret;
+}
+
+/**
+ * Destroyer implementation
+ *
+ * This method drops a reference to the given object, destroying it (and
+ * its reference counter) if it was the last one.
+ *
+ * @param p  Pointer to the object to delete
+ */
+template <typename T, typename Policy, typename ABI>
+void cow_handler<T, Policy, ABI>::destroy(T const *p) {
+  if (nullptr == p) {
+    return;
+  }
+
+  count_type *c = count;
+  count = nullptr;
+  if (nullptr == c || 0 == Policy::decrement(*c)) {
+    delete c;
+    default_handler<T, ABI>::destroy(p);
+  }
+}
+
+/**
+ * Replication implementation
+ *
+ * This method shares the given object if this handler refers to its
+ * reference counter (ie. it was copied from its owner's), and performs a
+ * real replication otherwise.
+ *
+ * @param p  Pointer to the object to copy
+ * @return either nullptr if nullptr is given, or a (possibly shared) copy of p
+ */
+template <typename T, typename Policy, typename ABI>
+T *cow_handler<T, Policy, ABI>::replicate(T const *p) {
+  if (nullptr == p) {
+    count = nullptr;
+    return nullptr;
+  }
+
+  if (nullptr != count) {
+    Policy::increment(*count);
+    return const_cast<T *>(p);
+  }
+
+  T *ret = default_handler<T, ABI>::replicate(p);
+  try {
+    count = new count_type(1);
+  } catch (...) {
+    default_handler<T, ABI>::destroy(ret);
+    throw;
+  }
+
+  return ret;
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * Assignment never writes into a (possibly shared) object, this method
+ * only succeeds if both pointers refer to the very same object already,
+ * and sharing takes place otherwise.
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @return whether both pointers refer to the same object
+ */
+template <typename T, typename Policy, typename ABI>
+constexpr bool cow_handler<T, Policy, ABI>::assign(T *p, T const *q) noexcept {
+  return p == q;
+}
+
+/**
+ * Detachment implementation
+ *
+ * This method performs a real replication of the given object if it is
+ * shared, dropping the reference to the shared one.
+ *
+ * @param p  Pointer to the (possibly shared) object
+ * @return a pointer to an unshared object
+ */
+template <typename T, typename Policy, typename ABI>
+T *cow_handler<T, Policy, ABI>::detach(T *p) {
+  if (nullptr == p || nullptr == count || 1 == Policy::load(*count)) {
+    return p;
+  }
+
+  count_type *c = count;
+  count = nullptr;
+  T *ret;
+  try {
+    ret = replicate(p);
+  } catch (...) {
+    count = c;
+    throw;
+  }
+
+  if (0 == Policy::decrement(*c)) {
+    delete c;
+    default_handler<T, ABI>::destroy(p);
+  }
+
+  return ret;
+}
+
+/**
+ * Release implementation
+ *
+ * This method detaches the given object and drops its reference counter.
+ * Releasing a shared pointee thus replicates it, which may throw (leaving
+ * the pointee shared).
+ *
+ * @param p  Pointer to the object to release
+ * @return a pointer the caller may take ownership of
+ */
+template <typename T, typename Policy, typename ABI>
+T *cow_handler<T, Policy, ABI>::release(T *p) {
+  T *ret = detach(p);
+  delete count;
+  count = nullptr;
+
+  return ret;
+}
+
 
 #endif /* VALUE_PTR__HANDLER_HPP__ */
 
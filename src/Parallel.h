@@ -0,0 +1,247 @@
+#ifndef VALUE_PTR__PARALLEL_H__
+#define VALUE_PTR__PARALLEL_H__
+
+
+#include <type_traits>
+#include <cstddef>
+
+#include "Handler.h"
+
+
+/**
+ * Static class encapsulating the replication of arrays across several threads
+ *
+ * The element range is split into as many contiguous chunks as threads
+ * requested; the calling thread builds the first chunk while one worker
+ * thread per remaining chunk builds the rest (should a worker fail to start,
+ * its chunk is built by the calling thread instead). Elements are copied as
+ * default_replicate would do: by placement clone for cloneable types, by
+ * copy construction otherwise (or by memcpy for trivially copyable types).
+ *
+ * @param T  Underlying type of the array
+ * @param ABI  ABI adapter class to use
+ */
+template <typename T, typename ABI>
+struct parallel_copy {
+  /**
+   * Return a new array replicated from the given one
+   *
+   * Should any element's replication throw, every chunk destroys the
+   * elements it had already built, the array is deleted, and the first
+   * exception caught (in chunk order) is rethrown.
+   *
+   * @param p  Pointer to the array to replicate
+   * @param n  Number of elements in the array
+   * @param threads  Number of threads to use (including the calling one)
+   * @return a new array replicated from p
+   */
+  static T *replicate(T const *p, std::size_t n, std::size_t threads);
+
+  protected:
+    /**
+     * Replicate a chunk of the given array by placement cloning
+     *
+     * Should any placement clone throw, the elements already built in the
+     * chunk are destroyed before rethrowing.
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param p  Pointer to the array to replicate
+     * @param begin  Index of the first element of the chunk
+     * @param end  Index past the last element of the chunk
+     * @param <unnamed>  Tag indicating cloneability
+     */
+    static void build(T *ret, T const *p, std::size_t begin, std::size_t end, std::true_type);
+
+    /**
+     * Replicate a chunk of the given array by copying
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param p  Pointer to the array to replicate
+     * @param begin  Index of the first element of the chunk
+     * @param end  Index past the last element of the chunk
+     * @param <unnamed>  Tag indicating cloneability
+     */
+    static void build(T *ret, T const *p, std::size_t begin, std::size_t end, std::false_type);
+
+    /**
+     * Copy a chunk of trivially copyable objects
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param p  Pointer to the array to copy
+     * @param begin  Index of the first element of the chunk
+     * @param end  Index past the last element of the chunk
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void copy(T *ret, T const *p, std::size_t begin, std::size_t end, std::true_type) noexcept;
+
+    /**
+     * Copy a chunk of non trivially copyable objects
+     *
+     * Should any copy constructor throw, the elements already built in the
+     * chunk are destroyed before rethrowing.
+     *
+     * @param ret  Pointer to the uninitialized array
+     * @param p  Pointer to the array to copy
+     * @param begin  Index of the first element of the chunk
+     * @param end  Index past the last element of the chunk
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void copy(T *ret, T const *p, std::size_t begin, std::size_t end, std::false_type);
+
+    /**
+     * Destroy a chunk of objects, in reverse order
+     *
+     * Should any destructor throw, std::terminate will be called.
+     *
+     * @param p  Pointer to the array
+     * @param begin  Index of the first element of the chunk
+     * @param end  Index past the last element of the chunk
+     */
+    static void destroy(T const *p, std::size_t begin, std::size_t end) noexcept;
+};
+
+
+
+/**
+ * Metaprogramming class encapsulating parallel replication of large arrays
+ *
+ * This handler behaves as a default_handler, except that arrays whose size
+ * in bytes reaches the given threshold are replicated by parallel_copy; for
+ * the same reason, such arrays are never assigned in place (the sequential
+ * in-place assignment is replaced by a parallel replication).
+ *
+ * @param T  Underlying type this class handles (an array type)
+ * @param Threshold  Size in bytes from which arrays are replicated in parallel
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ */
+template <typename T, std::size_t Threshold = 4 * 1024 * 1024, typename ABI = Itanium>
+struct parallel_handler : public default_handler<T, ABI> {
+  /**
+   * Refuse to accept non-array types
+   *
+   * There is nothing to split when replicating a single object.
+   *
+   */
+  static_assert(1 == std::rank<T>::value, "parallel_handler only works on array types");
+};
+
+/**
+ * Specialization of parallel_handler for array types
+ *
+ */
+template <typename T, std::size_t Threshold, typename ABI>
+struct parallel_handler<T[], Threshold, ABI> : public default_handler<T[], ABI> {
+  using default_handler<T[], ABI>::destroy;
+  using default_handler<T[], ABI>::slice_safe;
+
+  /**
+   * Constructor
+   *
+   * Uses as many threads as the hardware supports.
+   *
+   */
+  parallel_handler() noexcept;
+
+  /**
+   * Constructor
+   *
+   * @param count  Number of threads to use (0 for as many as the hardware supports)
+   */
+  explicit parallel_handler(std::size_t count) noexcept;
+
+  /**
+   * Replication implementation
+   *
+   * @param p  Pointer to the array to replicate
+   * @return either nullptr if nullptr is given, or a new array replicated from p
+   */
+  T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * Arrays reaching the threshold are never assigned in place.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q) const;
+
+  /**
+   * Return the number of threads used for parallel replication
+   *
+   * @return the number of threads used for parallel replication
+   */
+  std::size_t concurrency() const noexcept;
+
+  protected:
+    /**
+     * Number of threads requested (0 for as many as the hardware supports)
+     *
+     */
+    std::size_t threads;
+};
+
+/**
+ * Specialization of parallel_handler for fixed array types
+ *
+ */
+template <typename T, std::size_t Threshold, typename ABI, std::size_t N>
+struct parallel_handler<T[N], Threshold, ABI> : public default_handler<T[N], ABI> {
+  using default_handler<T[N], ABI>::destroy;
+  using default_handler<T[N], ABI>::slice_safe;
+
+  /**
+   * Constructor
+   *
+   * Uses as many threads as the hardware supports.
+   *
+   */
+  parallel_handler() noexcept;
+
+  /**
+   * Constructor
+   *
+   * @param count  Number of threads to use (0 for as many as the hardware supports)
+   */
+  explicit parallel_handler(std::size_t count) noexcept;
+
+  /**
+   * Replication implementation
+   *
+   * @param p  Pointer to the array to replicate
+   * @return either nullptr if nullptr is given, or a new array replicated from p
+   */
+  T *replicate(T const *p) const;
+
+  /**
+   * In-place assignment implementation
+   *
+   * Arrays reaching the threshold are never assigned in place.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q) const;
+
+  /**
+   * Return the number of threads used for parallel replication
+   *
+   * @return the number of threads used for parallel replication
+   */
+  std::size_t concurrency() const noexcept;
+
+  protected:
+    /**
+     * Number of threads requested (0 for as many as the hardware supports)
+     *
+     */
+    std::size_t threads;
+};
+
+
+#include "Parallel.hpp"
+
+#endif /* VALUE_PTR__PARALLEL_H__ */
@@ -0,0 +1,304 @@
+#ifndef VALUE_PTR__PARALLEL_HPP__
+#define VALUE_PTR__PARALLEL_HPP__
+
+
+#include "Parallel.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <new>
+
+
+/**
+ * Return a new array replicated from the given one
+ *
+ * Should any element's replication throw, every chunk destroys the
+ * elements it had already built, the array is deleted, and the first
+ * exception caught (in chunk order) is rethrown.
+ *
+ * @param p  Pointer to the array to replicate
+ * @param n  Number of elements in the array
+ * @param threads  Number of threads to use (including the calling one)
+ * @return a new array replicated from p
+ */
+template <typename T, typename ABI>
+T *parallel_copy<T, ABI>::replicate(T const *p, std::size_t n, std::size_t threads) {
+  std::size_t chunks = std::max(std::size_t(1), std::min(threads, n));
+  std::vector<std::exception_ptr> errors(chunks);
+  std::vector<std::thread> workers;
+  workers.reserve(chunks - 1);
+
+  T *ret = ABI::template newArray<T>(n);
+
+  auto run = [ret, p, n, chunks, &errors](std::size_t k) noexcept {
+    try {
+      build(ret, p, n * k / chunks, n * (k + 1) / chunks, typename condition<is_cloneable<T>::value>::type());
+    } catch (...) {
+      errors[k] = std::current_exception();
+    }
+  };
+
+  std::size_t k;
+  try {
+    for (k = 1; k < chunks; k++) {
+      workers.emplace_back(run, k);
+    }
+  } catch (...) {
+    // chunks whose worker could not be started are built by this thread below
+  }
+
+  run(0);
+  for (std::size_t i = k; i < chunks; i++) {
+    run(i);
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  auto failed = std::find_if(errors.begin(), errors.end(), [](std::exception_ptr const &e) { return nullptr != e; });
+  if (errors.end() != failed) {
+    for (std::size_t i = chunks; i--; ) {
+      if (nullptr == errors[i]) {
+        destroy(ret, n * i / chunks, n * (i + 1) / chunks);
+      }
+    }
+    ABI::template delArray<T>(ret);
+    std::rethrow_exception(*failed);
+  }
+
+  return ret;
+}
+
+/**
+ * Replicate a chunk of the given array by placement cloning
+ *
+ * Should any placement clone throw, the elements already built in the
+ * chunk are destroyed before rethrowing.
+ *
+ * @param ret  Pointer to the uninitialized array
+ * @param p  Pointer to the array to replicate
+ * @param begin  Index of the first element of the chunk
+ * @param end  Index past the last element of the chunk
+ * @param <unnamed>  Tag indicating cloneability
+ */
+template <typename T, typename ABI>
+void parallel_copy<T, ABI>::build(T *ret, T const *p, std::size_t begin, std::size_t end, std::true_type) {
+  std::size_t i;
+
+  try {
+    for (i = begin; i < end; i++) {
+      (p + i)->clone(ret + i);
+    }
+  } catch (...) {
+    destroy(ret, begin, i);
+    throw;
+  }
+}
+
+/**
+ * Replicate a chunk of the given array by copying
+ *
+ * @param ret  Pointer to the uninitialized array
+ * @param p  Pointer to the array to replicate
+ * @param begin  Index of the first element of the chunk
+ * @param end  Index past the last element of the chunk
+ * @param <unnamed>  Tag indicating cloneability
+ */
+template <typename T, typename ABI>
+void parallel_copy<T, ABI>::build(T *ret, T const *p, std::size_t begin, std::size_t end, std::false_type) {
+  copy(ret, p, begin, end, typename condition<std::is_trivially_copyable<T>::value>::type());
+}
+
+/**
+ * Copy a chunk of trivially copyable objects
+ *
+ * @param ret  Pointer to the uninitialized array
+ * @param p  Pointer to the array to copy
+ * @param begin  Index of the first element of the chunk
+ * @param end  Index past the last element of the chunk
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T, typename ABI>
+void parallel_copy<T, ABI>::copy(T *ret, T const *p, std::size_t begin, std::size_t end, std::true_type) noexcept {
+  std::memcpy(static_cast<void *>(ret + begin), static_cast<void const *>(p + begin), (end - begin) * sizeof(T));
+}
+
+/**
+ * Copy a chunk of non trivially copyable objects
+ *
+ * Should any copy constructor throw, the elements already built in the
+ * chunk are destroyed before rethrowing.
+ *
+ * @param ret  Pointer to the uninitialized array
+ * @param p  Pointer to the array to copy
+ * @param begin  Index of the first element of the chunk
+ * @param end  Index past the last element of the chunk
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T, typename ABI>
+void parallel_copy<T, ABI>::copy(T *ret, T const *p, std::size_t begin, std::size_t end, std::false_type) {
+  std::size_t i;
+
+  try {
+    for (i = begin; i < end; i++) {
+      new(ret + i) T{p[i]};
+    }
+  } catch (...) {
+    destroy(ret, begin, i);
+    throw;
+  }
+}
+
+/**
+ * Destroy a chunk of objects, in reverse order
+ *
+ * Should any destructor throw, std::terminate will be called.
+ *
+ * @param p  Pointer to the array
+ * @param begin  Index of the first element of the chunk
+ * @param end  Index past the last element of the chunk
+ */
+template <typename T, typename ABI>
+void parallel_copy<T, ABI>::destroy(T const *p, std::size_t begin, std::size_t end) noexcept {
+  while (end-- > begin) {
+    (p + end)->~T();
+  }
+}
+
+
+
+/**
+ * Constructor
+ *
+ * Uses as many threads as the hardware supports.
+ *
+ */
+template <typename T, std::size_t Threshold, typename ABI>
+parallel_handler<T[], Threshold, ABI>::parallel_handler() noexcept : threads(0) {}
+
+/**
+ * Constructor
+ *
+ * @param count  Number of threads to use (0 for as many as the hardware supports)
+ */
+template <typename T, std::size_t Threshold, typename ABI>
+parallel_handler<T[], Threshold, ABI>::parallel_handler(std::size_t count) noexcept : threads(count) {}
+
+/**
+ * Replication implementation
+ *
+ * @param p  Pointer to the array to replicate
+ * @return either nullptr if nullptr is given, or a new array replicated from p
+ */
+template <typename T, std::size_t Threshold, typename ABI>
+T *parallel_handler<T[], Threshold, ABI>::replicate(T const *p) const {
+  if (nullptr == p) {
+    return nullptr;
+  }
+
+  std::size_t n = ABI::template arraySize<T>(p);
+  if (n * sizeof(T) < Threshold || concurrency() < 2) {
+    return default_handler<T[], ABI>::replicate(p);
+  }
+
+  return parallel_copy<T, ABI>::replicate(p, n, concurrency());
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * Arrays reaching the threshold are never assigned in place.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, std::size_t Threshold, typename ABI>
+bool parallel_handler<T[], Threshold, ABI>::assign(T *p, T const *q) const {
+  if (ABI::template arraySize<T>(q) * sizeof(T) >= Threshold && concurrency() > 1) {
+    return false;
+  }
+
+  return default_handler<T[], ABI>::assign(p, q);
+}
+
+/**
+ * Return the number of threads used for parallel replication
+ *
+ * @return the number of threads used for parallel replication
+ */
+template <typename T, std::size_t Threshold, typename ABI>
+std::size_t parallel_handler<T[], Threshold, ABI>::concurrency() const noexcept {
+  return 0 != threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+
+/**
+ * Constructor
+ *
+ * Uses as many threads as the hardware supports.
+ *
+ */
+template <typename T, std::size_t Threshold, typename ABI, std::size_t N>
+parallel_handler<T[N], Threshold, ABI>::parallel_handler() noexcept : threads(0) {}
+
+/**
+ * Constructor
+ *
+ * @param count  Number of threads to use (0 for as many as the hardware supports)
+ */
+template <typename T, std::size_t Threshold, typename ABI, std::size_t N>
+parallel_handler<T[N], Threshold, ABI>::parallel_handler(std::size_t count) noexcept : threads(count) {}
+
+/**
+ * Replication implementation
+ *
+ * @param p  Pointer to the array to replicate
+ * @return either nullptr if nullptr is given, or a new array replicated from p
+ */
+template <typename T, std::size_t Threshold, typename ABI, std::size_t N>
+T *parallel_handler<T[N], Threshold, ABI>::replicate(T const *p) const {
+  if (nullptr == p) {
+    return nullptr;
+  }
+
+  if (N * sizeof(T) < Threshold || concurrency() < 2) {
+    return default_handler<T[N], ABI>::replicate(p);
+  }
+
+  return parallel_copy<T, ABI>::replicate(p, N, concurrency());
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * Arrays reaching the threshold are never assigned in place.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, std::size_t Threshold, typename ABI, std::size_t N>
+bool parallel_handler<T[N], Threshold, ABI>::assign(T *p, T const *q) const {
+  if (N * sizeof(T) >= Threshold && concurrency() > 1) {
+    return false;
+  }
+
+  return default_handler<T[N], ABI>::assign(p, q);
+}
+
+/**
+ * Return the number of threads used for parallel replication
+ *
+ * @return the number of threads used for parallel replication
+ */
+template <typename T, std::size_t Threshold, typename ABI, std::size_t N>
+std::size_t parallel_handler<T[N], Threshold, ABI>::concurrency() const noexcept {
+  return 0 != threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+#endif /* VALUE_PTR__PARALLEL_HPP__ */
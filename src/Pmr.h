@@ -0,0 +1,43 @@
+#ifndef VALUE_PTR__PMR_H__
+#define VALUE_PTR__PMR_H__
+
+
+#include <memory_resource>
+
+#include "ResourceHandler.h"
+
+
+/**
+ * Specialization of default_resource for polymorphic memory resources
+ *
+ * Default constructed handlers use the default resource current at the
+ * time of their construction.
+ *
+ */
+template <>
+struct default_resource<std::pmr::memory_resource> {
+  /**
+   * Return the default memory resource
+   *
+   * @return std::pmr::get_default_resource()
+   */
+  static std::pmr::memory_resource *get() noexcept;
+};
+
+
+/**
+ * Handler allocating pointees from a polymorphic memory resource
+ *
+ * Arrays are laid out in the resource by the ABI's resource-aware newArray
+ * and delArray overloads.
+ *
+ * @param T  Underlying type this class handles
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ */
+template <typename T, typename ABI = Itanium>
+using pmr_handler = resource_handler<T, std::pmr::memory_resource, ABI>;
+
+
+#include "Pmr.hpp"
+
+#endif /* VALUE_PTR__PMR_H__ */
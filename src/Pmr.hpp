@@ -0,0 +1,17 @@
+#ifndef VALUE_PTR__PMR_HPP__
+#define VALUE_PTR__PMR_HPP__
+
+
+#include "Pmr.h"
+
+
+/**
+ * Return the default memory resource
+ *
+ * @return std::pmr::get_default_resource()
+ */
+inline std::pmr::memory_resource *default_resource<std::pmr::memory_resource>::get() noexcept {
+  return std::pmr::get_default_resource();
+}
+
+#endif /* VALUE_PTR__PMR_HPP__ */
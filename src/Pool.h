@@ -0,0 +1,228 @@
+#ifndef VALUE_PTR__POOL_H__
+#define VALUE_PTR__POOL_H__
+
+
+#include <cstddef>
+
+#include "ResourceHandler.h"
+
+
+/**
+ * Size-class slab memory pool
+ *
+ * Requests of up to max_block bytes are rounded up to a multiple of the
+ * fundamental alignment and served from per-size-class slabs, carved
+ * lazily and recycled through an intrusive free list; larger requests are
+ * forwarded to the global allocation functions. Slabs are only returned to
+ * the global heap by the destructor or by explicitly calling release().
+ *
+ * Pools are not thread safe: each pool must be used from a single thread at
+ * a time.
+ *
+ */
+class slab_pool {
+  public:
+    /**
+     * Size class granularity, as well as the largest alignment served
+     *
+     */
+    static constexpr std::size_t granularity = alignof(std::max_align_t);
+
+    /**
+     * Largest request served from slabs
+     *
+     */
+    static constexpr std::size_t max_block = 512;
+
+    /**
+     * Default slab size
+     *
+     */
+    static constexpr std::size_t default_slab_size = 64 * 1024;
+
+    /**
+     * Constructor
+     *
+     * No memory is allocated until the first request.
+     *
+     * @param size  Size in bytes of each slab (rounded up so as to hold at least one block of every size class)
+     */
+    explicit slab_pool(std::size_t size = default_slab_size) noexcept;
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    slab_pool(slab_pool const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    slab_pool &operator=(slab_pool const &) = delete;
+
+    /**
+     * Destructor
+     *
+     * Returns every slab to the global heap, whether blocks are still live
+     * or not.
+     *
+     */
+    ~slab_pool() noexcept;
+
+    /**
+     * Return the calling thread's default pool
+     *
+     * Since pools are not thread safe, each thread gets its own default
+     * pool. Default pools are never destroyed, so that objects outliving
+     * their thread, or static destruction, may still return their blocks to
+     * them; the slabs of a finished thread are thus never reclaimed.
+     *
+     * @return the calling thread's default pool
+     */
+    static slab_pool &instance();
+
+    /**
+     * Allocate a block
+     *
+     * @param bytes  Number of bytes requested
+     * @param alignment  Alignment requested
+     * @return a pointer to the allocated block
+     * @throws std::bad_alloc  In case the alignment exceeds granularity, or the underlying operation throws
+     */
+    void *allocate(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * Return a block obtained from allocate
+     *
+     * @param p  Pointer to the block
+     * @param bytes  Number of bytes requested upon allocation
+     * @param alignment  Alignment requested upon allocation
+     */
+    void deallocate(void *p, std::size_t bytes, std::size_t alignment) noexcept;
+
+    /**
+     * Return the number of bytes held in slabs
+     *
+     * @return the number of bytes held in slabs
+     */
+    std::size_t capacity() const noexcept __attribute__((pure));
+
+    /**
+     * Return the number of bytes currently handed out (rounded up to size classes)
+     *
+     * @return the number of bytes currently handed out
+     */
+    std::size_t in_use() const noexcept __attribute__((pure));
+
+    /**
+     * Return the largest number of bytes ever handed out at once
+     *
+     * @return the high-water mark of in_use()
+     */
+    std::size_t high_water() const noexcept __attribute__((pure));
+
+    /**
+     * Return the slabs of every size class having no live blocks to the global heap
+     *
+     * @return the number of bytes released
+     */
+    std::size_t release() noexcept;
+
+  protected:
+    /**
+     * Free list node, overlaid on free blocks and on slab headers
+     *
+     */
+    struct block {
+      block *next;
+    };
+
+    /**
+     * Per size class state
+     *
+     */
+    struct size_class {
+      block *free;
+      char *cursor;
+      char *end;
+      block *slabs;
+      std::size_t live;
+    };
+
+    /**
+     * Number of size classes
+     *
+     */
+    static constexpr std::size_t class_count = max_block / granularity;
+
+    /**
+     * Return the size class index serving the given number of bytes
+     *
+     * @param bytes  Number of bytes requested (at most max_block)
+     * @return the size class index
+     */
+    static constexpr std::size_t classOf(std::size_t bytes) noexcept __attribute__((const));
+
+    /**
+     * Carve a new slab for the given size class
+     *
+     * @param c  Size class to refill
+     * @param size  Block size of the size class
+     * @throws std::bad_alloc  In case the underlying operation throws
+     */
+    void refill(size_class &c, std::size_t size);
+
+    /**
+     * Return all slabs of the given size class to the global heap
+     *
+     * @param c  Size class to empty
+     * @return the number of bytes released
+     */
+    std::size_t drop(size_class &c) noexcept;
+
+    /**
+     * Per size class state
+     *
+     */
+    size_class classes[class_count];
+
+    /**
+     * Size in bytes of each slab
+     *
+     */
+    std::size_t slabSize;
+
+    /**
+     * Number of bytes held in slabs
+     *
+     */
+    std::size_t held;
+
+    /**
+     * Number of bytes currently handed out
+     *
+     */
+    std::size_t used;
+
+    /**
+     * High-water mark of used
+     *
+     */
+    std::size_t peak;
+};
+
+
+/**
+ * Handler allocating pointees from a slab_pool
+ *
+ * @param T  Underlying type this class handles
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ */
+template <typename T, typename ABI = Itanium>
+using pool_handler = resource_handler<T, slab_pool, ABI>;
+
+
+#include "Pool.hpp"
+
+#endif /* VALUE_PTR__POOL_H__ */
@@ -0,0 +1,206 @@
+#ifndef VALUE_PTR__POOL_HPP__
+#define VALUE_PTR__POOL_HPP__
+
+
+#include "Pool.h"
+
+#include <new>
+
+
+/**
+ * Constructor
+ *
+ * No memory is allocated until the first request.
+ *
+ * @param size  Size in bytes of each slab (rounded up so as to hold at least one block of every size class)
+ */
+inline slab_pool::slab_pool(std::size_t size) noexcept : classes(), slabSize(size < granularity + max_block ? granularity + max_block : size), held(0), used(0), peak(0) {}
+
+/**
+ * Destructor
+ *
+ * Returns every slab to the global heap, whether blocks are still live
+ * or not.
+ *
+ */
+inline slab_pool::~slab_pool() noexcept {
+  for (size_class &c : classes) {
+    drop(c);
+  }
+}
+
+/**
+ * Return the calling thread's default pool
+ *
+ * Since pools are not thread safe, each thread gets its own default
+ * pool. Default pools are never destroyed, so that objects outliving
+ * their thread, or static destruction, may still return their blocks to
+ * them; the slabs of a finished thread are thus never reclaimed.
+ *
+ * @return the calling thread's default pool
+ */
+inline slab_pool &slab_pool::instance() {
+  thread_local slab_pool *pool = new slab_pool();
+  return *pool;
+}
+
+/**
+ * Allocate a block
+ *
+ * @param bytes  Number of bytes requested
+ * @param alignment  Alignment requested
+ * @return a pointer to the allocated block
+ * @throws std::bad_alloc  In case the alignment exceeds granularity, or the underlying operation throws
+ */
+inline void *slab_pool::allocate(std::size_t bytes, std::size_t alignment) {
+  if (alignment > granularity) {
+    throw std::bad_alloc();
+  }
+
+  void *ret;
+  if (bytes > max_block) {
+    ret = ::operator new(bytes);
+  } else {
+    size_class &c = classes[classOf(bytes)];
+    bytes = (classOf(bytes) + 1) * granularity;
+
+    if (nullptr != c.free) {
+      ret = c.free;
+      c.free = c.free->next;
+    } else {
+      if (c.cursor == c.end) {
+        refill(c, bytes);
+      }
+      ret = c.cursor;
+      c.cursor += bytes;
+    }
+    c.live++;
+  }
+
+  used += bytes;
+  if (used > peak) {
+    peak = used;
+  }
+
+  return ret;
+}
+
+/**
+ * Return a block obtained from allocate
+ *
+ * @param p  Pointer to the block
+ * @param bytes  Number of bytes requested upon allocation
+ * @param <unnamed>  Alignment requested upon allocation
+ */
+inline void slab_pool::deallocate(void *p, std::size_t bytes, std::size_t) noexcept {
+  if (bytes > max_block) {
+    ::operator delete(p);
+  } else {
+    size_class &c = classes[classOf(bytes)];
+    bytes = (classOf(bytes) + 1) * granularity;
+
+    block *b = static_cast<block *>(p);
+    b->next = c.free;
+    c.free = b;
+    c.live--;
+  }
+
+  used -= bytes;
+}
+
+/**
+ * Return the number of bytes held in slabs
+ *
+ * @return the number of bytes held in slabs
+ */
+inline std::size_t slab_pool::capacity() const noexcept {
+  return held;
+}
+
+/**
+ * Return the number of bytes currently handed out (rounded up to size classes)
+ *
+ * @return the number of bytes currently handed out
+ */
+inline std::size_t slab_pool::in_use() const noexcept {
+  return used;
+}
+
+/**
+ * Return the largest number of bytes ever handed out at once
+ *
+ * @return the high-water mark of in_use()
+ */
+inline std::size_t slab_pool::high_water() const noexcept {
+  return peak;
+}
+
+/**
+ * Return the slabs of every size class having no live blocks to the global heap
+ *
+ * @return the number of bytes released
+ */
+inline std::size_t slab_pool::release() noexcept {
+  std::size_t ret = 0;
+  for (size_class &c : classes) {
+    if (0 == c.live) {
+      ret += drop(c);
+    }
+  }
+
+  return ret;
+}
+
+/**
+ * Return the size class index serving the given number of bytes
+ *
+ * @param bytes  Number of bytes requested (at most max_block)
+ * @return the size class index
+ */
+inline constexpr std::size_t slab_pool::classOf(std::size_t bytes) noexcept {
+  return 0 == bytes ? 0 : (bytes - 1) / granularity;
+}
+
+/**
+ * Carve a new slab for the given size class
+ *
+ * The first granule of each slab links it to the previous one, the rest is
+ * carved lazily by bumping the size class' cursor.
+ *
+ * @param c  Size class to refill
+ * @param size  Block size of the size class
+ * @throws std::bad_alloc  In case the underlying operation throws
+ */
+inline void slab_pool::refill(slab_pool::size_class &c, std::size_t size) {
+  char *slab = static_cast<char *>(::operator new(slabSize));
+
+  reinterpret_cast<block *>(slab)->next = c.slabs;
+  c.slabs = reinterpret_cast<block *>(slab);
+  c.cursor = slab + granularity;
+  c.end = c.cursor + (slabSize - granularity) / size * size;
+
+  held += slabSize;
+}
+
+/**
+ * Return all slabs of the given size class to the global heap
+ *
+ * @param c  Size class to empty
+ * @return the number of bytes released
+ */
+inline std::size_t slab_pool::drop(slab_pool::size_class &c) noexcept {
+  std::size_t ret = 0;
+  while (nullptr != c.slabs) {
+    block *next = c.slabs->next;
+    ::operator delete(c.slabs);
+    c.slabs = next;
+    ret += slabSize;
+  }
+  c.free = nullptr;
+  c.cursor = c.end = nullptr;
+
+  held -= ret;
+  return ret;
+}
+
+#endif /* VALUE_PTR__POOL_HPP__ */
@@ -0,0 +1,405 @@
+#ifndef VALUE_PTR__RCU_H__
+#define VALUE_PTR__RCU_H__
+
+
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "value_ptr.h"
+
+
+/**
+ * Process-wide epoch domain delimiting read sections and grace periods
+ *
+ * Every reading thread owns a reader record, alone on its cache line, in
+ * which it announces the global epoch it entered its (outermost) read
+ * section in, and clears it upon leaving: entering and leaving a read
+ * section are thus wait-free, and only ever write to the reader's own
+ * record (entering also issues a full fence, but no read-modify-write
+ * operation). Writers advance the global epoch after publishing a new
+ * version, and the version it replaced may be reclaimed once every reader
+ * either is outside any read section, or entered it in a later epoch.
+ *
+ * Records of exited threads are kept (and reused by later threads), and
+ * the domain is never destroyed.
+ *
+ */
+class rcu_domain {
+  public:
+    /**
+     * Size to align reader records to, so that no two of them share a cache line
+     *
+     */
+    static constexpr std::size_t line = 64;
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    rcu_domain(rcu_domain const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    rcu_domain &operator=(rcu_domain const &) = delete;
+
+    /**
+     * Return the process-wide domain
+     *
+     * @return the process-wide domain
+     */
+    static rcu_domain &instance();
+
+    /**
+     * Enter a read section on the calling thread
+     *
+     * Read sections nest, only the outermost one announcing an epoch.
+     *
+     * @throws std::bad_alloc  In case the calling thread's record cannot be allocated
+     */
+    void enter();
+
+    /**
+     * Leave a read section on the calling thread
+     *
+     */
+    void leave() noexcept;
+
+    /**
+     * Advance the global epoch
+     *
+     * Versions unpublished before the call may be reclaimed once oldest()
+     * exceeds the returned epoch.
+     *
+     * @return the epoch before advancing
+     */
+    std::uint64_t advance() noexcept;
+
+    /**
+     * Return the oldest epoch any reader is in
+     *
+     * @return the oldest epoch any reader is in, or UINT64_MAX if no reader is in a read section
+     */
+    std::uint64_t oldest() const noexcept;
+
+  protected:
+    /**
+     * Per-thread reader record
+     *
+     * The epoch (0 outside of read sections) is only ever written by the
+     * owning thread, and read by writers; the depth is only ever touched by
+     * the owning thread. The record is explicitly padded to a full line.
+     *
+     */
+    struct alignas(line) reader {
+      std::atomic<std::uint64_t> epoch;
+      std::size_t depth;
+      reader *next;
+      std::atomic<bool> busy;
+      [[no_unique_address]] explicit_padding<padding_to<sizeof(std::atomic<std::uint64_t>) + sizeof(std::size_t) + sizeof(reader *) + sizeof(std::atomic<bool>), line>::value> padding;
+    };
+
+    /**
+     * Thread-local holder of a thread's reader record
+     *
+     * Hands the record back for reuse upon thread exit.
+     *
+     */
+    struct holder {
+      reader *mine;
+      ~holder() noexcept;
+    };
+
+    /**
+     * Constructor
+     *
+     */
+    rcu_domain() noexcept;
+
+    /**
+     * Destructor
+     *
+     */
+    ~rcu_domain() noexcept = default;
+
+    /**
+     * Return an idle reader record, creating one if needed
+     *
+     * @return an idle reader record, now busy
+     * @throws std::bad_alloc  In case a new record cannot be allocated
+     */
+    reader &acquire();
+
+    /**
+     * Return the calling thread's reader record
+     *
+     * @return the calling thread's reader record
+     * @throws std::bad_alloc  In case the record cannot be allocated
+     */
+    static reader &local();
+
+    /**
+     * Global epoch, starting at 1
+     *
+     */
+    std::atomic<std::uint64_t> epoch;
+
+    /**
+     * Reader records, never removed
+     *
+     */
+    std::atomic<reader *> readers;
+
+    /**
+     * Lock serializing record creation
+     *
+     */
+    std::mutex lock;
+};
+
+
+/**
+ * Read-mostly value_ptr, updated by read-copy-update
+ *
+ * Readers take snapshots of the current version, within read sections of
+ * the process-wide rcu_domain: taking a snapshot never blocks, nor writes
+ * to any cache line shared with other readers. Writers, serialized by a
+ * mutex, replicate the current version, modify the copy, and publish it;
+ * replaced versions are kept until every read section that could observe
+ * them has ended (their grace period), and only then destroyed by their
+ * handler. Lapsed versions are destroyed upon every publication and upon
+ * reclaim(); synchronize() waits for all of them.
+ *
+ * Writers must not wait for grace periods (ie. call synchronize()) from
+ * within a read section, and the rcu_value_ptr must outlive every snapshot
+ * taken of it.
+ *
+ * @param T  Underlying type to wrap
+ * @param H  Handler type to use (default_handler<T> by default)
+ */
+template <typename T, typename H = default_handler<T>>
+class rcu_value_ptr {
+  public:
+    using value_type         = value_ptr<T, H>;
+    using handler_type       = H;
+    using pointer_type       = typename value_type::pointer_type;
+    using const_pointer_type = typename value_type::const_pointer_type;
+
+    /**
+     * Read section holding on to the version current upon its creation
+     *
+     * The version is guaranteed not to be destroyed for as long as the
+     * snapshot lives; it is only ever given const access to.
+     *
+     */
+    class snapshot {
+      public:
+        /**
+         * Enter a read section and take hold of the current version of the given rcu_value_ptr
+         *
+         * @param source  rcu_value_ptr to read
+         * @throws std::bad_alloc  In case the calling thread's reader record cannot be allocated
+         */
+        explicit snapshot(rcu_value_ptr const &source);
+
+        /**
+         * Deleted copy constructor
+         *
+         */
+        snapshot(snapshot const &) = delete;
+
+        /**
+         * Deleted copy-assignment operator
+         *
+         */
+        snapshot &operator=(snapshot const &) = delete;
+
+        /**
+         * Destructor, leaving the read section
+         *
+         */
+        ~snapshot() noexcept;
+
+        /**
+         * Return the version's pointer
+         *
+         * @return the version's pointer
+         */
+        const_pointer_type get() const noexcept __attribute__((always_inline, pure));
+
+        /**
+         * Return the version's pointer
+         *
+         * @return the version's pointer
+         */
+        const_pointer_type operator->() const noexcept __attribute__((always_inline, pure));
+
+        /**
+         * Return the version's pointee
+         *
+         * @return the version's pointee
+         */
+        typename value_type::const_reference_type operator*() const noexcept __attribute__((always_inline, pure));
+
+        /**
+         * Return whether the version is non-null
+         *
+         * @return whether the version is non-null
+         */
+        explicit operator bool() const noexcept __attribute__((always_inline, pure));
+
+      protected:
+        /**
+         * Version's pointer
+         *
+         */
+        const_pointer_type p;
+    };
+
+    /**
+     * Default constructor
+     *
+     */
+    rcu_value_ptr() noexcept;
+
+    /**
+     * Constructor, publishing the given value_ptr as the first version
+     *
+     * @param v  First version
+     */
+    explicit rcu_value_ptr(value_type &&v) noexcept;
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    rcu_value_ptr(rcu_value_ptr const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    rcu_value_ptr &operator=(rcu_value_ptr const &) = delete;
+
+    /**
+     * Destructor
+     *
+     * Destroys every version at once; no snapshot may be left.
+     *
+     */
+    ~rcu_value_ptr() noexcept = default;
+
+    /**
+     * Take a snapshot of the current version
+     *
+     * @return a snapshot of the current version
+     * @throws std::bad_alloc  In case the calling thread's reader record cannot be allocated
+     */
+    snapshot read() const;
+
+    /**
+     * Return a deep copy of the current version
+     *
+     * @return a deep copy of the current version
+     */
+    value_type copy() const;
+
+    /**
+     * Replicate the current version, let the given callable modify the copy, and publish it
+     *
+     * Nothing is published should the callable throw.
+     *
+     * @param F  Callable type, taking a value_type &
+     * @param f  Callable modifying the copy
+     */
+    template <typename F> void update(F &&f);
+
+    /**
+     * Publish the given value_ptr as the new version
+     *
+     * @param v  New version, left null
+     * @throws std::bad_alloc  In case the replaced version cannot be kept (nothing being published then)
+     */
+    void publish(value_type &&v);
+
+    /**
+     * Destroy every replaced version whose grace period has elapsed
+     *
+     * @return the number of replaced versions still kept
+     */
+    std::size_t reclaim();
+
+    /**
+     * Wait until every replaced version has been destroyed
+     *
+     * Must not be called from within a read section.
+     *
+     */
+    void synchronize();
+
+    /**
+     * Return the number of replaced versions not yet destroyed
+     *
+     * @return the number of replaced versions not yet destroyed
+     */
+    std::size_t retired() const;
+
+  protected:
+    /**
+     * Replaced version, and the epoch it was replaced in
+     *
+     */
+    struct version {
+      value_type v;
+      std::uint64_t epoch;
+    };
+
+    /**
+     * Publish the given value_ptr as the new version (writer lock held)
+     *
+     * @param v  New version, left null
+     * @throws std::bad_alloc  In case the replaced version cannot be kept (nothing being published then)
+     */
+    void publishLocked(value_type &&v);
+
+    /**
+     * Destroy every replaced version whose grace period has elapsed (writer lock held)
+     *
+     * @return the number of replaced versions still kept
+     */
+    std::size_t reclaimLocked() noexcept;
+
+    /**
+     * Current version's pointer, as read by snapshots
+     *
+     */
+    std::atomic<pointer_type> current;
+
+    /**
+     * Current version
+     *
+     */
+    value_type owner;
+
+    /**
+     * Replaced versions, oldest first
+     *
+     */
+    std::vector<version> versions;
+
+    /**
+     * Lock serializing writers
+     *
+     */
+    mutable std::mutex lock;
+};
+
+
+#include "Rcu.hpp"
+
+#endif /* VALUE_PTR__RCU_H__ */
@@ -0,0 +1,341 @@
+#ifndef VALUE_PTR__RCU_HPP__
+#define VALUE_PTR__RCU_HPP__
+
+
+#include "Rcu.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <utility>
+
+
+/**
+ * Destructor
+ *
+ * Hands the reader record back for reuse.
+ *
+ */
+inline rcu_domain::holder::~holder() noexcept {
+  if (nullptr != mine) {
+    mine->epoch.store(0, std::memory_order_release);
+    mine->busy.store(false, std::memory_order_release);
+    mine = nullptr;
+  }
+}
+
+/**
+ * Return the process-wide domain
+ *
+ * The domain is never destroyed, so that read sections outliving static
+ * destruction may still be entered.
+ *
+ * @return the process-wide domain
+ */
+inline rcu_domain &rcu_domain::instance() {
+  static rcu_domain *domain = new rcu_domain();
+  return *domain;
+}
+
+/**
+ * Enter a read section on the calling thread
+ *
+ * Read sections nest, only the outermost one announcing an epoch.
+ *
+ * The fence orders the announcement before any read of a published
+ * pointer: a writer scanning the records after publishing either sees the
+ * announcement, or the reader sees the new version.
+ *
+ * @throws std::bad_alloc  In case the calling thread's record cannot be allocated
+ */
+inline void rcu_domain::enter() {
+  reader &r = local();
+  if (0 == r.depth++) {
+    r.epoch.store(epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+/**
+ * Leave a read section on the calling thread
+ *
+ */
+inline void rcu_domain::leave() noexcept {
+  reader &r = local();
+  if (0 == --r.depth) {
+    r.epoch.store(0, std::memory_order_release);
+  }
+}
+
+/**
+ * Advance the global epoch
+ *
+ * Versions unpublished before the call may be reclaimed once oldest()
+ * exceeds the returned epoch.
+ *
+ * @return the epoch before advancing
+ */
+inline std::uint64_t rcu_domain::advance() noexcept {
+  return epoch.fetch_add(1, std::memory_order_seq_cst);
+}
+
+/**
+ * Return the oldest epoch any reader is in
+ *
+ * @return the oldest epoch any reader is in, or UINT64_MAX if no reader is in a read section
+ */
+inline std::uint64_t rcu_domain::oldest() const noexcept {
+  std::uint64_t ret = std::numeric_limits<std::uint64_t>::max();
+  for (reader const *r = readers.load(std::memory_order_acquire); nullptr != r; r = r->next) {
+    std::uint64_t e = r->epoch.load(std::memory_order_seq_cst);
+    if (0 != e) {
+      ret = std::min(ret, e);
+    }
+  }
+  return ret;
+}
+
+/**
+ * Constructor
+ *
+ */
+inline rcu_domain::rcu_domain() noexcept : epoch(1), readers(nullptr), lock() {}
+
+/**
+ * Return an idle reader record, creating one if needed
+ *
+ * @return an idle reader record, now busy
+ * @throws std::bad_alloc  In case a new record cannot be allocated
+ */
+inline rcu_domain::reader &rcu_domain::acquire() {
+  std::lock_guard<std::mutex> guard(lock);
+
+  for (reader *r = readers.load(std::memory_order_relaxed); nullptr != r; r = r->next) {
+    bool idle = false;
+    if (r->busy.compare_exchange_strong(idle, true, std::memory_order_acquire)) {
+      return *r;
+    }
+  }
+
+  reader *r = new reader{{0}, 0, readers.load(std::memory_order_relaxed), {true}, {}};
+  readers.store(r, std::memory_order_release);
+  return *r;
+}
+
+/**
+ * Return the calling thread's reader record
+ *
+ * The record is cached in a trivially destructible thread-local pointer, so
+ * that the common path needs no thread-local initialization guard; the
+ * holder handing it back upon thread exit is only touched on first use.
+ *
+ * @return the calling thread's reader record
+ * @throws std::bad_alloc  In case the record cannot be allocated
+ */
+inline rcu_domain::reader &rcu_domain::local() {
+  static thread_local reader *mine = nullptr;
+  if (__builtin_expect(nullptr == mine, 0)) {
+    static thread_local holder h = { nullptr };
+    h.mine = mine = &instance().acquire();
+  }
+
+  return *mine;
+}
+
+
+/**
+ * Enter a read section and take hold of the current version of the given rcu_value_ptr
+ *
+ * @param source  rcu_value_ptr to read
+ * @throws std::bad_alloc  In case the calling thread's reader record cannot be allocated
+ */
+template <typename T, typename H>
+rcu_value_ptr<T, H>::snapshot::snapshot(rcu_value_ptr<T, H> const &source) : p(nullptr) {
+  rcu_domain::instance().enter();
+  p = source.current.load(std::memory_order_acquire);
+}
+
+/**
+ * Destructor, leaving the read section
+ *
+ */
+template <typename T, typename H>
+rcu_value_ptr<T, H>::snapshot::~snapshot() noexcept {
+  rcu_domain::instance().leave();
+}
+
+/**
+ * Return the version's pointer
+ *
+ * @return the version's pointer
+ */
+template <typename T, typename H>
+inline typename rcu_value_ptr<T, H>::const_pointer_type rcu_value_ptr<T, H>::snapshot::get() const noexcept { return p; }
+
+/**
+ * Return the version's pointer
+ *
+ * @return the version's pointer
+ */
+template <typename T, typename H>
+inline typename rcu_value_ptr<T, H>::const_pointer_type rcu_value_ptr<T, H>::snapshot::operator->() const noexcept { return p; }
+
+/**
+ * Return the version's pointee
+ *
+ * @return the version's pointee
+ */
+template <typename T, typename H>
+inline typename rcu_value_ptr<T, H>::value_type::const_reference_type rcu_value_ptr<T, H>::snapshot::operator*() const noexcept { return *p; }
+
+/**
+ * Return whether the version is non-null
+ *
+ * @return whether the version is non-null
+ */
+template <typename T, typename H>
+inline rcu_value_ptr<T, H>::snapshot::operator bool() const noexcept { return nullptr != p; }
+
+
+/**
+ * Default constructor
+ *
+ */
+template <typename T, typename H>
+rcu_value_ptr<T, H>::rcu_value_ptr() noexcept : current(nullptr), owner(), versions(), lock() {}
+
+/**
+ * Constructor, publishing the given value_ptr as the first version
+ *
+ * @param v  First version
+ */
+template <typename T, typename H>
+rcu_value_ptr<T, H>::rcu_value_ptr(typename rcu_value_ptr<T, H>::value_type &&v) noexcept : current(v.get()), owner(std::move(v)), versions(), lock() {}
+
+/**
+ * Take a snapshot of the current version
+ *
+ * @return a snapshot of the current version
+ * @throws std::bad_alloc  In case the calling thread's reader record cannot be allocated
+ */
+template <typename T, typename H>
+typename rcu_value_ptr<T, H>::snapshot rcu_value_ptr<T, H>::read() const {
+  return snapshot(*this);
+}
+
+/**
+ * Return a deep copy of the current version
+ *
+ * @return a deep copy of the current version
+ */
+template <typename T, typename H>
+typename rcu_value_ptr<T, H>::value_type rcu_value_ptr<T, H>::copy() const {
+  std::lock_guard<std::mutex> guard(lock);
+  return owner;
+}
+
+/**
+ * Replicate the current version, let the given callable modify the copy, and publish it
+ *
+ * Nothing is published should the callable throw.
+ *
+ * @param F  Callable type, taking a value_type &
+ * @param f  Callable modifying the copy
+ */
+template <typename T, typename H>
+template <typename F>
+void rcu_value_ptr<T, H>::update(F &&f) {
+  std::lock_guard<std::mutex> guard(lock);
+  value_type next = owner;
+  std::forward<F>(f)(next);
+  publishLocked(std::move(next));
+}
+
+/**
+ * Publish the given value_ptr as the new version
+ *
+ * @param v  New version, left null
+ * @throws std::bad_alloc  In case the replaced version cannot be kept (nothing being published then)
+ */
+template <typename T, typename H>
+void rcu_value_ptr<T, H>::publish(typename rcu_value_ptr<T, H>::value_type &&v) {
+  std::lock_guard<std::mutex> guard(lock);
+  publishLocked(std::move(v));
+}
+
+/**
+ * Destroy every replaced version whose grace period has elapsed
+ *
+ * @return the number of replaced versions still kept
+ */
+template <typename T, typename H>
+std::size_t rcu_value_ptr<T, H>::reclaim() {
+  std::lock_guard<std::mutex> guard(lock);
+  return reclaimLocked();
+}
+
+/**
+ * Wait until every replaced version has been destroyed
+ *
+ * Must not be called from within a read section.
+ *
+ */
+template <typename T, typename H>
+void rcu_value_ptr<T, H>::synchronize() {
+  std::lock_guard<std::mutex> guard(lock);
+  while (0 != reclaimLocked()) {
+    std::this_thread::yield();
+  }
+}
+
+/**
+ * Return the number of replaced versions not yet destroyed
+ *
+ * @return the number of replaced versions not yet destroyed
+ */
+template <typename T, typename H>
+std::size_t rcu_value_ptr<T, H>::retired() const {
+  std::lock_guard<std::mutex> guard(lock);
+  return versions.size();
+}
+
+/**
+ * Publish the given value_ptr as the new version (writer lock held)
+ *
+ * The replaced version is tagged with the epoch before advancing: readers
+ * still announcing that epoch (or an earlier one) may hold it, later ones
+ * cannot.
+ *
+ * @param v  New version, left null
+ * @throws std::bad_alloc  In case the replaced version cannot be kept (nothing being published then)
+ */
+template <typename T, typename H>
+void rcu_value_ptr<T, H>::publishLocked(typename rcu_value_ptr<T, H>::value_type &&v) {
+  versions.reserve(versions.size() + 1);
+
+  version old{std::move(owner), 0};
+  owner = std::move(v);
+  current.store(owner.get(), std::memory_order_seq_cst);
+  old.epoch = rcu_domain::instance().advance();
+  if (nullptr != old.v) {
+    versions.push_back(std::move(old));
+  }
+
+  reclaimLocked();
+}
+
+/**
+ * Destroy every replaced version whose grace period has elapsed (writer lock held)
+ *
+ * @return the number of replaced versions still kept
+ */
+template <typename T, typename H>
+std::size_t rcu_value_ptr<T, H>::reclaimLocked() noexcept {
+  if (!versions.empty()) {
+    std::uint64_t oldest = rcu_domain::instance().oldest();
+    versions.erase(std::remove_if(versions.begin(), versions.end(), [oldest](version const &old) { return old.epoch < oldest; }), versions.end());
+  }
+  return versions.size();
+}
+
+#endif /* VALUE_PTR__RCU_HPP__ */
@@ -0,0 +1,772 @@
+#ifndef VALUE_PTR__RESOURCE_HANDLER_H__
+#define VALUE_PTR__RESOURCE_HANDLER_H__
+
+
+#include <type_traits>
+#include <cstddef>
+
+#include "Handler.h"
+
+
+/**
+ * Metaprogramming class to select the memory resource a default constructed resource_handler uses
+ *
+ * The generic version relies on a static "instance" method of the resource
+ * type, specialize it for resource types lacking one.
+ *
+ * @param Resource  Type of the memory resource
+ */
+template <typename Resource>
+struct default_resource {
+  /**
+   * Return the default memory resource
+   *
+   * @return a pointer to the default memory resource
+   */
+  static Resource *get();
+};
+
+
+/**
+ * Static class encapsulating construction and destruction of arrays in memory resources
+ *
+ * @param T  Underlying type of the array
+ * @param Resource  Type of the memory resource
+ * @param ABI  ABI adapter class to use
+ */
+template <typename T, typename Resource, typename ABI>
+struct resource_array {
+  /**
+   * Whether objects of the underlying type can be constructed in a memory resource at all
+   *
+   * Cloneable types must be placement cloneable for this to be the case.
+   *
+   */
+  static constexpr bool placeable = !is_cloneable<T>::value || is_placement_cloneable<T>::value;
+
+  /**
+   * Replicate the given array into the given memory resource
+   *
+   * @param p  Pointer to the array to copy
+   * @param n  Number of elements in the array
+   * @param resource  Memory resource to allocate from
+   * @return a new array copied from p
+   */
+  static T *replicate(T const *p, std::size_t n, Resource &resource);
+
+  /**
+   * Construct a new array of objects in the given memory resource, value-initialized or constructed from the given arguments
+   *
+   * @param n  Number of elements in the array
+   * @param resource  Memory resource to allocate from
+   * @param args  Arguments to construct every element from, in order
+   * @return a new array of n objects
+   */
+  template <typename... Args> static T *construct(std::size_t n, Resource &resource, Args &... args);
+
+  /**
+   * Destroy the given array and return it to the given memory resource
+   *
+   * @param p  Pointer to the array to delete
+   * @param n  Number of elements in the array
+   * @param resource  Memory resource the array was allocated from
+   */
+  static void destroy(T const *p, std::size_t n, Resource &resource);
+
+  protected:
+    /**
+     * Copy an object into the given storage using its copy constructor
+     *
+     * @param raw  Storage to copy into
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     */
+    static void place(T *raw, T const *p, std::false_type);
+
+    /**
+     * Copy an object into the given storage using its placement clone method
+     *
+     * @param raw  Storage to copy into
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     */
+    static void place(T *raw, T const *p, std::true_type);
+};
+
+
+/**
+ * Metaprogramming class allocating pointees from a memory resource
+ *
+ * Replicas and objects constructed in place (eg. by make_value) are
+ * constructed in memory obtained from the resource (placement cloning
+ * replicas if needed) and returned to it upon destruction, objects adopted
+ * from raw pointers are assumed to come from the global heap and are
+ * handled by default_handler. The resource must provide
+ * allocate(bytes, alignment) and deallocate(pointer, bytes, alignment)
+ * methods and must outlive every object allocated from it.
+ *
+ * Handlers copied from one another share their resource.
+ *
+ * @param T  Underlying type this class handles
+ * @param Resource  Type of the memory resource to allocate from
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ */
+template <typename T, typename Resource, typename ABI = Itanium>
+struct resource_handler : public default_handler<T, ABI> {
+  using default_handler<T, ABI>::slice_safe;
+
+  /**
+   * Whether objects of the underlying type can be constructed in a memory resource at all
+   *
+   * Cloneable types must be placement cloneable for this to be the case.
+   *
+   */
+  static constexpr bool placeable = !is_cloneable<T>::value || is_placement_cloneable<T>::value;
+
+  /**
+   * Default constructor
+   *
+   * Uses the default resource; the dynamic type is assumed to be the static
+   * one for non-polymorphic types and unknown otherwise.
+   *
+   */
+  resource_handler();
+
+  /**
+   * Constructor
+   *
+   * @param resource  Memory resource to allocate from
+   */
+  explicit resource_handler(Resource *resource) noexcept;
+
+  /**
+   * Copy constructor
+   *
+   * Shares the given handler's resource and knowledge of the pointee's
+   * dynamic type, but not the ownership of its pointee.
+   *
+   * @param other  Handler to copy
+   */
+  resource_handler(resource_handler const &other) noexcept;
+
+  /**
+   * Rebinding constructor
+   *
+   * Shares the given handler's knowledge of the pointee's dynamic type, but
+   * allocates from the given resource instead (see value_ptr::clone_into).
+   *
+   * @param other  Handler to copy
+   * @param resource  Memory resource to allocate from
+   */
+  resource_handler(resource_handler const &other, Resource *resource) noexcept;
+
+  /**
+   * Move constructor
+   *
+   * Takes over the given handler's resource and the ownership of its
+   * pointee.
+   *
+   * @param other  Handler to move
+   */
+  resource_handler(resource_handler &&other) noexcept;
+
+  /**
+   * Copy-assignment operator
+   *
+   * Copies the given handler's resource and knowledge of the pointee's
+   * dynamic type, unless this handler currently owns an object allocated
+   * from its own resource.
+   *
+   * @param other  Handler to copy-assign
+   * @return the assigned handler
+   */
+  resource_handler &operator=(resource_handler const &other) noexcept;
+
+  /**
+   * Move-assignment operator
+   *
+   * Takes over the given handler's resource and the ownership of its
+   * pointee, this handler must not own an object allocated from its resource.
+   *
+   * @param other  Handler to move-assign
+   * @return the assigned handler
+   */
+  resource_handler &operator=(resource_handler &&other) noexcept;
+
+  /**
+   * Adoption implementation
+   *
+   * This method records whether the dynamic type of the given object is
+   * known (ie. coincides with T2) and may be served by the resource.
+   *
+   * @param T2  Static type of the adopted object
+   * @param p  Pointer to the adopted object
+   */
+  template <typename T2> void adopt(T2 const *p) noexcept;
+
+  /**
+   * Construction implementation
+   *
+   * This method constructs the new object in storage obtained from the
+   * resource if T2 may be served by it, and delegates to default_handler
+   * (adopting the new object) otherwise.
+   *
+   * @param T2  Class of the object to construct
+   * @param args  Arguments to forward to T2's constructor
+   * @return a new object constructed from args
+   */
+  template <typename T2, typename... Args> T2 *construct(Args&&... args);
+
+  /**
+   * Destroyer implementation
+   *
+   * This method destroys an object allocated from the resource and returns
+   * its storage, and delegates to default_handler otherwise.
+   *
+   * @param p  Pointer to the object to delete
+   */
+  void destroy(T const *p);
+
+  /**
+   * Replication implementation
+   *
+   * This method constructs the replica in storage obtained from the resource
+   * if the object's dynamic type is known, and delegates to default_handler
+   * otherwise.
+   *
+   * @param p  Pointer to the object to copy
+   * @return either nullptr if nullptr is given, or a new object copied from p
+   */
+  T *replicate(T const *p);
+
+  /**
+   * In-place assignment implementation
+   *
+   * For objects allocated from the resource, this method destroys the object
+   * and copies the other one into its storage (provided both dynamic types
+   * coincide); should the copy throw, the storage is returned to the
+   * resource. For other objects, it delegates to default_handler.
+   *
+   * @param p  Pointer to the object to assign to
+   * @param q  Pointer to the object to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q);
+
+  /**
+   * Release implementation
+   *
+   * This method replicates an object allocated from the resource onto the
+   * heap (and destroys the original), pointers to heap objects are simply
+   * handed back.
+   *
+   * @param p  Pointer to the object to release
+   * @return a pointer the caller may take ownership of
+   */
+  T *release(T *p);
+
+  /**
+   * Return the memory resource in use
+   *
+   * @return a pointer to the memory resource in use
+   */
+  Resource *resource() const noexcept __attribute__((pure));
+
+  protected:
+    /**
+     * Replication implementation for placeable types
+     *
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating placeability
+     * @return a new object copied from p
+     */
+    T *replicateInto(T const *p, std::true_type);
+
+    /**
+     * Replication implementation for non placeable types
+     *
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating placeability
+     * @return a new object copied from p
+     */
+    T *replicateInto(T const *p, std::false_type);
+
+    /**
+     * In-place assignment implementation for placeable types
+     *
+     * @param p  Pointer to the object to assign to
+     * @param q  Pointer to the object to assign from
+     * @param <unnamed>  Tag indicating placeability
+     * @return whether the assignment could be performed in place
+     */
+    bool assignInto(T *p, T const *q, std::true_type);
+
+    /**
+     * In-place assignment implementation for non placeable types
+     *
+     * @param p  Pointer to the object to assign to
+     * @param q  Pointer to the object to assign from
+     * @param <unnamed>  Tag indicating placeability
+     * @return whether the assignment could be performed in place
+     */
+    bool assignInto(T *p, T const *q, std::false_type);
+
+    /**
+     * Copy the given object into the given storage using its copy constructor
+     *
+     * @param raw  Storage to copy into
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     * @return a pointer to the new object
+     */
+    static T *place(void *raw, T const *p, std::false_type);
+
+    /**
+     * Copy the given object into the given storage using its placement clone method
+     *
+     * @param raw  Storage to copy into
+     * @param p  Pointer to the object to copy
+     * @param <unnamed>  Tag indicating cloneability
+     * @return a pointer to the new object
+     */
+    static T *place(void *raw, T const *p, std::true_type);
+
+    /**
+     * Return the storage of a non-polymorphic object
+     *
+     * @param p  Pointer to the object
+     * @param <unnamed>  Tag indicating polymorphism
+     * @return a pointer to the object's storage
+     */
+    static void const *storage(T const *p, std::false_type) noexcept __attribute__((const));
+
+    /**
+     * Return the storage of a polymorphic object
+     *
+     * @param p  Pointer to the object
+     * @param <unnamed>  Tag indicating polymorphism
+     * @return a pointer to the most derived object's storage
+     */
+    static void const *storage(T const *p, std::true_type) noexcept __attribute__((pure));
+
+    /**
+     * Memory resource to allocate from
+     *
+     */
+    Resource *r;
+
+    /**
+     * Size of the pointee's dynamic type if known and placeable, 0 otherwise
+     *
+     */
+    std::size_t size;
+
+    /**
+     * Whether the current pointee was allocated from the resource
+     *
+     */
+    bool owned;
+
+    /**
+     * Padding up to the alignment of r
+     *
+     */
+    [[no_unique_address]] explicit_padding<padding_to<sizeof(Resource *) + sizeof(std::size_t) + sizeof(bool), alignof(Resource *)>::value> padding;
+};
+
+/**
+ * Metaprogramming class allocating arrays from a memory resource
+ *
+ * @param T  Underlying type this class handles
+ * @param Resource  Type of the memory resource to allocate from
+ * @param ABI  ABI adapter class to use
+ */
+template <typename T, typename Resource, typename ABI>
+struct resource_handler<T[], Resource, ABI> : public default_handler<T[], ABI> {
+  using default_handler<T[], ABI>::slice_safe;
+
+  /**
+   * Default constructor
+   *
+   * Uses the default resource.
+   *
+   */
+  resource_handler();
+
+  /**
+   * Constructor
+   *
+   * @param resource  Memory resource to allocate from
+   */
+  explicit resource_handler(Resource *resource) noexcept;
+
+  /**
+   * Copy constructor
+   *
+   * Shares the given handler's resource, but not the ownership of its
+   * pointee.
+   *
+   * @param other  Handler to copy
+   */
+  resource_handler(resource_handler const &other) noexcept;
+
+  /**
+   * Rebinding constructor
+   *
+   * Shares the given handler's knowledge of the pointee's dynamic type, but
+   * allocates from the given resource instead (see value_ptr::clone_into).
+   *
+   * @param other  Handler to copy
+   * @param resource  Memory resource to allocate from
+   */
+  resource_handler(resource_handler const &other, Resource *resource) noexcept;
+
+  /**
+   * Move constructor
+   *
+   * Takes over the given handler's resource and the ownership of its
+   * pointee.
+   *
+   * @param other  Handler to move
+   */
+  resource_handler(resource_handler &&other) noexcept;
+
+  /**
+   * Copy-assignment operator
+   *
+   * Copies the given handler's resource unless this handler currently owns
+   * an array allocated from its own.
+   *
+   * @param other  Handler to copy-assign
+   * @return the assigned handler
+   */
+  resource_handler &operator=(resource_handler const &other) noexcept;
+
+  /**
+   * Move-assignment operator
+   *
+   * Takes over the given handler's resource and the ownership of its
+   * pointee, this handler must not own an array allocated from its resource.
+   *
+   * @param other  Handler to move-assign
+   * @return the assigned handler
+   */
+  resource_handler &operator=(resource_handler &&other) noexcept;
+
+  /**
+   * Adoption implementation
+   *
+   * Adopted arrays are assumed to come from the global heap.
+   *
+   * @param T2  Static type of the adopted array
+   * @param <unnamed>  Pointer to the adopted array
+   */
+  template <typename T2> void adopt(T2 const *) noexcept;
+
+  /**
+   * Construction implementation
+   *
+   * This method constructs a new array of objects, value-initialized or
+   * constructed from the given (lvalue) arguments in order, in storage
+   * obtained from the resource.
+   *
+   * @param T2  Array type to construct (T[])
+   * @param n  Number of elements in the array
+   * @param args  Arguments to construct every element from
+   * @return a new array of n objects
+   */
+  template <typename T2, typename... Args> T *construct(std::size_t n, Args &... args);
+
+  /**
+   * Destroyer implementation
+   *
+   * This method destroys an array allocated from the resource and returns
+   * its storage, and delegates to default_handler otherwise.
+   *
+   * @param p  Pointer to the array to delete
+   */
+  void destroy(T const *p);
+
+  /**
+   * Replication implementation
+   *
+   * This method constructs the replica in storage obtained from the
+   * resource, unless the underlying type is cloneable but not placement
+   * cloneable, in which case it delegates to default_handler.
+   *
+   * @param p  Pointer to the array to copy
+   * @return either nullptr if nullptr is given, or a new array copied from p
+   */
+  T *replicate(T const *p);
+
+  /**
+   * In-place assignment implementation
+   *
+   * Arrays allocated from the resource are never assigned in place, for
+   * other arrays this method delegates to default_handler.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q);
+
+  /**
+   * Release implementation
+   *
+   * This method replicates an array allocated from the resource onto the
+   * heap (and destroys the original), pointers to heap arrays are simply
+   * handed back.
+   *
+   * @param p  Pointer to the array to release
+   * @return a pointer the caller may take ownership of
+   */
+  T *release(T *p);
+
+  /**
+   * Return the memory resource in use
+   *
+   * @return a pointer to the memory resource in use
+   */
+  Resource *resource() const noexcept __attribute__((pure));
+
+  protected:
+    /**
+     * Replication implementation for placeable types
+     *
+     * @param p  Pointer to the array to copy
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating placeability
+     * @return a new array copied from p
+     */
+    T *replicateInto(T const *p, std::size_t n, std::true_type);
+
+    /**
+     * Replication implementation for non placeable types
+     *
+     * @param p  Pointer to the array to copy
+     * @param <unnamed>  Number of elements in the array
+     * @param <unnamed>  Tag indicating placeability
+     * @return a new array copied from p
+     */
+    T *replicateInto(T const *p, std::size_t, std::false_type);
+
+    /**
+     * Memory resource to allocate from
+     *
+     */
+    Resource *r;
+
+    /**
+     * Whether the current pointee was allocated from the resource
+     *
+     */
+    bool owned;
+
+    /**
+     * Padding up to the alignment of r
+     *
+     */
+    [[no_unique_address]] explicit_padding<padding_to<sizeof(Resource *) + sizeof(bool), alignof(Resource *)>::value> padding;
+};
+
+/**
+ * Metaprogramming class allocating fixed-size arrays from a memory resource
+ *
+ * @param T  Underlying type this class handles
+ * @param Resource  Type of the memory resource to allocate from
+ * @param ABI  ABI adapter class to use
+ * @param N  Number of elements in the array
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+struct resource_handler<T[N], Resource, ABI> : public default_handler<T[N], ABI> {
+  using default_handler<T[N], ABI>::slice_safe;
+
+  /**
+   * Default constructor
+   *
+   * Uses the default resource.
+   *
+   */
+  resource_handler();
+
+  /**
+   * Constructor
+   *
+   * @param resource  Memory resource to allocate from
+   */
+  explicit resource_handler(Resource *resource) noexcept;
+
+  /**
+   * Copy constructor
+   *
+   * Shares the given handler's resource, but not the ownership of its
+   * pointee.
+   *
+   * @param other  Handler to copy
+   */
+  resource_handler(resource_handler const &other) noexcept;
+
+  /**
+   * Rebinding constructor
+   *
+   * Shares the given handler's knowledge of the pointee's dynamic type, but
+   * allocates from the given resource instead (see value_ptr::clone_into).
+   *
+   * @param other  Handler to copy
+   * @param resource  Memory resource to allocate from
+   */
+  resource_handler(resource_handler const &other, Resource *resource) noexcept;
+
+  /**
+   * Move constructor
+   *
+   * Takes over the given handler's resource and the ownership of its
+   * pointee.
+   *
+   * @param other  Handler to move
+   */
+  resource_handler(resource_handler &&other) noexcept;
+
+  /**
+   * Copy-assignment operator
+   *
+   * Copies the given handler's resource unless this handler currently owns
+   * an array allocated from its own.
+   *
+   * @param other  Handler to copy-assign
+   * @return the assigned handler
+   */
+  resource_handler &operator=(resource_handler const &other) noexcept;
+
+  /**
+   * Move-assignment operator
+   *
+   * Takes over the given handler's resource and the ownership of its
+   * pointee, this handler must not own an array allocated from its resource.
+   *
+   * @param other  Handler to move-assign
+   * @return the assigned handler
+   */
+  resource_handler &operator=(resource_handler &&other) noexcept;
+
+  /**
+   * Adoption implementation
+   *
+   * Adopted arrays are assumed to come from the global heap.
+   *
+   * @param T2  Static type of the adopted array
+   * @param <unnamed>  Pointer to the adopted array
+   */
+  template <typename T2> void adopt(T2 const *) noexcept;
+
+  /**
+   * Construction implementation
+   *
+   * This method constructs a new array of N objects, value-initialized or
+   * constructed from the given (lvalue) arguments in order, in storage
+   * obtained from the resource.
+   *
+   * @param T2  Array type to construct (T[N])
+   * @param args  Arguments to construct every element from
+   * @return a new array of N objects
+   */
+  template <typename T2, typename... Args> T *construct(Args &... args);
+
+  /**
+   * Destroyer implementation
+   *
+   * This method destroys an array allocated from the resource and returns
+   * its storage, and delegates to default_handler otherwise.
+   *
+   * @param p  Pointer to the array to delete
+   */
+  void destroy(T const *p);
+
+  /**
+   * Replication implementation
+   *
+   * This method constructs the replica in storage obtained from the
+   * resource, unless the underlying type is cloneable but not placement
+   * cloneable, in which case it delegates to default_handler.
+   *
+   * @param p  Pointer to the array to copy
+   * @return either nullptr if nullptr is given, or a new array copied from p
+   */
+  T *replicate(T const *p);
+
+  /**
+   * In-place assignment implementation
+   *
+   * Arrays allocated from the resource are never assigned in place, for
+   * other arrays this method delegates to default_handler.
+   *
+   * @param p  Pointer to the array to assign to
+   * @param q  Pointer to the array to assign from
+   * @return whether the assignment could be performed in place
+   */
+  bool assign(T *p, T const *q);
+
+  /**
+   * Release implementation
+   *
+   * This method replicates an array allocated from the resource onto the
+   * heap (and destroys the original), pointers to heap arrays are simply
+   * handed back.
+   *
+   * @param p  Pointer to the array to release
+   * @return a pointer the caller may take ownership of
+   */
+  T *release(T *p);
+
+  /**
+   * Return the memory resource in use
+   *
+   * @return a pointer to the memory resource in use
+   */
+  Resource *resource() const noexcept __attribute__((pure));
+
+  protected:
+    /**
+     * Replication implementation for placeable types
+     *
+     * @param p  Pointer to the array to copy
+     * @param n  Number of elements in the array
+     * @param <unnamed>  Tag indicating placeability
+     * @return a new array copied from p
+     */
+    T *replicateInto(T const *p, std::size_t n, std::true_type);
+
+    /**
+     * Replication implementation for non placeable types
+     *
+     * @param p  Pointer to the array to copy
+     * @param <unnamed>  Number of elements in the array
+     * @param <unnamed>  Tag indicating placeability
+     * @return a new array copied from p
+     */
+    T *replicateInto(T const *p, std::size_t, std::false_type);
+
+    /**
+     * Memory resource to allocate from
+     *
+     */
+    Resource *r;
+
+    /**
+     * Whether the current pointee was allocated from the resource
+     *
+     */
+    bool owned;
+
+    /**
+     * Padding up to the alignment of r
+     *
+     */
+    [[no_unique_address]] explicit_padding<padding_to<sizeof(Resource *) + sizeof(bool), alignof(Resource *)>::value> padding;
+};
+
+
+#include "ResourceHandler.hpp"
+
+#endif /* VALUE_PTR__RESOURCE_HANDLER_H__ */
@@ -0,0 +1,989 @@
+#ifndef VALUE_PTR__RESOURCE_HANDLER_HPP__
+#define VALUE_PTR__RESOURCE_HANDLER_HPP__
+
+
+#include "ResourceHandler.h"
+
+#include <exception>
+#include <typeinfo>
+#include <utility>
+#include <new>
+
+
+/**
+ * Return the default memory resource
+ *
+ * @return a pointer to the default memory resource
+ */
+template <typename Resource>
+Resource *default_resource<Resource>::get() {
+  return &Resource::instance();
+}
+
+
+/**
+ * Replicate the given array into the given memory resource
+ *
+ * Should any copy throw, the already constructed objects are destroyed and
+ * the storage returned to the resource before rethrowing.
+ *
+ * @param p  Pointer to the array to copy
+ * @param n  Number of elements in the array
+ * @param resource  Memory resource to allocate from
+ * @return a new array copied from p
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_array<T, Resource, ABI>::replicate(T const *p, std::size_t n, Resource &resource) {
+  std::size_t i;
+  T *ret = ABI::template newArray<T>(n, resource);
+
+  try {
+    for (i = 0; i < n; i++) {
+      place(ret + i, p + i, typename condition<is_cloneable<T>::value>::type());
+    }
+  } catch (...) {
+    while (i--) {
+      try { (ret + i)->~T(); } catch (...) { std::terminate(); }
+    }
+    ABI::template delArray<T>(ret, n, resource);
+    throw;
+  }
+
+  return ret;
+}
+
+/**
+ * Construct a new array of objects in the given memory resource, value-initialized or constructed from the given arguments
+ *
+ * Should any constructor throw, the already constructed objects are
+ * destroyed and the storage returned to the resource before rethrowing.
+ *
+ * @param n  Number of elements in the array
+ * @param resource  Memory resource to allocate from
+ * @param args  Arguments to construct every element from, in order
+ * @return a new array of n objects
+ */
+template <typename T, typename Resource, typename ABI>
+template <typename... Args>
+T *resource_array<T, Resource, ABI>::construct(std::size_t n, Resource &resource, Args &... args) {
+  std::size_t i;
+  T *ret = ABI::template newArray<T>(n, resource);
+
+  try {
+    for (i = 0; i < n; i++) {
+      new(ret + i) T(args...);
+    }
+  } catch (...) {
+    while (i--) {
+      try { (ret + i)->~T(); } catch (...) { std::terminate(); }
+    }
+    ABI::template delArray<T>(ret, n, resource);
+    throw;
+  }
+
+  return ret;
+}
+
+/**
+ * Destroy the given array and return it to the given memory resource
+ *
+ * @param p  Pointer to the array to delete
+ * @param n  Number of elements in the array
+ * @param resource  Memory resource the array was allocated from
+ */
+template <typename T, typename Resource, typename ABI>
+void resource_array<T, Resource, ABI>::destroy(T const *p, std::size_t n, Resource &resource) {
+  std::size_t i = n;
+
+  try {
+    while (i--) {
+      (p + i)->~T();
+    }
+    ABI::template delArray<T>(p, n, resource);
+  } catch (...) {
+    while (i--) {
+      try { (p + i)->~T(); } catch (...) { std::terminate(); }
+    }
+    ABI::template delArray<T>(p, n, resource);
+    throw;
+  }
+}
+
+/**
+ * Copy an object into the given storage using its copy constructor
+ *
+ * @param raw  Storage to copy into
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ */
+template <typename T, typename Resource, typename ABI>
+void resource_array<T, Resource, ABI>::place(T *raw, T const *p, std::false_type) {
+  new(raw) T{*p};
+}
+
+/**
+ * Copy an object into the given storage using its placement clone method
+ *
+ * @param raw  Storage to copy into
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ */
+template <typename T, typename Resource, typename ABI>
+void resource_array<T, Resource, ABI>::place(T *raw, T const *p, std::true_type) {
+  p->clone(raw);
+}
+
+
+/**
+ * Default constructor
+ *
+ * Uses the default resource; the dynamic type is assumed to be the static
+ * one for non-polymorphic types and unknown otherwise.
+ *
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T, Resource, ABI>::resource_handler() : resource_handler(default_resource<Resource>::get()) {}
+
+/**
+ * Constructor
+ *
+ * @param resource  Memory resource to allocate from
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T, Resource, ABI>::resource_handler(Resource *resource) noexcept : default_handler<T, ABI>(), r(resource), size(placeable && !std::is_polymorphic<T>::value && alignof(T) <= alignof(std::max_align_t) ? sizeof(T) : 0), owned(false), padding() {}
+
+/**
+ * Copy constructor
+ *
+ * Shares the given handler's resource and knowledge of the pointee's
+ * dynamic type, but not the ownership of its pointee.
+ *
+ * @param other  Handler to copy
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T, Resource, ABI>::resource_handler(resource_handler<T, Resource, ABI> const &other) noexcept : default_handler<T, ABI>(other), r(other.r), size(other.size), owned(false), padding() {}
+
+/**
+ * Rebinding constructor
+ *
+ * Shares the given handler's knowledge of the pointee's dynamic type, but
+ * allocates from the given resource instead (see value_ptr::clone_into).
+ *
+ * @param other  Handler to copy
+ * @param resource  Memory resource to allocate from
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T, Resource, ABI>::resource_handler(resource_handler<T, Resource, ABI> const &other, Resource *resource) noexcept : default_handler<T, ABI>(other), r(resource), size(other.size), owned(false), padding() {}
+
+/**
+ * Move constructor
+ *
+ * Takes over the given handler's resource and the ownership of its
+ * pointee.
+ *
+ * @param other  Handler to move
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T, Resource, ABI>::resource_handler(resource_handler<T, Resource, ABI> &&other) noexcept : default_handler<T, ABI>(other), r(other.r), size(other.size), owned(other.owned), padding() { other.owned = false; }
+
+/**
+ * Copy-assignment operator
+ *
+ * Copies the given handler's resource and knowledge of the pointee's
+ * dynamic type, unless this handler currently owns an object allocated
+ * from its own resource.
+ *
+ * @param other  Handler to copy-assign
+ * @return the assigned handler
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T, Resource, ABI> &resource_handler<T, Resource, ABI>::operator=(resource_handler<T, Resource, ABI> const &other) noexcept {
+  if (!owned) {
+    r = other.r;
+    size = other.size;
+  }
+  return *this;
+}
+
+/**
+ * Move-assignment operator
+ *
+ * Takes over the given handler's resource and the ownership of its
+ * pointee, this handler must not own an object allocated from its resource.
+ *
+ * @param other  Handler to move-assign
+ * @return the assigned handler
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T, Resource, ABI> &resource_handler<T, Resource, ABI>::operator=(resource_handler<T, Resource, ABI> &&other) noexcept {
+  if (this != &other) {
+    r = other.r;
+    size = other.size;
+    owned = other.owned;
+    other.owned = false;
+  }
+  return *this;
+}
+
+/**
+ * Adoption implementation
+ *
+ * This method records whether the dynamic type of the given object is
+ * known (ie. coincides with T2) and may be served by the resource.
+ *
+ * @param T2  Static type of the adopted object
+ * @param p  Pointer to the adopted object
+ */
+template <typename T, typename Resource, typename ABI>
+template <typename T2>
+void resource_handler<T, Resource, ABI>::adopt(T2 const *p) noexcept {
+  size = placeable && typeid(*p) == typeid(T2) && alignof(T2) <= alignof(std::max_align_t) ? sizeof(T2) : 0;
+  owned = false;
+}
+
+/**
+ * Construction implementation
+ *
+ * This method constructs the new object in storage obtained from the
+ * resource if T2 may be served by it, and delegates to default_handler
+ * (adopting the new object) otherwise; should the construction throw, the
+ * storage is returned to the resource before rethrowing.
+ *
+ * @param T2  Class of the object to construct
+ * @param args  Arguments to forward to T2's constructor
+ * @return a new object constructed from args
+ */
+template <typename T, typename Resource, typename ABI>
+template <typename T2, typename... Args>
+T2 *resource_handler<T, Resource, ABI>::construct(Args&&... args) {
+  if (!placeable || alignof(T2) > alignof(std::max_align_t)) {
+    T2 *ret = default_handler<T, ABI>::template construct<T2>(std::forward<Args>(args)...);
+    adopt(ret);
+    return ret;
+  }
+
+  void *raw = r->allocate(sizeof(T2), alignof(std::max_align_t));
+
+  T2 *ret;
+  try {
+    ret = new(raw) T2(std::forward<Args>(args)...);
+  } catch (...) {
+    r->deallocate(raw, sizeof(T2), alignof(std::max_align_t));
+    throw;
+  }
+  size = sizeof(T2);
+  owned = true;
+
+  return ret;
+}
+
+/**
+ * Destroyer implementation
+ *
+ * This method destroys an object allocated from the resource and returns
+ * its storage, and delegates to default_handler otherwise.
+ *
+ * @param p  Pointer to the object to delete
+ */
+template <typename T, typename Resource, typename ABI>
+void resource_handler<T, Resource, ABI>::destroy(T const *p) {
+  if (nullptr == p || !owned) {
+    default_handler<T, ABI>::destroy(p);
+    return;
+  }
+
+  void *raw = const_cast<void *>(storage(p, typename condition<std::is_polymorphic<T>::value>::type()));
+
+  owned = false;
+  try {
+    p->~T();
+  } catch (...) {
+    r->deallocate(raw, size, alignof(std::max_align_t));
+    throw;
+  }
+  r->deallocate(raw, size, alignof(std::max_align_t));
+}
+
+/**
+ * Replication implementation
+ *
+ * This method constructs the replica in storage obtained from the resource
+ * if the object's dynamic type is known, and delegates to default_handler
+ * otherwise.
+ *
+ * @param p  Pointer to the object to copy
+ * @return either nullptr if nullptr is given, or a new object copied from p
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T, Resource, ABI>::replicate(T const *p) {
+  owned = false;
+  if (nullptr == p || 0 == size) {
+    return default_handler<T, ABI>::replicate(p);
+  }
+
+  return replicateInto(p, typename condition<placeable>::type());
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * For objects allocated from the resource, this method destroys the object
+ * and copies the other one into its storage (provided both dynamic types
+ * coincide); should the copy throw, the storage is returned to the
+ * resource. For other objects, it delegates to default_handler.
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename Resource, typename ABI>
+bool resource_handler<T, Resource, ABI>::assign(T *p, T const *q) {
+  if (!owned) {
+    return default_handler<T, ABI>::assign(p, q);
+  }
+
+  return assignInto(p, q, typename condition<placeable>::type());
+}
+
+/**
+ * Release implementation
+ *
+ * This method replicates an object allocated from the resource onto the
+ * heap (and destroys the original), pointers to heap objects are simply
+ * handed back.
+ *
+ * @param p  Pointer to the object to release
+ * @return a pointer the caller may take ownership of
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T, Resource, ABI>::release(T *p) {
+  if (nullptr == p || !owned) {
+    return p;
+  }
+
+  T *ret = default_handler<T, ABI>::replicate(p);
+  destroy(p);
+
+  return ret;
+}
+
+/**
+ * Return the memory resource in use
+ *
+ * @return a pointer to the memory resource in use
+ */
+template <typename T, typename Resource, typename ABI>
+Resource *resource_handler<T, Resource, ABI>::resource() const noexcept {
+  return r;
+}
+
+/**
+ * Replication implementation for placeable types
+ *
+ * Should the copy throw, the storage is returned to the resource before
+ * rethrowing.
+ *
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating placeability
+ * @return a new object copied from p
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T, Resource, ABI>::replicateInto(T const *p, std::true_type) {
+  void *raw = r->allocate(size, alignof(std::max_align_t));
+
+  T *ret;
+  try {
+    ret = place(raw, p, typename condition<is_cloneable<T>::value>::type());
+  } catch (...) {
+    r->deallocate(raw, size, alignof(std::max_align_t));
+    throw;
+  }
+  owned = true;
+
+  return ret;
+}
+
+/**
+ * Replication implementation for non placeable types
+ *
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating placeability
+ * @return a new object copied from p
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T, Resource, ABI>::replicateInto(T const *p, std::false_type) {
+  return default_handler<T, ABI>::replicate(p);
+}
+
+/**
+ * In-place assignment implementation for placeable types
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @param <unnamed>  Tag indicating placeability
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename Resource, typename ABI>
+bool resource_handler<T, Resource, ABI>::assignInto(T *p, T const *q, std::true_type) {
+  if (typeid(*p) != typeid(*q)) {
+    return false;
+  }
+
+  void *raw = const_cast<void *>(storage(p, typename condition<std::is_polymorphic<T>::value>::type()));
+
+  owned = false;
+  p->~T();
+  try {
+    place(raw, q, typename condition<is_cloneable<T>::value>::type());
+  } catch (...) {
+    r->deallocate(raw, size, alignof(std::max_align_t));
+    throw;
+  }
+  owned = true;
+
+  return true;
+}
+
+/**
+ * In-place assignment implementation for non placeable types
+ *
+ * @param p  Pointer to the object to assign to
+ * @param q  Pointer to the object to assign from
+ * @param <unnamed>  Tag indicating placeability
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename Resource, typename ABI>
+bool resource_handler<T, Resource, ABI>::assignInto(T *p, T const *q, std::false_type) {
+  return default_handler<T, ABI>::assign(p, q);
+}
+
+/**
+ * Copy the given object into the given storage using its copy constructor
+ *
+ * @param raw  Storage to copy into
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ * @return a pointer to the new object
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T, Resource, ABI>::place(void *raw, T const *p, std::false_type) {
+  return new(raw) T{*p};
+}
+
+/**
+ * Copy the given object into the given storage using its placement clone method
+ *
+ * @param raw  Storage to copy into
+ * @param p  Pointer to the object to copy
+ * @param <unnamed>  Tag indicating cloneability
+ * @return a pointer to the new object
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T, Resource, ABI>::place(void *raw, T const *p, std::true_type) {
+  return p->clone(raw);
+}
+
+/**
+ * Return the storage of a non-polymorphic object
+ *
+ * @param p  Pointer to the object
+ * @param <unnamed>  Tag indicating polymorphism
+ * @return a pointer to the object's storage
+ */
+template <typename T, typename Resource, typename ABI>
+void const *resource_handler<T, Resource, ABI>::storage(T const *p, std::false_type) noexcept {
+  return p;
+}
+
+/**
+ * Return the storage of a polymorphic object
+ *
+ * @param p  Pointer to the object
+ * @param <unnamed>  Tag indicating polymorphism
+ * @return a pointer to the most derived object's storage
+ */
+template <typename T, typename Resource, typename ABI>
+void const *resource_handler<T, Resource, ABI>::storage(T const *p, std::true_type) noexcept {
+  return dynamic_cast<void const *>(p);
+}
+
+
+/**
+ * Default constructor
+ *
+ * Uses the default resource.
+ *
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T[], Resource, ABI>::resource_handler() : resource_handler(default_resource<Resource>::get()) {}
+
+/**
+ * Constructor
+ *
+ * @param resource  Memory resource to allocate from
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T[], Resource, ABI>::resource_handler(Resource *resource) noexcept : default_handler<T[], ABI>(), r(resource), owned(false), padding() {}
+
+/**
+ * Copy constructor
+ *
+ * Shares the given handler's resource, but not the ownership of its
+ * pointee.
+ *
+ * @param other  Handler to copy
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T[], Resource, ABI>::resource_handler(resource_handler<T[], Resource, ABI> const &other) noexcept : default_handler<T[], ABI>(other), r(other.r), owned(false), padding() {}
+
+/**
+ * Rebinding constructor
+ *
+ * Shares the given handler's knowledge of the pointee's dynamic type, but
+ * allocates from the given resource instead (see value_ptr::clone_into).
+ *
+ * @param other  Handler to copy
+ * @param resource  Memory resource to allocate from
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T[], Resource, ABI>::resource_handler(resource_handler<T[], Resource, ABI> const &other, Resource *resource) noexcept : default_handler<T[], ABI>(other), r(resource), owned(false), padding() {}
+
+/**
+ * Move constructor
+ *
+ * Takes over the given handler's resource and the ownership of its
+ * pointee.
+ *
+ * @param other  Handler to move
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T[], Resource, ABI>::resource_handler(resource_handler<T[], Resource, ABI> &&other) noexcept : default_handler<T[], ABI>(other), r(other.r), owned(other.owned), padding() { other.owned = false; }
+
+/**
+ * Copy-assignment operator
+ *
+ * Copies the given handler's resource unless this handler currently owns
+ * an array allocated from its own.
+ *
+ * @param other  Handler to copy-assign
+ * @return the assigned handler
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T[], Resource, ABI> &resource_handler<T[], Resource, ABI>::operator=(resource_handler<T[], Resource, ABI> const &other) noexcept {
+  if (!owned) {
+    r = other.r;
+  }
+  return *this;
+}
+
+/**
+ * Move-assignment operator
+ *
+ * Takes over the given handler's resource and the ownership of its
+ * pointee, this handler must not own an array allocated from its resource.
+ *
+ * @param other  Handler to move-assign
+ * @return the assigned handler
+ */
+template <typename T, typename Resource, typename ABI>
+resource_handler<T[], Resource, ABI> &resource_handler<T[], Resource, ABI>::operator=(resource_handler<T[], Resource, ABI> &&other) noexcept {
+  if (this != &other) {
+    r = other.r;
+    owned = other.owned;
+    other.owned = false;
+  }
+  return *this;
+}
+
+/**
+ * Adoption implementation
+ *
+ * Adopted arrays are assumed to come from the global heap.
+ *
+ * @param T2  Static type of the adopted array
+ * @param <unnamed>  Pointer to the adopted array
+ */
+template <typename T, typename Resource, typename ABI>
+template <typename T2>
+void resource_handler<T[], Resource, ABI>::adopt(T2 const *) noexcept {
+  owned = false;
+}
+
+/**
+ * Construction implementation
+ *
+ * This method constructs a new array of objects, value-initialized or
+ * constructed from the given (lvalue) arguments in order, in storage
+ * obtained from the resource.
+ *
+ * @param T2  Array type to construct (T[])
+ * @param n  Number of elements in the array
+ * @param args  Arguments to construct every element from
+ * @return a new array of n objects
+ */
+template <typename T, typename Resource, typename ABI>
+template <typename T2, typename... Args>
+T *resource_handler<T[], Resource, ABI>::construct(std::size_t n, Args &... args) {
+  static_assert(std::is_same<T2, T[]>::value, "arrays can only be constructed as such");
+
+  T *ret = resource_array<T, Resource, ABI>::construct(n, *r, args...);
+  owned = true;
+
+  return ret;
+}
+
+/**
+ * Destroyer implementation
+ *
+ * This method destroys an array allocated from the resource and returns
+ * its storage, and delegates to default_handler otherwise.
+ *
+ * @param p  Pointer to the array to delete
+ */
+template <typename T, typename Resource, typename ABI>
+void resource_handler<T[], Resource, ABI>::destroy(T const *p) {
+  if (nullptr == p || !owned) {
+    default_handler<T[], ABI>::destroy(p);
+    return;
+  }
+
+  owned = false;
+  resource_array<T, Resource, ABI>::destroy(p, ABI::template arraySize<T>(p), *r);
+}
+
+/**
+ * Replication implementation
+ *
+ * This method constructs the replica in storage obtained from the
+ * resource, unless the underlying type is cloneable but not placement
+ * cloneable, in which case it delegates to default_handler.
+ *
+ * @param p  Pointer to the array to copy
+ * @return either nullptr if nullptr is given, or a new array copied from p
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T[], Resource, ABI>::replicate(T const *p) {
+  owned = false;
+  if (nullptr == p) {
+    return nullptr;
+  }
+
+  return replicateInto(p, ABI::template arraySize<T>(p), typename condition<resource_array<T, Resource, ABI>::placeable>::type());
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * Arrays allocated from the resource are never assigned in place, for
+ * other arrays this method delegates to default_handler.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename Resource, typename ABI>
+bool resource_handler<T[], Resource, ABI>::assign(T *p, T const *q) {
+  return !owned && default_handler<T[], ABI>::assign(p, q);
+}
+
+/**
+ * Release implementation
+ *
+ * This method replicates an array allocated from the resource onto the
+ * heap (and destroys the original), pointers to heap arrays are simply
+ * handed back.
+ *
+ * @param p  Pointer to the array to release
+ * @return a pointer the caller may take ownership of
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T[], Resource, ABI>::release(T *p) {
+  if (nullptr == p || !owned) {
+    return p;
+  }
+
+  T *ret = default_handler<T[], ABI>::replicate(p);
+  destroy(p);
+
+  return ret;
+}
+
+/**
+ * Return the memory resource in use
+ *
+ * @return a pointer to the memory resource in use
+ */
+template <typename T, typename Resource, typename ABI>
+Resource *resource_handler<T[], Resource, ABI>::resource() const noexcept {
+  return r;
+}
+
+/**
+ * Replication implementation for placeable types
+ *
+ * @param p  Pointer to the array to copy
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating placeability
+ * @return a new array copied from p
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T[], Resource, ABI>::replicateInto(T const *p, std::size_t n, std::true_type) {
+  T *ret = resource_array<T, Resource, ABI>::replicate(p, n, *r);
+  owned = true;
+
+  return ret;
+}
+
+/**
+ * Replication implementation for non placeable types
+ *
+ * @param p  Pointer to the array to copy
+ * @param <unnamed>  Number of elements in the array
+ * @param <unnamed>  Tag indicating placeability
+ * @return a new array copied from p
+ */
+template <typename T, typename Resource, typename ABI>
+T *resource_handler<T[], Resource, ABI>::replicateInto(T const *p, std::size_t, std::false_type) {
+  return default_handler<T[], ABI>::replicate(p);
+}
+
+
+/**
+ * Default constructor
+ *
+ * Uses the default resource.
+ *
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+resource_handler<T[N], Resource, ABI>::resource_handler() : resource_handler(default_resource<Resource>::get()) {}
+
+/**
+ * Constructor
+ *
+ * @param resource  Memory resource to allocate from
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+resource_handler<T[N], Resource, ABI>::resource_handler(Resource *resource) noexcept : default_handler<T[N], ABI>(), r(resource), owned(false), padding() {}
+
+/**
+ * Copy constructor
+ *
+ * Shares the given handler's resource, but not the ownership of its
+ * pointee.
+ *
+ * @param other  Handler to copy
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+resource_handler<T[N], Resource, ABI>::resource_handler(resource_handler<T[N], Resource, ABI> const &other) noexcept : default_handler<T[N], ABI>(other), r(other.r), owned(false), padding() {}
+
+/**
+ * Rebinding constructor
+ *
+ * Shares the given handler's knowledge of the pointee's dynamic type, but
+ * allocates from the given resource instead (see value_ptr::clone_into).
+ *
+ * @param other  Handler to copy
+ * @param resource  Memory resource to allocate from
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+resource_handler<T[N], Resource, ABI>::resource_handler(resource_handler<T[N], Resource, ABI> const &other, Resource *resource) noexcept : default_handler<T[N], ABI>(other), r(resource), owned(false), padding() {}
+
+/**
+ * Move constructor
+ *
+ * Takes over the given handler's resource and the ownership of its
+ * pointee.
+ *
+ * @param other  Handler to move
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+resource_handler<T[N], Resource, ABI>::resource_handler(resource_handler<T[N], Resource, ABI> &&other) noexcept : default_handler<T[N], ABI>(other), r(other.r), owned(other.owned), padding() { other.owned = false; }
+
+/**
+ * Copy-assignment operator
+ *
+ * Copies the given handler's resource unless this handler currently owns
+ * an array allocated from its own.
+ *
+ * @param other  Handler to copy-assign
+ * @return the assigned handler
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+resource_handler<T[N], Resource, ABI> &resource_handler<T[N], Resource, ABI>::operator=(resource_handler<T[N], Resource, ABI> const &other) noexcept {
+  if (!owned) {
+    r = other.r;
+  }
+  return *this;
+}
+
+/**
+ * Move-assignment operator
+ *
+ * Takes over the given handler's resource and the ownership of its
+ * pointee, this handler must not own an array allocated from its resource.
+ *
+ * @param other  Handler to move-assign
+ * @return the assigned handler
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+resource_handler<T[N], Resource, ABI> &resource_handler<T[N], Resource, ABI>::operator=(resource_handler<T[N], Resource, ABI> &&other) noexcept {
+  if (this != &other) {
+    r = other.r;
+    owned = other.owned;
+    other.owned = false;
+  }
+  return *this;
+}
+
+/**
+ * Adoption implementation
+ *
+ * Adopted arrays are assumed to come from the global heap.
+ *
+ * @param T2  Static type of the adopted array
+ * @param <unnamed>  Pointer to the adopted array
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+template <typename T2>
+void resource_handler<T[N], Resource, ABI>::adopt(T2 const *) noexcept {
+  owned = false;
+}
+
+/**
+ * Construction implementation
+ *
+ * This method constructs a new array of N objects, value-initialized or
+ * constructed from the given (lvalue) arguments in order, in storage
+ * obtained from the resource.
+ *
+ * @param T2  Array type to construct (T[N])
+ * @param args  Arguments to construct every element from
+ * @return a new array of N objects
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+template <typename T2, typename... Args>
+T *resource_handler<T[N], Resource, ABI>::construct(Args &... args) {
+  static_assert(std::is_same<T2, T[N]>::value, "arrays can only be constructed as such");
+
+  T *ret = resource_array<T, Resource, ABI>::construct(N, *r, args...);
+  owned = true;
+
+  return ret;
+}
+
+/**
+ * Destroyer implementation
+ *
+ * This method destroys an array allocated from the resource and returns
+ * its storage, and delegates to default_handler otherwise.
+ *
+ * @param p  Pointer to the array to delete
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+void resource_handler<T[N], Resource, ABI>::destroy(T const *p) {
+  if (nullptr == p || !owned) {
+    default_handler<T[N], ABI>::destroy(p);
+    return;
+  }
+
+  owned = false;
+  resource_array<T, Resource, ABI>::destroy(p, N, *r);
+}
+
+/**
+ * Replication implementation
+ *
+ * This method constructs the replica in storage obtained from the
+ * resource, unless the underlying type is cloneable but not placement
+ * cloneable, in which case it delegates to default_handler.
+ *
+ * @param p  Pointer to the array to copy
+ * @return either nullptr if nullptr is given, or a new array copied from p
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+T *resource_handler<T[N], Resource, ABI>::replicate(T const *p) {
+  owned = false;
+  if (nullptr == p) {
+    return nullptr;
+  }
+
+  return replicateInto(p, N, typename condition<resource_array<T, Resource, ABI>::placeable>::type());
+}
+
+/**
+ * In-place assignment implementation
+ *
+ * Arrays allocated from the resource are never assigned in place, for
+ * other arrays this method delegates to default_handler.
+ *
+ * @param p  Pointer to the array to assign to
+ * @param q  Pointer to the array to assign from
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+bool resource_handler<T[N], Resource, ABI>::assign(T *p, T const *q) {
+  return !owned && default_handler<T[N], ABI>::assign(p, q);
+}
+
+/**
+ * Release implementation
+ *
+ * This method replicates an array allocated from the resource onto the
+ * heap (and destroys the original), pointers to heap arrays are simply
+ * handed back.
+ *
+ * @param p  Pointer to the array to release
+ * @return a pointer the caller may take ownership of
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+T *resource_handler<T[N], Resource, ABI>::release(T *p) {
+  if (nullptr == p || !owned) {
+    return p;
+  }
+
+  T *ret = default_handler<T[N], ABI>::replicate(p);
+  destroy(p);
+
+  return ret;
+}
+
+/**
+ * Return the memory resource in use
+ *
+ * @return a pointer to the memory resource in use
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+Resource *resource_handler<T[N], Resource, ABI>::resource() const noexcept {
+  return r;
+}
+
+/**
+ * Replication implementation for placeable types
+ *
+ * @param p  Pointer to the array to copy
+ * @param n  Number of elements in the array
+ * @param <unnamed>  Tag indicating placeability
+ * @return a new array copied from p
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+T *resource_handler<T[N], Resource, ABI>::replicateInto(T const *p, std::size_t n, std::true_type) {
+  T *ret = resource_array<T, Resource, ABI>::replicate(p, n, *r);
+  owned = true;
+
+  return ret;
+}
+
+/**
+ * Replication implementation for non placeable types
+ *
+ * @param p  Pointer to the array to copy
+ * @param <unnamed>  Number of elements in the array
+ * @param <unnamed>  Tag indicating placeability
+ * @return a new array copied from p
+ */
+template <typename T, typename Resource, typename ABI, std::size_t N>
+T *resource_handler<T[N], Resource, ABI>::replicateInto(T const *p, std::size_t, std::false_type) {
+  return default_handler<T[N], ABI>::replicate(p);
+}
+
+#endif /* VALUE_PTR__RESOURCE_HANDLER_HPP__ */
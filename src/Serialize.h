@@ -0,0 +1,914 @@
+#ifndef VALUE_PTR__SERIALIZE_H__
+#define VALUE_PTR__SERIALIZE_H__
+
+
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "Cloneable.h"
+#include "value_ptr.h"
+#include "Compare.h"
+
+
+class value_writer;
+class value_reader;
+
+
+/**
+ * Exception thrown upon malformed or truncated input, and upon unregistered dynamic types
+ *
+ */
+class serial_error : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+
+/**
+ * Metaprogramming class to detect the presence of a "save" method
+ *
+ * A "save" method is a const method taking a single value_writer reference,
+ * writing the object's contents to it (for polymorphic classes, it is
+ * called on the dynamic type, and need thus not be virtual).
+ *
+ * @param T  Class to check for
+ * @var bool value  True if T has a save method, false otherwise
+ */
+template <typename T>
+struct is_saveable {
+  protected:
+    /**
+     * Default case
+     *
+     * Always succeeds (note the "..." in the argument specification), resolves
+     * to false (std::false_type).
+     *
+     * @param <unnamed>  Ignored
+     */
+    template <typename>
+    static constexpr auto test(...) -> std::false_type;
+
+    /**
+     * Test for the existence of a callable "save" method
+     *
+     * This metamethod will only be defined when calling "save" on a const S
+     * with a value_writer succeeds.
+     *
+     * @param S  Class under which to look for a "save" method
+     */
+    template <typename S>
+    static constexpr auto test(std::nullptr_t)
+      -> decltype(std::declval<S const &>().save(std::declval<value_writer &>()), std::true_type());
+
+  public:
+    static constexpr bool value = decltype(test<T>(nullptr))::value;
+};
+
+/**
+ * Metaprogramming class to detect a "loading" constructor
+ *
+ * A "loading" constructor takes a single value_reader reference, and reads
+ * the object's contents (in the order "save" wrote them) from it.
+ *
+ * @param T  Class to check for
+ * @var bool value  True if T has a loading constructor, false otherwise
+ */
+template <typename T>
+struct is_loadable {
+  static constexpr bool value = std::is_constructible<T, value_reader &>::value;
+};
+
+
+/**
+ * Registry of the dynamic types a value_ptr<T, H> may be serialized with
+ *
+ * Polymorphic pointees are written along with the name their dynamic type
+ * was enrolled under (once per stream, later ones referring back to it), and
+ * read back by having the handler construct an object of that type from
+ * the reader, in place. Every dynamic type must be enrolled (typically
+ * upon startup) before being written or read.
+ *
+ * Entries are never removed, and may be looked up concurrently with
+ * enrollment.
+ *
+ * @param T  Polymorphic base type
+ * @param H  Handler type of the value_ptrs (default_handler<T> by default)
+ */
+template <typename T, typename H = default_handler<T>>
+class serial_types {
+  public:
+    /**
+     * Refuse to work on non-polymorphic types
+     *
+     * Non-polymorphic pointees are always of their static type, there is
+     * nothing to register.
+     *
+     */
+    static_assert(std::is_polymorphic<T>::value, "serial_types can only work on polymorphic types");
+
+    /**
+     * Registered dynamic type
+     *
+     */
+    struct entry {
+      char const *name;
+      std::size_t length;
+      std::type_info const *type;
+      void (*save)(T const *, value_writer &);
+      value_ptr<T, H> (*load)(value_reader &);
+      entry const *next;
+    };
+
+    /**
+     * Enroll the given dynamic type under the given name
+     *
+     * Enrolling a type again under the same name has no effect.
+     *
+     * @param T2  Dynamic type to enroll, derived from T, saveable and loadable
+     * @param name  Name to enroll T2 under (must outlive the registry, eg. a string literal)
+     * @throws serial_error  In case the name or type is already enrolled otherwise
+     */
+    template <typename T2> static void enroll(char const *name);
+
+    /**
+     * Return the entry of the given dynamic type
+     *
+     * @param type  Dynamic type to look for
+     * @return the type's entry, or nullptr if not enrolled
+     */
+    static entry const *find(std::type_info const &type) noexcept;
+
+    /**
+     * Return the entry enrolled under the given name
+     *
+     * @param name  Name to look for (not necessarily NUL-terminated)
+     * @param length  Length of the name
+     * @return the name's entry, or nullptr if not enrolled
+     */
+    static entry const *find(char const *name, std::size_t length) noexcept;
+
+  protected:
+    /**
+     * Save an object of dynamic type T2
+     *
+     * @param T2  Dynamic type of the object
+     * @param p  Pointer to the object
+     * @param out  Writer to save to
+     */
+    template <typename T2> static void saveAs(T const *p, value_writer &out);
+
+    /**
+     * Load an object of dynamic type T2, constructed in place by the handler
+     *
+     * @param T2  Dynamic type of the object
+     * @param in  Reader to load from
+     * @return a value_ptr holding the loaded object
+     */
+    template <typename T2> static value_ptr<T, H> loadAs(value_reader &in);
+
+    /**
+     * Return the head of the entry list
+     *
+     * @return the head of the entry list
+     */
+    static std::atomic<entry const *> &entries() noexcept __attribute__((const));
+
+    /**
+     * Return the lock serializing enrollment
+     *
+     * @return the lock serializing enrollment
+     */
+    static std::mutex &lock() noexcept __attribute__((const));
+};
+
+
+/**
+ * Metaprogramming class serializing a value_ptr's pointee (single objects)
+ *
+ * Non-polymorphic pointees are written as a presence flag followed by the
+ * object; polymorphic ones as a type tag (0 for nullptr) followed by the
+ * object, as saved by its dynamic type's serial_types entry.
+ *
+ * @param T  Underlying type of the value_ptr
+ * @param H  Handler type of the value_ptr
+ */
+template <typename T, typename H>
+struct serial_pointee {
+  /**
+   * Save the given pointee
+   *
+   * @param out  Writer to save to
+   * @param p  Pointer to the pointee, or nullptr
+   * @throws serial_error  In case the pointee's dynamic type is not enrolled
+   */
+  static void save(value_writer &out, T const *p);
+
+  /**
+   * Load a pointee
+   *
+   * @param in  Reader to load from
+   * @return a value_ptr holding the loaded pointee, or nullptr
+   * @throws serial_error  In case the input is malformed or names an unenrolled type
+   */
+  static value_ptr<T, H> load(value_reader &in);
+
+  protected:
+    /**
+     * Save a polymorphic pointee
+     *
+     * @param out  Writer to save to
+     * @param p  Pointer to the pointee, or nullptr
+     * @param <unnamed>  Tag indicating polymorphism
+     */
+    static void save(value_writer &out, T const *p, std::true_type);
+
+    /**
+     * Save a non-polymorphic pointee
+     *
+     * @param out  Writer to save to
+     * @param p  Pointer to the pointee, or nullptr
+     * @param <unnamed>  Tag indicating polymorphism
+     */
+    static void save(value_writer &out, T const *p, std::false_type);
+
+    /**
+     * Load a polymorphic pointee
+     *
+     * @param in  Reader to load from
+     * @param <unnamed>  Tag indicating polymorphism
+     * @return a value_ptr holding the loaded pointee, or nullptr
+     */
+    static value_ptr<T, H> load(value_reader &in, std::true_type);
+
+    /**
+     * Load a non-polymorphic pointee
+     *
+     * @param in  Reader to load from
+     * @param <unnamed>  Tag indicating polymorphism
+     * @return a value_ptr holding the loaded pointee, or nullptr
+     */
+    static value_ptr<T, H> load(value_reader &in, std::false_type);
+
+    /**
+     * Construct a pointee in place by its loading constructor
+     *
+     * @param in  Reader to load from
+     * @param <unnamed>  Tag indicating a loading constructor
+     * @return a value_ptr holding the loaded pointee
+     */
+    static value_ptr<T, H> construct(value_reader &in, std::true_type);
+
+    /**
+     * Construct a trivially copyable pointee in place and read its bytes into it
+     *
+     * @param in  Reader to load from
+     * @param <unnamed>  Tag indicating a loading constructor
+     * @return a value_ptr holding the loaded pointee
+     */
+    static value_ptr<T, H> construct(value_reader &in, std::false_type);
+};
+
+/**
+ * Specialization of serial_pointee for array types
+ *
+ * Arrays are written as a presence flag, their length, and their elements
+ * (in a single bulk write for trivially copyable elements). They are read
+ * back into storage allocated (uninitialized) through the handler's ABI,
+ * trivially copyable elements in a single bulk read and others by their
+ * loading constructor, for handlers deleting arrays through a
+ * default_destroy; other handlers construct the array in place, trivially
+ * copyable elements being read over in bulk and others constructed by
+ * their loading constructor.
+ *
+ * @param T  Underlying type of the array
+ * @param H  Handler type of the value_ptr
+ */
+template <typename T, typename H>
+struct serial_pointee<T[], H> {
+  /**
+   * Save the given array
+   *
+   * @param out  Writer to save to
+   * @param p  Pointer to the array, or nullptr
+   */
+  static void save(value_writer &out, T const *p);
+
+  /**
+   * Load an array
+   *
+   * @param in  Reader to load from
+   * @return a value_ptr holding the loaded array, or nullptr
+   * @throws serial_error  In case the input is malformed
+   */
+  static value_ptr<T[], H> load(value_reader &in);
+
+  protected:
+    /**
+     * ABI adapter of the handler
+     *
+     */
+    using abi_type = typename handler_abi<H>::type;
+
+    /**
+     * Load an array into storage allocated through the handler's ABI
+     *
+     * @param in  Reader to load from
+     * @param n  Number of elements
+     * @param <unnamed>  Tag indicating ABI-allocated storage
+     * @return a value_ptr holding the loaded array
+     */
+    static value_ptr<T[], H> load(value_reader &in, std::size_t n, std::true_type);
+
+    /**
+     * Load an array constructed in place by the handler
+     *
+     * @param in  Reader to load from
+     * @param n  Number of elements
+     * @param <unnamed>  Tag indicating ABI-allocated storage
+     * @return a value_ptr holding the loaded array
+     */
+    static value_ptr<T[], H> load(value_reader &in, std::size_t n, std::false_type);
+
+    /**
+     * Construct an array of trivially copyable elements in place and read their bytes into it
+     *
+     * @param in  Reader to load from
+     * @param n  Number of elements
+     * @param <unnamed>  Tag indicating trivial copyability
+     * @return a value_ptr holding the loaded array
+     */
+    static value_ptr<T[], H> construct(value_reader &in, std::size_t n, std::true_type);
+
+    /**
+     * Construct an array in place, each element by its loading constructor
+     *
+     * @param in  Reader to load from
+     * @param n  Number of elements
+     * @param <unnamed>  Tag indicating trivial copyability
+     * @return a value_ptr holding the loaded array
+     */
+    static value_ptr<T[], H> construct(value_reader &in, std::size_t n, std::false_type);
+
+    /**
+     * Read elements into uninitialized storage, by a single bulk read
+     *
+     * @param in  Reader to load from
+     * @param p  Storage to read into
+     * @param n  Number of elements
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void place(value_reader &in, T *p, std::size_t n, std::true_type);
+
+    /**
+     * Construct elements into uninitialized storage, by their loading constructor
+     *
+     * Should any constructor throw, the already constructed elements are
+     * destroyed before rethrowing.
+     *
+     * @param in  Reader to load from
+     * @param p  Storage to construct into
+     * @param n  Number of elements
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void place(value_reader &in, T *p, std::size_t n, std::false_type);
+};
+
+/**
+ * Specialization of serial_pointee for fixed array types
+ *
+ * Fixed arrays are written as a presence flag and their elements (in a
+ * single bulk write for trivially copyable elements), and read back into an
+ * array constructed in place by the handler, trivially copyable elements
+ * being read over in bulk and others constructed by their loading
+ * constructor.
+ *
+ * @param T  Underlying type of the array
+ * @param N  Number of elements in the array
+ * @param H  Handler type of the value_ptr
+ */
+template <typename T, std::size_t N, typename H>
+struct serial_pointee<T[N], H> {
+  /**
+   * Save the given array
+   *
+   * @param out  Writer to save to
+   * @param p  Pointer to the array, or nullptr
+   */
+  static void save(value_writer &out, T const *p);
+
+  /**
+   * Load an array
+   *
+   * @param in  Reader to load from
+   * @return a value_ptr holding the loaded array, or nullptr
+   * @throws serial_error  In case the input is malformed
+   */
+  static value_ptr<T[N], H> load(value_reader &in);
+
+  protected:
+    /**
+     * Construct an array of trivially copyable elements in place and read their bytes into it
+     *
+     * @param in  Reader to load from
+     * @param <unnamed>  Tag indicating trivial copyability
+     * @return a value_ptr holding the loaded array
+     */
+    static value_ptr<T[N], H> construct(value_reader &in, std::true_type);
+
+    /**
+     * Construct an array in place, each element by its loading constructor
+     *
+     * @param in  Reader to load from
+     * @param <unnamed>  Tag indicating trivial copyability
+     * @return a value_ptr holding the loaded array
+     */
+    static value_ptr<T[N], H> construct(value_reader &in, std::false_type);
+};
+
+
+/**
+ * Metaprogramming class serializing values
+ *
+ * Trivially copyable values are written as raw bytes, others by their
+ * "save" method and read back by their loading constructor.
+ *
+ * @param T  Type of the value
+ */
+template <typename T>
+struct serial_value {
+  /**
+   * Least number of bytes a value is written as (none being known for "save" methods)
+   *
+   */
+  static constexpr std::size_t least_size = std::is_trivially_copyable<T>::value ? sizeof(T) : 0;
+
+  /**
+   * Save the given value
+   *
+   * @param out  Writer to save to
+   * @param value  Value to save
+   */
+  static void save(value_writer &out, T const &value);
+
+  /**
+   * Load a value
+   *
+   * @param in  Reader to load from
+   * @return the loaded value
+   */
+  static T load(value_reader &in);
+
+  protected:
+    /**
+     * Save a trivially copyable value
+     *
+     * @param out  Writer to save to
+     * @param value  Value to save
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void save(value_writer &out, T const &value, std::true_type);
+
+    /**
+     * Save a value by its "save" method
+     *
+     * @param out  Writer to save to
+     * @param value  Value to save
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    static void save(value_writer &out, T const &value, std::false_type);
+
+    /**
+     * Load a trivially copyable value
+     *
+     * @param in  Reader to load from
+     * @param <unnamed>  Tag indicating trivial copyability
+     * @return the loaded value
+     */
+    static T load(value_reader &in, std::true_type);
+
+    /**
+     * Load a value by its loading constructor
+     *
+     * @param in  Reader to load from
+     * @param <unnamed>  Tag indicating trivial copyability
+     * @return the loaded value
+     */
+    static T load(value_reader &in, std::false_type);
+};
+
+/**
+ * Specialization of serial_value for value_ptrs, delegating to serial_pointee
+ *
+ * @param T  Underlying type of the value_ptr
+ * @param H  Handler type of the value_ptr
+ */
+template <typename T, typename H>
+struct serial_value<value_ptr<T, H>> {
+  /**
+   * Least number of bytes a value_ptr is written as (its presence flag or type tag)
+   *
+   */
+  static constexpr std::size_t least_size = 1;
+
+  /**
+   * Save the given value_ptr's pointee
+   *
+   * @param out  Writer to save to
+   * @param v  value_ptr to save
+   */
+  static void save(value_writer &out, value_ptr<T, H> const &v);
+
+  /**
+   * Load a value_ptr's pointee
+   *
+   * @param in  Reader to load from
+   * @return a value_ptr holding the loaded pointee, or nullptr
+   */
+  static value_ptr<T, H> load(value_reader &in);
+};
+
+
+/**
+ * Streaming writer of values and value_ptr graphs
+ *
+ * Values are written in the platform's native representation, to be read
+ * back by the same build: the format is a checkpoint one, not an exchange
+ * one. Writes to a file descriptor go through a buffer of capacity bytes,
+ * runs of bytes at least as large bypassing it; writes to a vector append
+ * to it directly.
+ *
+ */
+class value_writer {
+  public:
+    /**
+     * Size of the buffer used for file descriptors
+     *
+     */
+    static constexpr std::size_t capacity = 64 * 1024;
+
+    /**
+     * Stream type tags of polymorphic pointees, type ids following
+     *
+     */
+    enum : std::uint32_t { null_tag, new_tag, first_id };
+
+    /**
+     * Constructor, appending to the given vector
+     *
+     * @param into  Vector to append to
+     */
+    explicit value_writer(std::vector<char> &into) noexcept;
+
+    /**
+     * Constructor, writing to the given file descriptor
+     *
+     * @param descriptor  File descriptor to write to (not closed by the writer)
+     */
+    explicit value_writer(int descriptor);
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    value_writer(value_writer const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    value_writer &operator=(value_writer const &) = delete;
+
+    /**
+     * Destructor, flushing the buffer
+     *
+     * Errors are ignored: call flush() beforehand to observe them.
+     *
+     */
+    ~value_writer() noexcept;
+
+    /**
+     * Write a run of raw bytes
+     *
+     * @param p  Pointer to the bytes
+     * @param n  Number of bytes
+     * @throws std::system_error  In case writing to the file descriptor fails
+     */
+    void write(void const *p, std::size_t n);
+
+    /**
+     * Write a value (or a value_ptr's pointee)
+     *
+     * @param T  Type of the value
+     * @param value  Value to write
+     */
+    template <typename T> void write(T const &value);
+
+    /**
+     * Write a run of values, trivially copyable ones in a single bulk write
+     *
+     * @param T  Type of the values
+     * @param p  Pointer to the values
+     * @param n  Number of values
+     */
+    template <typename T> void write(T const *p, std::size_t n);
+
+    /**
+     * Write the buffered bytes out
+     *
+     * @throws std::system_error  In case writing to the file descriptor fails
+     */
+    void flush();
+
+    /**
+     * Return the number of bytes written so far (buffered or not)
+     *
+     * @return the number of bytes written so far
+     */
+    std::size_t written() const noexcept __attribute__((pure));
+
+  protected:
+    template <typename T, typename H> friend struct serial_pointee;
+
+    /**
+     * Write a run of trivially copyable values by a single bulk write
+     *
+     * @param T  Type of the values
+     * @param p  Pointer to the values
+     * @param n  Number of values
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    template <typename T> void write(T const *p, std::size_t n, std::true_type);
+
+    /**
+     * Write a run of values one by one
+     *
+     * @param T  Type of the values
+     * @param p  Pointer to the values
+     * @param n  Number of values
+     * @param <unnamed>  Tag indicating trivial copyability
+     */
+    template <typename T> void write(T const *p, std::size_t n, std::false_type);
+
+    /**
+     * Write the given entry's type tag, and its name upon first use in the stream
+     *
+     * @param registry  Registry the entry belongs to
+     * @param e  Entry to write the tag of
+     * @param name  Name the entry is enrolled under
+     * @param length  Length of the name
+     */
+    void writeType(void const *registry, void const *e, char const *name, std::size_t length);
+
+    /**
+     * Append a run of raw bytes to the given vector
+     *
+     * @param into  Vector to append to
+     * @param p  Pointer to the bytes
+     * @param n  Number of bytes
+     */
+    static void append(std::vector<char> &into, void const *p, std::size_t n);
+
+    /**
+     * Write bytes out to the file descriptor
+     *
+     * @param p  Pointer to the bytes
+     * @param n  Number of bytes
+     * @throws std::system_error  In case writing fails
+     */
+    void drain(void const *p, std::size_t n);
+
+    /**
+     * Vector to append to, or nullptr when writing to a file descriptor
+     *
+     */
+    std::vector<char> *target;
+
+    /**
+     * File descriptor to write to, or -1
+     *
+     */
+    int fd;
+
+    /**
+     * Padding up to the alignment of buffer
+     *
+     */
+    [[no_unique_address]] explicit_padding<padding_to<sizeof(int), alignof(std::vector<char>)>::value> padding;
+
+    /**
+     * Buffered bytes (file descriptors only)
+     *
+     */
+    std::vector<char> buffer;
+
+    /**
+     * Number of bytes written out so far
+     *
+     */
+    std::size_t total;
+
+    /**
+     * Type ids assigned so far, by entry
+     *
+     */
+    std::map<std::pair<void const *, void const *>, std::uint32_t> ids;
+};
+
+
+/**
+ * Streaming reader of values and value_ptr graphs written by a value_writer
+ *
+ * Reads from a file descriptor go through a buffer of capacity bytes, runs
+ * of bytes at least as large bypassing it and being read directly into
+ * their destination. Truncated or malformed input throws serial_error.
+ *
+ */
+class value_reader {
+  public:
+    /**
+     * Size of the buffer used for file descriptors
+     *
+     */
+    static constexpr std::size_t capacity = 64 * 1024;
+
+    /**
+     * Constructor, reading from the given bytes
+     *
+     * @param data  Pointer to the bytes (which must outlive the reader)
+     * @param n  Number of bytes
+     */
+    value_reader(char const *data, std::size_t n) noexcept;
+
+    /**
+     * Constructor, reading from the given vector
+     *
+     * @param source  Vector to read from (which must outlive the reader)
+     */
+    explicit value_reader(std::vector<char> const &source) noexcept;
+
+    /**
+     * Constructor, reading from the given file descriptor
+     *
+     * @param descriptor  File descriptor to read from (not closed by the reader)
+     */
+    explicit value_reader(int descriptor);
+
+    /**
+     * Deleted copy constructor
+     *
+     */
+    value_reader(value_reader const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    value_reader &operator=(value_reader const &) = delete;
+
+    /**
+     * Read a run of raw bytes
+     *
+     * @param p  Pointer to read the bytes into
+     * @param n  Number of bytes
+     * @throws serial_error  In case the input ends prematurely
+     * @throws std::system_error  In case reading from the file descriptor fails
+     */
+    void read(void *p, std::size_t n);
+
+    /**
+     * Read a value (or a value_ptr)
+     *
+     * @param T  Type of the value
+     * @return the value read
+     */
+    template <typename T> T read();
+
+    /**
+     * Read a run of trivially copyable values by a single bulk read
+     *
+     * Other values are constructed from the reader instead, by their loading
+     * constructor.
+     *
+     * @param T  Type of the values
+     * @param p  Pointer to read the values into
+     * @param n  Number of values
+     */
+    template <typename T> void read(T *p, std::size_t n);
+
+    /**
+     * Return the number of bytes read so far
+     *
+     * @return the number of bytes read so far
+     */
+    std::size_t consumed() const noexcept __attribute__((pure));
+
+  protected:
+    template <typename T, typename H> friend struct serial_pointee;
+
+    /**
+     * Type known to the stream, by id
+     *
+     */
+    struct known {
+      void const *registry;
+      void const *entry;
+    };
+
+    /**
+     * Longest type name accepted
+     *
+     */
+    static constexpr std::uint32_t max_name = 4096;
+
+    /**
+     * Read a type tag, and its name upon first use in the stream
+     *
+     * @param F  Callable type, looking a name up in the registry
+     * @param registry  Registry the type is to belong to
+     * @param find  Callable looking a name (and length) up in the registry, returning nullptr if not enrolled
+     * @return the type's entry, or nullptr for a null tag
+     * @throws serial_error  In case the tag is malformed, or the name not enrolled
+     */
+    template <typename F> void const *readType(void const *registry, F find);
+
+    /**
+     * Read a count of elements of the given size, checking it against overflow
+     *
+     * When reading from bytes, the count is also checked against the bytes
+     * left, so that a malformed one is rejected before allocating.
+     *
+     * @param size  Size of an element
+     * @param least  Least number of bytes an element is written as
+     * @return the count read
+     * @throws serial_error  In case the count overflows, or exceeds the bytes left
+     */
+    std::size_t readCount(std::size_t size, std::size_t least);
+
+    /**
+     * Refill the buffer from the file descriptor
+     *
+     * @throws serial_error  In case the input has ended
+     */
+    void refill();
+
+    /**
+     * Start of the bytes available (counted in total once consumed)
+     *
+     */
+    char const *base;
+
+    /**
+     * Next byte to read
+     *
+     */
+    char const *cursor;
+
+    /**
+     * End of the bytes available
+     *
+     */
+    char const *end;
+
+    /**
+     * File descriptor to read from, or -1
+     *
+     */
+    int fd;
+
+    /**
+     * Padding up to the alignment of buffer
+     *
+     */
+    [[no_unique_address]] explicit_padding<padding_to<sizeof(int), alignof(std::vector<char>)>::value> padding;
+
+    /**
+     * Buffered bytes (file descriptors only)
+     *
+     */
+    std::vector<char> buffer;
+
+    /**
+     * Number of bytes read before base
+     *
+     */
+    std::size_t total;
+
+    /**
+     * Types known to the stream, by id
+     *
+     */
+    std::vector<known> types;
+};
+
+
+#include "Serialize.hpp"
+
+#endif /* VALUE_PTR__SERIALIZE_H__ */
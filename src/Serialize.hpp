@@ -0,0 +1,916 @@
+#ifndef VALUE_PTR__SERIALIZE_HPP__
+#define VALUE_PTR__SERIALIZE_HPP__
+
+
+#include "Serialize.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+
+/**
+ * Enroll the given dynamic type under the given name
+ *
+ * Enrolling a type again under the same name has no effect.
+ *
+ * @param T2  Dynamic type to enroll, derived from T, saveable and loadable
+ * @param name  Name to enroll T2 under (must outlive the registry, eg. a string literal)
+ * @throws serial_error  In case the name or type is already enrolled otherwise
+ */
+template <typename T, typename H>
+template <typename T2>
+void serial_types<T, H>::enroll(char const *name) {
+  static_assert(std::is_base_of<T, T2>::value, "enrolled types must derive from the base type");
+  static_assert(is_saveable<T2>::value, "enrolled types must provide a save(value_writer &) const method");
+  static_assert(is_loadable<T2>::value, "enrolled types must provide a value_reader & constructor");
+
+  std::size_t length = std::strlen(name);
+
+  std::lock_guard<std::mutex> guard(lock());
+  entry const *byType = find(typeid(T2));
+  entry const *byName = find(name, length);
+  if (nullptr != byType || nullptr != byName) {
+    if (byType == byName) {
+      return;
+    }
+    throw serial_error(std::string("serial_types: conflicting enrollment of \"") + name + "\"");
+  }
+
+  entries().store(new entry{name, length, &typeid(T2), &saveAs<T2>, &loadAs<T2>, entries().load(std::memory_order_relaxed)}, std::memory_order_release);
+}
+
+/**
+ * Return the entry of the given dynamic type
+ *
+ * @param type  Dynamic type to look for
+ * @return the type's entry, or nullptr if not enrolled
+ */
+template <typename T, typename H>
+typename serial_types<T, H>::entry const *serial_types<T, H>::find(std::type_info const &type) noexcept {
+  for (entry const *e = entries().load(std::memory_order_acquire); nullptr != e; e = e->next) {
+    if (*e->type == type) {
+      return e;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Return the entry enrolled under the given name
+ *
+ * @param name  Name to look for (not necessarily NUL-terminated)
+ * @param length  Length of the name
+ * @return the name's entry, or nullptr if not enrolled
+ */
+template <typename T, typename H>
+typename serial_types<T, H>::entry const *serial_types<T, H>::find(char const *name, std::size_t length) noexcept {
+  for (entry const *e = entries().load(std::memory_order_acquire); nullptr != e; e = e->next) {
+    if (length == e->length && 0 == std::memcmp(name, e->name, length)) {
+      return e;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Save an object of dynamic type T2
+ *
+ * @param T2  Dynamic type of the object
+ * @param p  Pointer to the object
+ * @param out  Writer to save to
+ */
+template <typename T, typename H>
+template <typename T2>
+void serial_types<T, H>::saveAs(T const *p, value_writer &out) {
+  dynamic_cast<T2 const *>(p)->save(out);
+}
+
+/**
+ * Load an object of dynamic type T2, constructed in place by the handler
+ *
+ * @param T2  Dynamic type of the object
+ * @param in  Reader to load from
+ * @return a value_ptr holding the loaded object
+ */
+template <typename T, typename H>
+template <typename T2>
+value_ptr<T, H> serial_types<T, H>::loadAs(value_reader &in) {
+  return value_ptr<T, H>(value_in_place_type<T2>, in);
+}
+
+/**
+ * Return the head of the entry list
+ *
+ * @return the head of the entry list
+ */
+template <typename T, typename H>
+std::atomic<typename serial_types<T, H>::entry const *> &serial_types<T, H>::entries() noexcept {
+  static std::atomic<entry const *> head(nullptr);
+  return head;
+}
+
+/**
+ * Return the lock serializing enrollment
+ *
+ * @return the lock serializing enrollment
+ */
+template <typename T, typename H>
+std::mutex &serial_types<T, H>::lock() noexcept {
+  static std::mutex m;
+  return m;
+}
+
+
+/**
+ * Save the given pointee
+ *
+ * @param out  Writer to save to
+ * @param p  Pointer to the pointee, or nullptr
+ * @throws serial_error  In case the pointee's dynamic type is not enrolled
+ */
+template <typename T, typename H>
+void serial_pointee<T, H>::save(value_writer &out, T const *p) {
+  save(out, p, typename condition<std::is_polymorphic<T>::value>::type());
+}
+
+/**
+ * Load a pointee
+ *
+ * @param in  Reader to load from
+ * @return a value_ptr holding the loaded pointee, or nullptr
+ * @throws serial_error  In case the input is malformed or names an unenrolled type
+ */
+template <typename T, typename H>
+value_ptr<T, H> serial_pointee<T, H>::load(value_reader &in) {
+  return load(in, typename condition<std::is_polymorphic<T>::value>::type());
+}
+
+/**
+ * Save a polymorphic pointee
+ *
+ * @param out  Writer to save to
+ * @param p  Pointer to the pointee, or nullptr
+ * @param <unnamed>  Tag indicating polymorphism
+ */
+template <typename T, typename H>
+void serial_pointee<T, H>::save(value_writer &out, T const *p, std::true_type) {
+  if (nullptr == p) {
+    out.write(static_cast<std::uint32_t>(value_writer::null_tag));
+    return;
+  }
+
+  typename serial_types<T, H>::entry const *e = serial_types<T, H>::find(typeid(*p));
+  if (nullptr == e) {
+    throw serial_error(std::string("serial_pointee: unenrolled dynamic type ") + typeid(*p).name());
+  }
+  out.writeType(&typeid(serial_types<T, H>), e, e->name, e->length);
+  e->save(p, out);
+}
+
+/**
+ * Save a non-polymorphic pointee
+ *
+ * @param out  Writer to save to
+ * @param p  Pointer to the pointee, or nullptr
+ * @param <unnamed>  Tag indicating polymorphism
+ */
+template <typename T, typename H>
+void serial_pointee<T, H>::save(value_writer &out, T const *p, std::false_type) {
+  out.write(static_cast<std::uint8_t>(nullptr != p));
+  if (nullptr != p) {
+    out.write(*p);
+  }
+}
+
+/**
+ * Load a polymorphic pointee
+ *
+ * @param in  Reader to load from
+ * @param <unnamed>  Tag indicating polymorphism
+ * @return a value_ptr holding the loaded pointee, or nullptr
+ */
+template <typename T, typename H>
+value_ptr<T, H> serial_pointee<T, H>::load(value_reader &in, std::true_type) {
+  using entry = typename serial_types<T, H>::entry;
+
+  entry const *(*find)(char const *, std::size_t) noexcept = &serial_types<T, H>::find;
+  entry const *e = static_cast<entry const *>(in.readType(&typeid(serial_types<T, H>), find));
+  if (nullptr == e) {
+    return value_ptr<T, H>();
+  }
+  return e->load(in);
+}
+
+/**
+ * Load a non-polymorphic pointee
+ *
+ * @param in  Reader to load from
+ * @param <unnamed>  Tag indicating polymorphism
+ * @return a value_ptr holding the loaded pointee, or nullptr
+ */
+template <typename T, typename H>
+value_ptr<T, H> serial_pointee<T, H>::load(value_reader &in, std::false_type) {
+  if (0 == in.read<std::uint8_t>()) {
+    return value_ptr<T, H>();
+  }
+  return construct(in, typename condition<is_loadable<T>::value>::type());
+}
+
+/**
+ * Construct a pointee in place by its loading constructor
+ *
+ * @param in  Reader to load from
+ * @param <unnamed>  Tag indicating a loading constructor
+ * @return a value_ptr holding the loaded pointee
+ */
+template <typename T, typename H>
+value_ptr<T, H> serial_pointee<T, H>::construct(value_reader &in, std::true_type) {
+  return value_ptr<T, H>(value_in_place, in);
+}
+
+/**
+ * Construct a trivially copyable pointee in place and read its bytes into it
+ *
+ * @param in  Reader to load from
+ * @param <unnamed>  Tag indicating a loading constructor
+ * @return a value_ptr holding the loaded pointee
+ */
+template <typename T, typename H>
+value_ptr<T, H> serial_pointee<T, H>::construct(value_reader &in, std::false_type) {
+  static_assert(std::is_trivially_copyable<T>::value, "pointees must be trivially copyable or provide a value_reader & constructor");
+
+  value_ptr<T, H> ret(value_in_place);
+  in.read(ret.get(), 1);
+  return ret;
+}
+
+
+/**
+ * Save the given array
+ *
+ * @param out  Writer to save to
+ * @param p  Pointer to the array, or nullptr
+ */
+template <typename T, typename H>
+void serial_pointee<T[], H>::save(value_writer &out, T const *p) {
+  out.write(static_cast<std::uint8_t>(nullptr != p));
+  if (nullptr != p) {
+    std::uint64_t n = abi_type::arraySize(p);
+    out.write(n);
+    out.write(p, n);
+  }
+}
+
+/**
+ * Load an array
+ *
+ * @param in  Reader to load from
+ * @return a value_ptr holding the loaded array, or nullptr
+ * @throws serial_error  In case the input is malformed
+ */
+template <typename T, typename H>
+value_ptr<T[], H> serial_pointee<T[], H>::load(value_reader &in) {
+  if (0 == in.read<std::uint8_t>()) {
+    return value_ptr<T[], H>();
+  }
+  std::size_t n = in.readCount(sizeof(T), serial_value<T>::least_size);
+  return load(in, n, typename condition<std::is_base_of<default_destroy<T[], abi_type>, H>::value>::type());
+}
+
+/**
+ * Load an array into storage allocated through the handler's ABI
+ *
+ * @param in  Reader to load from
+ * @param n  Number of elements
+ * @param <unnamed>  Tag indicating ABI-allocated storage
+ * @return a value_ptr holding the loaded array
+ */
+template <typename T, typename H>
+value_ptr<T[], H> serial_pointee<T[], H>::load(value_reader &in, std::size_t n, std::true_type) {
+  T *p = abi_type::template newArray<T>(n);
+  try {
+    place(in, p, n, typename condition<std::is_trivially_copyable<T>::value>::type());
+  } catch (...) {
+    abi_type::delArray(p);
+    throw;
+  }
+  return value_ptr<T[], H>(p);
+}
+
+/**
+ * Load an array constructed in place by the handler
+ *
+ * @param in  Reader to load from
+ * @param n  Number of elements
+ * @param <unnamed>  Tag indicating ABI-allocated storage
+ * @return a value_ptr holding the loaded array
+ */
+template <typename T, typename H>
+value_ptr<T[], H> serial_pointee<T[], H>::load(value_reader &in, std::size_t n, std::false_type) {
+  return construct(in, n, typename condition<std::is_trivially_copyable<T>::value>::type());
+}
+
+/**
+ * Construct an array of trivially copyable elements in place and read their bytes into it
+ *
+ * @param in  Reader to load from
+ * @param n  Number of elements
+ * @param <unnamed>  Tag indicating trivial copyability
+ * @return a value_ptr holding the loaded array
+ */
+template <typename T, typename H>
+value_ptr<T[], H> serial_pointee<T[], H>::construct(value_reader &in, std::size_t n, std::true_type) {
+  value_ptr<T[], H> ret(value_in_place, n);
+  in.read(ret.get(), n);
+  return ret;
+}
+
+/**
+ * Construct an array in place, each element by its loading constructor
+ *
+ * @param in  Reader to load from
+ * @param n  Number of elements
+ * @param <unnamed>  Tag indicating trivial copyability
+ * @return a value_ptr holding the loaded array
+ */
+template <typename T, typename H>
+value_ptr<T[], H> serial_pointee<T[], H>::construct(value_reader &in, std::size_t n, std::false_type) {
+  static_assert(is_loadable<T>::value, "array elements must be trivially copyable or provide a value_reader & constructor");
+
+  return value_ptr<T[], H>(value_in_place, n, in);
+}
+
+/**
+ * Read elements into uninitialized storage, by a single bulk read
+ *
+ * @param in  Reader to load from
+ * @param p  Storage to read into
+ * @param n  Number of elements
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T, typename H>
+void serial_pointee<T[], H>::place(value_reader &in, T *p, std::size_t n, std::true_type) {
+  in.read(p, n);
+}
+
+/**
+ * Construct elements into uninitialized storage, by their loading constructor
+ *
+ * Should any constructor throw, the already constructed elements are
+ * destroyed before rethrowing.
+ *
+ * @param in  Reader to load from
+ * @param p  Storage to construct into
+ * @param n  Number of elements
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T, typename H>
+void serial_pointee<T[], H>::place(value_reader &in, T *p, std::size_t n, std::false_type) {
+  static_assert(is_loadable<T>::value, "array elements must be trivially copyable or provide a value_reader & constructor");
+
+  std::size_t i = 0;
+  try {
+    for (; i < n; i++) {
+      new (p + i) T(in);
+    }
+  } catch (...) {
+    while (0 < i) {
+      p[--i].~T();
+    }
+    throw;
+  }
+}
+
+
+/**
+ * Save the given array
+ *
+ * @param out  Writer to save to
+ * @param p  Pointer to the array, or nullptr
+ */
+template <typename T, std::size_t N, typename H>
+void serial_pointee<T[N], H>::save(value_writer &out, T const *p) {
+  out.write(static_cast<std::uint8_t>(nullptr != p));
+  if (nullptr != p) {
+    out.write(p, N);
+  }
+}
+
+/**
+ * Load an array
+ *
+ * @param in  Reader to load from
+ * @return a value_ptr holding the loaded array, or nullptr
+ * @throws serial_error  In case the input is malformed
+ */
+template <typename T, std::size_t N, typename H>
+value_ptr<T[N], H> serial_pointee<T[N], H>::load(value_reader &in) {
+  if (0 == in.read<std::uint8_t>()) {
+    return value_ptr<T[N], H>();
+  }
+  return construct(in, typename condition<std::is_trivially_copyable<T>::value>::type());
+}
+
+/**
+ * Construct an array of trivially copyable elements in place and read their bytes into it
+ *
+ * @param in  Reader to load from
+ * @param <unnamed>  Tag indicating trivial copyability
+ * @return a value_ptr holding the loaded array
+ */
+template <typename T, std::size_t N, typename H>
+value_ptr<T[N], H> serial_pointee<T[N], H>::construct(value_reader &in, std::true_type) {
+  value_ptr<T[N], H> ret(value_in_place);
+  in.read(ret.get(), N);
+  return ret;
+}
+
+/**
+ * Construct an array in place, each element by its loading constructor
+ *
+ * @param in  Reader to load from
+ * @param <unnamed>  Tag indicating trivial copyability
+ * @return a value_ptr holding the loaded array
+ */
+template <typename T, std::size_t N, typename H>
+value_ptr<T[N], H> serial_pointee<T[N], H>::construct(value_reader &in, std::false_type) {
+  static_assert(is_loadable<T>::value, "array elements must be trivially copyable or provide a value_reader & constructor");
+
+  return value_ptr<T[N], H>(value_in_place, in);
+}
+
+
+/**
+ * Save the given value
+ *
+ * @param out  Writer to save to
+ * @param value  Value to save
+ */
+template <typename T>
+void serial_value<T>::save(value_writer &out, T const &value) {
+  save(out, value, typename condition<std::is_trivially_copyable<T>::value>::type());
+}
+
+/**
+ * Load a value
+ *
+ * @param in  Reader to load from
+ * @return the loaded value
+ */
+template <typename T>
+T serial_value<T>::load(value_reader &in) {
+  return load(in, typename condition<std::is_trivially_copyable<T>::value>::type());
+}
+
+/**
+ * Save a trivially copyable value
+ *
+ * @param out  Writer to save to
+ * @param value  Value to save
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T>
+void serial_value<T>::save(value_writer &out, T const &value, std::true_type) {
+  out.write(static_cast<void const *>(&value), sizeof(T));
+}
+
+/**
+ * Save a value by its "save" method
+ *
+ * @param out  Writer to save to
+ * @param value  Value to save
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T>
+void serial_value<T>::save(value_writer &out, T const &value, std::false_type) {
+  static_assert(is_saveable<T>::value, "values must be trivially copyable or provide a save(value_writer &) const method");
+
+  value.save(out);
+}
+
+/**
+ * Load a trivially copyable value
+ *
+ * @param in  Reader to load from
+ * @param <unnamed>  Tag indicating trivial copyability
+ * @return the loaded value
+ */
+template <typename T>
+T serial_value<T>::load(value_reader &in, std::true_type) {
+  T ret;
+  in.read(static_cast<void *>(&ret), sizeof(T));
+  return ret;
+}
+
+/**
+ * Load a value by its loading constructor
+ *
+ * @param in  Reader to load from
+ * @param <unnamed>  Tag indicating trivial copyability
+ * @return the loaded value
+ */
+template <typename T>
+T serial_value<T>::load(value_reader &in, std::false_type) {
+  static_assert(is_loadable<T>::value, "values must be trivially copyable or provide a value_reader & constructor");
+
+  return T(in);
+}
+
+/**
+ * Save the given value_ptr's pointee
+ *
+ * @param out  Writer to save to
+ * @param v  value_ptr to save
+ */
+template <typename T, typename H>
+void serial_value<value_ptr<T, H>>::save(value_writer &out, value_ptr<T, H> const &v) {
+  serial_pointee<T, H>::save(out, v.get());
+}
+
+/**
+ * Load a value_ptr's pointee
+ *
+ * @param in  Reader to load from
+ * @return a value_ptr holding the loaded pointee, or nullptr
+ */
+template <typename T, typename H>
+value_ptr<T, H> serial_value<value_ptr<T, H>>::load(value_reader &in) {
+  return serial_pointee<T, H>::load(in);
+}
+
+
+/**
+ * Constructor, appending to the given vector
+ *
+ * @param into  Vector to append to
+ */
+inline value_writer::value_writer(std::vector<char> &into) noexcept : target(&into), fd(-1), padding(), buffer(), total(0), ids() {}
+
+/**
+ * Constructor, writing to the given file descriptor
+ *
+ * @param descriptor  File descriptor to write to (not closed by the writer)
+ */
+inline value_writer::value_writer(int descriptor) : target(nullptr), fd(descriptor), padding(), buffer(), total(0), ids() {
+  buffer.reserve(capacity);
+}
+
+/**
+ * Destructor, flushing the buffer
+ *
+ * Errors are ignored: call flush() beforehand to observe them.
+ *
+ */
+inline value_writer::~value_writer() noexcept {
+  try {
+    flush();
+  } catch (...) {
+  }
+}
+
+/**
+ * Write a run of raw bytes
+ *
+ * @param p  Pointer to the bytes
+ * @param n  Number of bytes
+ * @throws std::system_error  In case writing to the file descriptor fails
+ */
+inline void value_writer::write(void const *p, std::size_t n) {
+  if (nullptr != target) {
+    append(*target, p, n);
+  } else if (n <= capacity - buffer.size()) {
+    append(buffer, p, n);
+  } else {
+    flush();
+    if (n < capacity) {
+      append(buffer, p, n);
+    } else {
+      drain(p, n);
+    }
+  }
+  total += n;
+}
+
+/**
+ * Write a value (or a value_ptr's pointee)
+ *
+ * @param T  Type of the value
+ * @param value  Value to write
+ */
+template <typename T>
+void value_writer::write(T const &value) {
+  serial_value<T>::save(*this, value);
+}
+
+/**
+ * Write a run of values, trivially copyable ones in a single bulk write
+ *
+ * @param T  Type of the values
+ * @param p  Pointer to the values
+ * @param n  Number of values
+ */
+template <typename T>
+void value_writer::write(T const *p, std::size_t n) {
+  write(p, n, typename condition<std::is_trivially_copyable<T>::value>::type());
+}
+
+/**
+ * Write the buffered bytes out
+ *
+ * @throws std::system_error  In case writing to the file descriptor fails
+ */
+inline void value_writer::flush() {
+  if (!buffer.empty()) {
+    drain(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+}
+
+/**
+ * Return the number of bytes written so far (buffered or not)
+ *
+ * @return the number of bytes written so far
+ */
+inline std::size_t value_writer::written() const noexcept {
+  return total;
+}
+
+/**
+ * Write a run of trivially copyable values by a single bulk write
+ *
+ * @param T  Type of the values
+ * @param p  Pointer to the values
+ * @param n  Number of values
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T>
+void value_writer::write(T const *p, std::size_t n, std::true_type) {
+  write(static_cast<void const *>(p), n * sizeof(T));
+}
+
+/**
+ * Write a run of values one by one
+ *
+ * @param T  Type of the values
+ * @param p  Pointer to the values
+ * @param n  Number of values
+ * @param <unnamed>  Tag indicating trivial copyability
+ */
+template <typename T>
+void value_writer::write(T const *p, std::size_t n, std::false_type) {
+  for (std::size_t i = 0; i < n; i++) {
+    write(p[i]);
+  }
+}
+
+/**
+ * Append a run of raw bytes to the given vector
+ *
+ * @param into  Vector to append to
+ * @param p  Pointer to the bytes
+ * @param n  Number of bytes
+ */
+inline void value_writer::append(std::vector<char> &into, void const *p, std::size_t n) {
+  std::size_t at = into.size();
+  into.resize(at + n);
+  std::memcpy(into.data() + at, p, n);
+}
+
+/**
+ * Write the given entry's type tag, and its name upon first use in the stream
+ *
+ * @param registry  Registry the entry belongs to
+ * @param e  Entry to write the tag of
+ * @param name  Name the entry is enrolled under
+ * @param length  Length of the name
+ */
+inline void value_writer::writeType(void const *registry, void const *e, char const *name, std::size_t length) {
+  std::pair<std::map<std::pair<void const *, void const *>, std::uint32_t>::iterator, bool> id = ids.emplace(std::make_pair(registry, e), static_cast<std::uint32_t>(first_id + ids.size()));
+  if (!id.second) {
+    write(id.first->second);
+    return;
+  }
+  write(static_cast<std::uint32_t>(new_tag));
+  write(static_cast<std::uint32_t>(length));
+  write(static_cast<void const *>(name), length);
+}
+
+/**
+ * Write bytes out to the file descriptor
+ *
+ * @param p  Pointer to the bytes
+ * @param n  Number of bytes
+ * @throws std::system_error  In case writing fails
+ */
+inline void value_writer::drain(void const *p, std::size_t n) {
+  char const *bytes = static_cast<char const *>(p);
+  while (0 < n) {
+    ssize_t done = ::write(fd, bytes, n);
+    if (done < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "value_writer");
+    }
+    bytes += done;
+    n -= static_cast<std::size_t>(done);
+  }
+}
+
+
+/**
+ * Constructor, reading from the given bytes
+ *
+ * @param data  Pointer to the bytes (which must outlive the reader)
+ * @param n  Number of bytes
+ */
+inline value_reader::value_reader(char const *data, std::size_t n) noexcept : base(data), cursor(data), end(data + n), fd(-1), padding(), buffer(), total(0), types() {}
+
+/**
+ * Constructor, reading from the given vector
+ *
+ * @param source  Vector to read from (which must outlive the reader)
+ */
+inline value_reader::value_reader(std::vector<char> const &source) noexcept : value_reader(source.data(), source.size()) {}
+
+/**
+ * Constructor, reading from the given file descriptor
+ *
+ * @param descriptor  File descriptor to read from (not closed by the reader)
+ */
+inline value_reader::value_reader(int descriptor) : base(nullptr), cursor(nullptr), end(nullptr), fd(descriptor), padding(), buffer(capacity), total(0), types() {
+  base = cursor = end = buffer.data();
+}
+
+/**
+ * Read a run of raw bytes
+ *
+ * @param p  Pointer to read the bytes into
+ * @param n  Number of bytes
+ * @throws serial_error  In case the input ends prematurely
+ * @throws std::system_error  In case reading from the file descriptor fails
+ */
+inline void value_reader::read(void *p, std::size_t n) {
+  char *bytes = static_cast<char *>(p);
+  for (;;) {
+    std::size_t available = std::min(n, static_cast<std::size_t>(end - cursor));
+    std::memcpy(bytes, cursor, available);
+    cursor += available;
+    bytes += available;
+    n -= available;
+    if (0 == n) {
+      return;
+    }
+
+    if (fd < 0) {
+      throw serial_error("value_reader: truncated input");
+    }
+    if (n < capacity) {
+      refill();
+      continue;
+    }
+
+    total += static_cast<std::size_t>(end - base);
+    cursor = end = base;
+    while (0 < n) {
+      ssize_t done = ::read(fd, bytes, n);
+      if (done < 0) {
+        if (EINTR == errno) {
+          continue;
+        }
+        throw std::system_error(errno, std::generic_category(), "value_reader");
+      } else if (0 == done) {
+        throw serial_error("value_reader: truncated input");
+      }
+      bytes += done;
+      n -= static_cast<std::size_t>(done);
+      total += static_cast<std::size_t>(done);
+    }
+    return;
+  }
+}
+
+/**
+ * Read a value (or a value_ptr)
+ *
+ * @param T  Type of the value
+ * @return the value read
+ */
+template <typename T>
+T value_reader::read() {
+  return serial_value<T>::load(*this);
+}
+
+/**
+ * Read a run of trivially copyable values by a single bulk read
+ *
+ * Other values are constructed from the reader instead, by their loading
+ * constructor.
+ *
+ * @param T  Type of the values
+ * @param p  Pointer to read the values into
+ * @param n  Number of values
+ */
+template <typename T>
+void value_reader::read(T *p, std::size_t n) {
+  static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be read in bulk");
+
+  read(static_cast<void *>(p), n * sizeof(T));
+}
+
+/**
+ * Return the number of bytes read so far
+ *
+ * @return the number of bytes read so far
+ */
+inline std::size_t value_reader::consumed() const noexcept {
+  return total + static_cast<std::size_t>(cursor - base);
+}
+
+/**
+ * Read a type tag, and its name upon first use in the stream
+ *
+ * @param F  Callable type, looking a name up in the registry
+ * @param registry  Registry the type is to belong to
+ * @param find  Callable looking a name (and length) up in the registry, returning nullptr if not enrolled
+ * @return the type's entry, or nullptr for a null tag
+ * @throws serial_error  In case the tag is malformed, or the name not enrolled
+ */
+template <typename F>
+void const *value_reader::readType(void const *registry, F find) {
+  std::uint32_t tag = read<std::uint32_t>();
+  if (value_writer::null_tag == tag) {
+    return nullptr;
+  }
+
+  if (value_writer::new_tag == tag) {
+    std::uint32_t length = read<std::uint32_t>();
+    if (length > max_name) {
+      throw serial_error("value_reader: malformed type name");
+    }
+    std::string name(length, '\0');
+    read(static_cast<void *>(&name[0]), name.size());
+    void const *e = find(name.data(), name.size());
+    if (nullptr == e) {
+      throw serial_error("value_reader: unenrolled type \"" + name + "\"");
+    }
+    types.push_back(known{registry, e});
+    return e;
+  }
+
+  std::size_t id = tag - value_writer::first_id;
+  if (types.size() <= id || registry != types[id].registry) {
+    throw serial_error("value_reader: malformed type tag");
+  }
+  return types[id].entry;
+}
+
+/**
+ * Read a count of elements of the given size, checking it against overflow
+ *
+ * When reading from bytes, the count is also checked against the bytes
+ * left, so that a malformed one is rejected before allocating.
+ *
+ * @param size  Size of an element
+ * @param least  Least number of bytes an element is written as
+ * @return the count read
+ * @throws serial_error  In case the count overflows, or exceeds the bytes left
+ */
+inline std::size_t value_reader::readCount(std::size_t size, std::size_t least) {
+  std::uint64_t n = read<std::uint64_t>();
+  if (n > std::numeric_limits<std::size_t>::max() / size || (fd < 0 && 0 < least && n > static_cast<std::size_t>(end - cursor) / least)) {
+    throw serial_error("value_reader: malformed count");
+  }
+  return n;
+}
+
+/**
+ * Refill the buffer from the file descriptor
+ *
+ * @throws serial_error  In case the input has ended
+ */
+inline void value_reader::refill() {
+  total += static_cast<std::size_t>(end - base);
+  cursor = end = base;
+  for (;;) {
+    ssize_t done = ::read(fd, buffer.data(), buffer.size());
+    if (done < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "value_reader");
+    } else if (0 == done) {
+      throw serial_error("value_reader: truncated input");
+    }
+    end = base + done;
+    return;
+  }
+}
+
+#endif /* VALUE_PTR__SERIALIZE_HPP__ */
@@ -0,0 +1,236 @@
+#ifndef VALUE_PTR__THREAD_CACHE_H__
+#define VALUE_PTR__THREAD_CACHE_H__
+
+
+#include <cstddef>
+#include <atomic>
+
+#include "Pool.h"
+
+
+/**
+ * Per-thread memory cache with remote-free support
+ *
+ * Each thread lazily gets its own cache, backed by a private slab_pool and
+ * thus served without synchronization. Every block is prefixed by a header
+ * naming its owning cache: blocks freed by their owning thread go straight
+ * back to its pool, while blocks freed by any other thread are pushed onto
+ * the owner's lock-free remote-free list, drained by the owner upon its next
+ * allocation or trim.
+ *
+ * Caches are reference counted by their owning thread and their live
+ * blocks: a cache whose thread has exited survives until its last block is
+ * freed, by whichever thread that happens on.
+ *
+ */
+class thread_cache {
+  friend class thread_cache_resource;
+
+  public:
+    /**
+     * Deleted copy constructor
+     *
+     */
+    thread_cache(thread_cache const &) = delete;
+
+    /**
+     * Deleted copy-assignment operator
+     *
+     */
+    thread_cache &operator=(thread_cache const &) = delete;
+
+    /**
+     * Return the calling thread's cache, creating it if needed
+     *
+     * @return the calling thread's cache
+     */
+    static thread_cache &local();
+
+    /**
+     * Allocate a block from this cache
+     *
+     * Must only be called by the owning thread.
+     *
+     * @param bytes  Number of bytes requested
+     * @param alignment  Alignment requested
+     * @return a pointer to the allocated block
+     * @throws std::bad_alloc  In case the alignment exceeds slab_pool::granularity, or the underlying operation throws
+     */
+    void *allocate(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * Return a block obtained from any cache's allocate
+     *
+     * May be called from any thread.
+     *
+     * @param p  Pointer to the block
+     */
+    static void deallocate(void *p) noexcept;
+
+    /**
+     * Drain the remote-free list and return idle slabs to the global heap
+     *
+     * Must only be called by the owning thread.
+     *
+     * @return the number of bytes released
+     */
+    std::size_t trim() noexcept;
+
+    /**
+     * Return the number of bytes held in slabs
+     *
+     * @return the number of bytes held in slabs
+     */
+    std::size_t capacity() const noexcept __attribute__((pure));
+
+    /**
+     * Return the number of bytes currently handed out, including headers and blocks pending in the remote-free list
+     *
+     * @return the number of bytes currently handed out
+     */
+    std::size_t in_use() const noexcept __attribute__((pure));
+
+    /**
+     * Return the largest number of bytes ever handed out at once
+     *
+     * @return the high-water mark of in_use()
+     */
+    std::size_t high_water() const noexcept __attribute__((pure));
+
+  protected:
+    /**
+     * Block header
+     *
+     * While allocated, a block names its owning cache; while pending in the
+     * owner's remote-free list, it links to the next pending block instead.
+     *
+     */
+    struct alignas(slab_pool::granularity) header {
+      union {
+        thread_cache *owner;
+        header *next;
+      };
+      std::size_t bytes;
+    };
+
+    /**
+     * Thread-local holder of a thread's cache reference
+     *
+     * Trims the cache and drops the thread's reference upon thread exit.
+     *
+     */
+    struct holder {
+      thread_cache *cache;
+      ~holder() noexcept;
+    };
+
+    /**
+     * Constructor
+     *
+     * The new cache starts with a single reference, its owning thread's.
+     *
+     */
+    thread_cache() noexcept;
+
+    /**
+     * Destructor
+     *
+     */
+    ~thread_cache() noexcept = default;
+
+    /**
+     * Return the calling thread's holder
+     *
+     * @return the calling thread's holder
+     */
+    static holder &current() noexcept;
+
+    /**
+     * Return every block pending in the remote-free list to the pool
+     *
+     */
+    void drain() noexcept;
+
+    /**
+     * Drop a reference, deleting the cache if it was the last one
+     *
+     */
+    void unref() noexcept;
+
+    /**
+     * Backing pool, only ever touched by the owning thread (or by the last reference's holder)
+     *
+     */
+    slab_pool pool;
+
+    /**
+     * Head of the remote-free list
+     *
+     */
+    std::atomic<header *> remote;
+
+    /**
+     * Number of live blocks, plus one while the owning thread is alive
+     *
+     */
+    std::atomic<std::size_t> refs;
+};
+
+
+/**
+ * Memory resource facade allocating from the calling thread's cache
+ *
+ * The resource is stateless: allocations are served by whichever thread
+ * performs them, and deallocations are routed to the owning cache.
+ *
+ */
+class thread_cache_resource {
+  public:
+    /**
+     * Return the process-wide facade
+     *
+     * @return the process-wide facade
+     */
+    static thread_cache_resource &instance() noexcept __attribute__((const));
+
+    /**
+     * Allocate a block from the calling thread's cache
+     *
+     * @param bytes  Number of bytes requested
+     * @param alignment  Alignment requested
+     * @return a pointer to the allocated block
+     * @throws std::bad_alloc  In case the alignment exceeds slab_pool::granularity, or the underlying operation throws
+     */
+    void *allocate(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * Return a block to its owning cache
+     *
+     * @param p  Pointer to the block
+     * @param <unnamed>  Number of bytes requested upon allocation
+     * @param <unnamed>  Alignment requested upon allocation
+     */
+    void deallocate(void *p, std::size_t, std::size_t) noexcept;
+
+    /**
+     * Trim the calling thread's cache
+     *
+     * @return the number of bytes released
+     */
+    static std::size_t trim() noexcept;
+};
+
+
+/**
+ * Handler allocating pointees from per-thread caches
+ *
+ * @param T  Underlying type this class handles
+ * @param ABI  ABI adapter class to use (Itanium by default)
+ */
+template <typename T, typename ABI = Itanium>
+using thread_cached_handler = resource_handler<T, thread_cache_resource, ABI>;
+
+
+#include "ThreadCache.hpp"
+
+#endif /* VALUE_PTR__THREAD_CACHE_H__ */
@@ -0,0 +1,212 @@
+#ifndef VALUE_PTR__THREAD_CACHE_HPP__
+#define VALUE_PTR__THREAD_CACHE_HPP__
+
+
+#include "ThreadCache.h"
+
+
+/**
+ * Return the calling thread's cache, creating it if needed
+ *
+ * @return the calling thread's cache
+ */
+inline thread_cache &thread_cache::local() {
+  holder &h = current();
+  if (nullptr == h.cache) {
+    h.cache = new thread_cache();
+  }
+
+  return *h.cache;
+}
+
+/**
+ * Allocate a block from this cache
+ *
+ * Must only be called by the owning thread.
+ *
+ * @param bytes  Number of bytes requested
+ * @param alignment  Alignment requested
+ * @return a pointer to the allocated block
+ * @throws std::bad_alloc  In case the alignment exceeds slab_pool::granularity, or the underlying operation throws
+ */
+inline void *thread_cache::allocate(std::size_t bytes, std::size_t alignment) {
+  if (nullptr != remote.load(std::memory_order_relaxed)) {
+    drain();
+  }
+
+  header *h = static_cast<header *>(pool.allocate(sizeof(header) + bytes, alignment));
+  h->owner = this;
+  h->bytes = bytes;
+  refs.fetch_add(1, std::memory_order_relaxed);
+
+  return h + 1;
+}
+
+/**
+ * Return a block obtained from any cache's allocate
+ *
+ * May be called from any thread.
+ *
+ * @param p  Pointer to the block
+ */
+inline void thread_cache::deallocate(void *p) noexcept {
+  header *h = static_cast<header *>(p) - 1;
+  thread_cache *owner = h->owner;
+
+  if (owner == current().cache) {
+    owner->pool.deallocate(h, sizeof(header) + h->bytes, alignof(header));
+    owner->refs.fetch_sub(1, std::memory_order_relaxed);
+    return;
+  }
+
+  header *head = owner->remote.load(std::memory_order_relaxed);
+  do {
+    h->next = head;
+  } while (!owner->remote.compare_exchange_weak(head, h, std::memory_order_release, std::memory_order_relaxed));
+  owner->unref();
+}
+
+/**
+ * Drain the remote-free list and return idle slabs to the global heap
+ *
+ * Must only be called by the owning thread.
+ *
+ * @return the number of bytes released
+ */
+inline std::size_t thread_cache::trim() noexcept {
+  drain();
+  return pool.release();
+}
+
+/**
+ * Return the number of bytes held in slabs
+ *
+ * @return the number of bytes held in slabs
+ */
+inline std::size_t thread_cache::capacity() const noexcept {
+  return pool.capacity();
+}
+
+/**
+ * Return the number of bytes currently handed out, including headers and blocks pending in the remote-free list
+ *
+ * @return the number of bytes currently handed out
+ */
+inline std::size_t thread_cache::in_use() const noexcept {
+  return pool.in_use();
+}
+
+/**
+ * Return the largest number of bytes ever handed out at once
+ *
+ * @return the high-water mark of in_use()
+ */
+inline std::size_t thread_cache::high_water() const noexcept {
+  return pool.high_water();
+}
+
+/**
+ * Destructor
+ *
+ * Trims the cache and drops the thread's reference upon thread exit.
+ *
+ */
+inline thread_cache::holder::~holder() noexcept {
+  if (nullptr != cache) {
+    cache->trim();
+    cache->unref();
+    cache = nullptr;
+  }
+}
+
+/**
+ * Constructor
+ *
+ * The new cache starts with a single reference, its owning thread's.
+ *
+ */
+inline thread_cache::thread_cache() noexcept : pool(), remote(nullptr), refs(1) {}
+
+/**
+ * Return the calling thread's holder
+ *
+ * @return the calling thread's holder
+ */
+inline thread_cache::holder &thread_cache::current() noexcept {
+  static thread_local holder h = { nullptr };
+  return h;
+}
+
+/**
+ * Return every block pending in the remote-free list to the pool
+ *
+ */
+inline void thread_cache::drain() noexcept {
+  header *h = remote.exchange(nullptr, std::memory_order_acquire);
+  while (nullptr != h) {
+    header *next = h->next;
+    pool.deallocate(h, sizeof(header) + h->bytes, alignof(header));
+    h = next;
+  }
+}
+
+/**
+ * Drop a reference, deleting the cache if it was the last one
+ *
+ * Blocks still pending in the remote-free list are returned to the pool
+ * before deletion, so that those the pool forwarded to the global heap are
+ * not leaked.
+ *
+ */
+inline void thread_cache::unref() noexcept {
+  if (1 == refs.fetch_sub(1, std::memory_order_acq_rel)) {
+    drain();
+    delete this;
+  }
+}
+
+
+/**
+ * Return the process-wide facade
+ *
+ * @return the process-wide facade
+ */
+inline thread_cache_resource &thread_cache_resource::instance() noexcept {
+  static thread_cache_resource resource;
+  return resource;
+}
+
+/**
+ * Allocate a block from the calling thread's cache
+ *
+ * @param bytes  Number of bytes requested
+ * @param alignment  Alignment requested
+ * @return a pointer to the allocated block
+ * @throws std::bad_alloc  In case the alignment exceeds slab_pool::granularity, or the underlying operation throws
+ */
+inline void *thread_cache_resource::allocate(std::size_t bytes, std::size_t alignment) {
+  return thread_cache::local().allocate(bytes, alignment);
+}
+
+/**
+ * Return a block to its owning cache
+ *
+ * @param p  Pointer to the block
+ * @param <unnamed>  Number of bytes requested upon allocation
+ * @param <unnamed>  Alignment requested upon allocation
+ */
+inline void thread_cache_resource::deallocate(void *p, std::size_t, std::size_t) noexcept {
+  thread_cache::deallocate(p);
+}
+
+/**
+ * Trim the calling thread's cache
+ *
+ * @return the number of bytes released
+ */
+inline std::size_t thread_cache_resource::trim() noexcept {
+  thread_cache::holder &h = thread_cache::current();
+  return nullptr != h.cache ? h.cache->trim() : 0;
+}
+
+#endif /* VALUE_PTR__THREAD_CACHE_HPP__ */
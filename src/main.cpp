@@ -1,6 +1,36 @@
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <typeinfo>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <new>
+
+#include <unistd.h>
 
 #include "value_ptr.h"
+#include "Pool.h"
+#include "ThreadCache.h"
+#include "Parallel.h"
+#include "Counting.h"
+#include "Deferred.h"
+#include "Erased.h"
+#include "Pmr.h"
+#include "Collection.h"
+#include "Arena.h"
+#include "Compare.h"
+#include "Atomic.h"
+#include "Rcu.h"
+#include "Serialize.h"
 
 // =========================================================================================================================================
 // == TESTS ================================================================================================================================
@@ -27,6 +57,29 @@ static void log_down() {
 
 // =========================================================================================================================================
 
+std::size_t allocations = 0;
+std::size_t deallocations = 0;
+bool exhausted = false;
+
+__attribute__((noinline)) void *operator new(std::size_t n) {
+  allocations++;
+  if (exhausted) {
+    throw std::bad_alloc();
+  }
+  if (void *p = std::malloc(n ? n : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void *operator new[](std::size_t n) { return operator new(n); }
+
+__attribute__((noinline)) void operator delete(void *p) noexcept { deallocations++; std::free(p); }
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { deallocations++; std::free(p); }
+__attribute__((noinline)) void operator delete[](void *p) noexcept { deallocations++; std::free(p); }
+__attribute__((noinline)) void operator delete[](void *p, std::size_t) noexcept { deallocations++; std::free(p); }
+
+// =========================================================================================================================================
+
 static bool test_fundamental() {
   value_ptr<int> vi1 = new int(1);
   value_ptr<int> vi2 = new int(2);
@@ -144,6 +197,1406 @@ static bool test_base_array() {
   return true;
 }
 
+static bool test_copy_assign_allocations() {
+  value_ptr<int> vi1 = new int(1);
+  value_ptr<int> vi2 = new int(2);
+
+  log_up("value_ptr<Base> vb1 = new Derived()"); value_ptr<Base> vb1 = new Derived(); log_down();
+  log_up("value_ptr<Base> vb2 = new Derived()"); value_ptr<Base> vb2 = new Derived(); log_down();
+  log_up("value_ptr<Base> vb3 = new Base()"); value_ptr<Base> vb3 = new Base(); log_down();
+
+  log_up("value_ptr<Base[]> va1 = new Derived[5]()"); value_ptr<Base[]> va1 = new Derived[5](); log_down();
+  log_up("value_ptr<Base[]> va2 = new Derived[5]()"); value_ptr<Base[]> va2 = new Derived[5](); log_down();
+  log_up("value_ptr<Base[]> va3 = new Derived[3]()"); value_ptr<Base[]> va3 = new Derived[3](); log_down();
+
+  bool ok = true;
+  std::size_t before;
+
+  before = allocations; vi1 = vi2;
+  ok = ok && allocations == before && 2 == *vi1 && vi1.get() != vi2.get();
+
+  log_up("vb1 = vb2"); before = allocations; vb1 = vb2; log_down();
+  ok = ok && allocations == before && vb1.get() != vb2.get();
+
+  log_up("vb3 = vb1"); before = allocations; vb3 = vb1; log_down();
+  ok = ok && allocations == before + 1 && typeid(*vb3) == typeid(Derived);
+
+  log_up("va1 = va2"); before = allocations; va1 = va2; log_down();
+  ok = ok && allocations == before && va1.get() != va2.get();
+
+  log_up("va3 = va1"); before = allocations; va3 = va1; log_down();
+  ok = ok && allocations == before + 1;
+
+  log(ok ? "allocation counts OK" : "allocation counts FAILED");
+
+  return ok;
+}
+
+struct Counted {
+  Counted() noexcept : value(0) {}
+  Counted(Counted const &other) noexcept : value(other.value + 1) {}
+  Counted &operator=(Counted const &other) noexcept { value = other.value + 1; return *this; }
+  ~Counted() noexcept {}
+
+  int value;
+};
+
+static bool test_bulk_copy() {
+  static_assert(std::is_trivially_copyable<double>::value, "double not trivially copyable");
+  static_assert(!std::is_trivially_copyable<Counted>::value && std::is_nothrow_copy_constructible<Counted>::value, "Counted not a nothrow non-trivial type");
+
+  bool ok = true;
+  std::size_t before;
+
+  value_ptr<double[64]> vd1 = new double[64]();
+  for (std::size_t i = 0; i < 64; i++) {
+    vd1.mutable_get()[i] = static_cast<double>(i) / 2;
+  }
+
+  value_ptr<double[64]> vd2 = vd1;
+  ok = ok && vd1.get() != vd2.get() && 0 == std::memcmp(vd1.get(), vd2.get(), sizeof(double[64]));
+
+  vd1.mutable_get()[7] = -1;
+  before = allocations; vd2 = vd1;
+  ok = ok && allocations == before && vd2[7] < 0 && 0 == std::memcmp(vd1.get(), vd2.get(), sizeof(double[64]));
+
+  value_ptr<Counted[]> vc1 = new Counted[8]();
+  value_ptr<Counted[]> vc2 = vc1;
+  ok = ok && 8 == Itanium::arraySize(vc2.get()) && 1 == vc2[0].value && 1 == vc2[7].value;
+
+  before = allocations; vc1 = vc2;
+  ok = ok && allocations == before && 2 == vc1[0].value && 2 == vc1[7].value;
+
+  log(ok ? "bulk copy OK" : "bulk copy FAILED");
+
+  return ok;
+}
+
+struct alignas(128) Lane {
+  float v[8];
+  char padding[128 - 8 * sizeof(float)];
+};
+
+static bool test_aligned() {
+  using va_type = value_ptr<Lane[], default_handler<Lane[], Aligned<>>>;
+  using vc_type = value_ptr<Counted[], default_handler<Counted[], Aligned<64, 64, true>>>;
+
+  bool ok = true;
+
+  Lane *l = Aligned<>::newArray<Lane>(3);
+  for (std::size_t i = 0; i < 3; i++) {
+    new (l + i) Lane();
+  }
+  va_type va1 = l;
+  va_type va2 = va1;
+  ok = ok && 3 == Aligned<>::arraySize(va2.get()) && 0 == reinterpret_cast<std::uintptr_t>(va2.get()) % 128;
+
+  unsigned char const *tail = reinterpret_cast<unsigned char const *>(va2.get() + 3);
+  ok = ok && std::all_of(tail, tail + 64, [](unsigned char c) { return 0 == c; });
+
+  Counted *c = Aligned<64, 64, true>::newArray<Counted>(5);
+  for (std::size_t i = 0; i < 5; i++) {
+    new (c + i) Counted();
+  }
+  vc_type vc1 = c;
+  vc_type vc2 = vc1;
+  ok = ok && 5 == Aligned<64, 64, true>::arraySize(vc2.get()) && 0 == reinterpret_cast<std::uintptr_t>(vc2.get()) % 64 && 1 == vc2[4].value;
+
+  vc1 = vc2;
+  ok = ok && 2 == vc1[4].value;
+
+  log(ok ? "aligned arrays OK" : "aligned arrays FAILED");
+
+  return ok;
+}
+
+static bool test_described() {
+  using vd_type = value_ptr<double[], default_handler<double[], Described<>>>;
+  using vu_type = value_ptr<std::uint8_t[], default_handler<std::uint8_t[], Described<true>>>;
+
+  bool ok = true;
+  std::size_t before;
+
+  double *d = Described<>::newArray<double>(7);
+  for (std::size_t i = 0; i < 7; i++) {
+    d[i] = static_cast<double>(i);
+  }
+  vd_type vd1 = d;
+  vd_type vd2 = vd1;
+  ok = ok && 7 == Described<>::arraySize(vd2.get()) && 0 == std::memcmp(vd1.get(), vd2.get(), 7 * sizeof(double));
+
+  vd2.mutable_get()[6] = -1;
+  before = allocations; vd1 = vd2;
+  ok = ok && allocations == before && vd1[6] < 0;
+
+  std::uint8_t *u = Described<true>::reserveArray<std::uint8_t>(3, 16);
+  std::memset(u, 0xa5, 3);
+  vu_type vu1 = u;
+  vu_type vu2 = vu1;
+  ok = ok && 16 == Described<true>::arrayCapacity(vu1.get()) && 3 == Described<true>::arraySize(vu2.get()) && 3 == Described<true>::arrayCapacity(vu2.get()) && 0xa5 == vu2[2];
+
+  log(ok ? "self-described arrays OK" : "self-described arrays FAILED");
+
+  return ok;
+}
+
+struct Fragile {
+  static std::atomic<int> live;
+
+  Fragile() noexcept : value(0) { live++; }
+  Fragile(Fragile const &other) : value(other.value + 1) { if (other.value < 0) { throw std::runtime_error("fragile"); } live++; }
+  Fragile &operator=(Fragile const &other) { value = other.value + 1; return *this; }
+  ~Fragile() noexcept { live--; }
+
+  int value;
+};
+
+std::atomic<int> Fragile::live(0);
+
+struct Stubborn {
+  explicit Stubborn(int v) noexcept : value(v) {}
+  Stubborn(Stubborn const &other) noexcept : value(other.value) {}
+  Stubborn &operator=(Stubborn const &) { throw std::runtime_error("stubborn"); }
+  ~Stubborn() noexcept {}
+
+  int value;
+};
+
+class Pooled {
+  public:
+    static std::size_t freed;
+    static bool failing;
+
+    Pooled() noexcept {}
+    Pooled(Pooled const &) { if (failing) { throw std::runtime_error("pooled"); } }
+    virtual ~Pooled() noexcept = default;
+
+    virtual Pooled *clone(void *p = nullptr) const { return nullptr == p ? new Pooled(*this) : ::new(p) Pooled(*this); }
+
+    static void *operator new(std::size_t n) { return ::operator new(n); }
+    static void operator delete(void *p) noexcept { freed++; ::operator delete(p); }
+};
+
+std::size_t Pooled::freed = 0;
+bool Pooled::failing = false;
+
+static bool test_copy_assign_exceptions() {
+  bool ok = true;
+
+  {
+    value_ptr<Stubborn> vs1 = make_value<Stubborn>(1);
+    value_ptr<Stubborn> vs2 = make_value<Stubborn>(2);
+
+    log_up("vs1 = vs2 (throwing copy-assignment)"); vs1 = vs2; log_down();
+    ok = ok && nullptr != vs1 && 2 == vs1->value && vs1.get() != vs2.get();
+
+    value_ptr<Stubborn[]> va1 = new Stubborn[2]{ Stubborn(1), Stubborn(2) }, va2 = new Stubborn[2]{ Stubborn(3), Stubborn(4) };
+    log_up("va1 = va2 (throwing element copy-assignment)"); va1 = va2; log_down();
+    ok = ok && nullptr != va1 && 3 == va1[0].value && 4 == va1[1].value && va1.get() != va2.get();
+
+    value_ptr<Stubborn[2]> vn1 = new Stubborn[2]{ Stubborn(1), Stubborn(2) }, vn2 = new Stubborn[2]{ Stubborn(3), Stubborn(4) };
+    log_up("vn1 = vn2 (throwing element copy-assignment)"); vn1 = vn2; log_down();
+    ok = ok && nullptr != vn1 && 3 == vn1[0].value && 4 == vn1[1].value && vn1.get() != vn2.get();
+  }
+
+  {
+    value_ptr<Pooled> vp1 = new Pooled();
+    value_ptr<Pooled> vp2 = new Pooled();
+    std::size_t before = Pooled::freed;
+
+    bool thrown = false;
+    Pooled::failing = true;
+    log_up("vp1 = vp2 (throwing placement clone)");
+    try { vp1 = vp2; } catch (std::runtime_error const &) { thrown = true; }
+    log_down();
+    Pooled::failing = false;
+    ok = ok && thrown && nullptr == vp1 && before + 1 == Pooled::freed;
+  }
+
+  log(ok ? "assignment exception safety OK" : "assignment exception safety FAILED");
+
+  return ok;
+}
+
+struct Tallied {
+  static std::size_t destroyed;
+
+  ~Tallied() noexcept { destroyed++; }
+};
+
+std::size_t Tallied::destroyed = 0;
+
+struct Crumbly {
+  static std::size_t destroyed;
+
+  Crumbly() noexcept : fragile(false) {}
+  ~Crumbly() noexcept(false) { destroyed++; if (fragile) { throw std::runtime_error("crumbly"); } }
+
+  bool fragile;
+};
+
+std::size_t Crumbly::destroyed = 0;
+
+static bool test_array_destroy() {
+  static_assert(std::is_trivially_destructible<int>::value, "int not trivially destructible");
+  static_assert(!std::is_trivially_destructible<Tallied>::value && std::is_nothrow_destructible<Tallied>::value, "Tallied not a nothrow non-trivial type");
+  static_assert(!std::is_nothrow_destructible<Crumbly>::value, "Crumbly not a throwing type");
+
+  bool ok = true;
+  std::size_t before;
+
+  int *pi = new int[4]();
+  log_up("array_destroy<int>::destroy(new int[4](), 4)"); before = deallocations; array_destroy<int, Itanium>::destroy(pi, 4); log_down();
+  ok = ok && deallocations == before + 1;
+
+  Tallied *pt = new Tallied[4]();
+  log_up("array_destroy<Tallied>::destroy(new Tallied[4](), 4)"); before = deallocations; array_destroy<Tallied, Itanium>::destroy(pt, 4); log_down();
+  ok = ok && deallocations == before + 1 && 4 == Tallied::destroyed;
+
+  Crumbly *pb = new Crumbly[4]();
+  pb[2].fragile = true;
+  bool freed = false;
+  log_up("array_destroy<Crumbly>::destroy(new Crumbly[4](), 4) (throwing destructor)"); before = deallocations;
+  try { array_destroy<Crumbly, Itanium>::destroy(pb, 4); } catch (std::runtime_error const &) { freed = deallocations == before + 1; }
+  log_down();
+  ok = ok && freed && 4 == Crumbly::destroyed;
+
+  log(ok ? "array destruction OK" : "array destruction FAILED");
+
+  return ok;
+}
+
+static bool test_parallel() {
+  using vf_type = value_ptr<Fragile[], parallel_handler<Fragile[], 1024>>;
+  using vd_type = value_ptr<double[4096], parallel_handler<double[4096], 1024>>;
+
+  bool ok = true;
+
+  vf_type vf1(new Fragile[10000](), parallel_handler<Fragile[], 1024>(4));
+  vf_type vf2 = vf1;
+  ok = ok && 4 == vf2.get_handler().concurrency() && 10000 == Itanium::arraySize(vf2.get()) && 1 == vf2[0].value && 1 == vf2[9999].value && 20000 == Fragile::live;
+
+  vf1.mutable_get()[7777].value = -1;
+  try {
+    vf1.get_handler().replicate(vf1.get());
+    ok = false;
+  } catch (std::runtime_error const &) {
+    ok = ok && 20000 == Fragile::live;
+  }
+
+  vf1.reset();
+  vf2.reset();
+  ok = ok && 0 == Fragile::live;
+
+  vd_type vd1(new double[4096](), parallel_handler<double[4096], 1024>(3));
+  vd1.mutable_get()[4095] = 0.5;
+  vd_type vd2 = vd1;
+  ok = ok && vd1.get() != vd2.get() && 0 == std::memcmp(vd1.get(), vd2.get(), sizeof(double[4096]));
+
+  log(ok ? "parallel replication OK" : "parallel replication FAILED");
+
+  return ok;
+}
+
+static bool test_counting() {
+  using vi_type = value_ptr<int, counting_handler<int>>;
+  using va_type = value_ptr<Base[], counting_handler<Base[]>>;
+
+  bool ok = true;
+
+  vi_type vi1 = new int(1);
+  vi_type vi2 = vi1;
+  vi_type vi3;
+  std::thread([&vi2, &vi3]() { vi3 = vi2; }).join();
+
+  counting_registry::snapshot s = counting_handler<int>::statistics();
+  ok = ok && 1 == s.adoptions && 2 == s.replicas && 2 * sizeof(int) == s.bytes_allocated && 3 == s.live_objects && 3 * sizeof(int) == static_cast<std::size_t>(s.live_bytes) && s.live_bytes <= s.peak_live_bytes;
+
+  delete vi2.release();
+  vi1.reset();
+  vi3.reset();
+  s = counting_handler<int>::statistics();
+  ok = ok && 2 == s.destructions && 1 == s.releases && 0 == s.live_objects && 0 == s.live_bytes;
+
+  log_up("va_type va1 = new Base[3]()"); va_type va1 = new Base[3](); log_down();
+  log_up("va_type va2 = va1"); va_type va2 = va1; log_down();
+  s = counting_handler<Base[]>::statistics();
+  ok = ok && "Base []" == s.type && 3 * sizeof(Base) == s.bytes_allocated && 2 == s.live_objects;
+
+  counting_registry::instance().dump(std::cout);
+
+  log(ok ? "counting OK" : "counting FAILED");
+
+  return ok;
+}
+
+struct Reclaimed {
+  static std::thread::id owner;
+  static std::atomic<int> remote;
+
+  ~Reclaimed() noexcept { if (std::this_thread::get_id() != owner) { remote++; } }
+};
+
+std::thread::id Reclaimed::owner;
+std::atomic<int> Reclaimed::remote(0);
+
+static bool test_deferred() {
+  using vr_type = value_ptr<Reclaimed, deferred_handler<Reclaimed>>;
+  using vf_type = value_ptr<Fragile[], deferred_handler<Fragile[]>>;
+
+  bool ok = true;
+
+  Reclaimed::owner = std::this_thread::get_id();
+
+  std::vector<vr_type> vrs(3 * reclaimer::capacity);
+  for (vr_type &vr : vrs) {
+    vr.reset(new Reclaimed());
+  }
+  vrs.clear();
+
+  vf_type vf1 = new Fragile[1000]();
+  vf_type vf2 = vf1;
+  ok = ok && 2000 == Fragile::live;
+  vf1.reset();
+  vf2.reset();
+
+  deferred_handler<Reclaimed>::flush();
+  ok = ok && 0 == reclaimer::instance().pending() && 0 == Fragile::live && 0 < Reclaimed::remote;
+
+  std::cout << "  destroyed remotely: " << Reclaimed::remote << ", inline on overflow: " << reclaimer::instance().overflows() << std::endl;
+
+  log(ok ? "deferred destruction OK" : "deferred destruction FAILED");
+
+  return ok;
+}
+
+class Animal {
+  public:
+    Animal() noexcept {}
+    Animal(Animal const &) = default;
+    Animal &operator=(Animal const &) = default;
+    virtual ~Animal() noexcept {}
+
+    virtual int legs() const noexcept = 0;
+};
+
+class Dog : public Animal {
+  public:
+    Dog() noexcept : Animal(), name("rex") {}
+    Dog(Dog const &) = default;
+    Dog &operator=(Dog const &) = default;
+    virtual ~Dog() noexcept {}
+
+    virtual int legs() const noexcept { return 4; }
+
+    std::string name;
+};
+
+class Cat final : public Animal {
+  public:
+    Cat() noexcept : Animal(), lives(9), padding() {}
+    Cat(Cat const &) = default;
+    Cat &operator=(Cat const &) = default;
+    virtual ~Cat() noexcept {}
+
+    virtual int legs() const noexcept { return 4; }
+
+    int lives;
+    explicit_padding<padding_to<sizeof(void *) + sizeof(int), alignof(void *)>::value> padding;
+};
+
+struct Plain {
+  int value;
+};
+
+struct Extended : public Plain {
+  static int dead;
+
+  Extended() noexcept : Plain{7}, extra(3) {}
+  Extended(Extended const &) = default;
+  ~Extended() noexcept { dead++; }
+
+  int extra;
+};
+
+int Extended::dead = 0;
+
+static bool test_erased() {
+  using va_type = value_ptr<Animal, erased_handler<Animal>>;
+  using vp_type = value_ptr<Plain, erased_handler<Plain>>;
+
+  bool ok = true;
+
+  va_type va1 = new Dog();
+  va_type va2 = va1;
+  va_type va3;
+  va3 = va2;
+  ok = ok && va1.get() != va2.get() && typeid(Dog) == typeid(*va2) && typeid(Dog) == typeid(*va3) && 4 == va3->legs() && "rex" == dynamic_cast<Dog const &>(*va3).name;
+
+  Animal const *before = va1.get();
+  va1 = va3;
+  ok = ok && before != va1.get() && "rex" == dynamic_cast<Dog const &>(*va1).name;
+
+  va_type vk1 = new Cat();
+  va_type vk2 = new Cat();
+  before = vk1.get();
+  vk1 = vk2;
+  ok = ok && before == vk1.get() && vk1.get() != vk2.get() && 4 == vk1->legs();
+
+  Animal *raw = new Dog();
+  va_type va4(raw);
+  try {
+    va4.get_handler().replicate(va4.get());
+    ok = false;
+  } catch (std::bad_typeid const &) {
+  }
+
+  vp_type vp1 = new Extended();
+  vp_type vp2 = vp1;
+  ok = ok && 7 == vp2->value && 3 == static_cast<Extended const *>(vp2.get())->extra;
+  vp1.reset();
+  vp2.reset();
+  ok = ok && 2 == Extended::dead;
+
+  log(ok ? "erased copies OK" : "erased copies FAILED");
+
+  return ok;
+}
+
+static bool test_move_allocations() {
+  static_assert(std::is_nothrow_move_constructible<value_ptr<Base>>::value, "value_ptr<Base> not nothrow move-constructible");
+  static_assert(std::is_nothrow_move_assignable<value_ptr<Base>>::value, "value_ptr<Base> not nothrow move-assignable");
+  static_assert(std::is_nothrow_move_constructible<value_ptr<Base[]>>::value, "value_ptr<Base[]> not nothrow move-constructible");
+  static_assert(std::is_nothrow_move_assignable<value_ptr<Base[]>>::value, "value_ptr<Base[]> not nothrow move-assignable");
+
+  bool ok = true;
+  std::size_t before;
+
+  log_up("value_ptr<Base> vb1 = new Derived()"); value_ptr<Base> vb1 = new Derived(); log_down();
+  log_up("value_ptr<Base> vb2 = new Base()"); value_ptr<Base> vb2 = new Base(); log_down();
+
+  Base *p = vb1.get();
+  log_up("vb2 = std::move(vb1)"); before = allocations; vb2 = std::move(vb1); log_down();
+  ok = ok && allocations == before && vb2.get() == p && nullptr == vb1;
+
+  std::vector<value_ptr<int>> v;
+  for (int i = 0; i < 64; i++) {
+    v.emplace_back(new int(64 - i));
+  }
+
+  before = allocations; v.reserve(2 * v.capacity());
+  ok = ok && allocations == before + 1;
+
+  before = allocations; std::sort(v.begin(), v.end(), [](value_ptr<int> const &x, value_ptr<int> const &y) { return *x < *y; });
+  ok = ok && allocations == before && 1 == *v.front() && 64 == *v.back();
+
+  log(ok ? "allocation counts OK" : "allocation counts FAILED");
+
+  return ok;
+}
+
+static bool test_layout() {
+  static_assert(sizeof(value_ptr<int>) == sizeof(int *), "value_ptr<int> not pointer-sized");
+  static_assert(sizeof(value_ptr<Base>) == sizeof(Base *), "value_ptr<Base> not pointer-sized");
+  static_assert(sizeof(value_ptr<Base[]>) == sizeof(Base *), "value_ptr<Base[]> not pointer-sized");
+  static_assert(sizeof(value_ptr<Base[2]>) == sizeof(Base *), "value_ptr<Base[2]> not pointer-sized");
+  static_assert(sizeof(value_ptr<double[], default_handler<double[], Aligned<>>>) == sizeof(double *), "value_ptr<double[], Aligned> not pointer-sized");
+  static_assert(sizeof(value_ptr<double[], default_handler<double[], Described<>>>) == sizeof(double *), "value_ptr<double[], Described> not pointer-sized");
+  static_assert(sizeof(value_ptr<int, counting_handler<int>>) == sizeof(int *), "value_ptr<int, counting_handler> not pointer-sized");
+  static_assert(sizeof(value_ptr<Base[], counting_handler<Base[]>>) == sizeof(Base *), "value_ptr<Base[], counting_handler> not pointer-sized");
+  static_assert(sizeof(value_ptr<int, deferred_handler<int>>) == sizeof(int *), "value_ptr<int, deferred_handler> not pointer-sized");
+
+  static_assert(sizeof(value_ptr<int, cow_handler<int>>) == sizeof(int *) + sizeof(cow_handler<int>), "value_ptr<int, cow_handler> padded");
+  static_assert(sizeof(value_ptr<int, pool_handler<int>>) == sizeof(int *) + sizeof(pool_handler<int>), "value_ptr<int, pool_handler> padded");
+  static_assert(sizeof(value_ptr<int, thread_cached_handler<int>>) == sizeof(int *) + sizeof(thread_cached_handler<int>), "value_ptr<int, thread_cached_handler> padded");
+  static_assert(sizeof(value_ptr<double[], parallel_handler<double[]>>) == sizeof(double *) + sizeof(parallel_handler<double[]>), "value_ptr<double[], parallel_handler> padded");
+  static_assert(sizeof(value_ptr<Animal, erased_handler<Animal>>) == sizeof(Animal *) + sizeof(erased_handler<Animal>), "value_ptr<Animal, erased_handler> padded");
+
+  bool ok = true;
+
+  std::vector<value_ptr<int>> v;
+  for (int i = 0; i < 4; i++) {
+    v.emplace_back(new int(i));
+  }
+
+  int *const *raw = reinterpret_cast<int *const *>(v.data());
+  for (std::size_t i = 0; i < v.size(); i++) {
+    ok = ok && raw[i] == v[i].get();
+  }
+
+  log(ok ? "layout OK" : "layout FAILED");
+
+  return ok;
+}
+
+template <typename T, typename H>
+static bool is_inline(value_ptr<T, H> const &vp) {
+  std::less<void const *> lt;
+  return !lt(vp.get(), &vp) && lt(vp.get(), &vp + 1);
+}
+
+struct Clingy {
+  static std::size_t moves;
+
+  Clingy() noexcept : value(0) {}
+  Clingy(Clingy const &other) noexcept : value(other.value) {}
+  Clingy(Clingy &&other) : value(other.value) { moves++; }
+  Clingy &operator=(Clingy const &other) noexcept { value = other.value; return *this; }
+
+  int value;
+};
+
+std::size_t Clingy::moves = 0;
+
+static bool test_inline() {
+  using vb_type = value_ptr<Base, inline_handler<Base>>;
+  using vc_type = value_ptr<Counted, inline_handler<Counted>>;
+  using vk_type = value_ptr<Clingy, inline_handler<Clingy>>;
+  using vi_type = value_ptr<int, inline_handler<int>>;
+
+  static_assert(!inline_handler<Base>::placeable && !inline_handler<Clingy>::placeable && inline_handler<Counted>::placeable, "inline_handler placeability");
+  static_assert(std::is_nothrow_move_constructible<vc_type>::value && !noexcept(std::declval<vc_type &>().release()), "inline_handler noexcept-ness");
+
+  bool ok = true;
+  std::size_t before;
+
+  log_up("vc_type vc1 = new Counted()"); vc_type vc1 = new Counted(); log_down();
+  ok = ok && !is_inline(vc1);
+
+  log_up("vc_type vc2 = vc1"); before = allocations; vc_type vc2 = vc1; log_down();
+  ok = ok && allocations == before && is_inline(vc2) && 1 == vc2->value;
+
+  log_up("vc_type vc3 = vc2"); before = allocations; vc_type vc3 = vc2; log_down();
+  ok = ok && allocations == before && is_inline(vc3);
+
+  log_up("vc_type vc4 = std::move(vc3)"); before = allocations; vc_type vc4 = std::move(vc3); log_down();
+  ok = ok && allocations == before && is_inline(vc4) && nullptr == vc3;
+
+  log_up("vc1 = vc4"); before = allocations; vc1 = vc4; log_down();
+  ok = ok && allocations == before && !is_inline(vc1);
+
+  log_up("vc3 = vc4"); before = allocations; vc3 = vc4; log_down();
+  ok = ok && allocations == before && is_inline(vc3);
+
+  log_up("vc2.swap(vc1)"); before = allocations; vc2.swap(vc1); log_down();
+  ok = ok && allocations == before && is_inline(vc1) && !is_inline(vc2);
+
+  log_up("vc3.release()"); before = allocations; Counted *p = vc3.release(); log_down();
+  ok = ok && allocations == before + 1 && nullptr == vc3 && nullptr != p;
+  delete p;
+
+  log_up("vb_type vb1 = new Derived()"); vb_type vb1 = new Derived(); log_down();
+  log_up("vb_type vb2 = vb1 (polymorphic, on the heap)"); before = allocations; vb_type vb2 = vb1; log_down();
+  ok = ok && allocations == before + 1 && !is_inline(vb2) && typeid(*vb2) == typeid(Derived);
+
+  vk_type vk1 = make_value<Clingy, inline_handler<Clingy>>();
+  log_up("vk_type vk2 = vk1 (throwing move constructor, on the heap)"); before = allocations; vk_type vk2 = vk1; log_down();
+  ok = ok && allocations == before + 1 && !is_inline(vk1) && !is_inline(vk2);
+  Clingy const *k = vk2.get();
+  log_up("vk_type vk3 = std::move(vk2)"); before = allocations; vk_type vk3 = std::move(vk2); log_down();
+  ok = ok && allocations == before && 0 == Clingy::moves && k == vk3.get() && nullptr == vk2;
+
+  vi_type vi1 = new int(1);
+  before = allocations; vi_type vi2 = vi1; vi_type vi3 = vi2; vi1 = vi3; vi3 = std::move(vi2);
+  ok = ok && allocations == before && is_inline(vi3) && nullptr == vi2 && 1 == *vi1 && 1 == *vi3;
+
+  log(ok ? "inline storage OK" : "inline storage FAILED");
+
+  return ok;
+}
+
+static bool test_cow() {
+  using vb_type = value_ptr<Base, cow_handler<Base>>;
+  using vi_type = value_ptr<int, cow_handler<int, plain_refcount>>;
+
+  bool ok = true;
+  std::size_t before;
+
+  log_up("vb_type vb1 = new Derived()"); vb_type vb1 = new Derived(); log_down();
+
+  log_up("vb_type vb2 = vb1"); before = allocations; vb_type vb2 = vb1; log_down();
+  ok = ok && allocations == before && vb1.get() == vb2.get();
+
+  log_up("vb_type vb3; vb3 = vb2"); before = allocations; vb_type vb3; vb3 = vb2; log_down();
+  ok = ok && allocations == before && vb2.get() == vb3.get();
+
+  vb_type const &cvb3 = vb3;
+  before = allocations; Base const &cb = *cvb3; (void) cb;
+  ok = ok && allocations == before && vb2.get() == vb3.get();
+
+  log_up("vb3.mutable_get()"); before = allocations; vb3.mutable_get(); log_down();
+  ok = ok && allocations > before && vb2.get() != vb3.get() && typeid(*vb3) == typeid(Derived);
+
+  log_up("vb3.mutable_get()"); before = allocations; vb3.mutable_get(); log_down();
+  ok = ok && allocations == before;
+
+  log_up("vb1.reset()"); vb1.reset(); log_down();
+  log_up("vb2.mutable_get()"); before = allocations; vb2.mutable_get(); log_down();
+  ok = ok && allocations == before;
+
+  vi_type vi1 = new int(1);
+  before = allocations; vi_type vi2 = vi1; vi_type vi3 = std::move(vi2); vi1 = vi3;
+  ok = ok && allocations == before && nullptr == vi2 && vi1.get() == vi3.get();
+  *vi1.mutable_get() = 2;
+  ok = ok && 2 == *vi1 && 1 == *vi3;
+  before = allocations; int *p = vi3.release();
+  ok = ok && allocations == before && nullptr == vi3 && 1 == *p;
+  delete p;
+
+  int *q = new int(3);
+  exhausted = true; vi_type vi4 = q; exhausted = false;
+  log_up("vi_type vi5 = vi4 (unshared)"); before = allocations; vi_type vi5 = vi4; log_down();
+  ok = ok && q == vi4.get() && allocations > before && vi4.get() != vi5.get() && 3 == *vi5;
+
+  static_assert(noexcept(std::declval<value_ptr<int> &>().release()) && !noexcept(std::declval<vi_type &>().release()), "release() noexcept-ness not forwarded");
+  vi_type vi6 = new int(4), vi7 = vi6;
+  bool thrown = false;
+  log_up("vi7.release() (shared, allocation failing)");
+  exhausted = true; try { vi7.release(); } catch (std::bad_alloc const &) { thrown = true; } exhausted = false;
+  log_down();
+  ok = ok && thrown && vi6.get() == vi7.get() && 4 == *vi7;
+  log_up("vi7.release() (shared)"); int *r = vi7.release(); log_down();
+  ok = ok && nullptr == vi7 && r != vi6.get() && 4 == *r && 4 == *vi6;
+  delete r;
+
+  log(ok ? "copy-on-write OK" : "copy-on-write FAILED");
+
+  return ok;
+}
+
+static bool test_pool() {
+  using vb_type = value_ptr<Base, pool_handler<Base>>;
+  using vi_type = value_ptr<int, pool_handler<int>>;
+  using va_type = value_ptr<Base[], pool_handler<Base[]>>;
+  using vn_type = value_ptr<Base[2], pool_handler<Base[2]>>;
+
+  bool ok = true;
+  std::size_t before;
+  slab_pool pool;
+
+  log_up("vb_type vb1(new Derived(), pool_handler<Base>(&pool))"); vb_type vb1(new Derived(), pool_handler<Base>(&pool)); log_down();
+  ok = ok && 0 == pool.capacity();
+
+  log_up("vb_type vb2 = vb1"); vb_type vb2 = vb1; log_down();
+  ok = ok && 0 != pool.capacity() && 0 != pool.in_use() && typeid(*vb2) == typeid(Derived);
+
+  log_up("vb_type vb3 = vb2"); before = allocations; vb_type vb3 = vb2; log_down();
+  ok = ok && allocations == before && vb3.get_handler().resource() == &pool;
+
+  log_up("vb2 = vb3"); before = allocations; vb2 = vb3; log_down();
+  ok = ok && allocations == before;
+
+  log_up("vb3.reset()"); vb3.reset(); log_down();
+  log_up("vb_type vb4 = std::move(vb2)"); before = allocations; vb_type vb4 = std::move(vb2); log_down();
+  ok = ok && allocations == before && nullptr == vb2;
+
+  log_up("vb3 = vb4"); before = allocations; vb3 = vb4; log_down();
+  ok = ok && allocations == before;
+
+  log_up("vb3.release()"); Base *p = vb3.release(); log_down();
+  ok = ok && nullptr == vb3 && typeid(*p) == typeid(Derived);
+  log_up("delete p"); delete p; log_down();
+
+  vi_type vi1(new int(1), pool_handler<int>(&pool));
+  before = allocations;
+  std::vector<vi_type> vs(16, vi1);
+  ok = ok && allocations == before + 1 && 1 == *vs.back();
+  vs.clear();
+
+  log_up("va_type va1(new Base[3](), pool_handler<Base[]>(&pool))"); va_type va1(new Base[3](), pool_handler<Base[]>(&pool)); log_down();
+  log_up("va_type va2 = va1"); va_type va2 = va1; log_down();
+  log_up("va2 = va1"); before = allocations; va2 = va1; log_down();
+  ok = ok && allocations == before && 3 == Itanium::arraySize(va2.get());
+
+  log_up("vn_type vn1(new Base[2](), pool_handler<Base[2]>(&pool))"); vn_type vn1(new Base[2](), pool_handler<Base[2]>(&pool)); log_down();
+  log_up("vn_type vn2 = vn1"); before = allocations; vn_type vn2 = vn1; log_down();
+  ok = ok && allocations == before;
+
+  std::size_t peak = pool.high_water();
+  ok = ok && 0 != peak && 0 == pool.release();
+
+  log_up("reset all"); vb1.reset(); vb4.reset(); vi1.reset(); va1.reset(); va2.reset(); vn1.reset(); vn2.reset(); log_down();
+  ok = ok && 0 == pool.in_use() && peak == pool.high_water() && pool.capacity() == pool.release() && 0 == pool.capacity();
+
+  log(ok ? "pool allocation OK" : "pool allocation FAILED");
+
+  return ok;
+}
+
+static bool test_thread_cache() {
+  using vi_type = value_ptr<int, thread_cached_handler<int>>;
+  using vb_type = value_ptr<Base, thread_cached_handler<Base>>;
+
+  bool ok = true;
+  std::size_t before;
+
+  vi_type vi1 = new int(1);
+  vi_type vi2 = vi1;
+  ok = ok && 0 != thread_cache::local().in_use();
+
+  before = allocations;
+  vi_type vi3 = vi2;
+  vi3 = vi1;
+  ok = ok && allocations == before && 1 == *vi3;
+
+  vi_type vi4, vi5;
+  std::thread([&vi1, &vi3, &vi4, &vi5]() {
+    vi4 = vi1;
+    vi5 = vi1;
+    vi3.reset();
+  }).join();
+  ok = ok && 1 == *vi4 && nullptr == vi3;
+
+  vi2.reset();
+  vi4.reset();
+  ok = ok && 0 != thread_cache_resource::trim() && 0 == thread_cache::local().in_use() && 0 == thread_cache::local().capacity();
+
+  log_up("vb_type vb1 = new Derived()"); vb_type vb1 = new Derived(); log_down();
+  std::vector<vb_type> vs(4);
+  std::thread([&vb1, &vs]() {
+    log_up("copy on worker"); for (vb_type &vb : vs) { vb = vb1; } log_down();
+  }).join();
+  ok = ok && typeid(*vs.front()) == typeid(Derived);
+  log_up("destroy on main"); vs.clear(); log_down();
+
+  log(ok ? "thread cache OK" : "thread cache FAILED");
+
+  return ok;
+}
+
+struct Brittle {
+  static int live;
+  static int budget;
+
+  Brittle() : value(0) { if (0 == budget--) { throw std::runtime_error("brittle"); } live++; }
+  Brittle(Brittle const &other) : value(other.value) { live++; }
+  ~Brittle() noexcept { live--; }
+
+  int value;
+};
+
+int Brittle::live = 0;
+int Brittle::budget = 0;
+
+static bool test_in_place() {
+  using vb_type = value_ptr<Base, inline_handler<Base>>;
+  using vl_type = value_ptr<Counted, inline_handler<Counted>>;
+  using va_type = value_ptr<Animal, erased_handler<Animal>>;
+  using vc_type = value_ptr<int, cow_handler<int>>;
+  using vt_type = value_ptr<Plain, counting_handler<Plain, erased_handler<Plain>>>;
+  using vp_type = value_ptr<int, pool_handler<int>>;
+  using vq_type = value_ptr<Base[], pool_handler<Base[]>>;
+  using vd_type = value_ptr<double[], default_handler<double[], Described<>>>;
+
+  bool ok = true;
+  std::size_t before;
+
+  before = allocations; value_ptr<int> vi = make_value<int>(7);
+  ok = ok && allocations == before + 1 && 7 == *vi;
+
+  log_up("vl_type vl1 = make_value<Counted, inline_handler<Counted>>()"); before = allocations; vl_type vl1 = make_value<Counted, inline_handler<Counted>>(); log_down();
+  ok = ok && allocations == before && is_inline(vl1);
+
+  log_up("vb_type vb1(value_in_place_type<Derived>)"); before = allocations; vb_type vb1(value_in_place_type<Derived>); log_down();
+  ok = ok && allocations == before + 1 && !is_inline(vb1) && typeid(*vb1) == typeid(Derived);
+
+  va_type va1(value_in_place_type<Dog>);
+  va_type va2 = va1;
+  ok = ok && typeid(Dog) == typeid(*va2) && "rex" == dynamic_cast<Dog const &>(*va2).name;
+
+  vc_type vc1 = make_value<int, cow_handler<int>>(1);
+  vc_type vc2 = vc1;
+  ok = ok && vc1.get() == vc2.get();
+  *vc2.mutable_get() = 2;
+  ok = ok && 1 == *vc1 && 2 == *vc2;
+
+  vt_type vt1 = make_value<Plain, counting_handler<Plain, erased_handler<Plain>>>(Plain{5});
+  vt_type vt2 = vt1;
+  counting_registry::snapshot s = counting_handler<Plain, erased_handler<Plain>>::statistics();
+  ok = ok && 5 == vt2->value && 1 == s.adoptions && 1 == s.replicas;
+
+  slab_pool &pool = slab_pool::instance();
+  std::size_t used = pool.in_use();
+  vp_type vp = make_value<int, pool_handler<int>>(3);
+  log_up("vq_type vq = make_value<Base[], pool_handler<Base[]>>(4u)"); vq_type vq = make_value<Base[], pool_handler<Base[]>>(4u); log_down();
+  ok = ok && 3 == *vp && 4 == Itanium::arraySize(vq.get()) && pool.in_use() > used;
+  log_up("reset pooled"); vp.reset(); vq.reset(); log_down();
+  ok = ok && pool.in_use() == used;
+
+  vd_type vd = make_value<double[], default_handler<double[], Described<>>>(5u);
+  value_ptr<int[3]> vn = make_value<int[3]>();
+  ok = ok && 5 == Described<>::arraySize(vd.get()) && !(vd[4] < 0) && !(vd[4] > 0) && 0 == vn[2];
+
+  Brittle::budget = 2;
+  try {
+    make_value<Brittle[]>(5u);
+    ok = false;
+  } catch (std::runtime_error const &) {
+  }
+  ok = ok && 0 == Brittle::live;
+
+  log(ok ? "in-place construction OK" : "in-place construction FAILED");
+
+  return ok;
+}
+
+static bool test_pmr() {
+  using vb_type = value_ptr<Base, pmr_handler<Base>>;
+  using va_type = value_ptr<Base[], pmr_handler<Base[]>>;
+  using vi_type = value_ptr<int, pmr_handler<int>>;
+
+  alignas(std::max_align_t) unsigned char arena[4096];
+  std::pmr::monotonic_buffer_resource request(arena, sizeof arena, std::pmr::null_memory_resource());
+  std::pmr::unsynchronized_pool_resource lasting;
+  auto in_arena = [&arena](void const *p) { return std::less_equal<void const *>()(arena, p) && std::less<void const *>()(p, arena + sizeof arena); };
+
+  bool ok = true;
+
+  vb_type vb0(new Derived());
+  log_up("vb_type vb1 = vb0.clone_into(&request)"); vb_type vb1 = vb0.clone_into(&request); log_down();
+  ok = ok && in_arena(vb1.get()) && typeid(*vb1) == typeid(Derived) && &request == vb1.get_handler().resource();
+
+  log_up("vb_type vb2 = vb1.clone_into(&lasting)"); vb_type vb2 = vb1.clone_into(&lasting); log_down();
+  ok = ok && !in_arena(vb2.get()) && typeid(*vb2) == typeid(Derived) && &lasting == vb2.get_handler().resource();
+
+  va_type va0 = make_value<Base[], pmr_handler<Base[]>>(3u);
+  log_up("va_type va1 = va0.clone_into(&request)"); va_type va1 = va0.clone_into(&request); log_down();
+  ok = ok && in_arena(va1.get()) && 3 == Itanium::arraySize(va1.get());
+
+  std::pmr::memory_resource *previous = std::pmr::set_default_resource(&request);
+  vi_type vi = make_value<int, pmr_handler<int>>(9);
+  std::pmr::set_default_resource(previous);
+  ok = ok && in_arena(vi.get()) && 9 == *vi;
+
+  log(ok ? "pmr OK" : "pmr FAILED");
+
+  return ok;
+}
+
+class Bird : public Animal {
+  public:
+    Bird() noexcept : Animal() {}
+    Bird(Bird const &) = default;
+    Bird &operator=(Bird const &) = default;
+    virtual ~Bird() noexcept {}
+
+    virtual int legs() const noexcept { return 2; }
+};
+
+class Snake : public Animal {
+  public:
+    static int clones;
+
+    Snake() noexcept : Animal() {}
+    virtual ~Snake() noexcept {}
+
+    virtual int legs() const noexcept { return 0; }
+
+    virtual Snake *clone(void *p) const { clones++; return new(p) Snake(*this); }
+
+  protected:
+    Snake(Snake const &) = default;
+};
+
+int Snake::clones = 0;
+
+static bool test_collection() {
+  using vc_type = value_collection<Animal>;
+
+  auto legs = [](vc_type const &v) { int ret = 0; v.for_each([&ret](Animal const &a) { ret += a.legs(); }); return ret; };
+
+  bool ok = true;
+
+  vc_type vc1;
+  vc1.emplace<Dog>();
+  vc1.insert(Bird());
+  vc1.emplace<Dog>().name = "fido";
+  vc1.emplace<Snake>();
+  ok = ok && 4 == vc1.size() && 3 == vc1.type_count() && 2 == vc1.count<Dog>() && 10 == legs(vc1);
+
+  vc_type vc2 = vc1;
+  vc1.for_each_of<Dog>([](Dog &d) { d.name = "spot"; });
+  std::string names;
+  vc2.for_each_of<Dog>([&names](Dog const &d) { names += d.name + " "; });
+  ok = ok && "rex fido " == names && 1 == Snake::clones && 10 == legs(vc2);
+
+  Dog const *first = nullptr;
+  vc1.reserve<Dog>(4);
+  vc1.emplace<Dog>();
+  vc1.emplace<Dog>();
+  vc1.for_each_of<Dog>([&first](Dog const &d) { if (nullptr == first) { first = &d; } });
+  vc1.emplace<Dog>(*first);
+  names.clear();
+  vc1.for_each_of<Dog>([&names](Dog const &d) { names += d.name + " "; });
+  ok = ok && 5 == vc1.count<Dog>() && "spot spot rex rex spot " == names && 22 == legs(vc1);
+
+  vc_type vc3 = std::move(vc1);
+  ok = ok && vc1.empty() && 0 == vc1.type_count() && 7 == vc3.size();
+  vc3 = vc2;
+  ok = ok && 4 == vc3.size() && 2 == Snake::clones;
+
+  value_collection<Base> vb;
+  log_up("vb.insert(Derived())"); vb.insert(Derived()); log_down();
+  try {
+    log_up("vb.insert(static_cast<Base const &>(Derived()))"); vb.insert(static_cast<Base const &>(Derived())); log_down();
+    ok = false;
+  } catch (std::bad_typeid const &) {
+    log_down();
+  }
+  ok = ok && 1 == vb.size() && 1 == vb.count<Derived>();
+
+  log(ok ? "collection OK" : "collection FAILED");
+
+  return ok;
+}
+
+static bool test_arena() {
+  using vb_type = value_ptr<Base, arena_handler<Base>>;
+  using vc_type = value_ptr<Counted[], arena_handler<Counted[]>>;
+  using vl_type = value_ptr<Lane, arena_handler<Lane>>;
+
+  bool ok = true;
+  std::size_t before;
+
+  std::vector<value_ptr<Base>> bases;
+  bases.reserve(4);
+  log_up("bases = { new Base(), new Derived(), new Base(), nullptr }");
+  bases.emplace_back(new Base()); bases.emplace_back(new Derived()); bases.emplace_back(new Base()); bases.emplace_back(nullptr);
+  log_down();
+
+  std::vector<vb_type> vbs;
+  vbs.reserve(bases.size());
+  log_up("clone_range(bases.begin(), bases.end(), std::back_inserter(vbs))"); before = allocations; clone_range(bases.begin(), bases.end(), std::back_inserter(vbs)); log_down();
+  clone_arena *arena = vbs[0].get_handler().arena();
+  ok = ok && 4 == vbs.size() && allocations == before + 2 && nullptr != arena && arena == vbs[2].get_handler().arena() && arena->used() == arena->capacity();
+  ok = ok && nullptr == vbs[1].get_handler().arena() && typeid(Derived) == typeid(*vbs[1]) && typeid(Base) == typeid(*vbs[2]) && nullptr == vbs[3].get();
+
+  log_up("vb_type vb = vbs[0]"); vb_type vb = vbs[0]; log_down();
+  ok = ok && nullptr == vb.get_handler().arena();
+  log_up("vbs.clear()"); vbs.clear(); log_down();
+
+  std::vector<value_ptr<Counted[]>> counted;
+  counted.emplace_back(new Counted[3]());
+  counted.emplace_back(new Counted[5]());
+  std::vector<vc_type> vcs;
+  clone_range(counted.begin(), counted.end(), std::back_inserter(vcs));
+  ok = ok && 3 == Itanium::arraySize(vcs[0].get()) && 5 == Itanium::arraySize(vcs[1].get()) && 1 == vcs[1][4].value && vcs[0].get_handler().arena() == vcs[1].get_handler().arena();
+
+  vc_type vc = std::move(vcs[1]);
+  vcs.clear();
+  Counted *released = vc.release();
+  ok = ok && 5 == Itanium::arraySize(released) && 2 == released[4].value;
+  delete[] released;
+
+  std::vector<value_ptr<Lane>> lanes(3);
+  for (value_ptr<Lane> &l : lanes) {
+    l = new Lane();
+  }
+  std::vector<vl_type> vls;
+  clone_range(lanes.begin(), lanes.end(), std::back_inserter(vls));
+  for (vl_type const &l : vls) {
+    ok = ok && nullptr != l.get_handler().arena() && 0 == reinterpret_cast<std::uintptr_t>(l.get()) % alignof(Lane);
+  }
+
+  log(ok ? "arena OK" : "arena FAILED");
+
+  return ok;
+}
+
+static bool test_compare() {
+  using vi_type = value_ptr<int[], default_handler<int[], Described<>>>;
+  using vs_type = value_ptr<std::string>;
+
+  bool ok = true;
+
+  value_ptr<int> x(new int(3)), y(new int(3)), z(new int(4)), none;
+  ok = ok && x != y && value_compare::equal(x, y) && !value_compare::equal(x, z) && value_compare::equal(none, value_ptr<int>());
+  ok = ok && value_compare::less(x, z) && !value_compare::less(z, x) && !value_compare::less(x, y) && value_compare::less(none, x) && !value_compare::less(x, none);
+  ok = ok && value_compare::hash(x) == value_compare::hash(y) && 0 == value_compare::hash(none);
+
+  log_up("vi_type a = make_value<int[], vi_type::handler_type>(1000u), b = a");
+  vi_type a = make_value<int[], vi_type::handler_type>(1000u);
+  for (std::size_t i = 0; i < 1000; i++) {
+    a[i] = static_cast<int>(i) - 500;
+  }
+  vi_type b = a;
+  log_down();
+  ok = ok && value_compare::equal(a, b) && !value_compare::less(a, b) && value_compare::hash(a) == value_compare::hash(b);
+
+  log_up("b[700] = -1"); b[700] = -1; log_down();
+  ok = ok && !value_compare::equal(a, b) && value_compare::less(b, a) && !value_compare::less(a, b) && value_compare::hash(a) != value_compare::hash(b);
+
+  log_up("b = make_value<int[], vi_type::handler_type>(999u), copying a's first 999 elements");
+  b = make_value<int[], vi_type::handler_type>(999u);
+  std::copy(a.get(), a.get() + 999, b.get());
+  log_down();
+  ok = ok && !value_compare::equal(a, b) && value_compare::less(b, a) && !value_compare::less(a, b);
+
+  value_ptr<int[8]> c = new int[8]{ -1, 0, 1, 2, 3, 4, 5, 6 }, d = new int[8]{ 1, 0, 1, 2, 3, 4, 5, 6 };
+  vi_type e = make_value<int[], vi_type::handler_type>(8u);
+  std::copy(c.get(), c.get() + 8, e.get());
+  ok = ok && value_compare::less(c, d) && value_compare::equal(c, e) && value_compare::hash(c) == value_compare::hash(e);
+
+  value_ptr<std::string[]> f = make_value<std::string[]>(2u), g = make_value<std::string[]>(2u);
+  f[0] = g[0] = "abc"; f[1] = "de"; g[1] = "df";
+  ok = ok && !value_compare::equal(f, g) && value_compare::less(f, g);
+  log_up("g[1] = \"de\""); g[1] = "de"; log_down();
+  ok = ok && value_compare::equal(f, g) && value_compare::hash(f) == value_compare::hash(g);
+
+  std::unordered_set<vs_type, std::hash<vs_type>, value_equal> strings;
+  strings.emplace(new std::string("one")); strings.emplace(new std::string("two")); strings.emplace(new std::string("one"));
+  ok = ok && 2 == strings.size() && 1 == strings.count(vs_type(new std::string("two")));
+
+  log(ok ? "compare OK" : "compare FAILED");
+
+  return ok;
+}
+
+class Gauge {
+  public:
+    constexpr explicit Gauge(int v) noexcept : value(v), padding() {}
+    constexpr Gauge(Gauge const &) = default;
+    constexpr Gauge &operator=(Gauge const &) = default;
+    constexpr virtual ~Gauge() noexcept {}
+
+    constexpr virtual Gauge *clone() const { return new Gauge(*this); }
+    constexpr virtual int read() const noexcept { return value; }
+
+  protected:
+    int value;
+    explicit_padding<padding_to<sizeof(void *) + sizeof(int), alignof(void *)>::value> padding;
+};
+
+class Doubled : public Gauge {
+  public:
+    constexpr explicit Doubled(int v) noexcept : Gauge(v) {}
+    constexpr Doubled(Doubled const &) = default;
+    constexpr Doubled &operator=(Doubled const &) = default;
+    constexpr virtual ~Doubled() noexcept {}
+
+    constexpr virtual Doubled *clone() const { return new Doubled(*this); }
+    constexpr virtual int read() const noexcept { return 2 * value; }
+};
+
+static constexpr int evaluate() {
+  value_ptr<int> vi = make_value<int>(20), vj = vi;
+  *vj += 1;
+  vi = vj;
+
+  value_ptr<int[4]> va = make_value<int[4]>(), vb = va;
+  vb[3] = 11;
+  va = vb;
+  vb.reset();
+
+  value_ptr<Gauge> vg = new Doubled(5), vh = vg;
+  vg = nullptr;
+  swap(vi, vj);
+
+  return *vi + va[3] + vh->read() + (nullptr == vg ? 1 : 0) + (nullptr == vb ? 1 : 0);
+}
+
+static_assert(44 == evaluate(), "value_ptr must be usable in constant expressions");
+
+constinit value_ptr<Gauge> no_gauge;
+constinit value_ptr<int[4], default_handler<int[4], Described<>>> no_table = nullptr;
+
+static bool test_constexpr() {
+  bool ok = true;
+
+  log_up("evaluate()"); int runtime = evaluate(); log_down();
+  ok = ok && 44 == runtime && nullptr == no_gauge && nullptr == no_table;
+
+  log_up("no_table = make_value<int[4], ...>()"); no_table = make_value<int[4], default_handler<int[4], Described<>>>(); log_down();
+  ok = ok && 0 == no_table[3];
+  log_up("no_table.reset()"); no_table.reset(); log_down();
+
+  log(ok ? "constexpr OK" : "constexpr FAILED");
+
+  return ok;
+}
+
+static bool test_atomic() {
+  using vf_type = value_ptr<Fragile>;
+
+  bool ok = true;
+
+  int baseline = Fragile::live;
+  {
+    atomic_value_ptr<Fragile> af(make_value<Fragile>());
+
+    log_up("af.load()"); vf_type vf = af.load(); log_down();
+    ok = ok && 1 == vf->value && baseline + 2 == Fragile::live;
+
+    {
+      log_up("af.borrow()"); atomic_value_ptr<Fragile>::guard g = af.borrow(); log_down();
+      log_up("af.store(...)"); af.store(make_value<Fragile>()); log_down();
+      ok = ok && 0 == g->value && 1 == af.retired() && baseline + 3 == Fragile::live;
+      ok = ok && 1 == af.reclaim();
+    }
+    ok = ok && 0 == af.reclaim() && 0 == af.retired() && baseline + 2 == Fragile::live;
+
+    {
+      atomic_value_ptr<Fragile>::guard g = af.borrow();
+      vf = make_value<Fragile>();
+      log_up("af.compare_exchange(g, vf)"); bool swapped = af.compare_exchange(g, vf); log_down();
+      ok = ok && swapped && nullptr == vf;
+      vf = make_value<Fragile>();
+      ok = ok && !af.compare_exchange(g, vf) && nullptr != vf;
+    }
+
+    log_up("af.exchange(...)"); vf = af.exchange(std::move(vf)); log_down();
+    ok = ok && nullptr != vf && 0 == af.reclaim() && baseline + 2 == Fragile::live;
+
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < 4; i++) {
+      readers.emplace_back([&af, &done, &torn, i]() {
+        while (!done.load(std::memory_order_relaxed)) {
+          if (0 == i % 2) {
+            atomic_value_ptr<Fragile>::guard g = af.borrow();
+            if (!g || g->value < 0) { torn++; }
+          } else if (af.load()->value < 1) {
+            torn++;
+          }
+        }
+      });
+    }
+    for (int i = 0; i < 20000; i++) {
+      vf_type next = make_value<Fragile>();
+      next->value = i;
+      af.store(std::move(next));
+    }
+    done = true;
+    for (std::thread &t : readers) {
+      t.join();
+    }
+    ok = ok && 0 == torn && 0 == af.reclaim() && baseline + 2 == Fragile::live;
+  }
+  ok = ok && baseline == Fragile::live;
+
+  log(ok ? "atomic publication OK" : "atomic publication FAILED");
+
+  return ok;
+}
+
+static bool test_rcu() {
+  using vf_type = value_ptr<Fragile>;
+
+  bool ok = true;
+
+  int baseline = Fragile::live;
+  {
+    rcu_value_ptr<Fragile> rf(make_value<Fragile>());
+
+    {
+      log_up("rf.read()"); rcu_value_ptr<Fragile>::snapshot s = rf.read(); log_down();
+      log_up("rf.update(...)"); rf.update([](vf_type &v) { v->value += 10; }); log_down();
+      ok = ok && 0 == s->value && 11 == rf.read()->value && baseline + 2 == Fragile::live;
+      ok = ok && 1 == rf.retired() && 1 == rf.reclaim();
+    }
+    log_up("rf.reclaim()"); ok = ok && 0 == rf.reclaim() && baseline + 1 == Fragile::live; log_down();
+
+    log_up("rf.copy()"); vf_type vf = rf.copy(); log_down();
+    vf->value = 20;
+    log_up("rf.publish(...)"); rf.publish(std::move(vf)); log_down();
+    ok = ok && nullptr == vf && 20 == rf.read()->value && 0 == rf.retired();
+
+    std::atomic<bool> done(false);
+    std::atomic<int> regressions(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+      readers.emplace_back([&rf, &done, &regressions]() {
+        int last = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+          rcu_value_ptr<Fragile>::snapshot s = rf.read();
+          rcu_value_ptr<Fragile>::snapshot nested = rf.read();
+          if (!s || s->value < last || nested->value < s->value) { regressions++; }
+          last = s->value;
+        }
+      });
+    }
+    for (int i = 0; i < 5000; i++) {
+      rf.update([](vf_type &v) { v->value++; });
+    }
+    done = true;
+    for (std::thread &t : readers) {
+      t.join();
+    }
+    log_up("rf.synchronize()"); rf.synchronize(); log_down();
+    ok = ok && 0 == regressions && 0 == rf.retired() && baseline + 1 == Fragile::live && 20 + 2 * 5000 == rf.read()->value;
+  }
+  ok = ok && baseline == Fragile::live;
+
+  log(ok ? "read-copy-update OK" : "read-copy-update FAILED");
+
+  return ok;
+}
+
+struct Label {
+  Label() noexcept : text() {}
+  explicit Label(value_reader &in) : text(in.read<std::uint32_t>(), '\0') { in.read(&text[0], text.size()); }
+  void save(value_writer &out) const { out.write(static_cast<std::uint32_t>(text.size())); out.write(text.data(), text.size()); }
+
+  std::string text;
+};
+
+struct Tally {
+  explicit Tally(int v) noexcept : value(v) {}
+  explicit Tally(value_reader &in) : value(in.read<int>()) {}
+  Tally(Tally const &) = default;
+  Tally &operator=(Tally const &) = delete;
+  ~Tally() noexcept {}
+  void save(value_writer &out) const { out.write(value); }
+
+  int value;
+};
+
+struct TallyHandler {
+  static constexpr bool slice_safe = true;
+
+  Tally *replicate(Tally const *p) const { return default_handler<Tally[]>().replicate(p); }
+  void destroy(Tally const *p) const { default_handler<Tally[]>().destroy(p); }
+};
+
+class Part {
+  public:
+    using samples_type = value_ptr<double[], default_handler<double[], Described<>>>;
+
+    explicit Part(int i) : id(i), padding(), samples(), labels() {}
+    explicit Part(value_reader &in) : id(in.read<int>()), padding(), samples(in.read<samples_type>()), labels(in.read<value_ptr<Label[]>>()) {}
+    Part(Part const &) = default;
+    Part &operator=(Part const &) = default;
+    virtual ~Part() = default;
+
+    virtual Part *clone() const { return new Part(*this); }
+    virtual void save(value_writer &out) const { out.write(id); out.write(samples); out.write(labels); }
+    virtual int weight() const { return id; }
+
+    int id;
+    explicit_padding<padding_to<sizeof(int), alignof(samples_type)>::value> padding;
+    samples_type samples;
+    value_ptr<Label[]> labels;
+};
+
+class Assembly : public Part {
+  public:
+    Assembly(int i, Part *l, Part *r) : Part(i), left(l), right(r) {}
+    explicit Assembly(value_reader &in) : Part(in), left(in.read<value_ptr<Part>>()), right(in.read<value_ptr<Part>>()) {}
+
+    Assembly *clone() const override { return new Assembly(*this); }
+    void save(value_writer &out) const override { Part::save(out); out.write(left); out.write(right); }
+    int weight() const override { return id + (left ? left->weight() : 0) + (right ? right->weight() : 0); }
+
+    value_ptr<Part> left;
+    value_ptr<Part> right;
+};
+
+class Stray : public Part {
+  public:
+    Stray() : Part(0) {}
+    explicit Stray(value_reader &in) : Part(in) {}
+
+    Stray *clone() const override { return new Stray(*this); }
+};
+
+static bool test_serialize() {
+  bool ok = true;
+
+  serial_types<Part>::enroll<Part>("part");
+  serial_types<Part>::enroll<Assembly>("assembly");
+  serial_types<Part>::enroll<Assembly>("assembly");
+
+  value_ptr<Part> graph = new Assembly(1, new Part(2), new Assembly(3, new Part(4), nullptr));
+  graph->samples = make_value<double[], Part::samples_type::handler_type>(100000u);
+  for (std::size_t i = 0; i < 100000u; i++) {
+    graph->samples[i] = static_cast<double>(i) / 2;
+  }
+  graph->labels = make_value<Label[]>(3u);
+  graph->labels[2].text = "third";
+
+  std::vector<char> bytes;
+  {
+    log_up("value_writer(bytes).write(graph)"); value_writer out(bytes); out.write(graph); log_down();
+    ok = ok && bytes.size() == out.written() && bytes.size() > 100000u * sizeof(double);
+  }
+
+  value_reader in(bytes);
+  log_up("value_reader(bytes).read<value_ptr<Part>>()"); value_ptr<Part> copy = in.read<value_ptr<Part>>(); log_down();
+  Assembly const *root = dynamic_cast<Assembly const *>(copy.get());
+  ok = ok && nullptr != root && bytes.size() == in.consumed() && 10 == copy->weight() && nullptr != dynamic_cast<Assembly const *>(root->right.get());
+  ok = ok && 100000u == Described<>::arraySize(copy->samples.get()) && 49999.0 < copy->samples[99999] && copy->samples[99999] < 50000.0 && "third" == copy->labels[2].text && nullptr == root->left->samples;
+
+  std::FILE *f = std::tmpfile();
+  if (nullptr == f) {
+    ok = false;
+  } else {
+    {
+      value_writer out(fileno(f));
+      out.write(copy);
+      out.write(graph);
+      out.flush();
+    }
+    std::size_t size = static_cast<std::size_t>(::lseek(fileno(f), 0, SEEK_END));
+    ::lseek(fileno(f), 0, SEEK_SET);
+    value_reader fin(fileno(f));
+    log_up("value_reader(fd).read<value_ptr<Part>>() x 2"); value_ptr<Part> first = fin.read<value_ptr<Part>>(), second = fin.read<value_ptr<Part>>(); log_down();
+    ok = ok && 10 == first->weight() && 10 == second->weight() && size == fin.consumed() && size < 2 * bytes.size();
+    std::fclose(f);
+  }
+
+  bool threw = false;
+  try {
+    value_writer out(bytes);
+    out.write(value_ptr<Part>(new Stray()));
+  } catch (serial_error const &) {
+    threw = true;
+  }
+  ok = ok && threw;
+
+  threw = false;
+  try {
+    value_reader cut(bytes.data(), bytes.size() / 2);
+    cut.read<value_ptr<Part>>();
+  } catch (serial_error const &) {
+    threw = true;
+  }
+  ok = ok && threw;
+
+  std::vector<char> huge;
+  {
+    value_writer out(huge);
+    out.write(static_cast<std::uint8_t>(1));
+    out.write(static_cast<std::uint64_t>(1) << 40);
+    out.write(0.5);
+  }
+  using vt_type = value_ptr<Tally[], TallyHandler>;
+  std::vector<char> tallies;
+  Tally seed(7);
+  {
+    value_writer out(tallies);
+    out.write(value_ptr<Tally[2]>(new Tally[2]{Tally(1), Tally(2)}));
+    out.write(vt_type(value_in_place, 3u, seed));
+  }
+  value_reader tin(tallies);
+  log_up("value_reader(tallies).read<value_ptr<Tally[2]>>()"); value_ptr<Tally[2]> fixed = tin.read<value_ptr<Tally[2]>>(); log_down();
+  log_up("value_reader(tallies).read<vt_type>()"); vt_type flexible = tin.read<vt_type>(); log_down();
+  ok = ok && 1 == fixed[0].value && 2 == fixed[1].value && 7 == flexible[2].value && tallies.size() == tin.consumed();
+
+  threw = false;
+  try {
+    value_reader bogus(huge);
+    bogus.read<value_ptr<double[]>>();
+  } catch (serial_error const &) {
+    threw = true;
+  }
+  ok = ok && threw;
+
+  log(ok ? "serialization OK" : "serialization FAILED");
+
+  return ok;
+}
+
 // =========================================================================================================================================
 // =========================================================================================================================================
 
@@ -160,9 +1613,36 @@ int main(int argc, char *argv[]) {
 
   // ---------------------------------------------------------------------------
 
-  cout << "FUNDAMENTAL" << endl; test_fundamental(); cout << endl << endl;
-  cout << "BASE"        << endl; test_base()       ; cout << endl << endl;
-  cout << "ARRAY"       << endl; test_base_array() ; cout << endl << endl;
+  bool ok = true;
+
+  cout << "FUNDAMENTAL" << endl; ok = test_fundamental()             && ok; cout << endl << endl;
+  cout << "BASE"        << endl; ok = test_base()                    && ok; cout << endl << endl;
+  cout << "ARRAY"       << endl; ok = test_base_array()              && ok; cout << endl << endl;
+  cout << "ALLOCATIONS" << endl; ok = test_copy_assign_allocations() && ok; cout << endl << endl;
+  cout << "EXCEPTIONS"  << endl; ok = test_copy_assign_exceptions()  && ok; cout << endl << endl;
+  cout << "DESTROY"     << endl; ok = test_array_destroy()           && ok; cout << endl << endl;
+  cout << "BULK COPY"   << endl; ok = test_bulk_copy()               && ok; cout << endl << endl;
+  cout << "ALIGNED"     << endl; ok = test_aligned()                 && ok; cout << endl << endl;
+  cout << "DESCRIBED"   << endl; ok = test_described()               && ok; cout << endl << endl;
+  cout << "PARALLEL"    << endl; ok = test_parallel()                && ok; cout << endl << endl;
+  cout << "COUNTING"    << endl; ok = test_counting()                && ok; cout << endl << endl;
+  cout << "DEFERRED"    << endl; ok = test_deferred()                && ok; cout << endl << endl;
+  cout << "ERASED"      << endl; ok = test_erased()                  && ok; cout << endl << endl;
+  cout << "MOVES"       << endl; ok = test_move_allocations()        && ok; cout << endl << endl;
+  cout << "LAYOUT"      << endl; ok = test_layout()                  && ok; cout << endl << endl;
+  cout << "INLINE"      << endl; ok = test_inline()                  && ok; cout << endl << endl;
+  cout << "COW"         << endl; ok = test_cow()                     && ok; cout << endl << endl;
+  cout << "POOL"        << endl; ok = test_pool()                    && ok; cout << endl << endl;
+  cout << "THREADS"     << endl; ok = test_thread_cache()            && ok; cout << endl << endl;
+  cout << "IN PLACE"    << endl; ok = test_in_place()                && ok; cout << endl << endl;
+  cout << "PMR"         << endl; ok = test_pmr()                     && ok; cout << endl << endl;
+  cout << "COLLECTION"  << endl; ok = test_collection()              && ok; cout << endl << endl;
+  cout << "ARENA"       << endl; ok = test_arena()                   && ok; cout << endl << endl;
+  cout << "COMPARE"     << endl; ok = test_compare()                 && ok; cout << endl << endl;
+  cout << "CONSTEXPR"   << endl; ok = test_constexpr()               && ok; cout << endl << endl;
+  cout << "ATOMIC"      << endl; ok = test_atomic()                  && ok; cout << endl << endl;
+  cout << "RCU"         << endl; ok = test_rcu()                     && ok; cout << endl << endl;
+  cout << "SERIALIZE"   << endl; ok = test_serialize()               && ok; cout << endl << endl;
 
   value_ptr<Base[2]> vb = new Base[2]();
   cout << "RESET BEGIN" << endl;
@@ -171,6 +1651,6 @@ int main(int argc, char *argv[]) {
 
   // ---------------------------------------------------------------------------
 
-  return 0;
+  return ok ? 0 : 1;
 }
 
@@ -5,14 +5,166 @@
 #include <type_traits>
 #include <cstddef>
 #include <memory>
-#include <tuple>
+#include <utility>
 
 #include "Handler.h"
 
 
+/**
+ * Internal state of a value_ptr, holding a pointer and a handler
+ *
+ * Empty (non-final) handlers are stored as a base class, so that they take
+ * up no room at all (by virtue of the empty base optimization); any other
+ * handler (or reference to one) is stored as a member.
+ *
+ * Accessors are always inlined, so that they stay cheap in unoptimized
+ * builds.
+ *
+ * @param P  Pointer type
+ * @param H  Handler type
+ * @param compress  Whether to store the handler as a base class (defaults to automatic detection)
+ */
+template <typename P, typename H, bool compress = std::is_empty<H>::value && !std::is_final<H>::value>
+struct value_ptr_state;
+
+/**
+ * Specialization of value_ptr_state for empty handlers
+ *
+ */
+template <typename P, typename H>
+struct value_ptr_state<P, H, true> : private H {
+  /**
+   * Constructor
+   *
+   * @param p  Pointer to hold
+   * @param h  Handler to initialize from
+   */
+  template <typename H2> constexpr value_ptr_state(P p, H2 &&h);
+
+  /**
+   * Get a modifiable reference to the handler
+   *
+   * @return a reference to the handler
+   */
+  constexpr H &handler() noexcept __attribute__((always_inline, const));
+
+  /**
+   * Get an unmodifiable reference to the handler
+   *
+   * @return a const reference to the handler
+   */
+  constexpr H const &handler() const noexcept __attribute__((always_inline, const));
+
+  /**
+   * Swap pointers and handlers with another state
+   *
+   * @param other  State to swap with
+   */
+  constexpr void swap(value_ptr_state &other) noexcept;
+
+  /**
+   * Pointer held
+   *
+   */
+  P pointer;
+};
+
+/**
+ * Specialization of value_ptr_state for stateful handlers and handler references
+ *
+ */
+template <typename P, typename H>
+struct value_ptr_state<P, H, false> {
+  /**
+   * Constructor
+   *
+   * @param p  Pointer to hold
+   * @param h  Handler to initialize from
+   */
+  template <typename H2> constexpr value_ptr_state(P p, H2 &&h);
+
+  /**
+   * Get a modifiable reference to the handler
+   *
+   * @return a reference to the handler
+   */
+  constexpr typename std::add_lvalue_reference<H>::type handler() noexcept __attribute__((always_inline, pure));
+
+  /**
+   * Get an unmodifiable reference to the handler
+   *
+   * @return a const reference to the handler
+   */
+  constexpr typename std::add_lvalue_reference<typename std::add_const<H>::type>::type handler() const noexcept __attribute__((always_inline, pure));
+
+  /**
+   * Swap pointers and handlers with another state
+   *
+   * @param other  State to swap with
+   */
+  constexpr void swap(value_ptr_state &other) noexcept;
+
+  /**
+   * Pointer held
+   *
+   */
+  P pointer;
+
+  /**
+   * Padding up to the handler's alignment (for over-aligned handlers)
+   *
+   */
+  [[no_unique_address]] explicit_padding<padding_to<sizeof(P), alignof(typename std::conditional<std::is_reference<H>::value, void *, H>::type)>::value> padding;
+
+  /**
+   * Handler held
+   *
+   */
+  H held;
+};
+
+
+/**
+ * Tag type selecting in-place construction of a value_ptr's pointee
+ *
+ */
+struct value_in_place_t {
+  explicit value_in_place_t() = default;
+};
+
+/**
+ * Tag selecting in-place construction of a value_ptr's pointee
+ *
+ */
+constexpr value_in_place_t value_in_place{};
+
+/**
+ * Tag type selecting in-place construction of a value_ptr's pointee as a given type
+ *
+ * @param T  Type of the pointee to construct
+ */
+template <typename T>
+struct value_in_place_type_t {
+  explicit value_in_place_type_t() = default;
+};
+
+/**
+ * Tag selecting in-place construction of a value_ptr's pointee as a given type
+ *
+ * @param T  Type of the pointee to construct
+ */
+template <typename T>
+constexpr value_in_place_type_t<T> value_in_place_type{};
+
+
 /**
  * Smart pointer with value-like semantics
  *
+ * Every member is constexpr: with default_handler (or any handler whose
+ * methods are constexpr themselves), value_ptrs to scalars and to arrays of
+ * known bound may be created, copied, assigned and destroyed during
+ * constant evaluation, and null value_ptrs may be constinit.
+ *
  * @param T  Underlying type to wrap
  * @param H  Handler type to use
  */
@@ -25,7 +177,9 @@ class value_ptr {
      */
     using element_type          = typename std::remove_extent<T>::type;
     using pointer_type          = element_type *;
+    using const_pointer_type    = element_type const *;
     using reference_type        = element_type &;
+    using const_reference_type  = element_type const &;
     using lvalue_reference_type = element_type &&;
 
     /**
@@ -39,19 +193,18 @@ class value_ptr {
 
   protected:
     /**
-     * The internal state will consist of a tuple of:
+     * The internal state will consist of:
      *  - a pointer to the underlying type
-     *  - a replicator
-     *  - a deleter
+     *  - a handler (taking up no room if empty)
      *
      */
-    using tuple_type = std::tuple<pointer_type, handler_type>;
+    using state_type = value_ptr_state<pointer_type, handler_type>;
 
     /**
      * This is just a trick to provide safe bool conversion
      *
      */
-    using __unspecified_bool_type = tuple_type value_ptr::*;
+    using __unspecified_bool_type = state_type value_ptr::*;
 
     /**
      * Convenience alias used to enable only if we're serving a different type.
@@ -100,8 +253,10 @@ class value_ptr {
     /**
      * Copy constructor
      *
-     * Initializes using the to-be-copied replicator, delegating to the
-     * "master" constructor below.
+     * Initializes a copy of the to-be-copied handler, delegating to the
+     * "master" constructor below, and then replicates the other object's
+     * pointee through it (so that handlers providing their own storage may
+     * replicate into it).
      *
      * @param other  Object to copy
      */
@@ -110,8 +265,9 @@ class value_ptr {
     /**
      * Move constructor
      *
-     * Initializes using the release()'d pointer, delegating to the
-     * "master" constructor below.
+     * Initializes using the moved handler, delegating to the "master"
+     * constructor below, and then takes over the other object's pointer,
+     * allowing the handler to relocate it.
      *
      * @param other  Object to move
      */
@@ -139,11 +295,13 @@ class value_ptr {
      * there exists an implicit conversion for the replicator and deleter
      * types; in all other respects it behaves like the above move constructor.
      *
-     * It delegates construction to the "master constructor" below.
+     * It delegates construction to the "master constructor" below, taking
+     * the pointee through other's release() (hence it is only noexcept if
+     * the latter is).
      *
      * @param other  Object to move
      */
-    template <typename T2, typename H2> constexpr value_ptr(typename enable_if_different<T2, value_ptr<T2, H2>>::type &&other) noexcept;
+    template <typename T2, typename H2> constexpr value_ptr(typename enable_if_different<T2, value_ptr<T2, H2>>::type &&other) noexcept(noexcept(std::declval<value_ptr<T2, H2> &>().release()));
 
     /**
      * Ownership taking initializing constructors
@@ -154,7 +312,8 @@ class value_ptr {
      *
      * Note the use of "universal references" and perfect forwarding.
      *
-     * They delegate construction to the "master constructor" below.
+     * They delegate construction to the "master constructor" below, and then
+     * let the handler know the static type of the adopted pointee.
      *
      * @param p  Pointer to take ownership of
      * @param h  Handler to use
@@ -265,6 +424,28 @@ class value_ptr {
     template <typename T2> constexpr value_ptr(std::weak_ptr<T2> const &p) noexcept;
     template <typename T2, typename H2> constexpr value_ptr(std::weak_ptr<T2> const &p, H2&& h) noexcept;
 
+    /**
+     * In-place constructors
+     *
+     * These constructors have a default constructed handler construct the
+     * pointee from the given arguments, either as a T or as the given T2
+     * (which must then be derived from T); for array types, the sole
+     * argument is the number of elements for open arrays, and there is none
+     * for fixed ones, elements being value-initialized.
+     *
+     * Allocation and construction are performed in a single step by the
+     * handler's "construct" method (so that handlers providing their own
+     * storage may construct into it), or by a plain new expression followed
+     * by adoption for handlers lacking one: no raw pointer is ever exposed.
+     *
+     * They delegate construction to the "master constructor" below.
+     *
+     * @param <unnamed>  In-place construction tag
+     * @param args  Arguments to construct the pointee from
+     */
+    template <typename... Args> constexpr explicit value_ptr(value_in_place_t, Args&&... args);
+    template <typename T2, typename... Args> constexpr explicit value_ptr(value_in_place_type_t<T2>, Args&&... args);
+
     /**
      * Nullptr assignment operator
      *
@@ -274,17 +455,37 @@ class value_ptr {
      * @param <unnamed>  Nullptr to assign
      * @return the assigned object
      */
-    value_ptr &operator=(nullptr_t) noexcept;
+    constexpr value_ptr &operator=(nullptr_t) noexcept;
 
     /**
      * Copy-assignment operator
      *
-     * This copy-assignment operator DOES NOT implement the "copy and swap" idiom ON PURPOSE (ambiguous declarations otherwise).
+     * If both objects hold a pointee and the handler provides an "assign"
+     * method that accepts them (eg. same dynamic type, or arrays of equal
+     * length), the pointee is copy-assigned into the existing storage and no
+     * allocation takes place (the current handler is kept in this case).
+     * Otherwise, a single replica of the other object's pointee is created and
+     * moved in, along with a copy of its handler.
+     *
+     * If the in-place assignment throws, the handler will have disposed of the
+     * current pointee, and this object is left holding nullptr.
      *
      * @param other  Object to copy-assign
      * @return the assigned object
      */
-    value_ptr &operator=(value_ptr other);
+    constexpr value_ptr &operator=(value_ptr const &other);
+
+    /**
+     * Move-assignment operator
+     *
+     * This move-assignment operator destroys the currently held pointee (if
+     * any) and merely transfers the other object's pointer and handler, no
+     * replication ever takes place.
+     *
+     * @param other  Object to move-assign
+     * @return the assigned object
+     */
+    constexpr value_ptr &operator=(value_ptr &&other) noexcept;
 
     /**
      * Templated move-assignment operator
@@ -295,7 +496,7 @@ class value_ptr {
      * @param other  Object to move-assign
      * @return the assigned object
      */
-    template <typename T2, typename H2> typename enable_if_different<T2, typename enable_if_compatible<T2, value_ptr &>::type>::type operator=(value_ptr<T2, H2> &&other);
+    template <typename T2, typename H2> constexpr typename enable_if_different<T2, typename enable_if_compatible<T2, value_ptr &>::type>::type operator=(value_ptr<T2, H2> &&other);
 
     /**
      * Safe bool conversion operator
@@ -303,15 +504,16 @@ class value_ptr {
      * This operator implements a safe bool conversion.
      *
      */
-    constexpr operator __unspecified_bool_type() const noexcept __attribute__((pure));
+    constexpr operator __unspecified_bool_type() const noexcept __attribute__((always_inline, pure));
 
     /**
-     * Virtual destructor
+     * Destructor
      *
-     * The destructor merely resets the object.
+     * The destructor merely resets the object; it is not virtual, so that
+     * value_ptrs with empty handlers are exactly pointer-sized.
      *
      */
-    virtual ~value_ptr() noexcept;
+    constexpr ~value_ptr() noexcept;
 
     /**
      * Const-reference operator[]
@@ -327,7 +529,7 @@ class value_ptr {
      * @param i  Index to retrieve
      * @return a reference to the i-th entry in the array
      */
-    template <typename U = T> constexpr typename enable_if_array<U, lvalue_reference_type>::type operator[](std::size_t i) const;
+    template <typename U = T> constexpr typename enable_if_array<U, reference_type>::type operator[](std::size_t i) const __attribute__((always_inline));
 
     /**
      * Non-const reference operator[]
@@ -343,78 +545,281 @@ class value_ptr {
      * @param i  Index to retrieve
      * @return a reference to the i-th entry in the array
      */
-    template <typename U = T> typename enable_if_array<U, reference_type>::type operator[](std::size_t i) __attribute__((const));
+    template <typename U = T> constexpr typename enable_if_array<U, reference_type>::type operator[](std::size_t i) __attribute__((always_inline));
 
     /**
      * Get the pointed-to object
      *
      * @return the pointed-to object as a reference
      */
-    constexpr reference_type operator*() const;
+    constexpr reference_type operator*() const __attribute__((always_inline));
 
     /**
      * Get the current pointer
      *
      * @return the pointer being held
      */
-    constexpr pointer_type operator->() const noexcept;
+    constexpr pointer_type operator->() const noexcept __attribute__((always_inline));
+
+    /**
+     * Return the pointer part of the internal state, ready for mutation
+     *
+     * If the handler provides a "detach" method, it is given the chance to
+     * replace the pointee with an unshared one first.
+     *
+     * @return the current (possibly detached) pointer
+     */
+    constexpr pointer_type mutable_get() __attribute__((always_inline));
 
     /**
      * Return the pointer part of the internal state
      *
      * @return the current pointer
      */
-    constexpr pointer_type get() const noexcept;
+    constexpr pointer_type get() const noexcept __attribute__((always_inline, pure));
 
     /**
      * Get a modifiable reference to the current handler
      *
      * @return a reference to the current handler
      */
-    handler_reference get_handler() noexcept __attribute__((const));
+    constexpr handler_reference get_handler() noexcept __attribute__((always_inline, const));
 
     /**
      * Get an unmodifiable reference to the current handler
      *
      * @return a const reference to the current handler
      */
-    constexpr handler_const_reference get_handler() const noexcept;
+    constexpr handler_const_reference get_handler() const noexcept __attribute__((always_inline, const));
 
     /**
      * Release ownership of the current pointer and reset it to nullptr
      *
+     * If the handler provides a "release" method, it is given the chance to
+     * move the pointee out of any storage of its own first; this is only
+     * noexcept if that method is. Should it throw, the value_ptr keeps
+     * owning its pointee.
+     *
      * @return the previously owned pointer
      */
-    pointer_type release() noexcept;
+    constexpr pointer_type release() noexcept(noexcept(handlerRelease(std::declval<handler_reference>(), pointer_type(), 0)));
 
     /**
      * Reset the internal pointer to the given value (nullptr, by default)
      *
      * @param p  New value to acquire
      */
-    void reset(pointer_type p = pointer_type()) noexcept;
+    constexpr void reset(pointer_type p = pointer_type()) noexcept;
 
     /**
      * Swap the internal state with a compatible value_ptr
      *
      * @param other  The value_ptr to swap values with
      */
-    template <typename T2, typename H2> typename enable_if_compatible<T2, void>::type swap(value_ptr<T2, H2> &other) noexcept;
+    template <typename T2, typename H2> constexpr typename enable_if_compatible<T2, void>::type swap(value_ptr<T2, H2> &other) noexcept;
 
     /**
      * Swap the internal state with a compatible value_ptr (rvalue overload)
      *
      * @param other  The value_ptr to swap values with
      */
-    template <typename T2, typename H2> typename enable_if_compatible<T2, void>::type swap(value_ptr<T2, H2> &&other) noexcept;
+    template <typename T2, typename H2> constexpr typename enable_if_compatible<T2, void>::type swap(value_ptr<T2, H2> &&other) noexcept;
+
+    /**
+     * Deep-copy the pointee into a value_ptr allocating from the given memory resource
+     *
+     * The copy's handler is built from this value_ptr's handler and the
+     * given resource, which the handler must thus support (as eg.
+     * resource_handler and pmr_handler do); the copy then replicates the
+     * pointee through it, so that the pointee (and, for arrays, every
+     * element) lives in the given resource.
+     *
+     * @param resource  Memory resource the copy is to allocate from
+     * @return a value_ptr holding a copy of the pointee
+     */
+    template <typename R> value_ptr clone_into(R *resource) const;
 
   protected:
+    /**
+     * Relinquish the current pointer without involving the handler
+     *
+     * @return the previously owned pointer
+     */
+    constexpr pointer_type yield() noexcept;
+
+    /**
+     * Swap the internal state with a value_ptr whose handler may relocate pointees
+     *
+     * This overload is only viable if the handler does provide a "relocate"
+     * method, in which case the swap is performed by means of three moves.
+     *
+     * @param other  The value_ptr to swap values with
+     * @param <unnamed>  int parameter to use for overload prioritization
+     */
+    template <typename V, typename H2 = handler_type> constexpr auto swapState(V &other, int) noexcept -> decltype(std::declval<H2 &>().relocate(other.get_handler(), pointer_type()), void());
+
+    /**
+     * Swap the internal state with a value_ptr by swapping the internal states
+     *
+     * @param other  The value_ptr to swap values with
+     * @param <unnamed>  long parameter to use for overload prioritization
+     */
+    template <typename V> constexpr void swapState(V &other, long) noexcept;
+
+    /**
+     * Let the handler know the static type of a newly adopted pointee using its "adopt" method
+     *
+     * This overload is only viable if the handler does provide an "adopt"
+     * method.
+     *
+     * @param h  Handler to use
+     * @param p  Pointer to the adopted pointee
+     * @param <unnamed>  int parameter to use for overload prioritization
+     */
+    template <typename H2, typename T2> static constexpr auto handlerAdopt(H2 &h, T2 const *p, int) -> decltype(h.adopt(p));
+
+    /**
+     * Fallback for handlers lacking an "adopt" method
+     *
+     * @param <unnamed>  Handler to use
+     * @param <unnamed>  Pointer to the adopted pointee
+     * @param <unnamed>  long parameter to use for overload prioritization
+     */
+    template <typename H2, typename T2> static constexpr void handlerAdopt(H2 &, T2 const *, long) noexcept;
+
+    /**
+     * Construct a new pointee using the handler's "construct" method
+     *
+     * This overload is only viable if the handler does provide a "construct"
+     * method.
+     *
+     * @param T2  Type of the pointee to construct
+     * @param h  Handler to use
+     * @param <unnamed>  int parameter to use for overload prioritization
+     * @param args  Arguments to construct the pointee from
+     * @return a pointer to the new pointee
+     */
+    template <typename T2, typename H2, typename... Args> static constexpr auto handlerConstruct(H2 &h, int, Args&&... args) -> decltype(h.template construct<T2>(std::forward<Args>(args)...));
+
+    /**
+     * Fallback for handlers lacking a "construct" method
+     *
+     * Constructs the pointee by a plain new expression and lets the handler
+     * adopt it, deleting it should that throw.
+     *
+     * @param T2  Type of the pointee to construct
+     * @param h  Handler to use
+     * @param <unnamed>  long parameter to use for overload prioritization
+     * @param args  Arguments to construct the pointee from
+     * @return a pointer to the new pointee
+     */
+    template <typename T2, typename H2, typename... Args> static constexpr typename std::remove_extent<T2>::type *handlerConstruct(H2 &h, long, Args&&... args);
+
+    /**
+     * Take over a pointer owned by another handler using the handler's "relocate" method
+     *
+     * This overload is only viable if the handler does provide a "relocate"
+     * method.
+     *
+     * @param h  Handler to use
+     * @param from  Handler the pointer is being taken from
+     * @param p  Pointer to take over
+     * @param <unnamed>  int parameter to use for overload prioritization
+     * @return the pointer to use from now on
+     */
+    template <typename H2> static constexpr auto handlerRelocate(H2 &h, H2 &from, pointer_type p, int) -> decltype(h.relocate(from, p));
+
+    /**
+     * Fallback for handlers lacking a "relocate" method
+     *
+     * @param <unnamed>  Handler to use
+     * @param <unnamed>  Handler the pointer is being taken from
+     * @param p  Pointer to take over
+     * @param <unnamed>  long parameter to use for overload prioritization
+     * @return the given pointer
+     */
+    template <typename H2> static constexpr pointer_type handlerRelocate(H2 &, H2 &, pointer_type p, long) noexcept __attribute__((const));
+
+    /**
+     * Hand out a pointer no longer bound to the handler using its "release" method
+     *
+     * This overload is only viable if the handler does provide a "release"
+     * method.
+     *
+     * @param h  Handler to use
+     * @param p  Pointer to release
+     * @param <unnamed>  int parameter to use for overload prioritization
+     * @return a pointer the caller may take ownership of
+     */
+    template <typename H2> static constexpr auto handlerRelease(H2 &h, pointer_type p, int) -> decltype(h.release(p));
+
+    /**
+     * Fallback for handlers lacking a "release" method
+     *
+     * @param <unnamed>  Handler to use
+     * @param p  Pointer to release
+     * @param <unnamed>  long parameter to use for overload prioritization
+     * @return the given pointer
+     */
+    template <typename H2> static constexpr pointer_type handlerRelease(H2 &, pointer_type p, long) noexcept __attribute__((const));
+
+    /**
+     * Obtain an unshared pointee using the handler's "detach" method
+     *
+     * This overload is only viable if the handler does provide a "detach"
+     * method.
+     *
+     * @param h  Handler to use
+     * @param p  Pointer to the (possibly shared) pointee
+     * @param <unnamed>  int parameter to use for overload prioritization
+     * @return a pointer to an unshared pointee
+     */
+    template <typename H2> static constexpr auto handlerDetach(H2 &h, pointer_type p, int) -> decltype(h.detach(p));
+
+    /**
+     * Fallback for handlers lacking a "detach" method
+     *
+     * @param <unnamed>  Handler to use
+     * @param p  Pointer to the pointee
+     * @param <unnamed>  long parameter to use for overload prioritization
+     * @return the given pointer
+     */
+    template <typename H2> static constexpr pointer_type handlerDetach(H2 &, pointer_type p, long) noexcept __attribute__((always_inline, const));
+
+    /**
+     * Copy-assign the given pointee into the given storage using the handler's "assign" method
+     *
+     * This overload is only viable if the handler does provide an "assign"
+     * method.
+     *
+     * @param h  Handler to use
+     * @param p  Pointer to the storage to assign to
+     * @param q  Pointer to the object to assign from
+     * @param <unnamed>  int parameter to use for overload prioritization
+     * @return whether the assignment could be performed in place
+     */
+    template <typename H2> static constexpr auto handlerAssign(H2 &h, pointer_type p, element_type const *q, int) -> decltype(h.assign(p, q));
+
+    /**
+     * Fallback for handlers lacking an "assign" method
+     *
+     * @param <unnamed>  Handler to use
+     * @param <unnamed>  Pointer to the storage to assign to
+     * @param <unnamed>  Pointer to the object to assign from
+     * @param <unnamed>  long parameter to use for overload prioritization
+     * @return false, always
+     */
+    template <typename H2> static constexpr bool handlerAssign(H2 &, pointer_type, element_type const *, long) noexcept __attribute__((const));
+
     /**
      * Construct a new value_ptr with the given arguments and perform sanity checks
      *
      * The sanity checks performed are:
      * - if the pointed-to type is polymorphic, the replicator must use clone,
-     * - if the handler type is a reference, it cannot be initialized with a temporary.
+     * - if the handler type is a reference, it cannot be initialized with a temporary,
+     * - the handler type must be nothrow move-assignable,
+     * - value_ptr must be nothrow move-constructible and move-assignable,
+     * - value_ptr must be pointer-sized if the handler type is empty.
      *
      *
      * @param p  Pointer to take ownership of
@@ -428,7 +833,10 @@ class value_ptr {
      *
      * The sanity checks performed are:
      * - if the pointed-to type is polymorphic, the replicator must use clone,
-     * - if the handler type is a reference, it cannot be initialized with a temporary.
+     * - if the handler type is a reference, it cannot be initialized with a temporary,
+     * - the handler type must be nothrow move-assignable,
+     * - value_ptr must be nothrow move-constructible and move-assignable,
+     * - value_ptr must be pointer-sized if the handler type is empty.
      *
      *
      * @param <unnamed>  Nullptr to use
@@ -438,10 +846,10 @@ class value_ptr {
     template <typename H2> constexpr value_ptr(nullptr_t, H2&& h, nullptr_t) noexcept;
 
     /**
-     * Internal state, holding a pointer, a replicator and a deleter
+     * Internal state, holding a pointer and a handler
      *
      */
-    tuple_type c;
+    state_type c;
 };
 
 
@@ -451,20 +859,35 @@ class value_ptr {
  * @param x  First value_ptr to swap
  * @param y  Second value_ptr to swap
  */
-template <class T, class H> inline void swap(value_ptr<T, H> &x, value_ptr<T, H> &y) noexcept;
+template <class T, class H> constexpr void swap(value_ptr<T, H> &x, value_ptr<T, H> &y) noexcept;
+
+/**
+ * Create a value_ptr whose pointee is constructed in place from the given arguments
+ *
+ * For array types, the sole argument is the number of elements for open
+ * arrays, and there is none for fixed ones, elements being
+ * value-initialized.
+ *
+ * @param T  Type of the pointee to construct
+ * @param H  Handler type to use
+ * @param args  Arguments to construct the pointee from
+ * @return a value_ptr owning the new pointee
+ */
+template <class T, class H = default_handler<T>, class... Args> constexpr value_ptr<T, H> make_value(Args&&... args);
 
 /**
  * Equality and difference operator overloads for arbitrary value_ptrs
  *
- * Equality is determined by pointer value.
+ * Equality is determined by pointer value; see value_compare (in Compare.h) for
+ * comparison by pointee.
  *
  *
  * @param x  First value_ptr to compare
  * @param y  Second value_ptr to compare
  * @return the comparison result
  */
-template <class T1, class H1, class T2, class H2> inline bool operator==(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
-template <class T1, class H1, class T2, class H2> inline bool operator!=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
+template <class T1, class H1, class T2, class H2> constexpr bool operator==(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
+template <class T1, class H1, class T2, class H2> constexpr bool operator!=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
 
 /**
  * Equality and difference operator overloads for value_ptrs vs nullptr_t
@@ -476,25 +899,26 @@ template <class T1, class H1, class T2, class H2> inline bool operator!=(value_p
  * @param y  Second nullptr_t (value_ptr) to compare
  * @return the comparison result
  */
-template <class T, class H> inline bool operator==(value_ptr<T, H> const &x, nullptr_t y);
-template <class T, class H> inline bool operator!=(value_ptr<T, H> const &x, nullptr_t y);
-template <class T, class H> inline bool operator==(nullptr_t x, value_ptr<T, H> const &y);
-template <class T, class H> inline bool operator!=(nullptr_t x, value_ptr<T, H> const &y);
+template <class T, class H> constexpr bool operator==(value_ptr<T, H> const &x, nullptr_t y);
+template <class T, class H> constexpr bool operator!=(value_ptr<T, H> const &x, nullptr_t y);
+template <class T, class H> constexpr bool operator==(nullptr_t x, value_ptr<T, H> const &y);
+template <class T, class H> constexpr bool operator!=(nullptr_t x, value_ptr<T, H> const &y);
 
 /**
  * Comparison operators overloads for arbitrary value_ptrs
  *
- * Comparison is determined by pointer value.
+ * Comparison is determined by pointer value; see value_compare (in Compare.h) for
+ * comparison by pointee.
  *
  *
  * @param x  First value_ptr to compare
  * @param y  Second value_ptr to compare
  * @return the comparison result
  */
-template <class T1, class H1, class T2, class H2> inline bool operator< (value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
-template <class T1, class H1, class T2, class H2> inline bool operator> (value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
-template <class T1, class H1, class T2, class H2> inline bool operator<=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
-template <class T1, class H1, class T2, class H2> inline bool operator>=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
+template <class T1, class H1, class T2, class H2> constexpr bool operator< (value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
+template <class T1, class H1, class T2, class H2> constexpr bool operator> (value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
+template <class T1, class H1, class T2, class H2> constexpr bool operator<=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
+template <class T1, class H1, class T2, class H2> constexpr bool operator>=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y);
 
 
 #include "value_ptr.hpp"
@@ -7,6 +7,76 @@
 #include <functional>
 
 
+/**
+ * Constructor
+ *
+ * @param p  Pointer to hold
+ * @param h  Handler to initialize from
+ */
+template <typename P, typename H>
+template <typename H2>
+constexpr value_ptr_state<P, H, true>::value_ptr_state(P p, H2 &&h) : H(std::forward<H2>(h)), pointer(p) {}
+
+/**
+ * Get a modifiable reference to the handler
+ *
+ * @return a reference to the handler
+ */
+template <typename P, typename H>
+constexpr H &value_ptr_state<P, H, true>::handler() noexcept { return *this; }
+
+/**
+ * Get an unmodifiable reference to the handler
+ *
+ * @return a const reference to the handler
+ */
+template <typename P, typename H>
+constexpr H const &value_ptr_state<P, H, true>::handler() const noexcept { return *this; }
+
+/**
+ * Swap pointers and handlers with another state
+ *
+ * @param other  State to swap with
+ */
+template <typename P, typename H>
+constexpr void value_ptr_state<P, H, true>::swap(value_ptr_state<P, H, true> &other) noexcept { using std::swap; swap(pointer, other.pointer); swap(handler(), other.handler()); }
+
+/**
+ * Constructor
+ *
+ * @param p  Pointer to hold
+ * @param h  Handler to initialize from
+ */
+template <typename P, typename H>
+template <typename H2>
+constexpr value_ptr_state<P, H, false>::value_ptr_state(P p, H2 &&h) : pointer(p), padding(), held(std::forward<H2>(h)) {}
+
+/**
+ * Get a modifiable reference to the handler
+ *
+ * @return a reference to the handler
+ */
+template <typename P, typename H>
+constexpr typename std::add_lvalue_reference<H>::type value_ptr_state<P, H, false>::handler() noexcept { return held; }
+
+/**
+ * Get an unmodifiable reference to the handler
+ *
+ * @return a const reference to the handler
+ */
+template <typename P, typename H>
+constexpr typename std::add_lvalue_reference<typename std::add_const<H>::type>::type value_ptr_state<P, H, false>::handler() const noexcept { return held; }
+
+/**
+ * Swap pointers and handlers with another state
+ *
+ * @param other  State to swap with
+ */
+template <typename P, typename H>
+constexpr void value_ptr_state<P, H, false>::swap(value_ptr_state<P, H, false> &other) noexcept { using std::swap; swap(pointer, other.pointer); swap(held, other.held); }
+
+
+
 /**
  * Default constructor
  *
@@ -19,24 +89,27 @@ constexpr value_ptr<T, H>::value_ptr() noexcept : value_ptr<T, H>{pointer_type()
 /**
  * Copy constructor
  *
- * Initializes using the to-be-copied replicator, delegating to the
- * "master" constructor below.
+ * Initializes a copy of the to-be-copied handler, delegating to the
+ * "master" constructor below, and then replicates the other object's
+ * pointee through it (so that handlers providing their own storage may
+ * replicate into it).
  *
  * @param other  Object to copy
  */
 template <typename T, typename H>
-constexpr value_ptr<T, H>::value_ptr(value_ptr<T, H> const &other) noexcept : value_ptr<T, H>{other.get_handler().replicate(other.get()), other.get_handler(), nullptr} {}
+constexpr value_ptr<T, H>::value_ptr(value_ptr<T, H> const &other) noexcept : value_ptr<T, H>{pointer_type(), other.get_handler(), nullptr} { c.pointer = get_handler().replicate(other.get()); }
 
 /**
  * Move constructor
  *
- * Initializes using the release()'d pointer, delegating to the
- * "master" constructor below.
+ * Initializes using the moved handler, delegating to the "master"
+ * constructor below, and then takes over the other object's pointer,
+ * allowing the handler to relocate it.
  *
  * @param other  Object to move
  */
 template <typename T, typename H>
-constexpr value_ptr<T, H>::value_ptr(value_ptr<T, H> &&other) noexcept : value_ptr<T, H>{other.release(), std::move(other.get_handler()), nullptr} {}
+constexpr value_ptr<T, H>::value_ptr(value_ptr<T, H> &&other) noexcept : value_ptr<T, H>{pointer_type(), std::move(other.get_handler()), nullptr} { c.pointer = handlerRelocate(get_handler(), other.get_handler(), other.yield(), 0); }
 
 /**
  * Templated copy constructor
@@ -62,13 +135,15 @@ constexpr value_ptr<T, H>::value_ptr(typename value_ptr<T, H>::template enable_i
  * there exists an implicit conversion for the replicator and deleter
  * types; in all other respects it behaves like the above move constructor.
  *
- * It delegates construction to the "master constructor" below.
+ * It delegates construction to the "master constructor" below, taking
+ * the pointee through other's release() (hence it is only noexcept if
+ * the latter is).
  *
  * @param other  Object to move
  */
 template <typename T, typename H>
 template <typename T2, typename H2>
-constexpr value_ptr<T, H>::value_ptr(typename value_ptr<T, H>::template enable_if_different<T2, value_ptr<T2, H2>>::type &&other) noexcept : value_ptr<T, H>{other.release(), std::move(other.get_handler()), nullptr} {}
+constexpr value_ptr<T, H>::value_ptr(typename value_ptr<T, H>::template enable_if_different<T2, value_ptr<T2, H2>>::type &&other) noexcept(noexcept(std::declval<value_ptr<T2, H2> &>().release())) : value_ptr<T, H>{other.release(), std::move(other.get_handler()), nullptr} {}
 
 /**
  * Ownership taking initializing constructors
@@ -79,17 +154,18 @@ constexpr value_ptr<T, H>::value_ptr(typename value_ptr<T, H>::template enable_i
  *
  * Note the use of "universal references" and perfect forwarding.
  *
- * They delegate construction to the "master constructor" below.
+ * They delegate construction to the "master constructor" below, and then
+ * let the handler know the static type of the adopted pointee.
  *
  * @param p  Pointer to take ownership of
  * @param h  Handler to use
  */
 template <typename T, typename H>
 template <typename T2>
-constexpr value_ptr<T, H>::value_ptr(T2 *p) noexcept : value_ptr<T, H>{p, handler_type(), nullptr} {}
+constexpr value_ptr<T, H>::value_ptr(T2 *p) noexcept : value_ptr<T, H>{p, handler_type(), nullptr} { if (nullptr != p) { handlerAdopt(get_handler(), p, 0); } }
 template <typename T, typename H>
 template <typename T2, typename H2>
-constexpr value_ptr<T, H>::value_ptr(T2 *p, H2&& h) noexcept : value_ptr<T, H>{p, std::forward<H2>(h), nullptr} {}
+constexpr value_ptr<T, H>::value_ptr(T2 *p, H2&& h) noexcept : value_ptr<T, H>{p, std::forward<H2>(h), nullptr} { if (nullptr != p) { handlerAdopt(get_handler(), p, 0); } }
 
 /**
  * Nullptr constructors
@@ -221,6 +297,35 @@ template <typename T, typename H>
 template <typename T2, typename H2>
 constexpr value_ptr<T, H>::value_ptr(std::weak_ptr<T2> const &p, H2&& h) noexcept : value_ptr<T, H>{p.lock(), std::forward<H2>(h)} {}
 
+/**
+ * In-place constructors
+ *
+ * These constructors have a default constructed handler construct the
+ * pointee from the given arguments, either as a T or as the given T2
+ * (which must then be derived from T); for array types, the sole
+ * argument is the number of elements for open arrays, and there is none
+ * for fixed ones, elements being value-initialized.
+ *
+ * Allocation and construction are performed in a single step by the
+ * handler's "construct" method (so that handlers providing their own
+ * storage may construct into it), or by a plain new expression followed
+ * by adoption for handlers lacking one: no raw pointer is ever exposed.
+ *
+ * They delegate construction to the "master constructor" below.
+ *
+ * @param <unnamed>  In-place construction tag
+ * @param args  Arguments to construct the pointee from
+ */
+template <typename T, typename H>
+template <typename... Args>
+constexpr value_ptr<T, H>::value_ptr(value_in_place_t, Args&&... args) : value_ptr<T, H>{value_in_place_type<T>, std::forward<Args>(args)...} {}
+template <typename T, typename H>
+template <typename T2, typename... Args>
+constexpr value_ptr<T, H>::value_ptr(value_in_place_type_t<T2>, Args&&... args) : value_ptr<T, H>{nullptr, handler_type(), nullptr} {
+  static_assert(std::is_same<T, T2>::value || (0 == std::rank<T>::value && std::is_convertible<T2 *, pointer_type>::value), "incompatible in-place type");
+  c.pointer = handlerConstruct<T2>(get_handler(), 0, std::forward<Args>(args)...);
+}
+
 /**
  * Nullptr assignment operator
  *
@@ -231,19 +336,61 @@ constexpr value_ptr<T, H>::value_ptr(std::weak_ptr<T2> const &p, H2&& h) noexcep
  * @return the assigned object
  */
 template <typename T, typename H>
-value_ptr<T, H> &value_ptr<T, H>::operator=(nullptr_t) noexcept { reset(); return *this; }
+constexpr value_ptr<T, H> &value_ptr<T, H>::operator=(nullptr_t) noexcept { reset(); return *this; }
 
 /**
  * Copy-assignment operator
  *
- * This copy-assignment operator DOES NOT implement the "copy and swap" idiom ON PURPOSE (ambiguous declarations otherwise).
+ * If both objects hold a pointee and the handler provides an "assign"
+ * method that accepts them (eg. same dynamic type, or arrays of equal
+ * length), the pointee is copy-assigned into the existing storage and no
+ * allocation takes place (the current handler is kept in this case).
+ * Otherwise, a single replica of the other object's pointee is created and
+ * moved in, along with a copy of its handler.
+ *
+ * If the in-place assignment throws, the handler will have disposed of the
+ * current pointee, and this object is left holding nullptr.
  *
  * @param other  Object to copy-assign
  * @return the assigned object
  */
 template <typename T, typename H>
-value_ptr<T, H> &value_ptr<T, H>::operator=(value_ptr<T, H> other) {
-  swap(value_ptr<T, H>(other));
+constexpr value_ptr<T, H> &value_ptr<T, H>::operator=(value_ptr<T, H> const &other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  bool assigned;
+  try {
+    assigned = nullptr != get() && nullptr != other.get() && handlerAssign(get_handler(), get(), other.get(), 0);
+  } catch (...) {
+    yield();
+    throw;
+  }
+
+  if (!assigned) {
+    *this = value_ptr<T, H>(other);
+  }
+  return *this;
+}
+
+/**
+ * Move-assignment operator
+ *
+ * This move-assignment operator destroys the currently held pointee (if
+ * any) and merely transfers the other object's pointer and handler, no
+ * replication ever takes place.
+ *
+ * @param other  Object to move-assign
+ * @return the assigned object
+ */
+template <typename T, typename H>
+constexpr value_ptr<T, H> &value_ptr<T, H>::operator=(value_ptr<T, H> &&other) noexcept {
+  if (this != &other) {
+    reset();
+    get_handler() = std::move(other.get_handler());
+    c.pointer = handlerRelocate(get_handler(), other.get_handler(), other.yield(), 0);
+  }
   return *this;
 }
 
@@ -258,7 +405,7 @@ value_ptr<T, H> &value_ptr<T, H>::operator=(value_ptr<T, H> other) {
  */
 template <typename T, typename H>
 template <typename T2, typename H2>
-typename value_ptr<T, H>::template enable_if_different<T2, typename value_ptr<T, H>::template enable_if_compatible<T2, value_ptr<T, H> &>::type>::type value_ptr<T, H>::operator=(value_ptr<T2, H2> &&other) { swap(std::move(other)); return *this; }
+constexpr typename value_ptr<T, H>::template enable_if_different<T2, typename value_ptr<T, H>::template enable_if_compatible<T2, value_ptr<T, H> &>::type>::type value_ptr<T, H>::operator=(value_ptr<T2, H2> &&other) { swap(std::move(other)); return *this; }
 
 /**
  * Safe bool conversion operator
@@ -270,13 +417,14 @@ template <typename T, typename H>
 constexpr value_ptr<T, H>::operator value_ptr<T, H>::__unspecified_bool_type() const noexcept { return nullptr == get() ? nullptr : &value_ptr<T, H>::c; }
 
 /**
- * Virtual destructor
+ * Destructor
  *
- * The destructor merely resets the object.
+ * The destructor merely resets the object; it is not virtual, so that
+ * value_ptrs with empty handlers are exactly pointer-sized.
  *
  */
 template <typename T, typename H>
-value_ptr<T, H>::~value_ptr() noexcept { reset(); }
+constexpr value_ptr<T, H>::~value_ptr() noexcept { reset(); }
 
 /**
  * Const-reference operator[]
@@ -294,7 +442,7 @@ value_ptr<T, H>::~value_ptr() noexcept { reset(); }
  */
 template <typename T, typename H>
 template <typename U>
-constexpr typename value_ptr<T, H>::template enable_if_array<U, typename value_ptr<T, H>::lvalue_reference_type>::type value_ptr<T, H>::operator[](std::size_t i) const { return get()[i]; }
+constexpr typename value_ptr<T, H>::template enable_if_array<U, typename value_ptr<T, H>::reference_type>::type value_ptr<T, H>::operator[](std::size_t i) const { return get()[i]; }
 
 /**
  * Non-const reference operator[]
@@ -312,7 +460,7 @@ constexpr typename value_ptr<T, H>::template enable_if_array<U, typename value_p
  */
 template <typename T, typename H>
 template <typename U>
-typename value_ptr<T, H>::template enable_if_array<U, typename value_ptr<T, H>::reference_type>::type value_ptr<T, H>::operator[](std::size_t i) { return get()[i]; }
+constexpr typename value_ptr<T, H>::template enable_if_array<U, typename value_ptr<T, H>::reference_type>::type value_ptr<T, H>::operator[](std::size_t i) { return get()[i]; }
 
 /**
  * Get the pointed-to object
@@ -330,13 +478,24 @@ constexpr typename value_ptr<T, H>::reference_type value_ptr<T, H>::operator*()
 template <typename T, typename H>
 constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::operator->() const noexcept { return get(); }
 
+/**
+ * Return the pointer part of the internal state, ready for mutation
+ *
+ * If the handler provides a "detach" method, it is given the chance to
+ * replace the pointee with an unshared one first.
+ *
+ * @return the current (possibly detached) pointer
+ */
+template <typename T, typename H>
+constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::mutable_get() { return c.pointer = handlerDetach(get_handler(), get(), 0); }
+
 /**
  * Return the pointer part of the internal state
  *
  * @return the current pointer
  */
 template <typename T, typename H>
-constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::get() const noexcept { return std::get<0>(c); }
+constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::get() const noexcept { return c.pointer; }
 
 /**
  * Get a modifiable reference to the current handler
@@ -344,7 +503,7 @@ constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::get() const no
  * @return a reference to the current handler
  */
 template <typename T, typename H>
-typename value_ptr<T, H>::handler_reference value_ptr<T, H>::get_handler() noexcept { return std::get<1>(c); }
+constexpr typename value_ptr<T, H>::handler_reference value_ptr<T, H>::get_handler() noexcept { return c.handler(); }
 
 /**
  * Get an unmodifiable reference to the current handler
@@ -352,15 +511,24 @@ typename value_ptr<T, H>::handler_reference value_ptr<T, H>::get_handler() noexc
  * @return a const reference to the current handler
  */
 template <typename T, typename H>
-constexpr typename value_ptr<T, H>::handler_const_reference value_ptr<T, H>::get_handler() const noexcept { return std::get<1>(c); }
+constexpr typename value_ptr<T, H>::handler_const_reference value_ptr<T, H>::get_handler() const noexcept { return c.handler(); }
 
 /**
  * Release ownership of the current pointer and reset it to nullptr
  *
+ * If the handler provides a "release" method, it is given the chance to
+ * move the pointee out of any storage of its own first; this is only
+ * noexcept if that method is. Should it throw, the value_ptr keeps
+ * owning its pointee.
+ *
  * @return the previously owned pointer
  */
 template <typename T, typename H>
-typename value_ptr<T, H>::pointer_type value_ptr<T, H>::release() noexcept { value_ptr<T, H>::pointer_type old = get(); std::get<0>(c) = nullptr; return old; }
+constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::release() noexcept(noexcept(handlerRelease(std::declval<handler_reference>(), pointer_type(), 0))) {
+  pointer_type p = handlerRelease(get_handler(), get(), 0);
+  yield();
+  return p;
+}
 
 /**
  * Reset the internal pointer to the given value (nullptr, by default)
@@ -368,7 +536,15 @@ typename value_ptr<T, H>::pointer_type value_ptr<T, H>::release() noexcept { val
  * @param p  New value to acquire
  */
 template <typename T, typename H>
-void value_ptr<T, H>::reset(typename value_ptr<T, H>::pointer_type p) noexcept { if (p != get()) { get_handler().destroy(get()); std::get<0>(c) = p; } }
+constexpr void value_ptr<T, H>::reset(typename value_ptr<T, H>::pointer_type p) noexcept {
+  if (p != get()) {
+    get_handler().destroy(get());
+    c.pointer = p;
+    if (nullptr != p) {
+      handlerAdopt(get_handler(), p, 0);
+    }
+  }
+}
 
 /**
  * Swap the internal state with a compatible value_ptr
@@ -377,7 +553,7 @@ void value_ptr<T, H>::reset(typename value_ptr<T, H>::pointer_type p) noexcept {
  */
 template <typename T, typename H>
 template <typename T2, typename H2>
-typename value_ptr<T, H>::template enable_if_compatible<T2, void>::type value_ptr<T, H>::swap(value_ptr<T2, H2> &other) noexcept { using std::swap; swap(c, other.c); }
+constexpr typename value_ptr<T, H>::template enable_if_compatible<T2, void>::type value_ptr<T, H>::swap(value_ptr<T2, H2> &other) noexcept { swapState(other, 0); }
 
 /**
  * Swap the internal state with a compatible value_ptr (rvalue overload)
@@ -386,7 +562,242 @@ typename value_ptr<T, H>::template enable_if_compatible<T2, void>::type value_pt
  */
 template <typename T, typename H>
 template <typename T2, typename H2>
-typename value_ptr<T, H>::template enable_if_compatible<T2, void>::type value_ptr<T, H>::swap(value_ptr<T2, H2> &&other) noexcept { using std::swap; swap(c, other.c); }
+constexpr typename value_ptr<T, H>::template enable_if_compatible<T2, void>::type value_ptr<T, H>::swap(value_ptr<T2, H2> &&other) noexcept { swapState(other, 0); }
+
+/**
+ * Deep-copy the pointee into a value_ptr allocating from the given memory resource
+ *
+ * The copy's handler is built from this value_ptr's handler and the
+ * given resource, which the handler must thus support (as eg.
+ * resource_handler and pmr_handler do); the copy then replicates the
+ * pointee through it, so that the pointee (and, for arrays, every
+ * element) lives in the given resource.
+ *
+ * @param resource  Memory resource the copy is to allocate from
+ * @return a value_ptr holding a copy of the pointee
+ */
+template <typename T, typename H>
+template <typename R>
+value_ptr<T, H> value_ptr<T, H>::clone_into(R *resource) const {
+  value_ptr<T, H> ret{pointer_type(), handler_type(get_handler(), resource), nullptr};
+  ret.c.pointer = ret.get_handler().replicate(get());
+  return ret;
+}
+
+/**
+ * Relinquish the current pointer without involving the handler
+ *
+ * @return the previously owned pointer
+ */
+template <typename T, typename H>
+constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::yield() noexcept { value_ptr<T, H>::pointer_type old = get(); c.pointer = nullptr; return old; }
+
+/**
+ * Swap the internal state with a value_ptr whose handler may relocate pointees
+ *
+ * This overload is only viable if the handler does provide a "relocate"
+ * method, in which case the swap is performed by means of three moves.
+ *
+ * @param other  The value_ptr to swap values with
+ * @param <unnamed>  int parameter to use for overload prioritization
+ */
+template <typename T, typename H>
+template <typename V, typename H2>
+constexpr auto value_ptr<T, H>::swapState(V &other, int) noexcept -> decltype(std::declval<H2 &>().relocate(other.get_handler(), pointer_type()), void()) {
+  V tmp{std::move(other)};
+  other = std::move(*this);
+  *this = std::move(tmp);
+}
+
+/**
+ * Swap the internal state with a value_ptr by swapping the internal states
+ *
+ * @param other  The value_ptr to swap values with
+ * @param <unnamed>  long parameter to use for overload prioritization
+ */
+template <typename T, typename H>
+template <typename V>
+constexpr void value_ptr<T, H>::swapState(V &other, long) noexcept { c.swap(other.c); }
+
+/**
+ * Let the handler know the static type of a newly adopted pointee using its "adopt" method
+ *
+ * This overload is only viable if the handler does provide an "adopt"
+ * method.
+ *
+ * @param h  Handler to use
+ * @param p  Pointer to the adopted pointee
+ * @param <unnamed>  int parameter to use for overload prioritization
+ */
+template <typename T, typename H>
+template <typename H2, typename T2>
+constexpr auto value_ptr<T, H>::handlerAdopt(H2 &h, T2 const *p, int) -> decltype(h.adopt(p)) { return h.adopt(p); }
+
+/**
+ * Fallback for handlers lacking an "adopt" method
+ *
+ * @param <unnamed>  Handler to use
+ * @param <unnamed>  Pointer to the adopted pointee
+ * @param <unnamed>  long parameter to use for overload prioritization
+ */
+template <typename T, typename H>
+template <typename H2, typename T2>
+constexpr void value_ptr<T, H>::handlerAdopt(H2 &, T2 const *, long) noexcept {}
+
+/**
+ * Construct a new pointee using the handler's "construct" method
+ *
+ * This overload is only viable if the handler does provide a "construct"
+ * method.
+ *
+ * @param T2  Type of the pointee to construct
+ * @param h  Handler to use
+ * @param <unnamed>  int parameter to use for overload prioritization
+ * @param args  Arguments to construct the pointee from
+ * @return a pointer to the new pointee
+ */
+template <typename T, typename H>
+template <typename T2, typename H2, typename... Args>
+constexpr auto value_ptr<T, H>::handlerConstruct(H2 &h, int, Args&&... args) -> decltype(h.template construct<T2>(std::forward<Args>(args)...)) { return h.template construct<T2>(std::forward<Args>(args)...); }
+
+/**
+ * Fallback for handlers lacking a "construct" method
+ *
+ * Constructs the pointee by a plain new expression and lets the handler
+ * adopt it, deleting it should that throw.
+ *
+ * @param T2  Type of the pointee to construct
+ * @param h  Handler to use
+ * @param <unnamed>  long parameter to use for overload prioritization
+ * @param args  Arguments to construct the pointee from
+ * @return a pointer to the new pointee
+ */
+template <typename T, typename H>
+template <typename T2, typename H2, typename... Args>
+constexpr typename std::remove_extent<T2>::type *value_ptr<T, H>::handlerConstruct(H2 &h, long, Args&&... args) {
+  typename std::remove_extent<T2>::type *ret = default_construct<T2, Itanium>().template construct<T2>(std::forward<Args>(args)...);
+
+  try {
+    handlerAdopt(h, ret, 0);
+  } catch (...) {
+    default_destroy<T2, Itanium>().destroy(ret);
+    throw;
+  }
+
+  return ret;
+}
+
+/**
+ * Take over a pointer owned by another handler using the handler's "relocate" method
+ *
+ * This overload is only viable if the handler does provide a "relocate"
+ * method.
+ *
+ * @param h  Handler to use
+ * @param from  Handler the pointer is being taken from
+ * @param p  Pointer to take over
+ * @param <unnamed>  int parameter to use for overload prioritization
+ * @return the pointer to use from now on
+ */
+template <typename T, typename H>
+template <typename H2>
+constexpr auto value_ptr<T, H>::handlerRelocate(H2 &h, H2 &from, typename value_ptr<T, H>::pointer_type p, int) -> decltype(h.relocate(from, p)) { return h.relocate(from, p); }
+
+/**
+ * Fallback for handlers lacking a "relocate" method
+ *
+ * @param <unnamed>  Handler to use
+ * @param <unnamed>  Handler the pointer is being taken from
+ * @param p  Pointer to take over
+ * @param <unnamed>  long parameter to use for overload prioritization
+ * @return the given pointer
+ */
+template <typename T, typename H>
+template <typename H2>
+constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::handlerRelocate(H2 &, H2 &, typename value_ptr<T, H>::pointer_type p, long) noexcept { return p; }
+
+/**
+ * Hand out a pointer no longer bound to the handler using its "release" method
+ *
+ * This overload is only viable if the handler does provide a "release"
+ * method.
+ *
+ * @param h  Handler to use
+ * @param p  Pointer to release
+ * @param <unnamed>  int parameter to use for overload prioritization
+ * @return a pointer the caller may take ownership of
+ */
+template <typename T, typename H>
+template <typename H2>
+constexpr auto value_ptr<T, H>::handlerRelease(H2 &h, typename value_ptr<T, H>::pointer_type p, int) -> decltype(h.release(p)) { return h.release(p); }
+
+/**
+ * Fallback for handlers lacking a "release" method
+ *
+ * @param <unnamed>  Handler to use
+ * @param p  Pointer to release
+ * @param <unnamed>  long parameter to use for overload prioritization
+ * @return the given pointer
+ */
+template <typename T, typename H>
+template <typename H2>
+constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::handlerRelease(H2 &, typename value_ptr<T, H>::pointer_type p, long) noexcept { return p; }
+
+/**
+ * Obtain an unshared pointee using the handler's "detach" method
+ *
+ * This overload is only viable if the handler does provide a "detach"
+ * method.
+ *
+ * @param h  Handler to use
+ * @param p  Pointer to the (possibly shared) pointee
+ * @param <unnamed>  int parameter to use for overload prioritization
+ * @return a pointer to an unshared pointee
+ */
+template <typename T, typename H>
+template <typename H2>
+constexpr auto value_ptr<T, H>::handlerDetach(H2 &h, typename value_ptr<T, H>::pointer_type p, int) -> decltype(h.detach(p)) { return h.detach(p); }
+
+/**
+ * Fallback for handlers lacking a "detach" method
+ *
+ * @param <unnamed>  Handler to use
+ * @param p  Pointer to the pointee
+ * @param <unnamed>  long parameter to use for overload prioritization
+ * @return the given pointer
+ */
+template <typename T, typename H>
+template <typename H2>
+constexpr typename value_ptr<T, H>::pointer_type value_ptr<T, H>::handlerDetach(H2 &, typename value_ptr<T, H>::pointer_type p, long) noexcept { return p; }
+
+/**
+ * Copy-assign the given pointee into the given storage using the handler's "assign" method
+ *
+ * This overload is only viable if the handler does provide an "assign"
+ * method.
+ *
+ * @param h  Handler to use
+ * @param p  Pointer to the storage to assign to
+ * @param q  Pointer to the object to assign from
+ * @param <unnamed>  int parameter to use for overload prioritization
+ * @return whether the assignment could be performed in place
+ */
+template <typename T, typename H>
+template <typename H2>
+constexpr auto value_ptr<T, H>::handlerAssign(H2 &h, typename value_ptr<T, H>::pointer_type p, typename value_ptr<T, H>::element_type const *q, int) -> decltype(h.assign(p, q)) { return h.assign(p, q); }
+
+/**
+ * Fallback for handlers lacking an "assign" method
+ *
+ * @param <unnamed>  Handler to use
+ * @param <unnamed>  Pointer to the storage to assign to
+ * @param <unnamed>  Pointer to the object to assign from
+ * @param <unnamed>  long parameter to use for overload prioritization
+ * @return false, always
+ */
+template <typename T, typename H>
+template <typename H2>
+constexpr bool value_ptr<T, H>::handlerAssign(H2 &, typename value_ptr<T, H>::pointer_type, typename value_ptr<T, H>::element_type const *, long) noexcept { return false; }
 
 /**
  * Construct a new value_ptr with the given arguments and perform sanity checks
@@ -396,7 +807,10 @@ typename value_ptr<T, H>::template enable_if_compatible<T2, void>::type value_pt
  * - if the replicator type is a pointer, it cannot be initialized with nullptr,
  * - if the deleter type is a pointer, it cannot be initialized with nullptr,
  * - if the replicator type is a reference, it cannot be initialized with a temporary,
- * - if the deleter type is a reference, it cannot be initialized with a temporary.
+ * - if the deleter type is a reference, it cannot be initialized with a temporary,
+ * - the handler type must be nothrow move-assignable,
+ * - value_ptr must be nothrow move-constructible and move-assignable,
+ * - value_ptr must be pointer-sized if the handler type is empty.
  *
  *
  * @param p  Pointer to take ownership of
@@ -408,6 +822,10 @@ template <typename T2, typename H2>
 constexpr value_ptr<T, H>::value_ptr(T2 *p, H2&& h, typename value_ptr<T, H>::template enable_if_compatible<T2>::type) noexcept : c{p, std::forward<H2>(h)} {
   static_assert(!std::is_polymorphic<T>::value || H::slice_safe, "would slice when copying");
   static_assert(!std::is_reference<value_ptr<T, H>::handler_type>::value || !std::is_rvalue_reference<H2>::value, "rvalue handler bound to reference");
+  static_assert(std::is_nothrow_move_assignable<value_ptr<T, H>::handler_type>::value, "handler must be nothrow move-assignable");
+  static_assert(std::is_nothrow_move_constructible<value_ptr<T, H>>::value, "value_ptr must be nothrow move-constructible");
+  static_assert(std::is_nothrow_move_assignable<value_ptr<T, H>>::value, "value_ptr must be nothrow move-assignable");
+  static_assert(!std::is_empty<value_ptr<T, H>::handler_type>::value || std::is_final<value_ptr<T, H>::handler_type>::value || sizeof(value_ptr<T, H>) == sizeof(pointer_type), "value_ptr must be pointer-sized for empty handlers");
 }
 
 /**
@@ -418,7 +836,10 @@ constexpr value_ptr<T, H>::value_ptr(T2 *p, H2&& h, typename value_ptr<T, H>::te
  * - if the replicator type is a pointer, it cannot be initialized with nullptr,
  * - if the deleter type is a pointer, it cannot be initialized with nullptr,
  * - if the replicator type is a reference, it cannot be initialized with a temporary,
- * - if the deleter type is a reference, it cannot be initialized with a temporary.
+ * - if the deleter type is a reference, it cannot be initialized with a temporary,
+ * - the handler type must be nothrow move-assignable,
+ * - value_ptr must be nothrow move-constructible and move-assignable,
+ * - value_ptr must be pointer-sized if the handler type is empty.
  *
  *
  * @param <unnamed>  Nullptr to use
@@ -430,6 +851,10 @@ template <typename H2>
 constexpr value_ptr<T, H>::value_ptr(nullptr_t, H2&& h, nullptr_t) noexcept : c{nullptr, std::forward<H2>(h)} {
   static_assert(!std::is_polymorphic<T>::value || H::slice_safe, "would slice when copying");
   static_assert(!std::is_reference<value_ptr<T, H>::handler_type>::value || !std::is_rvalue_reference<H2>::value, "rvalue handler bound to reference");
+  static_assert(std::is_nothrow_move_assignable<value_ptr<T, H>::handler_type>::value, "handler must be nothrow move-assignable");
+  static_assert(std::is_nothrow_move_constructible<value_ptr<T, H>>::value, "value_ptr must be nothrow move-constructible");
+  static_assert(std::is_nothrow_move_assignable<value_ptr<T, H>>::value, "value_ptr must be nothrow move-assignable");
+  static_assert(!std::is_empty<value_ptr<T, H>::handler_type>::value || std::is_final<value_ptr<T, H>::handler_type>::value || sizeof(value_ptr<T, H>) == sizeof(pointer_type), "value_ptr must be pointer-sized for empty handlers");
 }
 
 
@@ -441,12 +866,28 @@ constexpr value_ptr<T, H>::value_ptr(nullptr_t, H2&& h, nullptr_t) noexcept : c{
  * @param y  Second value_ptr to swap
  */
 template <class T, class H>
-inline void swap(value_ptr<T, H> &x, value_ptr<T, H> &y) noexcept { x.swap(y); }
+constexpr void swap(value_ptr<T, H> &x, value_ptr<T, H> &y) noexcept { x.swap(y); }
+
+/**
+ * Create a value_ptr whose pointee is constructed in place from the given arguments
+ *
+ * For array types, the sole argument is the number of elements for open
+ * arrays, and there is none for fixed ones, elements being
+ * value-initialized.
+ *
+ * @param T  Type of the pointee to construct
+ * @param H  Handler type to use
+ * @param args  Arguments to construct the pointee from
+ * @return a value_ptr owning the new pointee
+ */
+template <class T, class H, class... Args>
+constexpr value_ptr<T, H> make_value(Args&&... args) { return value_ptr<T, H>(value_in_place, std::forward<Args>(args)...); }
 
 /**
  * Equality and difference operator overloads for arbitrary value_ptrs
  *
- * Equality is determined by pointer value.
+ * Equality is determined by pointer value; see value_compare (in Compare.h) for
+ * comparison by pointee.
  *
  *
  * @param x  First value_ptr to compare
@@ -454,9 +895,9 @@ inline void swap(value_ptr<T, H> &x, value_ptr<T, H> &y) noexcept { x.swap(y); }
  * @return the comparison result
  */
 template <class T1, class H1, class T2, class H2>
-inline bool operator==(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return x.get() == y.get(); }
+constexpr bool operator==(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return x.get() == y.get(); }
 template <class T1, class H1, class T2, class H2>
-inline bool operator!=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return !(x == y); }
+constexpr bool operator!=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return !(x == y); }
 
 /**
  * Equality and difference operator overloads for value_ptrs vs nullptr_t
@@ -469,18 +910,19 @@ inline bool operator!=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) {
  * @return the comparison result
  */
 template <class T, class H>
-inline bool operator==(value_ptr<T, H> const &x, nullptr_t y) { return x.get() == y; }
+constexpr bool operator==(value_ptr<T, H> const &x, nullptr_t y) { return x.get() == y; }
 template <class T, class H>
-inline bool operator!=(value_ptr<T, H> const &x, nullptr_t y) { return !(x == y); }
+constexpr bool operator!=(value_ptr<T, H> const &x, nullptr_t y) { return !(x == y); }
 template <class T, class H>
-inline bool operator==(nullptr_t x, value_ptr<T, H> const &y) { return x == y.get(); }
+constexpr bool operator==(nullptr_t x, value_ptr<T, H> const &y) { return x == y.get(); }
 template <class T, class H>
-inline bool operator!=(nullptr_t x, value_ptr<T, H> const &y) { return !(x == y); }
+constexpr bool operator!=(nullptr_t x, value_ptr<T, H> const &y) { return !(x == y); }
 
 /**
  * Comparison operators overloads for arbitrary value_ptrs
  *
- * Comparison is determined by pointer value.
+ * Comparison is determined by pointer value; see value_compare (in Compare.h) for
+ * comparison by pointee.
  *
  *
  * @param x  First value_ptr to compare
@@ -488,16 +930,16 @@ inline bool operator!=(nullptr_t x, value_ptr<T, H> const &y) { return !(x == y)
  * @return the comparison result
  */
 template <class T1, class H1, class T2, class H2>
-inline bool operator< (value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) {
+constexpr bool operator< (value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) {
   using CT = typename std::common_type<typename value_ptr<T1, H1>::pointer_type, typename value_ptr<T2, H2>::pointer_type>::type;
   return std::less<CT>()(x.get(), y.get());
 }
 template <class T1, class H1, class T2, class H2>
-inline bool operator> (value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return y < x; }
+constexpr bool operator> (value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return y < x; }
 template <class T1, class H1, class T2, class H2>
-inline bool operator<=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return !(y < x); }
+constexpr bool operator<=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return !(y < x); }
 template <class T1, class H1, class T2, class H2>
-inline bool operator>=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return !(x < y); }
+constexpr bool operator>=(value_ptr<T1, H1> const &x, value_ptr<T2, H2> const &y) { return !(x < y); }
 
 
 #endif /* VALUE_PTR__ */